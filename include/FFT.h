@@ -31,17 +31,29 @@
 #include <assert.h>
 #include <cmath>
 #include <complex>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numbers>
+#include <type_traits>
 #include <vector>
 
 namespace util
 {
-class FFT
+/**
+ * @brief Radix-2 Fast Fourier Transform of a tape of real samples.
+ *
+ * @tparam FLOAT_TYPE floating point type of the samples and the calculation
+ */
+template <typename FLOAT_TYPE = long double>
+class basic_fft
 {
+    static_assert(std::is_floating_point_v<FLOAT_TYPE>, "the FFT calculates in a floating point type");
+
   public:
     using INTTYPE       = int64_t;
     using INTVECTOR     = std::vector<INTTYPE>;
-    using FLOATTYPE     = long double;
+    using FLOATTYPE     = FLOAT_TYPE;
     using FLOATVECTOR   = std::vector<FLOATTYPE>;
     using COMPLEXVALUE  = std::complex<FLOATTYPE>;
     using COMPLEXVECTOR = std::vector<COMPLEXVALUE>;
@@ -58,7 +70,7 @@ class FFT
      * @param sampleRate the rate at which the input will be sampled
      * @param calibrate whether or not to calibrate on a 1kHz wave
      */
-    explicit FFT(INTTYPE logOfNumOfPoints = 10, INTTYPE sampleRate = 1'024, bool calibrate = false)
+    explicit basic_fft(INTTYPE logOfNumOfPoints = 10, INTTYPE sampleRate = 1'024, bool calibrate = false)
         : logOfPoints_(logOfNumOfPoints)
         , numOfPoints_(powTwo[logOfNumOfPoints])
         , sampleRate_(sampleRate)
@@ -68,8 +80,8 @@ class FFT
         if (calibrate)
         {
             // 1 kHz calibration wave
-            FLOATTYPE TWO_KILO_PI        = 2.0 * FLOATTYPE(PI) * 1000.0L;
-            FLOATTYPE CALIBRATION_FACTOR = 1600.0L;
+            FLOATTYPE TWO_KILO_PI        = FLOATTYPE(2) * PI * FLOATTYPE(1000);
+            FLOATTYPE CALIBRATION_FACTOR = FLOATTYPE(1600);
 
             for (INTTYPE i = 0; i < numOfPoints_; i++)
             {
@@ -97,22 +109,8 @@ class FFT
 
         bitReverseVector_.resize(numOfPoints_);
         transformedComplexVector_.resize(numOfPoints_);
-        complexExpontials_.resize(logOfPoints_ + 1);
-
-        // Pre-compute complex exponentials
-        for (INTTYPE l = 1; l <= logOfPoints_; l++)
-        {
-            (complexExpontials_[l]).resize(numOfPoints_);
-
-            for (INTTYPE i = 0; i < numOfPoints_; i++)
-            {
-                const static FLOATTYPE TWO_PI = 2. * PI;
-                FLOATTYPE              re     = std::cos(TWO_PI * i / FLOATTYPE(powTwo[l]));
-                FLOATTYPE              im     = -std::sin(TWO_PI * i / FLOATTYPE(powTwo[l]));
-
-                complexExpontials_[l][i] = COMPLEXVALUE(re, im);
-            }
-        }
+        halfComplexVector_.resize(numOfPoints_ / 2);
+        twiddles_ = twiddleTable(logOfPoints_);
 
         // set up bit reverse mapping
         INTTYPE rev        = 0;
@@ -136,8 +134,8 @@ class FFT
         bitReverseVector_[numOfPoints_ - 1] = numOfPoints_ - 1;
     }
 
-    FFT(const FFT &lhs)            = default;
-    FFT &operator=(const FFT &lhs) = default;
+    basic_fft(const basic_fft &lhs)            = default;
+    basic_fft &operator=(const basic_fft &lhs) = default;
 
     [[nodiscard]] INTTYPE numberOfPoints() const
     {
@@ -196,32 +194,54 @@ class FFT
      */
     COMPLEXVECTOR transform()
     {
-        // step = 2 ^ (level-1)
-        // increm = 2 ^ level;
-        INTTYPE step = 1;
-        for (INTTYPE level = 1; level <= logOfPoints_; level++)
+        butterflies(transformedComplexVector_, logOfPoints_);
+
+        return transformedComplexVector_;
+    }
+
+    /**
+     * @brief Transform the tape as the real signal it is. The N samples are packed into N/2 complex values
+     * x[2k] + i x[2k+1], which are transformed with an FFT of N/2 points and then separated into the spectra of the
+     * even and the odd samples and combined. This calculates the spectrum that transform() does, with half the work.
+     * The samples are read from the tape, so that the transform can be repeated, and the spectrum replaces the data
+     * that transform() works on: load the samples again before calling it.
+     *
+     * @return the N points of the spectrum, the second half being the complex conjugate of the first
+     */
+    COMPLEXVECTOR transformReal()
+    {
+        if (logOfPoints_ == 0)
         {
-            INTTYPE increment = step * 2;
+            transformedComplexVector_[0] = COMPLEXVALUE(tapeOfDoubles_[0]);
 
-            for (INTTYPE j = 0; j < step; j++)
-            {
-                // U = exp ( - 2 PI j / 2 ^ level )
-                COMPLEXVALUE U = complexExpontials_[level][j];
+            return transformedComplexVector_;
+        }
 
-                for (INTTYPE i = j; i < numOfPoints_; i += increment)
-                {
-                    // butterfly
-                    COMPLEXVALUE T = U;
+        // the bit reversal of k among N/2 points is its bit reversal among N points, halved
+        INTTYPE const halfPoints = numOfPoints_ / 2;
+        for (INTTYPE k = 0; k < halfPoints; k++)
+        {
+            halfComplexVector_[bitReverseVector_[k] / 2] =
+                COMPLEXVALUE(tapeOfDoubles_[2 * k], tapeOfDoubles_[2 * k + 1]);
+        }
+        butterflies(halfComplexVector_, logOfPoints_ - 1);
 
-                    T *= transformedComplexVector_[i + step];
+        // Z[k] = E[k] + i O[k] for the spectra E and O of the even and odd samples, and X[k] = E[k] + W^k O[k]
+        FLOATTYPE const half = FLOATTYPE(0.5);
+        for (INTTYPE k = 0; k <= halfPoints; k++)
+        {
+            COMPLEXVALUE const z     = halfComplexVector_[k & (halfPoints - 1)];
+            COMPLEXVALUE const zConj = std::conj(halfComplexVector_[(halfPoints - k) & (halfPoints - 1)]);
+            COMPLEXVALUE const even((z.real() + zConj.real()) * half, (z.imag() + zConj.imag()) * half);
+            COMPLEXVALUE const odd((z.imag() - zConj.imag()) * half, (zConj.real() - z.real()) * half);
 
-                    transformedComplexVector_[i + step] = transformedComplexVector_[i];
-                    transformedComplexVector_[i + step] -= T;
-                    transformedComplexVector_[i] += T;
-                }
-            }
+            COMPLEXVALUE const twiddle = k < halfPoints ? (*twiddles_)[k] : COMPLEXVALUE(-1);
 
-            step *= 2;
+            transformedComplexVector_[k] = even + multiply(twiddle, odd);
+        }
+        for (INTTYPE k = 1; k < halfPoints; k++)
+        {
+            transformedComplexVector_[numOfPoints_ - k] = std::conj(transformedComplexVector_[k]);
         }
 
         return transformedComplexVector_;
@@ -293,15 +313,116 @@ class FFT
         transformedComplexVector_[bitReverseVector_[i]] = COMPLEXVALUE(val);
     }
 
-    INTTYPE       logOfPoints_;
-    INTTYPE       numOfPoints_;
-    INTTYPE       sampleRate_;
-    FLOATTYPE     sqrtOfPoints_;
-    INTVECTOR     bitReverseVector_;         // bit reverse vector
-    COMPLEXVECTOR transformedComplexVector_; // in-place FFT array
-    COMPLEXMATRIX complexExpontials_;        // exponentials
-    FLOATVECTOR   tapeOfDoubles_;            // recording tape
+    /**
+     * @brief Multiply complex values without the recovery of infinities and NaNs that keeps std::complex
+     * multiplication from being inlined.
+     */
+    static COMPLEXVALUE multiply(COMPLEXVALUE const &lhs, COMPLEXVALUE const &rhs)
+    {
+        return COMPLEXVALUE(
+            lhs.real() * rhs.real() - lhs.imag() * rhs.imag(),
+            lhs.real() * rhs.imag() + lhs.imag() * rhs.real()
+        );
+    }
+
+    /**
+     * @brief Retrieve the twiddle factors exp(-2 PI i k / N), k < N / 2, of an FFT of N = 2 ^ logOfNumOfPoints points.
+     * They are calculated once for each size and shared by all transforms of that size and precision.
+     */
+    static std::shared_ptr<COMPLEXVECTOR const> twiddleTable(INTTYPE logOfNumOfPoints)
+    {
+        static std::mutex                                              cacheMutex;
+        static std::map<INTTYPE, std::shared_ptr<COMPLEXVECTOR const>> cache;
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto                       &table = cache[logOfNumOfPoints];
+        if (!table)
+        {
+            table = std::make_shared<COMPLEXVECTOR const>(calculateTwiddles(logOfNumOfPoints));
+        }
+
+        return table;
+    }
+
+    /**
+     * @brief Calculate the twiddle factors exp(-2 PI i k / N), k < N / 2. Only the first eighth of the circle is
+     * calculated, in long double for accuracy whatever the precision of the transform, the rest follows from the
+     * symmetries of sine and cosine.
+     */
+    static COMPLEXVECTOR calculateTwiddles(INTTYPE logOfNumOfPoints)
+    {
+        const static long double TWO_PI = 2.0L * std::numbers::pi_v<long double>;
+
+        INTTYPE const points  = powTwo[logOfNumOfPoints];
+        INTTYPE const half    = points / 2;
+        INTTYPE const quarter = points / 4;
+        COMPLEXVECTOR reval(half);
+
+        for (INTTYPE k = 0; k <= points / 8 && k < half; k++)
+        {
+            long double const angle = TWO_PI * k / static_cast<long double>(points);
+
+            reval[k] = COMPLEXVALUE(FLOATTYPE(std::cos(angle)), FLOATTYPE(-std::sin(angle)));
+        }
+        // cos(a) = sin(PI / 2 - a) and sin(a) = cos(PI / 2 - a)
+        for (INTTYPE k = points / 8 + 1; k <= quarter && k < half; k++)
+        {
+            reval[k] = COMPLEXVALUE(-reval[quarter - k].imag(), -reval[quarter - k].real());
+        }
+        // cos(a) = -cos(PI - a) and sin(a) = sin(PI - a)
+        for (INTTYPE k = quarter + 1; k < half; k++)
+        {
+            reval[k] = COMPLEXVALUE(-reval[half - k].real(), reval[half - k].imag());
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Run the butterflies of an FFT of 2 ^ logSize points in place on bit-reversed data.
+     */
+    void butterflies(COMPLEXVECTOR &data, INTTYPE logSize) const
+    {
+        INTTYPE const size = powTwo[logSize];
+
+        // step = 2 ^ (level-1)
+        // increm = 2 ^ level;
+        INTTYPE step = 1;
+        for (INTTYPE level = 1; level <= logSize; level++)
+        {
+            INTTYPE increment = step * 2;
+
+            for (INTTYPE j = 0; j < step; j++)
+            {
+                // U = exp ( - 2 PI j / 2 ^ level ) = exp ( - 2 PI j * (N / 2 ^ level) / N )
+                COMPLEXVALUE const U = (*twiddles_)[j * (numOfPoints_ >> level)];
+
+                for (INTTYPE i = j; i < size; i += increment)
+                {
+                    // butterfly
+                    COMPLEXVALUE const T = multiply(U, data[i + step]);
+
+                    data[i + step] = data[i] - T;
+                    data[i] += T;
+                }
+            }
+
+            step *= 2;
+        }
+    }
+
+    INTTYPE                              logOfPoints_;
+    INTTYPE                              numOfPoints_;
+    INTTYPE                              sampleRate_;
+    FLOATTYPE                            sqrtOfPoints_;
+    INTVECTOR                            bitReverseVector_;         // bit reverse vector
+    COMPLEXVECTOR                        transformedComplexVector_; // in-place FFT array
+    COMPLEXVECTOR                        halfComplexVector_;        // in-place FFT array of the packed real samples
+    std::shared_ptr<COMPLEXVECTOR const> twiddles_;                 // exp(-2 PI i k / N) for k < N / 2, shared
+    FLOATVECTOR                          tapeOfDoubles_;            // recording tape
 };
+
+using FFT = basic_fft<long double>;
 }; // namespace util
 
 #endif // !defined(NS_UTIL_FFT_H_INCLUDED)
@@ -0,0 +1,343 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/gemm.h
+ * Description: cache-blocked, vectorised general matrix multiplication kernels
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_GEMM_H_INCLUDED
+#define NS_UTIL_GEMM_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define DKYB_GEMM_X86_DISPATCH_
+#endif
+
+namespace util
+{
+/**
+ * @brief Instruction set used by the GEMM micro-kernel.
+ */
+enum class simd_level
+{
+    generic,
+    avx2,
+    avx512
+};
+
+/**
+ * @brief Determine the best instruction set supported by the CPU. The check is done only once.
+ *
+ * @return simd_level the instruction set used by gemm_accumulate()
+ */
+inline simd_level detected_simd_level()
+{
+    static simd_level const level = []()
+    {
+#if defined DKYB_GEMM_X86_DISPATCH_
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+        {
+            return simd_level::avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return simd_level::avx2;
+        }
+#endif
+        return simd_level::generic;
+    }();
+    return level;
+}
+
+/**
+ * @brief Check whether the blocked GEMM kernel is available for a value type.
+ *
+ * @tparam T value type
+ */
+template <typename T>
+constexpr bool has_gemm_kernel_v = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+namespace gemm_detail
+{
+/**
+ * @brief Rows of C computed by one call of the micro-kernel.
+ */
+constexpr size_t MR = 6UL;
+
+/**
+ * @brief Number of vector registers per row of C computed by one call of the micro-kernel.
+ */
+constexpr size_t NV = 2UL;
+
+/**
+ * @brief Depth of the packed panels of A and B, chosen so that a panel of B stays in L1.
+ */
+constexpr size_t KC = 256UL;
+
+/**
+ * @brief Rows of A packed at a time, chosen so that the packed block of A stays in L2.
+ */
+constexpr size_t MC = 96UL;
+
+/**
+ * @brief Columns of B packed at a time, chosen so that the packed block of B stays in L3.
+ */
+constexpr size_t NC = 2048UL;
+
+/**
+ * @brief Micro-kernel: C[0..mr, 0..nr] += A-panel * B-panel, with the MR x NR tile of C kept in vector registers.
+ *
+ * @tparam T value type
+ * @tparam VecBytes_ vector register width in bytes
+ * @param kc depth of the panels
+ * @param a packed panel of A, MR values per k
+ * @param b packed panel of B, NR values per k
+ * @param c top-left element of the tile of C
+ * @param ldc row stride of C
+ * @param mr number of valid rows in the tile
+ * @param nr number of valid columns in the tile
+ */
+template <typename T, size_t VecBytes_>
+[[gnu::always_inline]] inline void
+    microKernelBody(size_t kc, T const *a, T const *b, T *c, size_t ldc, size_t mr, size_t nr)
+{
+    constexpr size_t V  = VecBytes_ / sizeof(T);
+    constexpr size_t NR = V * NV;
+    typedef T        vec_t __attribute__((vector_size(VecBytes_)));
+
+    vec_t acc[MR][NV] = {};
+    for (size_t p = 0; p < kc; p++)
+    {
+        vec_t bv[NV];
+#pragma GCC unroll 4
+        for (size_t j = 0; j < NV; j++)
+        {
+            std::memcpy(&bv[j], b + p * NR + j * V, sizeof(vec_t));
+        }
+#pragma GCC unroll 8
+        for (size_t r = 0; r < MR; r++)
+        {
+            T const av = a[p * MR + r];
+#pragma GCC unroll 4
+            for (size_t j = 0; j < NV; j++)
+            {
+                acc[r][j] += av * bv[j];
+            }
+        }
+    }
+
+    if (mr == MR && nr == NR)
+    {
+#pragma GCC unroll 8
+        for (size_t r = 0; r < MR; r++)
+        {
+#pragma GCC unroll 4
+            for (size_t j = 0; j < NV; j++)
+            {
+                vec_t cv;
+                std::memcpy(&cv, c + r * ldc + j * V, sizeof(vec_t));
+                cv += acc[r][j];
+                std::memcpy(c + r * ldc + j * V, &cv, sizeof(vec_t));
+            }
+        }
+    }
+    else
+    {
+        T tile[MR][NR];
+        std::memcpy(tile, acc, sizeof(tile));
+        for (size_t r = 0; r < mr; r++)
+        {
+            for (size_t col = 0; col < nr; col++)
+            {
+                c[r * ldc + col] += tile[r][col];
+            }
+        }
+    }
+}
+
+template <typename T>
+void microKernelGeneric(size_t kc, T const *a, T const *b, T *c, size_t ldc, size_t mr, size_t nr)
+{
+    microKernelBody<T, 16>(kc, a, b, c, ldc, mr, nr);
+}
+
+#if defined DKYB_GEMM_X86_DISPATCH_
+template <typename T>
+[[gnu::target("avx2,fma")]] void microKernelAvx2(size_t kc, T const *a, T const *b, T *c, size_t ldc, size_t mr, size_t nr)
+{
+    microKernelBody<T, 32>(kc, a, b, c, ldc, mr, nr);
+}
+
+template <typename T>
+[[gnu::target("avx512f")]] void
+    microKernelAvx512(size_t kc, T const *a, T const *b, T *c, size_t ldc, size_t mr, size_t nr)
+{
+    microKernelBody<T, 64>(kc, a, b, c, ldc, mr, nr);
+}
+#endif
+
+/**
+ * @brief Pack an mc x kc block of A into micro-panels of MR rows, zero-padding the last panel.
+ */
+template <typename T>
+void packA(size_t mc, size_t kc, T const *a, size_t lda, T *packed)
+{
+    for (size_t i0 = 0; i0 < mc; i0 += MR)
+    {
+        size_t const mr = std::min(MR, mc - i0);
+        for (size_t p = 0; p < kc; p++)
+        {
+            for (size_t r = 0; r < MR; r++)
+            {
+                *packed++ = r < mr ? a[(i0 + r) * lda + p] : T(0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Pack a kc x nc block of B into micro-panels of nrWidth columns, zero-padding the last panel.
+ */
+template <typename T>
+void packB(size_t kc, size_t nc, T const *b, size_t ldb, T *packed, size_t nrWidth)
+{
+    for (size_t j0 = 0; j0 < nc; j0 += nrWidth)
+    {
+        size_t const nr = std::min(nrWidth, nc - j0);
+        for (size_t p = 0; p < kc; p++)
+        {
+            T const *bRow = b + p * ldb + j0;
+            for (size_t col = 0; col < nrWidth; col++)
+            {
+                *packed++ = col < nr ? bRow[col] : T(0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Blocked GEMM driver for a given micro-kernel and register width.
+ */
+template <typename T, size_t VecBytes_, typename Kernel_>
+void gemmBlocked(
+    size_t   m,
+    size_t   n,
+    size_t   k,
+    T const *a,
+    size_t   lda,
+    T const *b,
+    size_t   ldb,
+    T       *c,
+    size_t   ldc,
+    Kernel_  kernel
+)
+{
+    constexpr size_t NR = VecBytes_ / sizeof(T) * NV;
+
+    // packing buffers are reused between calls of the same thread
+    thread_local std::vector<T> packedA;
+    thread_local std::vector<T> packedB;
+    packedA.resize(((MC + MR - 1) / MR) * MR * KC);
+    packedB.resize(((NC + NR - 1) / NR) * NR * KC);
+
+    for (size_t j0 = 0; j0 < n; j0 += NC)
+    {
+        size_t const nc = std::min(NC, n - j0);
+        for (size_t p0 = 0; p0 < k; p0 += KC)
+        {
+            size_t const kc = std::min(KC, k - p0);
+            packB(kc, nc, b + p0 * ldb + j0, ldb, packedB.data(), NR);
+            for (size_t i0 = 0; i0 < m; i0 += MC)
+            {
+                size_t const mc = std::min(MC, m - i0);
+                packA(mc, kc, a + i0 * lda + p0, lda, packedA.data());
+                for (size_t jr = 0; jr < nc; jr += NR)
+                {
+                    T const *bPanel = packedB.data() + (jr / NR) * NR * kc;
+                    for (size_t ir = 0; ir < mc; ir += MR)
+                    {
+                        kernel(
+                            kc,
+                            packedA.data() + (ir / MR) * MR * kc,
+                            bPanel,
+                            c + (i0 + ir) * ldc + j0 + jr,
+                            ldc,
+                            std::min(MR, mc - ir),
+                            std::min(NR, nc - jr)
+                        );
+                    }
+                }
+            }
+        }
+    }
+}
+} // namespace gemm_detail
+
+/**
+ * @brief General matrix multiplication C += A * B for row-major float or double data.
+ *
+ * A is m x k, B is k x n and C is m x n. The operands are split into cache-sized blocks that are packed into
+ * contiguous panels, and a register-blocked micro-kernel computes 6 rows of C at a time. The micro-kernel is compiled
+ * for AVX-512, AVX2+FMA and a generic fallback, and the variant is selected at runtime according to CPUID.
+ *
+ * @tparam T value type, float or double
+ * @param m number of rows of A and C
+ * @param n number of columns of B and C
+ * @param k number of columns of A and rows of B
+ * @param a pointer to A
+ * @param lda row stride of A
+ * @param b pointer to B
+ * @param ldb row stride of B
+ * @param c pointer to C, which must not overlap A or B
+ * @param ldc row stride of C
+ */
+template <typename T>
+void gemm_accumulate(size_t m, size_t n, size_t k, T const *a, size_t lda, T const *b, size_t ldb, T *c, size_t ldc)
+{
+    static_assert(has_gemm_kernel_v<T>, "gemm_accumulate is only implemented for float and double");
+    if (m == 0 || n == 0 || k == 0)
+    {
+        return;
+    }
+#if defined DKYB_GEMM_X86_DISPATCH_
+    switch (detected_simd_level())
+    {
+        case simd_level::avx512:
+            gemm_detail::gemmBlocked<T, 64>(m, n, k, a, lda, b, ldb, c, ldc, gemm_detail::microKernelAvx512<T>);
+            return;
+        case simd_level::avx2:
+            gemm_detail::gemmBlocked<T, 32>(m, n, k, a, lda, b, ldb, c, ldc, gemm_detail::microKernelAvx2<T>);
+            return;
+        default:
+            break;
+    }
+#endif
+    gemm_detail::gemmBlocked<T, 16>(m, n, k, a, lda, b, ldb, c, ldc, gemm_detail::microKernelGeneric<T>);
+}
+}; // namespace util
+
+#endif // NS_UTIL_GEMM_H_INCLUDED
@@ -26,13 +26,20 @@
 #ifndef NS_UTIL_GRID_H_INCLUDED
 #define NS_UTIL_GRID_H_INCLUDED
 
+#include "threadutil.h"
 #include "to_string.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <map>
-#include <set>
+#include <iterator>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -50,6 +57,18 @@ class grid_error : public std::out_of_range
     }
 };
 
+/**
+ * @brief Thrown when a grid cannot be written to or read from a file or a stream.
+ */
+class grid_file_error : public std::runtime_error
+{
+  public:
+    explicit grid_file_error(std::string const &what_arg)
+        : runtime_error(what_arg)
+    {
+    }
+};
+
 /**
  * @brief Base class for grid-shaped containers (2-dimensional)
  *
@@ -80,6 +99,11 @@ class gridBase
         Stats  = 0x04
     };
 
+    /**
+     * @brief Number of element operations below which bulk operations run sequentially with exec_policy::automatic.
+     */
+    static constexpr size_t parallelThreshold = 1UL << 21;
+
     /**
      * @brief Default constructor.
      */
@@ -118,9 +142,9 @@ class gridBase
      *
      * @return true, if set, false otherwise
      */
-    Mode isAutoGrowX() const
+    bool isAutoGrowX() const
     {
-        return (mode_ | Mode::AutoGrowX) == Mode::AutoGrowX;
+        return hasFlag(mode_, Mode::AutoGrowX);
     }
 
     /**
@@ -128,9 +152,9 @@ class gridBase
      *
      * @return true, if set, false otherwise
      */
-    Mode isAutoGrowY() const
+    bool isAutoGrowY() const
     {
-        return (mode_ | Mode::AutoGrowY) == Mode::AutoGrowY;
+        return hasFlag(mode_, Mode::AutoGrowY);
     }
 
     /**
@@ -138,9 +162,23 @@ class gridBase
      *
      * @return true, if set, false otherwise
      */
-    Mode isAutoGrow() const
+    bool isAutoGrow() const
+    {
+        return hasFlag(mode_, Mode::AutoGrow);
+    }
+
+    /**
+     * @brief Check whether all bits of a flag are set in a mode or display mode.
+     *
+     * @param mode the mode to check
+     * @param flag the flag(s) to look for
+     *
+     * @return true, if set, false otherwise
+     */
+    template <typename ENUM_TYPE>
+    static bool hasFlag(ENUM_TYPE mode, ENUM_TYPE flag)
     {
-        return (mode_ | Mode::AutoGrow) == Mode::AutoGrow;
+        return (static_cast<int>(mode) & static_cast<int>(flag)) == static_cast<int>(flag);
     }
 
     ////////////////////////////////////////////////////////////////////////
@@ -206,7 +244,7 @@ class index_pair : public std::pair<size_t, size_t>
      * @param y y-coordinate
      */
     index_pair(size_t x = 0, size_t y = 0)
-        : std::pair<size_t, size_t>(x, y)
+        : std::pair<size_t, size_t>(y, x)
     {
     }
 
@@ -365,358 +403,1017 @@ class index_pair : public std::pair<size_t, size_t>
 };
 
 /**
- * @brief Specialisation of the gridBase class that is used for sparse population
+ * @brief The neighbours of a grid element, as passed to the function of a stencil operation.
+ *
+ * Offsets are relative to the element, dx to the right and dy downwards. Neighbours outside the grid read as the
+ * default value. Only offsets within the radius of the stencil may be used.
  *
  * @tparam EL_TYPE element-type
  */
-template <typename EL_TYPE = long double>
-class sparse_grid : public gridBase<EL_TYPE>
+template <typename EL_TYPE>
+class grid_neighbourhood
 {
-  private:
-    using DATA_CONTAINER = std::map<index_pair, EL_TYPE>;
-    using INDEXSET       = std::set<size_t>;
-    using INDEXSETMAP    = std::map<size_t, INDEXSET>;
+  public:
+    /**
+     * @brief Construct from the position of the element in a buffer of rows.
+     *
+     * @param centre the element
+     * @param stride distance between two rows of the buffer
+     */
+    grid_neighbourhood(EL_TYPE const *centre, std::ptrdiff_t const stride)
+        : centre_(centre)
+        , stride_(stride)
+    {
+    }
 
     /**
-     * @brief enumeration of modes how to set an index
+     * @brief Retrieve a neighbour.
+     *
+     * @param dx offset in X-direction
+     * @param dy offset in Y-direction
+     *
+     * @return the value of the neighbour
      */
-    enum class IndexSetOper
+    EL_TYPE const &operator()(std::ptrdiff_t const dx, std::ptrdiff_t const dy) const
     {
-        Insert = 0x01,
-        Remove = 0x02
+        return centre_[dy * stride_ + dx];
+    }
+
+  private:
+    EL_TYPE const *centre_;
+    std::ptrdiff_t stride_;
+};
+
+namespace grid_detail
+{
+/**
+ * @brief Retrieve the weights of a square kernel of odd size, row by row, and its radius.
+ *
+ * @throw grid_error if the kernel is not square or its size is even
+ */
+template <typename EL_TYPE>
+std::pair<std::vector<EL_TYPE>, size_t> kernelWeights(gridBase<EL_TYPE> const &kernel)
+{
+    if (kernel.sizeX() != kernel.sizeY() || kernel.sizeX() % 2 == 0)
+    {
+        throw grid_error(
+            "A kernel of " + toString(index_pair(kernel.sizeX(), kernel.sizeY())) + " is not square of odd size."
+        );
+    }
+
+    std::vector<EL_TYPE> weights;
+    weights.reserve(kernel.sizeX() * kernel.sizeY());
+    for (size_t y = 0; y < kernel.sizeY(); y++)
+    {
+        for (size_t x = 0; x < kernel.sizeX(); x++)
+        {
+            weights.push_back(kernel.get(x, y));
+        }
+    }
+
+    return {std::move(weights), kernel.sizeX() / 2};
+}
+
+/**
+ * @brief Stencil function that sums the neighbours weighted by the weights of a kernel.
+ */
+template <typename EL_TYPE>
+auto weightedSum(std::vector<EL_TYPE> const &weights, size_t const radius)
+{
+    return [&weights, r = std::ptrdiff_t(radius)](grid_neighbourhood<EL_TYPE> const &neighbours)
+    {
+        EL_TYPE        reval  = EL_TYPE();
+        EL_TYPE const *weight = weights.data();
+        for (std::ptrdiff_t dy = -r; dy <= r; dy++)
+        {
+            for (std::ptrdiff_t dx = -r; dx <= r; dx++)
+            {
+                reval += *weight++ * neighbours(dx, dy);
+            }
+        }
+        return reval;
     };
+}
+}; // namespace grid_detail
 
+/**
+ * @brief Open-addressing hash table from cell coordinates to values, the storage engine of sparse_grid.
+ *
+ * The coordinates of a cell are packed into a single 64-bit key, the row index in the upper and the column index in
+ * the lower half, so that the numerical order of the keys is the row-major order of the cells. Keys and values are
+ * kept in two flat arrays and collisions are resolved by linear probing: a lookup touches one or two cache-lines and
+ * an element costs the size of its key and value divided by the load factor, instead of a separately allocated tree
+ * node per element and per index.
+ *
+ * @tparam EL_TYPE element-type
+ */
+template <typename EL_TYPE>
+class cell_table
+{
   public:
-    using iterator  = typename DATA_CONTAINER::iterator;
-    using iteratorX = INDEXSET::iterator;
-    using iteratorY = INDEXSET::iterator;
+    using key_type = uint64_t;
+
+    /**
+     * @brief Coordinates must be smaller than this to be packed into a key.
+     */
+    static constexpr size_t coordinateLimit = 0xFFFFFFFFUL;
 
     /**
-     * @brief Iterator into the raw underlying data container.
+     * @brief Pack the coordinates of a cell into a key.
      *
-     * @return the begin() iterator of the underlying data
+     * @param lower column index, the lower half of the key
+     * @param upper row index, the upper half of the key
+     *
+     * @return the key
      */
-    iterator begin()
+    static key_type key(size_t lower, size_t upper)
     {
-        return data_.begin();
+        return (key_type(upper) << 32) | key_type(lower);
     }
 
     /**
-     * @brief Just beyond the end of the raw underlying data container.
-     *
-     * @return the end() iterator of the underlying data
+     * @brief Retrieve the lower half of a key, the column index.
      */
-    iterator end()
+    static size_t lowerHalf(key_type k)
     {
-        return data_.end();
+        return size_t(k & 0xFFFFFFFFUL);
     }
 
     /**
-     * @brief The iterator to the first logical non-default element in X-direction
-     * at row y.
-     *
-     * @param y the row index
-     *
-     * @return iterator to the first logical non-default element in X-direction
+     * @brief Retrieve the upper half of a key, the row index.
      */
-    iteratorX beginX(size_t y)
+    static size_t upperHalf(key_type k)
     {
-        auto indexIter = xIndices_.find(y);
-
-        if (indexIter == xIndices_.end())
-        {
-            return iteratorX{nullptr};
-        }
-
-        return (indexIter->second).begin();
+        return size_t(k >> 32);
     }
 
     /**
-     * @brief Just beyond the end of the  logical non-default element in X-direction.
-     * @return the end() iterator in x-direction at y
+     * @brief Swap the halves of a key, so that the numerical order of the keys becomes column-major.
      */
-    iteratorX endX(size_t y)
+    static key_type transposed(key_type k)
     {
-        auto indexIter = xIndices_.find(y);
-
-        if (indexIter == xIndices_.end())
-        {
-            return iteratorX{nullptr};
-        }
-
-        return (indexIter->second).end();
+        return (k << 32) | (k >> 32);
     }
 
     /**
-     * @brief Check whether the given X-dimension-iterator is valid or not
-     *
-     * @param iter the X-dimension iterator
-     * @return true, if valid, false otherwise
+     * @brief Retrieve the number of elements.
+     * @return the number of elements
      */
-    bool iteratorXValid(iteratorX iter)
+    size_t size() const
     {
-        return (iter == iteratorX{nullptr}) ? false : true;
+        return size_;
     }
 
     /**
-     * @brief Check whether the given Y-dimension-iterator is valid or not
-     *
-     * @param iter the Y-dimension iterator
-     * @return true, if valid, false otherwise
+     * @brief Retrieve the number of slots, occupied or not.
+     * @return the number of slots
      */
-    bool iteratorYValid(iteratorY iter)
+    size_t capacity() const
     {
-        return (iter == iteratorY{nullptr}) ? false : true;
+        return keys_.size();
     }
 
     /**
-     * @brief The iterator to the first logical non-default element in Y-direction
-     * at column x.
-     * @param x the column index
-     * @return iterator to the first logical non-default element in X-direction
+     * @brief Retrieve the number of bytes allocated for keys and values.
+     * @return the number of bytes
      */
-    iteratorY beginY(size_t x)
+    size_t memoryUsage() const
     {
-        auto indexIter = yIndices_.find(x);
-
-        if (indexIter == yIndices_.end())
-        {
-            return iteratorY{nullptr};
-        }
+        return keys_.capacity() * sizeof(key_type) + values_.capacity() * sizeof(EL_TYPE);
+    }
 
-        return (indexIter->second).begin();
+    /**
+     * @brief Check whether a slot holds an element.
+     */
+    bool occupied(size_t slot) const
+    {
+        return keys_[slot] != emptyKey;
     }
 
     /**
-     * @brief Just beyond the end of the  logical non-default element in Y-direction.
-     * @param x the column index
-     * @return the end() iterator in y-direction at x
+     * @brief Retrieve the key of the element in an occupied slot.
      */
-    iteratorY endY(size_t x)
+    key_type keyAt(size_t slot) const
     {
-        auto indexIter = yIndices_.find(x);
+        return keys_[slot];
+    }
 
-        if (indexIter == yIndices_.end())
-        {
-            return iteratorY{nullptr};
-        }
+    /**
+     * @brief Retrieve the value of the element in an occupied slot.
+     */
+    EL_TYPE &valueAt(size_t slot)
+    {
+        return values_[slot];
+    }
 
-        return (indexIter->second).end();
+    /**
+     * @brief Retrieve the value of the element in an occupied slot.
+     */
+    EL_TYPE const &valueAt(size_t slot) const
+    {
+        return values_[slot];
     }
 
     /**
-     * @brief Default constructor.
+     * @brief Find the value stored for a key.
      *
-     * @param dimX size of X-dimension
-     * @param dimY size of Y-dimension
-     * @param defaultValue default value to return if a cell has not been set
-     * @param mode auto-grow behaviour
+     * @param k the key
+     *
+     * @return pointer to the value, or nullptr if there is none
      */
-    sparse_grid(
-        size_t dimX                                 = 0,
-        size_t dimY                                 = 0,
-        EL_TYPE defaultValue                        = EL_TYPE(),
-        typename util::gridBase<EL_TYPE>::Mode mode = util::gridBase<EL_TYPE>::Mode::AutoGrow
-    )
-        : util::gridBase<EL_TYPE>(defaultValue)
-        , dims_(dimX, dimY)
+    EL_TYPE *find(key_type k)
     {
-        setMode(mode);
+        size_t const slot = findSlot(k);
+        return slot == npos ? nullptr : &values_[slot];
     }
 
-    sparse_grid(sparse_grid<EL_TYPE> const &rhs)                    = default;
-    virtual ~sparse_grid()                                          = default;
-    sparse_grid<EL_TYPE> operator=(sparse_grid<EL_TYPE> const &rhs) = default;
-
     /**
-     * @brief Set the element value at coorinates (x, y).
+     * @brief Find the value stored for a key.
      *
-     * @param x X-position
-     * @param y Y-position
-     * @param value the new value
+     * @param k the key
+     *
+     * @return pointer to the value, or nullptr if there is none
      */
-    void set(size_t const x, size_t const y, const EL_TYPE &value)
+    EL_TYPE const *find(key_type k) const
     {
-        auto autoGrowX = this->util::gridBase<EL_TYPE>::isAutoGrowX();
-        auto autoGrowY = this->util::gridBase<EL_TYPE>::isAutoGrowY();
-
-        if ((x < dims_.x() || autoGrowX) && (y < dims_.y() || autoGrowY))
-        {
-            index_pair insertIndex;
-
-            insertIndex.x() = x;
-            insertIndex.y() = y;
-
-            if (value != this->util::gridBase<EL_TYPE>::getDefaultValue())
-            {
-                data_.insert(DATA_CONTAINER::value_type(insertIndex, value));
-                updateIndexSets(x, y, IndexSetOper::Insert);
-            }
-            else // if the new value equals the default value
-            {
-                // if there is a value already there, we delete it
-                if (data_.find(insertIndex) != data_.end())
-                {
-                    data_.erase(data_.find(insertIndex));
-                    updateIndexSets(x, y, IndexSetOper::Remove);
-                }
-            }
-
-            dims_.x() = std::max(dims_.x(), x + 1);
-            dims_.y() = std::max(dims_.y(), y + 1);
-        }
-        else
-        {
-            throw grid_error("Set a value at " + toString(index_pair(x, y)) + " out of bounds" + toString(dims_) + ".");
-        }
+        size_t const slot = findSlot(k);
+        return slot == npos ? nullptr : &values_[slot];
     }
 
     /**
-     * @brief Retrieve the element at coordinates (x,y) if possible.
+     * @brief Find the slot that holds a key.
      *
-     * @param x X-position
-     * @param y Y-position
+     * @param k the key
      *
-     * @return the value at coordinates (x,y)
+     * @return the slot, or npos if the key is not present
      */
-    EL_TYPE &get(size_t const x, size_t const y)
-
+    size_t slotOf(key_type k) const
     {
-        index_pair ind(x, y);
-        auto       iter      = data_.find(ind);
-        auto       autoGrowX = this->util::gridBase<EL_TYPE>::isAutoGrowX();
-        auto       autoGrowY = this->util::gridBase<EL_TYPE>::isAutoGrowY();
-
-        if ((x < dims_.x() || autoGrowX) && (y < dims_.y() || autoGrowY))
-        {
-            if (iter == data_.end())
-            {
-                set(x, y, this->util::gridBase<EL_TYPE>::getDefaultValue());
-                iter = data_.find(index_pair(x, y));
-            }
-        }
-        else
-        {
-            throw grid_error("Get a value at " + toString(ind) + " out of bounds" + toString(dims_) + ".");
-        }
-
-        return iter->second;
+        return findSlot(k);
     }
 
     /**
-     * @brief Retrieve the element at coordinates (x,y) if possible.
+     * @brief Insert a value for a key, unless the key is already present.
+     * Inserting invalidates pointers to values, as the table may grow.
      *
-     * @param x X-position
-     * @param y Y-position
+     * @param k the key
+     * @param value the value to insert
      *
-     * @return the value at coordinates (x,y)
+     * @return pointer to the value stored for the key, and whether it has been inserted
      */
-    EL_TYPE get(size_t const x, size_t const y) const
-
+    std::pair<EL_TYPE *, bool> tryEmplace(key_type k, EL_TYPE const &value)
     {
-        index_pair findIndex(x, y);
-        auto       iter = data_.find(findIndex);
-
-        if (iter == data_.end())
+        if ((size_ + 1) * 4 > keys_.size() * 3)
         {
-            return this->util::gridBase<EL_TYPE>::getDefaultValue();
+            grow();
+        }
+        size_t slot = home(k);
+        while (keys_[slot] != emptyKey)
+        {
+            if (keys_[slot] == k)
+            {
+                return {&values_[slot], false};
+            }
+            slot = (slot + 1) & mask_;
         }
+        keys_[slot]   = k;
+        values_[slot] = value;
+        size_++;
 
-        return iter->second;
+        return {&values_[slot], true};
     }
 
     /**
-     * @brief Resize the grid to new dimensions.
+     * @brief Remove the element with the given key, if any.
      *
-     * @param nNewSizeX new size in x-dimension
-     * @param nNewSizeY new size in y-dimension
+     * @param k the key
+     *
+     * @return true if an element has been removed, false otherwise
      */
-    void resize(size_t const nNewSizeX, size_t const nNewSizeY)
-
+    bool erase(key_type k)
     {
-        // if we make the scheme larger in all dimensions, then we just need
-        // to adjust the sizes
-        if (nNewSizeX >= dims_.x() && nNewSizeY >= dims_.y())
+        size_t gap = findSlot(k);
+        if (gap == npos)
         {
-            dims_.x() = nNewSizeX;
-            dims_.y() = nNewSizeY;
-
-            return;
+            return false;
         }
-        else
-        {
-            dims_.x() = nNewSizeX;
-            dims_.y() = nNewSizeY;
 
-            auto iter = data_.begin();
-
-            while (iter != data_.end())
+        // move the following elements of the probe sequence back into the gap, so that no tombstones are needed:
+        // an element can fill the gap if the gap lies between its home slot and its current slot
+        for (size_t next = (gap + 1) & mask_; keys_[next] != emptyKey; next = (next + 1) & mask_)
+        {
+            if (((next - home(keys_[next])) & mask_) >= ((next - gap) & mask_))
             {
-                if ((iter->first).x() >= dims_.x() || (iter->first).y() >= dims_.y())
-                {
-                    // delete the map element
-                    iter = data_.erase(iter);
-                }
-                else
-                {
-                    iter++;
-                }
+                keys_[gap]   = keys_[next];
+                values_[gap] = std::move(values_[next]);
+                gap          = next;
             }
         }
+        keys_[gap]   = emptyKey;
+        values_[gap] = EL_TYPE();
+        size_--;
+
+        return true;
     }
 
     /**
-     * @brief Retrieve the size in x-dimension.
-     * @return the size in x-dimension
+     * @brief Remove all elements and release the memory.
      */
-    size_t sizeX() const
+    void clear()
     {
-        return dims_.x();
+        keys_   = std::vector<key_type>();
+        values_ = std::vector<EL_TYPE>();
+        size_   = 0;
+        mask_   = 0;
+        shift_  = 64;
     }
 
+    static constexpr size_t npos = ~size_t(0); ///< slot returned for keys that are not present
+
+  private:
+    static constexpr key_type emptyKey = ~key_type(0);
+
+    std::vector<key_type> keys_;
+    std::vector<EL_TYPE>  values_;
+    size_t                size_  = 0;
+    size_t                mask_  = 0;
+    unsigned              shift_ = 64;
+
     /**
-     * @brief Retrieve the size in y-dimension.
-     * @return the size in y-dimension
+     * @brief Slot where the probe sequence of a key starts, by Fibonacci hashing, which spreads the regular keys of
+     * neighbouring cells evenly over the table.
      */
-    size_t sizeY() const
+    size_t home(key_type k) const
     {
-        return dims_.y();
+        return static_cast<size_t>((k * 0x9E3779B97F4A7C15ULL) >> shift_);
     }
 
-    /**
-     * @brief Show the grid on cout stream
-     *
-     * @param mode display mode
-     */
-    void show(typename util::gridBase<EL_TYPE>::DisplayMode mode = util::gridBase<EL_TYPE>::DisplayMode::Stats)
+    size_t findSlot(key_type k) const
     {
-        std::cout << "grid sizeX=" << sizeX() << "grid sizeY=" << sizeY() << std::endl;
-        if ((mode | util::gridBase<EL_TYPE>::DisplayMode::Stats) == util::gridBase<EL_TYPE>::DisplayMode::Stats)
+        if (size_ == 0)
         {
-            double totalValues = static_cast<double>(sizeX()) * static_cast<double>(sizeY());
-            double fillPercentage;
-
-            if (totalValues > 0.0)
+            return npos;
+        }
+        for (size_t slot = home(k);; slot = (slot + 1) & mask_)
+        {
+            if (keys_[slot] == k)
             {
-                fillPercentage = (tatic_cast<double>(data_.size()) / (totalValues)) * 100.0;
+                return slot;
             }
-            else
+            if (keys_[slot] == emptyKey)
             {
-                fillPercentage = 0.0;
+                return npos;
             }
-            std::cout << "\telements different from default value:" << fillPercentage << "%" << std::endl;
         }
+    }
 
-        auto iter = data_.begin();
-
-        if ((mode | util::gridBase<EL_TYPE>::DisplayMode::Full) == util::gridBase<EL_TYPE>::DisplayMode::Full)
+    /**
+     * @brief Double the number of slots and re-insert all elements.
+     */
+    void grow()
+    {
+        std::vector<key_type> oldKeys   = std::move(keys_);
+        std::vector<EL_TYPE>  oldValues = std::move(values_);
+        size_t const          newSize   = std::max(size_t{16}, oldKeys.size() * 2);
+
+        keys_.assign(newSize, emptyKey);
+        values_.assign(newSize, EL_TYPE());
+        mask_  = newSize - 1;
+        shift_ = 64 - static_cast<unsigned>(std::countr_zero(newSize));
+        for (size_t i = 0; i < oldKeys.size(); i++)
         {
-            index_pair runner;
+            if (oldKeys[i] != emptyKey)
+            {
+                size_t slot = home(oldKeys[i]);
+                while (keys_[slot] != emptyKey)
+                {
+                    slot = (slot + 1) & mask_;
+                }
+                keys_[slot]   = oldKeys[i];
+                values_[slot] = std::move(oldValues[i]);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Header of the binary dump of a sparse_grid.
+ *
+ * The header is followed by the cells, in no particular order, each a 64-bit key holding X in the lower and Y in the
+ * upper half, and the value, in the byte order of the writing machine.
+ */
+struct sparse_grid_file_header
+{
+    static constexpr char     magicValue[8] = {'U', 'T', 'I', 'L', 'S', 'G', 'D', '\0'};
+    static constexpr uint16_t formatVersion = 1;
+    static constexpr uint16_t byteOrderMark = 0x0102;
+
+    char          magic[8]    = {'U', 'T', 'I', 'L', 'S', 'G', 'D', '\0'};
+    uint16_t      version     = formatVersion;
+    uint16_t      byteOrder   = byteOrderMark;
+    uint16_t      elementSize = 0; ///< sizeof(EL_TYPE)
+    uint16_t      mode        = 0; ///< gridBase::Mode
+    uint64_t      sizeX       = 0;
+    uint64_t      sizeY       = 0;
+    uint64_t      cells       = 0;
+    unsigned char defaultValue[32]{};
+    char          reserved[24]{};
+};
+
+static_assert(sizeof(sparse_grid_file_header) == 96);
+static_assert(std::is_trivially_copyable_v<sparse_grid_file_header>);
+
+/**
+ * @brief Specialisation of the gridBase class that is used for sparse population
+ *
+ * Only the cells that have been set to a value different from the default value are stored, in a cell_table. Ordered
+ * views of the cells, by row and by column, are brought up to date lazily when they are iterated after the set of
+ * cells has changed: the keys of the cells added or removed since are sorted and merged into the view, which costs
+ * O(n log d) for d changes to n cells, so that interleaving set() with iteration stays cheap. Only after more than
+ * n / 2 changes is the whole view sorted again. As removing cells and growing the table move cells to other slots,
+ * the slots of the view are then looked up again, in O(n). Iterators are invalidated whenever a cell is added or
+ * removed, references to values whenever a cell is added. The views are brought up to date under a mutex, so const
+ * member functions may be called concurrently, as long as no thread changes the grid meanwhile.
+ *
+ * The cell table takes about 27 bytes per cell for doubles; each ordered view adds 16 bytes per cell once it has been
+ * built, the row-major one on the first iteration and the column-major one on the first column access.
+ *
+ * The number of cells in each row and column and the bounding box of the cells are counted as cells are added and
+ * removed, so that the statistics cost O(1) to retrieve.
+ *
+ * @tparam EL_TYPE element-type
+ */
+template <typename EL_TYPE = long double>
+class sparse_grid : public gridBase<EL_TYPE>
+{
+  private:
+    using CELL_TABLE    = cell_table<EL_TYPE>;
+    using key_type      = typename CELL_TABLE::key_type;
+    using ORDERED_CELLS = std::vector<std::pair<key_type, size_t>>;
+
+    /**
+     * @brief Iterator over the cells of a grid in row-major order, that dereferences to the pair of index and value.
+     */
+    template <bool isConst>
+    class cell_iterator
+    {
+        using table_type = std::conditional_t<isConst, CELL_TABLE const, CELL_TABLE>;
+
+      public:
+        using value_type        = std::pair<index_pair, std::conditional_t<isConst, EL_TYPE const &, EL_TYPE &>>;
+        using reference         = value_type;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        /**
+         * @brief Holder of a dereferenced cell, so that iter->first and iter->second work.
+         */
+        struct pointer
+        {
+            value_type cell;
+
+            value_type *operator->()
+            {
+                return &cell;
+            }
+        };
+
+        cell_iterator() = default;
+
+        cell_iterator(typename ORDERED_CELLS::const_iterator pos, table_type *table)
+            : pos_(pos)
+            , table_(table)
+        {
+        }
+
+        value_type operator*() const
+        {
+            return {index_pair(CELL_TABLE::lowerHalf(pos_->first), CELL_TABLE::upperHalf(pos_->first)),
+                    table_->valueAt(pos_->second)};
+        }
+
+        pointer operator->() const
+        {
+            return {**this};
+        }
+
+        cell_iterator &operator++()
+        {
+            ++pos_;
+            return *this;
+        }
+
+        cell_iterator operator++(int)
+        {
+            cell_iterator reval = *this;
+            ++pos_;
+            return reval;
+        }
+
+        friend bool operator==(cell_iterator const &lhs, cell_iterator const &rhs)
+        {
+            return lhs.pos_ == rhs.pos_;
+        }
+
+        friend bool operator!=(cell_iterator const &lhs, cell_iterator const &rhs)
+        {
+            return lhs.pos_ != rhs.pos_;
+        }
+
+      private:
+        typename ORDERED_CELLS::const_iterator pos_{};
+        table_type                            *table_ = nullptr;
+    };
+
+    /**
+     * @brief Iterator over the column indices of the cells in a row, or the row indices of the cells in a column.
+     */
+    class index_iterator
+    {
+      public:
+        using value_type        = size_t;
+        using reference         = size_t;
+        using pointer           = size_t const *;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        index_iterator(std::pair<key_type, size_t> const *pos = nullptr)
+            : pos_(pos)
+        {
+        }
+
+        size_t operator*() const
+        {
+            return CELL_TABLE::lowerHalf(pos_->first);
+        }
+
+        index_iterator &operator++()
+        {
+            ++pos_;
+            return *this;
+        }
+
+        index_iterator operator++(int)
+        {
+            index_iterator reval = *this;
+            ++pos_;
+            return reval;
+        }
+
+        friend bool operator==(index_iterator const &lhs, index_iterator const &rhs)
+        {
+            return lhs.pos_ == rhs.pos_;
+        }
+
+        friend bool operator!=(index_iterator const &lhs, index_iterator const &rhs)
+        {
+            return lhs.pos_ != rhs.pos_;
+        }
+
+      private:
+        std::pair<key_type, size_t> const *pos_;
+    };
+
+  public:
+    using iterator       = cell_iterator<false>;
+    using const_iterator = cell_iterator<true>;
+    using iteratorX      = index_iterator;
+    using iteratorY      = index_iterator;
+
+    /**
+     * @brief Iterator to the first cell, ordered by row, then column.
+     *
+     * @return the begin() iterator of the cells
+     */
+    iterator begin()
+    {
+        return iterator(rowOrder().begin(), &cells_);
+    }
+
+    /**
+     * @brief Just beyond the last cell.
+     *
+     * @return the end() iterator of the cells
+     */
+    iterator end()
+    {
+        return iterator(rowOrder().end(), &cells_);
+    }
+
+    /**
+     * @brief Const iterator to the first cell, ordered by row, then column.
+     *
+     * @return the begin() iterator of the cells
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(rowOrder().begin(), &cells_);
+    }
+
+    /**
+     * @brief Just beyond the last cell.
+     *
+     * @return the end() iterator of the cells
+     */
+    const_iterator end() const
+    {
+        return const_iterator(rowOrder().end(), &cells_);
+    }
+
+    /**
+     * @brief The iterator to the first logical non-default element in X-direction
+     * at row y.
+     *
+     * @param y the row index
+     *
+     * @return iterator to the first logical non-default element in X-direction
+     */
+    iteratorX beginX(size_t y)
+    {
+        return findLine(rowOrder(), y).first;
+    }
+
+    /**
+     * @brief Just beyond the end of the  logical non-default element in X-direction.
+     * @return the end() iterator in x-direction at y
+     */
+    iteratorX endX(size_t y)
+    {
+        return findLine(rowOrder(), y).second;
+    }
+
+    /**
+     * @brief Check whether the given X-dimension-iterator is valid or not
+     *
+     * @param iter the X-dimension iterator
+     * @return true, if valid, false otherwise
+     */
+    bool iteratorXValid(iteratorX iter)
+    {
+        return iter != iteratorX{nullptr};
+    }
+
+    /**
+     * @brief Check whether the given Y-dimension-iterator is valid or not
+     *
+     * @param iter the Y-dimension iterator
+     * @return true, if valid, false otherwise
+     */
+    bool iteratorYValid(iteratorY iter)
+    {
+        return iter != iteratorY{nullptr};
+    }
+
+    /**
+     * @brief The iterator to the first logical non-default element in Y-direction
+     * at column x.
+     * @param x the column index
+     * @return iterator to the first logical non-default element in X-direction
+     */
+    iteratorY beginY(size_t x)
+    {
+        return findLine(columnOrder(), x).first;
+    }
+
+    /**
+     * @brief Just beyond the end of the  logical non-default element in Y-direction.
+     * @param x the column index
+     * @return the end() iterator in y-direction at x
+     */
+    iteratorY endY(size_t x)
+    {
+        return findLine(columnOrder(), x).second;
+    }
+
+    /**
+     * @brief Default constructor.
+     *
+     * @param dimX size of X-dimension
+     * @param dimY size of Y-dimension
+     * @param defaultValue default value to return if a cell has not been set
+     * @param mode auto-grow behaviour
+     */
+    sparse_grid(
+        size_t dimX                                 = 0,
+        size_t dimY                                 = 0,
+        EL_TYPE defaultValue                        = EL_TYPE(),
+        typename util::gridBase<EL_TYPE>::Mode mode = util::gridBase<EL_TYPE>::Mode::AutoGrow
+    )
+        : util::gridBase<EL_TYPE>(defaultValue)
+        , dims_(dimX, dimY)
+    {
+        this->setMode(mode);
+    }
+
+    sparse_grid(sparse_grid<EL_TYPE> const &rhs)                    = default;
+    virtual ~sparse_grid()                                          = default;
+    sparse_grid<EL_TYPE> &operator=(sparse_grid<EL_TYPE> const &rhs) = default;
+
+    /**
+     * @brief Set the element value at coorinates (x, y).
+     *
+     * @param x X-position
+     * @param y Y-position
+     * @param value the new value
+     */
+    void set(size_t const x, size_t const y, const EL_TYPE &value)
+    {
+        auto autoGrowX = this->util::gridBase<EL_TYPE>::isAutoGrowX();
+        auto autoGrowY = this->util::gridBase<EL_TYPE>::isAutoGrowY();
+
+        if ((x < dims_.x() || autoGrowX) && (y < dims_.y() || autoGrowY))
+        {
+            assertStorable(x, y);
+            key_type const k = CELL_TABLE::key(x, y);
+
+            if (value != this->util::gridBase<EL_TYPE>::getDefaultValue())
+            {
+                auto [stored, inserted] = insertCell(k, value);
+                if (!inserted)
+                {
+                    *stored = value;
+                }
+            }
+            else // if there is a value already there, we delete it
+            {
+                eraseCell(k);
+            }
+
+            dims_.x() = std::max(dims_.x(), x + 1);
+            dims_.y() = std::max(dims_.y(), y + 1);
+        }
+        else
+        {
+            throw grid_error("Set a value at " + toString(index_pair(x, y)) + " out of bounds" + toString(dims_) + ".");
+        }
+    }
+
+    /**
+     * @brief Retrieve the element at coordinates (x,y) if possible.
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the value at coordinates (x,y)
+     */
+    EL_TYPE &get(size_t const x, size_t const y)
+
+    {
+        auto autoGrowX = this->util::gridBase<EL_TYPE>::isAutoGrowX();
+        auto autoGrowY = this->util::gridBase<EL_TYPE>::isAutoGrowY();
+
+        if ((x < dims_.x() || autoGrowX) && (y < dims_.y() || autoGrowY))
+        {
+            if (EL_TYPE *stored = x < dims_.x() && y < dims_.y() ? cells_.find(CELL_TABLE::key(x, y)) : nullptr)
+            {
+                return *stored;
+            }
+            createDataEntry(x, y);
+        }
+        else
+        {
+            throw grid_error("Get a value at " + toString(index_pair(x, y)) + " out of bounds" + toString(dims_) + ".");
+        }
+
+        return *cells_.find(CELL_TABLE::key(x, y));
+    }
+
+    /**
+     * @brief Retrieve the element at coordinates (x,y) if possible.
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the value at coordinates (x,y)
+     */
+    EL_TYPE get(size_t const x, size_t const y) const
+
+    {
+        EL_TYPE const *stored = x < dims_.x() && y < dims_.y() ? cells_.find(CELL_TABLE::key(x, y)) : nullptr;
+
+        if (stored == nullptr)
+        {
+            return this->util::gridBase<EL_TYPE>::getDefaultValue();
+        }
+
+        return *stored;
+    }
+
+    /**
+     * @brief Resize the grid to new dimensions.
+     *
+     * @param nNewSizeX new size in x-dimension
+     * @param nNewSizeY new size in y-dimension
+     */
+    void resize(size_t const nNewSizeX, size_t const nNewSizeY)
+
+    {
+        // if we make the scheme larger in all dimensions, then we just need
+        // to adjust the sizes
+        if (nNewSizeX >= dims_.x() && nNewSizeY >= dims_.y())
+        {
+            dims_.x() = nNewSizeX;
+            dims_.y() = nNewSizeY;
+
+            return;
+        }
+        else
+        {
+            dims_.x() = nNewSizeX;
+            dims_.y() = nNewSizeY;
+
+            std::vector<key_type> outside;
+            for (size_t slot = 0; slot < cells_.capacity(); slot++)
+            {
+                if (cells_.occupied(slot))
+                {
+                    key_type const k = cells_.keyAt(slot);
+                    if (CELL_TABLE::lowerHalf(k) >= dims_.x() || CELL_TABLE::upperHalf(k) >= dims_.y())
+                    {
+                        outside.push_back(k);
+                    }
+                }
+            }
+            for (auto const k : outside)
+            {
+                eraseCell(k);
+            }
+        }
+    }
+
+    /**
+     * @brief Retrieve the size in x-dimension.
+     * @return the size in x-dimension
+     */
+    size_t sizeX() const
+    {
+        return dims_.x();
+    }
+
+    /**
+     * @brief Retrieve the size in y-dimension.
+     * @return the size in y-dimension
+     */
+    size_t sizeY() const
+    {
+        return dims_.y();
+    }
+
+    /**
+     * @brief Retrieve the number of cells that are stored, the cells that have been set to a non-default value.
+     * @return the number of stored cells
+     */
+    size_t size() const
+    {
+        return cells_.size();
+    }
+
+    /**
+     * @brief Retrieve the number of bytes allocated for the cells and the ordered views of them.
+     * @return the number of bytes
+     */
+    size_t memoryUsage() const
+    {
+        std::lock_guard<std::mutex> lock(viewMutex_.mtx);
+        return cells_.memoryUsage() + rowCells_.memoryUsage() + colCells_.memoryUsage() +
+               (rowOrder_.cells.capacity() + colOrder_.cells.capacity()) * sizeof(typename ORDERED_CELLS::value_type) +
+               (rowOrder_.changed.capacity() + colOrder_.changed.capacity()) * sizeof(key_type);
+    }
+
+    /**
+     * @brief Retrieve the number of rows that have cells.
+     * @return the number of occupied rows
+     */
+    size_t rowsOccupied() const
+    {
+        return rowCells_.size();
+    }
+
+    /**
+     * @brief Retrieve the number of columns that have cells.
+     * @return the number of occupied columns
+     */
+    size_t columnsOccupied() const
+    {
+        return colCells_.size();
+    }
+
+    /**
+     * @brief Retrieve the number of cells in row y.
+     *
+     * @param y the row index
+     *
+     * @return the number of cells
+     */
+    size_t cellsInRow(size_t const y) const
+    {
+        size_t const *count = y < CELL_TABLE::coordinateLimit ? rowCells_.find(y) : nullptr;
+
+        return count == nullptr ? 0 : *count;
+    }
+
+    /**
+     * @brief Retrieve the number of cells in column x.
+     *
+     * @param x the column index
+     *
+     * @return the number of cells
+     */
+    size_t cellsInColumn(size_t const x) const
+    {
+        size_t const *count = x < CELL_TABLE::coordinateLimit ? colCells_.find(x) : nullptr;
+
+        return count == nullptr ? 0 : *count;
+    }
+
+    /**
+     * @brief Retrieve the smallest rectangle that contains all cells. Costs O(1), except after the last cell of a
+     * boundary row or column has been removed, when the box is found again from the occupied rows and columns.
+     *
+     * @return the top-left corner and the corner just beyond the bottom-right cell; (0, 0) and (0, 0) if there are
+     * no cells
+     */
+    std::pair<index_pair, index_pair> boundingBox() const
+    {
+        if (cells_.size() == 0)
+        {
+            return {index_pair(0, 0), index_pair(0, 0)};
+        }
+        std::lock_guard<std::mutex> lock(viewMutex_.mtx);
+        if (!boundsValid_)
+        {
+            boundsBegin_ = index_pair(CELL_TABLE::coordinateLimit, CELL_TABLE::coordinateLimit);
+            boundsEnd_   = index_pair(0, 0);
+            for (size_t slot = 0; slot < rowCells_.capacity(); slot++)
+            {
+                if (rowCells_.occupied(slot))
+                {
+                    boundsBegin_.y() = std::min<size_t>(boundsBegin_.y(), rowCells_.keyAt(slot));
+                    boundsEnd_.y()   = std::max<size_t>(boundsEnd_.y(), rowCells_.keyAt(slot) + 1);
+                }
+            }
+            for (size_t slot = 0; slot < colCells_.capacity(); slot++)
+            {
+                if (colCells_.occupied(slot))
+                {
+                    boundsBegin_.x() = std::min<size_t>(boundsBegin_.x(), colCells_.keyAt(slot));
+                    boundsEnd_.x()   = std::max<size_t>(boundsEnd_.x(), colCells_.keyAt(slot) + 1);
+                }
+            }
+            boundsValid_ = true;
+        }
+
+        return {boundsBegin_, boundsEnd_};
+    }
+
+    /**
+     * @brief Show the grid on cout stream
+     *
+     * @param mode display mode
+     */
+    void show(typename util::gridBase<EL_TYPE>::DisplayMode mode = util::gridBase<EL_TYPE>::DisplayMode::Stats)
+    {
+        show(std::cout, mode);
+    }
+
+    /**
+     * @brief Write the grid to a stream, element by element, without building it as a string first.
+     *
+     * @param os the output stream
+     * @param mode display mode
+     */
+    void show(std::ostream &os, typename util::gridBase<EL_TYPE>::DisplayMode mode) const
+    {
+        os << "grid sizeX=" << sizeX() << "grid sizeY=" << sizeY() << std::endl;
+        if (util::gridBase<EL_TYPE>::hasFlag(mode, util::gridBase<EL_TYPE>::DisplayMode::Stats))
+        {
+            double totalValues = static_cast<double>(sizeX()) * static_cast<double>(sizeY());
+            double fillPercentage;
+
+            if (totalValues > 0.0)
+            {
+                fillPercentage = (static_cast<double>(cells_.size()) / (totalValues)) * 100.0;
+            }
+            else
+            {
+                fillPercentage = 0.0;
+            }
+            auto const [boxBegin, boxEnd] = boundingBox();
+            os << "\telements different from default value:" << fillPercentage << "%" << std::endl;
+            os << "\tcells:" << cells_.size() << " rows:" << rowsOccupied() << " columns:" << columnsOccupied()
+               << " bounding box:" << boxBegin << "-" << boxEnd << std::endl;
+        }
+
+        // the sorted row view is only materialised when the cells are actually listed
+        if (util::gridBase<EL_TYPE>::hasFlag(mode, util::gridBase<EL_TYPE>::DisplayMode::Full))
+        {
+            auto       iter = this->begin();
+            index_pair runner;
             index_pair start(0, 0);
             index_pair end;
 
             // display all elements and the gaps between them
-            while (iter != data_.end())
+            while (iter != this->end())
             {
                 // end point (of the gap)
                 end = iter->first;
@@ -729,14 +1426,14 @@ class sparse_grid : public gridBase<EL_TYPE>
                     // before end
                     for (runner = start; runner != end && runner.isWithinBounds(dims_); runner.increment(dims_))
                     {
-                        std::cout << this->util::gridBase<EL_TYPE>::getDefaultValue();
+                        os << this->util::gridBase<EL_TYPE>::getDefaultValue();
                         if (runner.x() == dims_.x() - 1)
                         {
-                            std::cout << std::endl;
+                            os << std::endl;
                         }
                         else
                         {
-                            std::cout << ",";
+                            os << ",";
                         }
                     }
 
@@ -744,15 +1441,15 @@ class sparse_grid : public gridBase<EL_TYPE>
                     start.increment(dims_);
                 }
 
-                std::cout << iter->second;
+                os << iter->second;
 
                 if ((iter->first).x() == dims_.x() - 1)
                 {
-                    std::cout << std::endl;
+                    os << std::endl;
                 }
                 else
                 {
-                    std::cout << ",";
+                    os << ",";
                 }
 
                 iter++;
@@ -761,41 +1458,42 @@ class sparse_grid : public gridBase<EL_TYPE>
             // now write the remaining fields
             for (runner = start; runner.isWithinBounds(dims_); runner.increment(dims_))
             {
-                std::cout << this->util::gridBase<EL_TYPE>::getDefaultValue();
+                os << this->util::gridBase<EL_TYPE>::getDefaultValue();
                 if (runner.x() == dims_.x() - 1)
                 {
-                    std::cout << std::endl;
+                    os << std::endl;
                 }
                 else
                 {
-                    std::cout << ",";
+                    os << ",";
                 }
             }
         }
-        else if ((mode | util::gridBase<EL_TYPE>::DisplayMode::Sparse) == util::gridBase<EL_TYPE>::DisplayMode::Sparse)
+        else if (util::gridBase<EL_TYPE>::hasFlag(mode, util::gridBase<EL_TYPE>::DisplayMode::Sparse))
         {
+            auto   iter = this->begin();
             size_t line = 0;
 
-            if (iter != data_.end())
+            if (iter != this->end())
             {
-                std::cout << "line [" << (iter->first).y() << "]\t";
+                os << "line [" << (iter->first).y() << "]\t";
                 line = (iter->first).y();
             }
 
-            while (iter != data_.end())
+            while (iter != this->end())
             {
                 if (line != (iter->first).y())
                 {
-                    std::cout << std::endl;
+                    os << std::endl;
                     line = (iter->first).y();
-                    std::cout << "line [" << line << "]\t";
+                    os << "line [" << line << "]\t";
                 }
 
-                std::cout << "[" << (iter->first).x() << "]" << iter->second << " ";
+                os << "[" << (iter->first).x() << "]" << iter->second << " ";
                 iter++;
             }
 
-            std::cout << std::endl;
+            os << std::endl;
         }
 
         /*
@@ -840,14 +1538,102 @@ class sparse_grid : public gridBase<EL_TYPE>
          */
     }
 
+    /**
+     * @brief Write a binary dump of the grid to a stream: a sparse_grid_file_header followed by the cells, streamed
+     * straight from the cell table.
+     *
+     * @param os the output stream, opened in binary mode
+     *
+     * @throw grid_file_error if the stream fails
+     */
+    void writeBinary(std::ostream &os) const
+    {
+        static_assert(std::is_trivially_copyable_v<EL_TYPE>, "cells are dumped as raw bytes");
+        static_assert(sizeof(EL_TYPE) <= sizeof(sparse_grid_file_header::defaultValue));
+
+        sparse_grid_file_header header;
+        EL_TYPE const           defaultValue = this->util::gridBase<EL_TYPE>::getDefaultValue();
+        header.elementSize                   = sizeof(EL_TYPE);
+        header.mode                          = static_cast<uint16_t>(this->getMode());
+        header.sizeX                         = dims_.x();
+        header.sizeY                         = dims_.y();
+        header.cells                         = cells_.size();
+        std::memcpy(header.defaultValue, &defaultValue, sizeof(EL_TYPE));
+        os.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        for (size_t slot = 0; slot < cells_.capacity(); slot++)
+        {
+            if (cells_.occupied(slot))
+            {
+                key_type const k = cells_.keyAt(slot);
+                os.write(reinterpret_cast<char const *>(&k), sizeof(k));
+                os.write(reinterpret_cast<char const *>(&cells_.valueAt(slot)), sizeof(EL_TYPE));
+            }
+        }
+        if (!os)
+        {
+            throw grid_file_error("sparse_grid::writeBinary(): failed to write grid to stream.");
+        }
+    }
+
+    /**
+     * @brief Read a grid written by writeBinary() from a stream.
+     *
+     * @param is the input stream, opened in binary mode
+     *
+     * @return the grid
+     * @throw grid_file_error if the stream does not hold a sparse_grid of this element type
+     */
+    static sparse_grid readBinary(std::istream &is)
+    {
+        static_assert(std::is_trivially_copyable_v<EL_TYPE>, "cells are dumped as raw bytes");
+
+        sparse_grid_file_header header;
+        is.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!is || std::memcmp(header.magic, sparse_grid_file_header::magicValue, sizeof(header.magic)) != 0)
+        {
+            throw grid_file_error("sparse_grid::readBinary(): not a sparse grid dump.");
+        }
+        if (header.version != sparse_grid_file_header::formatVersion ||
+            header.byteOrder != sparse_grid_file_header::byteOrderMark || header.elementSize != sizeof(EL_TYPE))
+        {
+            throw grid_file_error("sparse_grid::readBinary(): unsupported format, byte order or element type.");
+        }
+
+        EL_TYPE defaultValue;
+        std::memcpy(&defaultValue, header.defaultValue, sizeof(EL_TYPE));
+        sparse_grid reval(
+            header.sizeX,
+            header.sizeY,
+            defaultValue,
+            static_cast<typename util::gridBase<EL_TYPE>::Mode>(header.mode)
+        );
+        for (uint64_t i = 0; i < header.cells; i++)
+        {
+            key_type k;
+            EL_TYPE  value;
+            is.read(reinterpret_cast<char *>(&k), sizeof(k));
+            is.read(reinterpret_cast<char *>(&value), sizeof(EL_TYPE));
+            // keys must address a storable cell inside the grid, the unstorable halves double as the empty key
+            size_t const x = CELL_TABLE::lowerHalf(k);
+            size_t const y = CELL_TABLE::upperHalf(k);
+            if (!is || x >= CELL_TABLE::coordinateLimit || y >= CELL_TABLE::coordinateLimit || x >= header.sizeX ||
+                y >= header.sizeY || !reval.insertCell(k, value).second)
+            {
+                throw grid_file_error("sparse_grid::readBinary(): the dump is truncated or inconsistent.");
+            }
+        }
+
+        return reval;
+    }
+
     /**
      * @brief Clear the grid and set all values to the same value.
      * @param value the new value
      */
     void setAll(const EL_TYPE &value)
     {
-        setDefaultValue(value);
-        data_.clear();
+        this->setDefaultValue(value);
+        clearCells();
     }
 
     /**
@@ -889,43 +1675,175 @@ class sparse_grid : public gridBase<EL_TYPE>
     }
 
     /**
-     * @brief Insert or remove indices.
+     * @brief Apply a function to all elements in place: to the cells that are set and to the default value. Cells
+     * whose new value equals the new default value are removed. The function is called concurrently when run in
+     * parallel.
      *
-     * @param x X-position
-     * @param y Y-position
-     * @param operationMode Insert or Remove
+     * @param f function mapping the value of an element to its new value
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold cells
      */
-    void updateIndexSets(size_t x, size_t y, IndexSetOper operationMode)
+    template <typename F>
+    void transform(F f, exec_policy policy = exec_policy::automatic)
     {
-        if (operationMode == IndexSetOper::Insert)
+        auto transformSlots = [this, &f](size_t lo, size_t hi)
         {
-            INDEXSET setToInsert;
-
-            if (xIndices_.find(y) == xIndices_.end())
+            for (size_t slot = lo; slot < hi; slot++)
             {
-                xIndices_.insert(INDEXSETMAP::value_type(y, setToInsert));
+                if (cells_.occupied(slot))
+                {
+                    cells_.valueAt(slot) = f(cells_.valueAt(slot));
+                }
             }
+        };
 
-            ((xIndices_.find(y))->second).insert(x);
+        if (use_parallel(policy, cells_.size(), util::gridBase<EL_TYPE>::parallelThreshold))
+        {
+            parallel_for(0, cells_.capacity(), transformSlots);
+        }
+        else
+        {
+            transformSlots(0, cells_.capacity());
+        }
+        this->setDefaultValue(f(this->util::gridBase<EL_TYPE>::getDefaultValue()));
+        eraseDefaultCells();
+    }
 
-            if (yIndices_.find(x) == yIndices_.end())
+    /**
+     * @brief Calculate a grid from the neighbourhoods of all elements. Only the elements within the radius of a cell
+     * that is set are evaluated: all others have a neighbourhood of default values, the value of which becomes the
+     * default value of the result. The function is called concurrently when run in parallel.
+     *
+     * @param radius the neighbourhood of an element reaches radius elements in each direction
+     * @param f function mapping the grid_neighbourhood of an element to the element of the result
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold neighbours read
+     *
+     * @return the resulting grid, of the same size and mode
+     */
+    template <typename F>
+    sparse_grid stencil(size_t const radius, F f, exec_policy policy = exec_policy::automatic) const
+    {
+        size_t const         width = 2 * radius + 1;
+        std::vector<EL_TYPE> defaults(width * width, this->util::gridBase<EL_TYPE>::getDefaultValue());
+        sparse_grid          reval(
+            dims_.x(),
+            dims_.y(),
+            f(grid_neighbourhood<EL_TYPE>(defaults.data() + radius * width + radius, std::ptrdiff_t(width))),
+            this->getMode()
+        );
+
+        // the elements that have a cell that is set in their neighbourhood
+        cell_table<char>      marked;
+        std::vector<key_type> candidates;
+        for (size_t slot = 0; slot < cells_.capacity(); slot++)
+        {
+            if (cells_.occupied(slot))
             {
-                yIndices_.insert(INDEXSETMAP::value_type(x, setToInsert));
+                size_t const x = CELL_TABLE::lowerHalf(cells_.keyAt(slot));
+                size_t const y = CELL_TABLE::upperHalf(cells_.keyAt(slot));
+                for (size_t ny = y > radius ? y - radius : 0; ny <= std::min(y + radius, dims_.y() - 1); ny++)
+                {
+                    for (size_t nx = x > radius ? x - radius : 0; nx <= std::min(x + radius, dims_.x() - 1); nx++)
+                    {
+                        if (marked.tryEmplace(CELL_TABLE::key(nx, ny), 1).second)
+                        {
+                            candidates.push_back(CELL_TABLE::key(nx, ny));
+                        }
+                    }
+                }
             }
-
-            ((yIndices_.find(x))->second).insert(y);
         }
-        else if (operationMode == IndexSetOper::Remove)
-        {
-            if (xIndices_.find(y) != xIndices_.end())
+
+        size_t const numThreads =
+            use_parallel(policy, candidates.size() * width * width, util::gridBase<EL_TYPE>::parallelThreshold)
+                ? parallel_thread_count()
+                : 1;
+        std::vector<std::vector<std::pair<key_type, EL_TYPE>>> results(numThreads);
+        EL_TYPE const                                          resultDefault = reval.getDefaultValue();
+        run_on_threads(
+            numThreads,
+            [&](size_t t, size_t n)
             {
-                xIndices_.erase(xIndices_.find(y));
+                std::vector<EL_TYPE> window(width * width);
+                for (size_t i = candidates.size() * t / n; i < candidates.size() * (t + 1) / n; i++)
+                {
+                    // coordinates left of or above the grid wrap around and read as the default value, too
+                    size_t const x = CELL_TABLE::lowerHalf(candidates[i]) - radius;
+                    size_t const y = CELL_TABLE::upperHalf(candidates[i]) - radius;
+                    for (size_t dy = 0; dy < width; dy++)
+                    {
+                        for (size_t dx = 0; dx < width; dx++)
+                        {
+                            window[dy * width + dx] = get(x + dx, y + dy);
+                        }
+                    }
+                    EL_TYPE value =
+                        f(grid_neighbourhood<EL_TYPE>(window.data() + radius * width + radius, std::ptrdiff_t(width)));
+                    if (!(value == resultDefault))
+                    {
+                        results[t].emplace_back(candidates[i], std::move(value));
+                    }
+                }
             }
-            if (xIndices_.find(y) != yIndices_.end())
+        );
+
+        for (auto const &threadResults : results)
+        {
+            for (auto const &[k, value] : threadResults)
             {
-                yIndices_.erase(yIndices_.find(x));
+                reval.insertCell(k, value);
             }
         }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the sums of the neighbourhoods of all elements, weighted by a kernel: element (x, y) of the
+     * result is the sum of kernel(i, j) * this(x + i - r, y + j - r), where r is the radius of the kernel.
+     *
+     * @param kernel square grid of weights of odd size 2 * r + 1
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @return the resulting grid, of the same size and mode
+     * @throw grid_error if the kernel is not square or its size is even
+     */
+    sparse_grid applyKernel(gridBase<EL_TYPE> const &kernel, exec_policy policy = exec_policy::automatic) const
+    {
+        auto const [weights, radius] = grid_detail::kernelWeights(kernel);
+
+        return stencil(radius, grid_detail::weightedSum(weights, radius), policy);
+    }
+
+    /**
+     * @brief Fold the cells that are set in each row, from left to right. The operation is called concurrently for
+     * different rows when run in parallel.
+     *
+     * @param init initial value of the fold, and the result for rows without cells
+     * @param op function combining the value accumulated so far with the value of a cell into the new accumulation
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold cells
+     *
+     * @return one value per row
+     */
+    template <typename R, typename Op>
+    std::vector<R> reduceRows(R const &init, Op op, exec_policy policy = exec_policy::automatic) const
+    {
+        return reduceLines(rowOrder(), dims_.y(), init, op, policy);
+    }
+
+    /**
+     * @brief Fold the cells that are set in each column, from top to bottom. The operation is called concurrently
+     * for different columns when run in parallel.
+     *
+     * @param init initial value of the fold, and the result for columns without cells
+     * @param op function combining the value accumulated so far with the value of a cell into the new accumulation
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold cells
+     *
+     * @return one value per column
+     */
+    template <typename R, typename Op>
+    std::vector<R> reduceColumns(R const &init, Op op, exec_policy policy = exec_policy::automatic) const
+    {
+        return reduceLines(columnOrder(), dims_.x(), init, op, policy);
     }
 
     /**
@@ -936,97 +1854,425 @@ class sparse_grid : public gridBase<EL_TYPE>
      */
     void indexSetInfo(size_t x, size_t y)
     {
-        auto iterX = xIndices_.find(y);
-        auto iterY = yIndices_.find(x);
-
-        std::cout << "m_xIndices=" << xIndices_.size() << " m_yIndices=" << yIndices_.size() << std::endl;
+        std::cout << "m_xIndices=" << rowsOccupied() << " m_yIndices=" << columnsOccupied() << std::endl;
 
-        if (iterX == xIndices_.end())
+        if (beginX(y) == endX(y))
         {
             std::cout << "==== row " << y << " not found,";
         }
         else
         {
-            std::cout << (iterX->second).size() << " x-Indices attached to row " << y << std::endl;
+            std::cout << std::distance(beginX(y), endX(y)) << " x-Indices attached to row " << y << std::endl;
+
+            for (auto ix = beginX(y); ix != endX(y); ix++)
+            {
+                std::cout << *ix << ",";
+            }
+            std::cout << std::endl;
+        }
 
-            auto iy = (iterX->second).begin();
+        if (beginY(x) == endY(x))
+        {
+            std::cout << " line " << x << " not found,";
+        }
+        else
+        {
+            std::cout << std::distance(beginY(x), endY(x)) << " y-Indices attached to row " << x << std::endl;
 
-            while (iy != (iterX->second).end())
+            for (auto iy = beginY(x); iy != endY(x); iy++)
             {
                 std::cout << *iy << ",";
-                iy++;
             }
+
             std::cout << std::endl;
         }
 
-        if (iterY == yIndices_.end())
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Create a data-entry at (x, y).
+     *
+     * @param x X-position
+     * @param y Y-position
+     */
+    void createDataEntry(size_t const x, size_t const y)
+    {
+        if ((x < dims_.x() && y < dims_.y()) || this->util::gridBase<EL_TYPE>::isAutoGrow())
         {
-            std::cout << " line " << x << " not found,";
+            assertStorable(x, y);
+            insertCell(CELL_TABLE::key(x, y), this->util::gridBase<EL_TYPE>::getDefaultValue());
+            dims_.x() = std::max(dims_.x(), x + 1);
+            dims_.y() = std::max(dims_.y(), y + 1);
         }
         else
         {
-            std::cout << (iterY->second).size() << " y-Indices attached to row " << x << std::endl;
+            throw grid_error("Set a value at " + toString(index_pair(x, y)) + " out of bounds" + toString(dims_) + ".");
+        }
+    }
+
+  private:
+    /**
+     * @brief A sorted view of the cells and the changes that have not been merged into it yet.
+     */
+    struct ordered_view
+    {
+        ORDERED_CELLS         cells;              ///< keys, transposed for the column-major order, and slots
+        std::vector<key_type> changed;            ///< keys of the cells added or removed since the last update
+        bool                  slotsMoved = false; ///< cells may have moved to other slots since the last update
+        bool                  rebuild    = false; ///< too many changes to merge, sort all cells again
+    };
+
+    /**
+     * @brief Guards the lazily updated members against concurrent const access. A copy gets a mutex of its own, so
+     * that the grid stays copyable.
+     */
+    struct view_mutex
+    {
+        std::mutex mtx;
+
+        view_mutex() = default;
+
+        view_mutex(view_mutex const &)
+        {
+        }
+
+        view_mutex &operator=(view_mutex const &)
+        {
+            return *this;
+        }
+    };
+
+    index_pair            dims_;
+    CELL_TABLE            cells_;
+    mutable ordered_view  rowOrder_;
+    mutable ordered_view  colOrder_;
+    cell_table<size_t>    rowCells_;            ///< number of cells in each occupied row, keyed by row
+    cell_table<size_t>    colCells_;            ///< number of cells in each occupied column, keyed by column
+    mutable index_pair    boundsBegin_{0, 0};
+    mutable index_pair    boundsEnd_{0, 0};
+    mutable bool          boundsValid_ = true;
+    mutable view_mutex    viewMutex_;
+
+    /**
+     * @brief Throw a grid_error if a cell cannot be stored, because a coordinate does not fit into a key.
+     */
+    static void assertStorable(size_t x, size_t y)
+    {
+        if (x >= CELL_TABLE::coordinateLimit || y >= CELL_TABLE::coordinateLimit)
+        {
+            throw grid_error("Coordinates " + toString(index_pair(x, y)) + " too large for a sparse_grid.");
+        }
+    }
+
+    /**
+     * @brief Record in the ordered views that the cell at a key has been added or removed.
+     *
+     * @param k the key of the cell
+     * @param slotsMoved whether other cells may have moved to other slots
+     */
+    void recordChange(key_type const k, bool const slotsMoved)
+    {
+        for (ordered_view *view : {&rowOrder_, &colOrder_})
+        {
+            if (view->rebuild)
+            {
+                continue;
+            }
+            if (view->changed.size() > cells_.size() / 2)
+            {
+                view->rebuild = true;
+                view->changed.clear();
+            }
+            else
+            {
+                view->changed.push_back(k);
+                view->slotsMoved = view->slotsMoved || slotsMoved;
+            }
+        }
+    }
+
+    /**
+     * @brief Add a cell if there is none at its key, and count it.
+     *
+     * @return the stored value and whether the cell has been added
+     */
+    std::pair<EL_TYPE *, bool> insertCell(key_type const k, EL_TYPE const &value)
+    {
+        size_t const capacity = cells_.capacity();
+        auto const   reval    = cells_.tryEmplace(k, value);
+        if (reval.second)
+        {
+            size_t const x = CELL_TABLE::lowerHalf(k);
+            size_t const y = CELL_TABLE::upperHalf(k);
+            ++*rowCells_.tryEmplace(y, 0).first;
+            ++*colCells_.tryEmplace(x, 0).first;
+            if (cells_.size() == 1)
+            {
+                boundsBegin_ = index_pair(x, y);
+                boundsEnd_   = index_pair(x + 1, y + 1);
+                boundsValid_ = true;
+            }
+            else if (boundsValid_)
+            {
+                boundsBegin_ = index_pair(std::min(boundsBegin_.x(), x), std::min(boundsBegin_.y(), y));
+                boundsEnd_   = index_pair(std::max(boundsEnd_.x(), x + 1), std::max(boundsEnd_.y(), y + 1));
+            }
+            recordChange(k, cells_.capacity() != capacity);
+        }
+        else if (cells_.capacity() != capacity)
+        {
+            // the table may grow even if the key is present already
+            rowOrder_.slotsMoved = true;
+            colOrder_.slotsMoved = true;
+        }
+        return reval;
+    }
+
+    /**
+     * @brief Remove the cell at a key, if there is one, and stop counting it.
+     *
+     * @return true if a cell has been removed
+     */
+    bool eraseCell(key_type const k)
+    {
+        if (!cells_.erase(k))
+        {
+            return false;
+        }
+
+        size_t const x = CELL_TABLE::lowerHalf(k);
+        size_t const y = CELL_TABLE::upperHalf(k);
+        if (uncount(rowCells_, y) && (y == boundsBegin_.y() || y + 1 == boundsEnd_.y()))
+        {
+            boundsValid_ = false;
+        }
+        if (uncount(colCells_, x) && (x == boundsBegin_.x() || x + 1 == boundsEnd_.x()))
+        {
+            boundsValid_ = false;
+        }
+        recordChange(k, true);
+
+        return true;
+    }
+
+    /**
+     * @brief Remove all cells and reset the counters.
+     */
+    void clearCells()
+    {
+        cells_.clear();
+        rowCells_.clear();
+        colCells_.clear();
+        boundsBegin_ = index_pair(0, 0);
+        boundsEnd_   = index_pair(0, 0);
+        boundsValid_ = true;
+        rowOrder_    = ordered_view();
+        colOrder_    = ordered_view();
+    }
+
+    /**
+     * @brief Decrement the number of cells of a row or column, removing it when it has no cells left.
+     *
+     * @return true if the line has no cells left
+     */
+    static bool uncount(cell_table<size_t> &lineCells, size_t const line)
+    {
+        size_t *count = lineCells.find(line);
+        if (--*count == 0)
+        {
+            lineCells.erase(line);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Sort the keys and slots of all cells, transposed for the column-major order.
+     */
+    void buildOrder(ORDERED_CELLS &order, bool transposed) const
+    {
+        order.clear();
+        order.reserve(cells_.size());
+        for (size_t slot = 0; slot < cells_.capacity(); slot++)
+        {
+            if (cells_.occupied(slot))
+            {
+                key_type const k = cells_.keyAt(slot);
+                order.emplace_back(transposed ? CELL_TABLE::transposed(k) : k, slot);
+            }
+        }
+        std::sort(order.begin(), order.end());
+    }
+
+    /**
+     * @brief Bring an ordered view up to date: merge the cells added since the last update into it, drop the removed
+     * ones, and look the slots up again if cells have moved.
+     */
+    ORDERED_CELLS const &updateOrder(ordered_view &view, bool transposed) const
+    {
+        if (view.rebuild)
+        {
+            buildOrder(view.cells, transposed);
+            view.changed.clear();
+            view.rebuild    = false;
+            view.slotsMoved = false;
+            return view.cells;
+        }
+
+        auto const cellKey = [transposed](key_type k) { return transposed ? CELL_TABLE::transposed(k) : k; };
+        if (!view.changed.empty())
+        {
+            // only the net effect of the changes counts: every changed key is dropped and re-added if still present
+            std::vector<key_type> &changed = view.changed;
+            for (auto &k : changed)
+            {
+                k = cellKey(k);
+            }
+            std::sort(changed.begin(), changed.end());
+            changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+            auto const isChanged = [&changed](typename ORDERED_CELLS::value_type const &cell)
+            { return std::binary_search(changed.begin(), changed.end(), cell.first); };
+            view.cells.erase(std::remove_if(view.cells.begin(), view.cells.end(), isChanged), view.cells.end());
+            size_t const kept = view.cells.size();
+            for (auto const k : changed)
+            {
+                size_t const slot = cells_.slotOf(cellKey(k));
+                if (slot != CELL_TABLE::npos)
+                {
+                    view.cells.emplace_back(k, slot);
+                }
+            }
+            std::inplace_merge(view.cells.begin(), view.cells.begin() + kept, view.cells.end());
+            changed.clear();
+        }
+        if (view.slotsMoved)
+        {
+            for (auto &cell : view.cells)
+            {
+                cell.second = cells_.slotOf(cellKey(cell.first));
+            }
+            view.slotsMoved = false;
+        }
+        return view.cells;
+    }
+
+    /**
+     * @brief The cells in row-major order, updated if the cells have changed.
+     */
+    ORDERED_CELLS const &rowOrder() const
+    {
+        std::lock_guard<std::mutex> lock(viewMutex_.mtx);
+        return updateOrder(rowOrder_, false);
+    }
+
+    /**
+     * @brief The cells in column-major order, updated if the cells have changed.
+     */
+    ORDERED_CELLS const &columnOrder() const
+    {
+        std::lock_guard<std::mutex> lock(viewMutex_.mtx);
+        return updateOrder(colOrder_, true);
+    }
+
+    /**
+     * @brief Find the range of cells of a row in the row-major, or a column in the column-major order.
+     *
+     * @return the range, or a pair of invalid iterators if the line has no cells
+     */
+    static std::pair<index_iterator, index_iterator> findLine(ORDERED_CELLS const &order, size_t line)
+    {
+        auto const keyLess = [](typename ORDERED_CELLS::value_type const &cell, key_type k) { return cell.first < k; };
+        auto const first   = std::lower_bound(order.begin(), order.end(), CELL_TABLE::key(0, line), keyLess);
+        if (first == order.end() || CELL_TABLE::upperHalf(first->first) != line)
+        {
+            return {index_iterator{nullptr}, index_iterator{nullptr}};
+        }
+        auto const last = std::lower_bound(first, order.end(), CELL_TABLE::key(0, line + 1), keyLess);
 
-            auto ix = (iterY->second).begin();
+        return {index_iterator{&*first}, index_iterator{order.data() + (last - order.begin())}};
+    }
 
-            while (ix != (iterY->second).end())
+    /**
+     * @brief Remove the cells that hold the default value.
+     */
+    void eraseDefaultCells()
+    {
+        EL_TYPE const         defaultValue = this->util::gridBase<EL_TYPE>::getDefaultValue();
+        std::vector<key_type> erased;
+        for (size_t slot = 0; slot < cells_.capacity(); slot++)
+        {
+            if (cells_.occupied(slot) && cells_.valueAt(slot) == defaultValue)
             {
-                std::cout << *ix << ",";
-                ix++;
+                erased.push_back(cells_.keyAt(slot));
             }
-
-            std::cout << std::endl;
         }
-
-        std::cout << std::endl;
+        for (auto const k : erased)
+        {
+            eraseCell(k);
+        }
     }
 
     /**
-     * @brief Create a data-entry at (x, y).
-     *
-     * @param x X-position
-     * @param y Y-position
+     * @brief Fold the cells of each row in the row-major, or each column in the column-major order.
      */
-    void createDataEntry(size_t const x, size_t const y)
+    template <typename R, typename Op>
+    std::vector<R> reduceLines(ORDERED_CELLS const &order, size_t lines, R const &init, Op &op, exec_policy policy)
+        const
     {
-        if ((x < dims_.x() && y < dims_.y()) || this->util::gridBase<EL_TYPE>::isAutoGrow())
+        std::vector<R> reval(lines, init);
+        auto           reduce = [this, &order, &reval, &op](size_t lo, size_t hi)
         {
-            index_pair insertPoint;
+            auto const keyLess = [](typename ORDERED_CELLS::value_type const &cell, key_type k)
+            {
+                return cell.first < k;
+            };
+            for (auto cell = std::lower_bound(order.begin(), order.end(), CELL_TABLE::key(0, lo), keyLess);
+                 cell != order.end() && CELL_TABLE::upperHalf(cell->first) < hi;
+                 ++cell)
+            {
+                R &accumulated = reval[CELL_TABLE::upperHalf(cell->first)];
+                accumulated    = op(std::move(accumulated), cells_.valueAt(cell->second));
+            }
+        };
 
-            insertPoint.x() = x;
-            insertPoint.y() = y;
-            data_.insert(DATA_CONTAINER::value_type(insertPoint, this->util::gridBase<EL_TYPE>::getDefaultValue()));
-            updateIndexSets(x, y, IndexSetOper::Insert);
-            dims_.x() = std::max(dims_.x(), x + 1);
-            dims_.y() = std::max(dims_.y(), y + 1);
+        if (use_parallel(policy, order.size(), util::gridBase<EL_TYPE>::parallelThreshold))
+        {
+            parallel_for(0, lines, reduce);
         }
         else
         {
-            throw grid_error("Set a value at " + toString(index_pair(x, y)) + " out of bounds" + toString(dims_) + ".");
+            reduce(0, lines);
         }
-    }
 
-  private:
-    index_pair     dims_;
-    DATA_CONTAINER data_;
-    INDEXSETMAP    xIndices_;
-    INDEXSETMAP    yIndices_;
+        return reval;
+    }
 };
 
 /**
  * @brief Specialisation of the gridBase class that expexts to be non-sparsely populated
  *
+ * The elements are stored row by row in a single buffer, rows padded to the capacity in X-dimension. The capacity
+ * grows geometrically in both dimensions and the elements outside the grid hold the default value, so that growing
+ * within the capacity costs nothing and a grid that auto-grows one cell at a time is re-allocated only a logarithmic
+ * number of times. setAll, fill and copy work on contiguous rows. References to elements are invalidated when the
+ * grid grows beyond its capacity.
+ *
  * @tparam EL_TYPE element-type
  */
 template <typename EL_TYPE = long double>
 class grid : public gridBase<EL_TYPE>
 {
   private:
-    using EL_VECT   = std::vector<EL_TYPE>;
-    using EL_MATRIX = std::vector<EL_VECT>;
+    using EL_VECT = std::vector<EL_TYPE>;
 
     // variables
-    EL_MATRIX values_;
+    EL_VECT values_;
+    size_t  sizeX_     = 0;
+    size_t  sizeY_     = 0;
+    size_t  capacityX_ = 0;
+    size_t  capacityY_ = 0;
+    EL_TYPE outsideValue_;
 
   public:
     /**
@@ -1034,28 +2280,20 @@ class grid : public gridBase<EL_TYPE>
      *
      * @param dimX X-dimension
      * @param dimY Y-dimension
-     * @param pDefaultValue default value to use when a data value has not been explicitly set
+     * @param defaultValue default value to use when a data value has not been explicitly set
      * @param mode mode to use for this grid
      */
     grid(
         size_t const dimX                           = 0,
         size_t const dimY                           = 0,
-        EL_TYPE *pDefaultValue                      = 0,
+        EL_TYPE defaultValue                        = EL_TYPE(),
         typename util::gridBase<EL_TYPE>::Mode mode = util::gridBase<EL_TYPE>::Mode::AutoGrow
     )
-        : gridBase<EL_TYPE>()
+        : gridBase<EL_TYPE>(defaultValue)
+        , outsideValue_(defaultValue)
     {
-        setMode(mode);
-
-        if (pDefaultValue != NULL)
-        {
-            setDefaultValue(*pDefaultValue);
-        }
-
-        for (size_t iIndexX = 0; iIndexX < dimX; iIndexX++)
-        {
-            values_.push_back(vector<EL_TYPE>(dimY));
-        }
+        this->setMode(mode);
+        resize(dimX, dimY);
     }
 
     grid(grid<EL_TYPE> const &rhs)                     = default;
@@ -1069,28 +2307,55 @@ class grid : public gridBase<EL_TYPE>
      */
     size_t sizeX() const
     {
-        return values_.size();
+        return sizeX_;
     }
 
     /**
      * @brief Retrieve the (current) size of the grid in Y-dimension.
      *
-     * @return the size; if size in X dimension is 0, then size in Y-dimension is automatically also 0.
+     * @return the size
      */
     size_t sizeY() const
     {
-        if (values_.size())
-        {
-            return values_[0].size();
-        }
-        else
+        return sizeY_;
+    }
+
+    /**
+     * @brief Retrieve the size in X-dimension the grid can grow to without re-allocation.
+     *
+     * @return the capacity in X-dimension
+     */
+    size_t capacityX() const
+    {
+        return capacityX_;
+    }
+
+    /**
+     * @brief Retrieve the size in Y-dimension the grid can grow to without re-allocation.
+     *
+     * @return the capacity in Y-dimension
+     */
+    size_t capacityY() const
+    {
+        return capacityY_;
+    }
+
+    /**
+     * @brief Make room for a grid of the given dimensions, without changing the size.
+     *
+     * @param capacityX the capacity in X-dimension
+     * @param capacityY the capacity in Y-dimension
+     */
+    void reserve(size_t const capacityX, size_t const capacityY)
+    {
+        if (capacityX > capacityX_ || capacityY > capacityY_)
         {
-            return 0;
+            reallocate(std::max(capacityX, capacityX_), std::max(capacityY, capacityY_));
         }
     }
 
     /**
-     * @brief Resize the grid no new dimensions.
+     * @brief Resize the grid no new dimensions. Elements that become part of the grid are set to the default value.
      *
      * @param newX new X-dimension
      * @param newY new Y-dimension
@@ -1098,25 +2363,71 @@ class grid : public gridBase<EL_TYPE>
     void resize(size_t const newX, size_t const newY)
 
     {
-        values_.resize(newX);
+        EL_TYPE const defaultValue = this->util::gridBase<EL_TYPE>::getDefaultValue();
+        if (!(outsideValue_ == defaultValue))
+        {
+            // the default value has changed since the elements outside the grid have been set
+            outsideValue_ = defaultValue;
+            for (size_t y = 0; y < capacityY_; y++)
+            {
+                size_t const from = y < sizeY_ ? sizeX_ : 0;
+                std::fill(values_.begin() + index(from, y), values_.begin() + index(0, y + 1), defaultValue);
+            }
+        }
+
+        // elements that drop out of the grid get the default value
+        if (newX < sizeX_ || newY < sizeY_)
+        {
+            for (size_t y = 0; y < sizeY_; y++)
+            {
+                size_t const from = y < newY ? std::min(newX, sizeX_) : 0;
+                std::fill(values_.begin() + index(from, y), values_.begin() + index(sizeX_, y), defaultValue);
+            }
+        }
 
-        for (size_t x = 0; x < newX; x++)
+        if (newX > capacityX_ || newY > capacityY_)
         {
-            values_[x].resize(newY);
+            reallocate(
+                newX > capacityX_ ? std::max(newX, 2 * capacityX_) : capacityX_,
+                newY > capacityY_ ? std::max(newY, 2 * capacityY_) : capacityY_
+            );
         }
+        sizeX_ = newX;
+        sizeY_ = newY;
     }
 
     /**
-     * @brief Retrieve the element at position (x, y).
+     * @brief Retrieve the element at position (x, y), growing the grid if it is out of bounds and the mode allows.
      *
      * @param x X-position
      * @param y Y-position
      *
      * @return the element
+     * @throw grid_error if (x, y) is out of bounds and the grid cannot grow
      */
     EL_TYPE &get(size_t const x, size_t const y)
     {
-        return (values_[x])[y];
+        growToInclude(x, y, "Get");
+
+        return values_[index(x, y)];
+    }
+
+    /**
+     * @brief Retrieve the element at position (x, y).
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the element, or the default value if (x, y) is out of bounds
+     */
+    EL_TYPE get(size_t const x, size_t const y) const
+    {
+        if (x >= sizeX_ || y >= sizeY_)
+        {
+            return this->util::gridBase<EL_TYPE>::getDefaultValue();
+        }
+
+        return values_[index(x, y)];
     }
 
     /**
@@ -1126,54 +2437,300 @@ class grid : public gridBase<EL_TYPE>
      */
     void setAll(const EL_TYPE &value)
     {
-        for (size_t x = 0; x < sizeY(); x++)
+        fill(value, 0, 0, sizeX_, sizeY_);
+    }
+
+    /**
+     * @brief Set all elements of a rectangle to the same value.
+     *
+     * @param value the new value
+     * @param x X-position of the upper left corner of the rectangle
+     * @param y Y-position of the upper left corner of the rectangle
+     * @param dimX X-dimension of the rectangle
+     * @param dimY Y-dimension of the rectangle
+     *
+     * @throw grid_error if the rectangle is not within the bounds of the grid
+     */
+    void fill(const EL_TYPE &value, size_t const x, size_t const y, size_t const dimX, size_t const dimY)
+    {
+        assertWithinBounds(x, y, dimX, dimY, "Fill");
+
+        if (dimX == capacityX_)
+        {
+            // rows without padding form a single contiguous range
+            std::fill_n(values_.begin() + index(0, y), dimX * dimY, value);
+        }
+        else
         {
-            for (size_t y = 0; y < sizeX(); y++)
+            for (size_t row = y; row < y + dimY; row++)
             {
-                set(x, y, value);
+                std::fill_n(values_.begin() + index(x, row), dimX, value);
             }
         }
     }
 
     /**
-     * @brief Set a new value for element (x, y).
+     * @brief Copy a rectangle of elements from a grid, which can be this grid, into this grid. The grid grows to
+     * include the target rectangle, if the mode allows.
      *
-     * @param x X-position
-     * @param y Y-position
-     * @param value the value to set
+     * @param source the grid to copy from
+     * @param fromX X-position of the upper left corner of the source rectangle
+     * @param fromY Y-position of the upper left corner of the source rectangle
+     * @param dimX X-dimension of the rectangle
+     * @param dimY Y-dimension of the rectangle
+     * @param toX X-position of the upper left corner of the target rectangle
+     * @param toY Y-position of the upper left corner of the target rectangle
+     *
+     * @throw grid_error if the source rectangle is not within the bounds of the source grid, or the target rectangle
+     * is out of bounds and this grid cannot grow
      */
-    void set(size_t const x, size_t const y, const EL_TYPE &value)
+    void copy(
+        grid<EL_TYPE> const &source,
+        size_t const         fromX,
+        size_t const         fromY,
+        size_t const         dimX,
+        size_t const         dimY,
+        size_t const         toX,
+        size_t const         toY
+    )
     {
-        if (x >= sizeX() || y >= sizeY())
+        source.assertWithinBounds(fromX, fromY, dimX, dimY, "Copy");
+        if (dimX == 0 || dimY == 0)
+        {
+            return;
+        }
+        growToInclude(toX + dimX - 1, toY + dimY - 1, "Copy");
+
+        // rows and the elements within a row are copied in the order that does not overwrite the rows and elements
+        // of the source that are yet to be copied, if source and target overlap
+        bool const overlapping = &source == this;
+        for (size_t i = 0; i < dimY; i++)
         {
-            if (this->util::gridBase<EL_TYPE>::isAutoGrow())
+            size_t const   row  = overlapping && toY > fromY ? dimY - 1 - i : i;
+            EL_TYPE const *from = source.values_.data() + source.index(fromX, fromY + row);
+            EL_TYPE       *to   = values_.data() + index(toX, toY + row);
+            if (!overlapping || to < from)
             {
-                resize(std::max(x + 1, sizeX()), std::max(y + 1, sizeY()));
+                std::copy(from, from + dimX, to);
+            }
+            else
+            {
+                std::copy_backward(from, from + dimX, to + dimX);
             }
         }
+    }
 
-        ((values_[x])[y]) = value;
+    /**
+     * @brief Apply a function to all elements in place. The function is called concurrently when run in parallel.
+     *
+     * @param f function mapping the value of an element to its new value
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     */
+    template <typename F>
+    void transform(F f, exec_policy policy = exec_policy::automatic)
+    {
+        forRowBlocks(
+            policy,
+            sizeX_ * sizeY_,
+            [this, &f](size_t y0, size_t y1)
+            {
+                for (size_t y = y0; y < y1; y++)
+                {
+                    EL_TYPE *row = values_.data() + index(0, y);
+                    for (size_t x = 0; x < sizeX_; x++)
+                    {
+                        row[x] = f(row[x]);
+                    }
+                }
+            }
+        );
     }
 
     /**
-     * @brief Retrieve a reference to the element at position (x, y).
+     * @brief Calculate a grid from the neighbourhoods of all elements. Neighbours outside the grid read as the default
+     * value. The function is called concurrently when run in parallel.
      *
-     * @param x X-position
-     * @param y Y-position
+     * The rows are processed in bands, each copied together with the rows above and below it that its neighbourhoods
+     * reach into a buffer padded with the default value, so that no neighbour needs a bounds check. A band is
+     * traversed in tiles of columns, so that the rows read for a tile stay in the cache.
      *
-     * @return the element
+     * @param radius the neighbourhood of an element reaches radius elements in each direction
+     * @param f function mapping the grid_neighbourhood of an element to the element of the result
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold neighbours read
+     *
+     * @return the resulting grid, of the same size, default value and mode
      */
-    EL_TYPE &operator()(size_t const x, size_t const y = 0)
+    template <typename F>
+    grid stencil(size_t const radius, F f, exec_policy policy = exec_policy::automatic) const
     {
-        if (x >= sizeX() || y >= sizeY())
+        EL_TYPE const defaultValue = this->util::gridBase<EL_TYPE>::getDefaultValue();
+        size_t const  width        = 2 * radius + 1;
+        size_t const  paddedX      = sizeX_ + 2 * radius;
+        grid          reval(sizeX_, sizeY_, defaultValue, this->getMode());
+
+        forRowBlocks(
+            policy,
+            sizeX_ * sizeY_ * width * width,
+            [&](size_t y0, size_t y1)
+            {
+                std::vector<EL_TYPE> band((stencilBandRows + 2 * radius) * paddedX);
+                for (size_t b0 = y0; b0 < y1; b0 += stencilBandRows)
+                {
+                    size_t const b1 = std::min(b0 + stencilBandRows, y1);
+                    for (size_t row = 0; row < b1 - b0 + 2 * radius; row++)
+                    {
+                        EL_TYPE     *to = band.data() + row * paddedX;
+                        size_t const y  = b0 + row - radius;
+                        if (b0 + row < radius || y >= sizeY_)
+                        {
+                            std::fill_n(to, paddedX, defaultValue);
+                        }
+                        else
+                        {
+                            std::fill_n(to, radius, defaultValue);
+                            std::copy_n(values_.data() + index(0, y), sizeX_, to + radius);
+                            std::fill_n(to + radius + sizeX_, radius, defaultValue);
+                        }
+                    }
+
+                    for (size_t x0 = 0; x0 < sizeX_; x0 += stencilTileColumns)
+                    {
+                        size_t const x1 = std::min(x0 + stencilTileColumns, sizeX_);
+                        for (size_t y = b0; y < b1; y++)
+                        {
+                            EL_TYPE const *centre = band.data() + (y - b0 + radius) * paddedX + radius;
+                            EL_TYPE       *out    = reval.values_.data() + reval.index(0, y);
+                            for (size_t x = x0; x < x1; x++)
+                            {
+                                out[x] = f(grid_neighbourhood<EL_TYPE>(centre + x, std::ptrdiff_t(paddedX)));
+                            }
+                        }
+                    }
+                }
+            }
+        );
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the sums of the neighbourhoods of all elements, weighted by a kernel: element (x, y) of the
+     * result is the sum of kernel(i, j) * this(x + i - r, y + j - r), where r is the radius of the kernel.
+     *
+     * @param kernel square grid of weights of odd size 2 * r + 1
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @return the resulting grid, of the same size, default value and mode
+     * @throw grid_error if the kernel is not square or its size is even
+     */
+    grid applyKernel(gridBase<EL_TYPE> const &kernel, exec_policy policy = exec_policy::automatic) const
+    {
+        auto const [weights, radius] = grid_detail::kernelWeights(kernel);
+
+        return stencil(radius, grid_detail::weightedSum(weights, radius), policy);
+    }
+
+    /**
+     * @brief Fold the elements of each row, from left to right. The operation is called concurrently for different
+     * rows when run in parallel.
+     *
+     * @param init initial value of the fold
+     * @param op function combining the value accumulated so far with an element into the new accumulation
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     *
+     * @return one value per row
+     */
+    template <typename R, typename Op>
+    std::vector<R> reduceRows(R const &init, Op op, exec_policy policy = exec_policy::automatic) const
+    {
+        std::vector<R> reval(sizeY_, init);
+        forRowBlocks(
+            policy,
+            sizeX_ * sizeY_,
+            [this, &reval, &op](size_t y0, size_t y1)
+            {
+                for (size_t y = y0; y < y1; y++)
+                {
+                    EL_TYPE const *row = values_.data() + index(0, y);
+                    for (size_t x = 0; x < sizeX_; x++)
+                    {
+                        reval[y] = op(std::move(reval[y]), row[x]);
+                    }
+                }
+            }
+        );
+
+        return reval;
+    }
+
+    /**
+     * @brief Fold the elements of each column, from top to bottom. The columns are split between the threads, each
+     * of which folds its columns row by row, reading the elements in the order they are stored in. The operation is
+     * called concurrently for different columns when run in parallel.
+     *
+     * @param init initial value of the fold
+     * @param op function combining the value accumulated so far with an element into the new accumulation
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     *
+     * @return one value per column
+     */
+    template <typename R, typename Op>
+    std::vector<R> reduceColumns(R const &init, Op op, exec_policy policy = exec_policy::automatic) const
+    {
+        std::vector<R> reval(sizeX_, init);
+        auto           reduce = [this, &reval, &op](size_t x0, size_t x1)
         {
-            if (this->util::gridBase<EL_TYPE>::isAutoGrow())
+            for (size_t y = 0; y < sizeY_; y++)
             {
-                resize(std::max(x + 1, sizeX()), std::max(y + 1, sizeY()));
+                EL_TYPE const *row = values_.data() + index(0, y);
+                for (size_t x = x0; x < x1; x++)
+                {
+                    reval[x] = op(std::move(reval[x]), row[x]);
+                }
             }
+        };
+
+        if (use_parallel(policy, sizeX_ * sizeY_, util::gridBase<EL_TYPE>::parallelThreshold))
+        {
+            parallel_for(0, sizeX_, reduce);
+        }
+        else
+        {
+            reduce(0, sizeX_);
         }
 
-        return (values_[x])[y];
+        return reval;
+    }
+
+    /**
+     * @brief Set a new value for element (x, y), growing the grid if it is out of bounds and the mode allows.
+     *
+     * @param x X-position
+     * @param y Y-position
+     * @param value the value to set
+     *
+     * @throw grid_error if (x, y) is out of bounds and the grid cannot grow
+     */
+    void set(size_t const x, size_t const y, const EL_TYPE &value)
+    {
+        growToInclude(x, y, "Set");
+
+        values_[index(x, y)] = value;
+    }
+
+    /**
+     * @brief Retrieve a reference to the element at position (x, y), growing the grid if it is out of bounds and the
+     * mode allows.
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the element
+     * @throw grid_error if (x, y) is out of bounds and the grid cannot grow
+     */
+    EL_TYPE &operator()(size_t const x, size_t const y = 0)
+    {
+        return get(x, y);
     }
 
     /**
@@ -1183,17 +2740,19 @@ class grid : public gridBase<EL_TYPE>
      * @param y Y-position
      *
      * @return the element
+     * @throw grid_error if (x, y) is out of bounds
      */
     EL_TYPE operator()(size_t const x, size_t const y = 0) const
     {
-        if (x >= sizeX() || y >= sizeY())
+        if (x >= sizeX_ || y >= sizeY_)
         {
             throw grid_error(
-                "Get a value at " + toString(index_pair(x, y)) + " out of bounds [" + sizeX() + "," + sizeY() + "]."
+                "Get a value at " + toString(index_pair(x, y)) + " out of bounds" +
+                toString(index_pair(sizeX_, sizeY_)) + "."
             );
         }
 
-        return (values_[x])[y];
+        return values_[index(x, y)];
     }
 
     /**
@@ -1210,7 +2769,7 @@ class grid : public gridBase<EL_TYPE>
         {
             for (size_t x = 0; x < sizeX(); x++)
             {
-                std::cout << get(x, y) << "\t";
+                std::cout << values_[index(x, y)] << "\t";
             }
 
             std::cout << std::endl;
@@ -1218,6 +2777,105 @@ class grid : public gridBase<EL_TYPE>
 
         std::cout << "\n---\n" << std::endl;
     }
+
+  private:
+    static constexpr size_t stencilBandRows    = 32;
+    static constexpr size_t stencilTileColumns = 512;
+
+    /**
+     * @brief Run a function on blocks of rows, in parallel if the policy and the amount of work ask for it.
+     */
+    template <typename F>
+    void forRowBlocks(exec_policy policy, size_t work, F &&f) const
+    {
+        if (use_parallel(policy, work, util::gridBase<EL_TYPE>::parallelThreshold))
+        {
+            parallel_for(0, sizeY_, f);
+        }
+        else
+        {
+            f(0, sizeY_);
+        }
+    }
+
+    /**
+     * @brief Position of element (x, y) in the buffer.
+     */
+    size_t index(size_t const x, size_t const y) const
+    {
+        return y * capacityX_ + x;
+    }
+
+    /**
+     * @brief Move the elements into a buffer with new capacities, which are not smaller than the current ones.
+     */
+    void reallocate(size_t const newCapacityX, size_t const newCapacityY)
+    {
+        if (newCapacityX == capacityX_)
+        {
+            // the rows keep their positions, the buffer gets longer
+            values_.resize(newCapacityX * newCapacityY, outsideValue_);
+        }
+        else
+        {
+            EL_VECT newValues(newCapacityX * newCapacityY, outsideValue_);
+            for (size_t y = 0; y < sizeY_; y++)
+            {
+                std::move(
+                    values_.begin() + index(0, y),
+                    values_.begin() + index(sizeX_, y),
+                    newValues.begin() + y * newCapacityX
+                );
+            }
+            values_.swap(newValues);
+        }
+        capacityX_ = newCapacityX;
+        capacityY_ = newCapacityY;
+    }
+
+    /**
+     * @brief Grow the grid, if necessary, so that (x, y) is within its bounds.
+     *
+     * @throw grid_error if (x, y) is out of bounds and the mode does not allow to grow
+     */
+    void growToInclude(size_t const x, size_t const y, char const *operation)
+    {
+        if (x >= sizeX_ || y >= sizeY_)
+        {
+            if ((x < sizeX_ || this->util::gridBase<EL_TYPE>::isAutoGrowX()) &&
+                (y < sizeY_ || this->util::gridBase<EL_TYPE>::isAutoGrowY()))
+            {
+                resize(std::max(x + 1, sizeX_), std::max(y + 1, sizeY_));
+            }
+            else
+            {
+                throw grid_error(
+                    std::string(operation) + " a value at " + toString(index_pair(x, y)) + " out of bounds" +
+                    toString(index_pair(sizeX_, sizeY_)) + "."
+                );
+            }
+        }
+    }
+
+    /**
+     * @brief Throw a grid_error unless a rectangle is within the bounds of the grid.
+     */
+    void assertWithinBounds(
+        size_t const x,
+        size_t const y,
+        size_t const dimX,
+        size_t const dimY,
+        char const  *operation
+    ) const
+    {
+        if (x + dimX > sizeX_ || y + dimY > sizeY_)
+        {
+            throw grid_error(
+                std::string(operation) + " a rectangle of " + toString(index_pair(dimX, dimY)) + " at " +
+                toString(index_pair(x, y)) + " out of bounds" + toString(index_pair(sizeX_, sizeY_)) + "."
+            );
+        }
+    }
 };
 
 }; // namespace util
@@ -27,24 +27,41 @@
 #define NS_UTIL_HEAP_H_INCLUDED
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace util
 {
 /**
- * @brief a heap implementation
+ * @brief an iterative d-ary heap implementation
+ *
+ * Sifting moves a "hole" through the tree instead of swapping elements at every level, so each level costs a single
+ * move. With an arity of 4 the children of a node of 4- or 8-byte elements share one cache line, which makes the
+ * heap considerably faster than the binary layout for large queues.
  *
  * @tparam T_ element type
  * @tparam Compare comparison function type, by default comparison is std::greater, which results in a min-heap
+ * @tparam Arity_ number of children per node, one of 2, 4 or 8
  */
-template <typename T_, typename Compare = std::greater<T_>>
+template <typename T_, typename Compare = std::greater<T_>, size_t Arity_ = 2UL>
 class heap
 {
-    std::vector<T_> arr_;
-    size_t          last_ = 0UL;
+    static_assert(Arity_ == 2UL || Arity_ == 4UL || Arity_ == 8UL, "heap arity must be one of 2, 4 or 8");
+
+    std::vector<T_>               arr_;
+    [[no_unique_address]] Compare comp_{};
 
     /**
      * @brief Retrieve the index of the parent of the given index
@@ -54,73 +71,171 @@ class heap
      */
     static size_t parentOf_(size_t const idx)
     {
-        return idx > 0UL ? ((idx - 1) / 2UL) : 0UL;
+        return idx > 0UL ? ((idx - 1) / Arity_) : 0UL;
+    }
+
+    /**
+     * @brief Retrieve the index of the first child of the given index
+     *
+     * @param idx the parent whose first child to look for
+     * @return size_t the first child, which may be out of range
+     */
+    static size_t firstChildOf_(size_t const idx)
+    {
+        return idx * Arity_ + 1UL;
     }
 
     /**
-     * @brief Recursive bubble up function
+     * @brief Iterative bubble up function
      *
      * @param nodeIdx index of the node to bubble up
      */
     void bubbleUp_(size_t nodeIdx)
     {
-        if (nodeIdx != 0UL)
+        T_ value = std::move(arr_[nodeIdx]);
+        while (nodeIdx != 0UL)
         {
             size_t parentIdx = parentOf_(nodeIdx);
-            if (Compare()(arr_[parentIdx], arr_[nodeIdx]))
+            if (!comp_(arr_[parentIdx], value))
             {
-                std::swap(arr_[parentIdx], arr_[nodeIdx]);
-                bubbleUp_(parentIdx);
+                break;
             }
+            arr_[nodeIdx] = std::move(arr_[parentIdx]);
+            nodeIdx       = parentIdx;
         }
+        arr_[nodeIdx] = std::move(value);
     }
 
     /**
-     * @brief Recursive bubble down function
+     * @brief Iterative bubble down function
      *
      * @param nodeIdx index of the node to bubble down
      */
-    void bubbleDown_(size_t nodeIndex)
+    void bubbleDown_(size_t nodeIdx)
     {
-        size_t minIdx;
-        size_t leftIdx  = nodeIndex * 2 + 1;
-        size_t rightIdx = nodeIndex * 2 + 2;
-
-        if (rightIdx >= last_)
+        size_t const last  = arr_.size();
+        T_           value = std::move(arr_[nodeIdx]);
+        for (size_t childIdx = firstChildOf_(nodeIdx); childIdx < last; childIdx = firstChildOf_(nodeIdx))
         {
-            if (leftIdx >= last_)
+            size_t const endIdx  = std::min(childIdx + Arity_, last);
+            size_t       bestIdx = childIdx;
+            for (++childIdx; childIdx < endIdx; ++childIdx)
             {
-                return;
+                bestIdx = comp_(arr_[bestIdx], arr_[childIdx]) ? childIdx : bestIdx;
             }
-            else
+            if (!comp_(value, arr_[bestIdx]))
             {
-                minIdx = leftIdx;
+                break;
             }
+            arr_[nodeIdx] = std::move(arr_[bestIdx]);
+            nodeIdx       = bestIdx;
         }
-        else
+        arr_[nodeIdx] = std::move(value);
+    }
+
+    /**
+     * @brief Establish the heap property over the whole array bottom-up (Floyd's method) in O(n).
+     */
+    void heapify_()
+    {
+        if (arr_.size() < 2UL)
         {
-            if (!Compare()(arr_[leftIdx], arr_[rightIdx]))
-            {
-                minIdx = leftIdx;
-            }
-            else
-            {
-                minIdx = rightIdx;
-            }
+            return;
         }
-
-        if (Compare()(arr_[nodeIndex], arr_[minIdx]))
+        for (size_t nodeIdx = parentOf_(arr_.size() - 1) + 1UL; nodeIdx-- > 0UL;)
         {
-            std::swap(arr_[minIdx], arr_[nodeIndex]);
-            bubbleDown_(minIdx);
+            bubbleDown_(nodeIdx);
         }
     }
 
   public:
     heap()                = default;
     heap(heap const &rhs) = default;
+    heap(heap &&rhs)      = default;
     virtual ~heap()       = default;
 
+    heap &operator=(heap const &rhs) = default;
+    heap &operator=(heap &&rhs)      = default;
+
+    /**
+     * @brief Construct an empty heap with a stateful comparison object.
+     *
+     * @param comp the comparison object
+     */
+    explicit heap(Compare const &comp)
+        : comp_(comp)
+    {
+    }
+
+    /**
+     * @brief Construct a heap from a range of elements in O(n).
+     *
+     * @tparam InputIt_ input iterator type
+     * @param first begin of the range
+     * @param last end of the range
+     * @param comp the comparison object
+     */
+    template <std::input_iterator InputIt_>
+    heap(InputIt_ first, InputIt_ last, Compare const &comp = Compare())
+        : arr_(first, last)
+        , comp_(comp)
+    {
+        heapify_();
+    }
+
+    /**
+     * @brief Replace the content of the heap with a range of elements in O(n).
+     *
+     * @tparam InputIt_ input iterator type
+     * @param first begin of the range
+     * @param last end of the range
+     */
+    template <std::input_iterator InputIt_>
+    void assign(InputIt_ first, InputIt_ last)
+    {
+        arr_.assign(first, last);
+        heapify_();
+    }
+
+    /**
+     * @brief Move all elements of another heap into this one, leaving the other heap empty.
+     *
+     * Small heaps are inserted element by element, otherwise the arrays are concatenated and re-heapified in linear
+     * time, whichever is cheaper.
+     *
+     * @param rhs the heap to merge into this one
+     */
+    void merge(heap &&rhs)
+    {
+        if (&rhs == this)
+        {
+            return;
+        }
+        if (rhs.arr_.size() > arr_.size())
+        {
+            std::swap(arr_, rhs.arr_);
+        }
+        size_t const oldSize  = arr_.size();
+        size_t       logOfNew = 1UL;
+        for (size_t n = oldSize + rhs.arr_.size(); n >>= 1UL;)
+        {
+            logOfNew++;
+        }
+        arr_.insert(arr_.end(), std::make_move_iterator(rhs.arr_.begin()), std::make_move_iterator(rhs.arr_.end()));
+        if (rhs.arr_.size() * logOfNew < arr_.size())
+        {
+            for (size_t nodeIdx = oldSize; nodeIdx < arr_.size(); nodeIdx++)
+            {
+                bubbleUp_(nodeIdx);
+            }
+        }
+        else
+        {
+            heapify_();
+        }
+        rhs.arr_.clear();
+    }
+
     /**
      * @brief Get the top element
      * @return pointer to the top element, nullptr if heap is empt
@@ -134,6 +249,19 @@ class heap
         return &arr_[0];
     }
 
+    /**
+     * @brief Get the top element
+     * @return const pointer to the top element, nullptr if heap is empty
+     */
+    T_ const *top() const
+    {
+        if (empty())
+        {
+            return nullptr;
+        }
+        return &arr_[0];
+    }
+
     /**
      * @brief Function to delete the top element from the heap
      */
@@ -141,13 +269,17 @@ class heap
     {
         if (!empty())
         {
-            // Replace root with last_ element
-            arr_[0] = arr_[last_ - 1];
-
-            // Decrement size of heap
-            last_--;
-
-            bubbleDown_(0L);
+            // Replace root with last element
+            if (arr_.size() > 1UL)
+            {
+                arr_[0] = std::move(arr_.back());
+                arr_.pop_back();
+                bubbleDown_(0UL);
+            }
+            else
+            {
+                arr_.pop_back();
+            }
         }
     }
 
@@ -158,16 +290,46 @@ class heap
      */
     void insert(T_ key)
     {
-        // Increase the size of Heap by 1
-        last_++;
-        if (last_ >= arr_.size())
+        // Insert the element at end of Heap
+        arr_.push_back(std::move(key));
+        bubbleUp_(arr_.size() - 1);
+    }
+
+    /**
+     * @brief Replace the top element by a new key and restore the heap order. This is cheaper than pop() followed by
+     * insert() as the tree is only traversed once.
+     *
+     * @param key key to replace the top with
+     */
+    void replaceTop(T_ key)
+    {
+        if (empty())
         {
-            arr_.resize(last_);
+            insert(std::move(key));
+        }
+        else
+        {
+            arr_[0] = std::move(key);
+            bubbleDown_(0UL);
         }
+    }
 
-        // Insert the element at end of Heap
-        arr_[last_ - 1] = key;
-        bubbleUp_(last_ - 1);
+    /**
+     * @brief Reserve storage for at least the given number of elements.
+     *
+     * @param capacity the number of elements to reserve space for
+     */
+    void reserve(size_t capacity)
+    {
+        arr_.reserve(capacity);
+    }
+
+    /**
+     * @brief Remove all elements from the heap.
+     */
+    void clear()
+    {
+        arr_.clear();
     }
 
     /**
@@ -177,7 +339,7 @@ class heap
      */
     [[nodiscard]] size_t size() const
     {
-        return last_;
+        return arr_.size();
     }
 
     /**
@@ -188,7 +350,7 @@ class heap
      */
     T_ operator[](size_t index) const
     {
-        if (index > last_)
+        if (index >= arr_.size())
         {
             throw std::out_of_range("");
         }
@@ -203,7 +365,7 @@ class heap
      */
     [[nodiscard]] bool empty() const
     {
-        return size() == 0UL;
+        return arr_.empty();
     }
 
     /**
@@ -223,7 +385,7 @@ class heap
             if (layerCount == layerSize)
             {
                 os << " | ";
-                layerSize *= 2;
+                layerSize *= Arity_;
                 layerCount = 1;
             }
             else
@@ -368,6 +530,1060 @@ class std_heap
         return os;
     }
 };
+
+/**
+ * @brief an addressable d-ary heap
+ *
+ * Every inserted element is identified by a handle that stays valid until the element is popped or erased. The
+ * handle can be used to change the key of the element (decrease-key as well as increase-key) or to remove it from
+ * anywhere in the heap in O(log n), which avoids the lazy-deletion workaround needed with a plain heap.
+ *
+ * @tparam T_ element type
+ * @tparam Compare comparison function type, by default comparison is std::greater, which results in a min-heap
+ * @tparam Arity_ number of children per node, one of 2, 4 or 8
+ */
+template <typename T_, typename Compare = std::greater<T_>, size_t Arity_ = 4UL>
+class indexed_heap
+{
+    static_assert(Arity_ == 2UL || Arity_ == 4UL || Arity_ == 8UL, "heap arity must be one of 2, 4 or 8");
+
+  public:
+    using handle_type                 = size_t;
+    static constexpr handle_type npos = static_cast<handle_type>(-1);
+
+  private:
+    struct node
+    {
+        T_          value_;
+        handle_type handle_;
+    };
+
+    std::vector<node>             arr_;
+    std::vector<size_t>           position_;
+    std::vector<handle_type>      freeHandles_;
+    [[no_unique_address]] Compare comp_{};
+
+    /**
+     * @brief Retrieve the index of the parent of the given index.
+     */
+    static size_t parentOf_(size_t const idx)
+    {
+        return idx > 0UL ? ((idx - 1) / Arity_) : 0UL;
+    }
+
+    /**
+     * @brief Retrieve the index of the first child of the given index.
+     */
+    static size_t firstChildOf_(size_t const idx)
+    {
+        return idx * Arity_ + 1UL;
+    }
+
+    /**
+     * @brief Move a node into the given slot and record its new position.
+     */
+    void place_(size_t idx, node &&n)
+    {
+        position_[n.handle_] = idx;
+        arr_[idx]            = std::move(n);
+    }
+
+    /**
+     * @brief Iterative bubble up function.
+     *
+     * @param nodeIdx index of the node to bubble up
+     * @return true if the node moved, false otherwise
+     */
+    bool bubbleUp_(size_t nodeIdx)
+    {
+        size_t const startIdx = nodeIdx;
+        node         n        = std::move(arr_[nodeIdx]);
+        while (nodeIdx != 0UL)
+        {
+            size_t parentIdx = parentOf_(nodeIdx);
+            if (!comp_(arr_[parentIdx].value_, n.value_))
+            {
+                break;
+            }
+            place_(nodeIdx, std::move(arr_[parentIdx]));
+            nodeIdx = parentIdx;
+        }
+        place_(nodeIdx, std::move(n));
+        return nodeIdx != startIdx;
+    }
+
+    /**
+     * @brief Iterative bubble down function.
+     *
+     * @param nodeIdx index of the node to bubble down
+     */
+    void bubbleDown_(size_t nodeIdx)
+    {
+        size_t const last = arr_.size();
+        node         n    = std::move(arr_[nodeIdx]);
+        for (size_t childIdx = firstChildOf_(nodeIdx); childIdx < last; childIdx = firstChildOf_(nodeIdx))
+        {
+            size_t const endIdx  = std::min(childIdx + Arity_, last);
+            size_t       bestIdx = childIdx;
+            for (++childIdx; childIdx < endIdx; ++childIdx)
+            {
+                bestIdx = comp_(arr_[bestIdx].value_, arr_[childIdx].value_) ? childIdx : bestIdx;
+            }
+            if (!comp_(n.value_, arr_[bestIdx].value_))
+            {
+                break;
+            }
+            place_(nodeIdx, std::move(arr_[bestIdx]));
+            nodeIdx = bestIdx;
+        }
+        place_(nodeIdx, std::move(n));
+    }
+
+    /**
+     * @brief Restore the heap property for a node whose key has changed in either direction.
+     */
+    void fix_(size_t nodeIdx)
+    {
+        if (!bubbleUp_(nodeIdx))
+        {
+            bubbleDown_(nodeIdx);
+        }
+    }
+
+    /**
+     * @brief Remove the node at the given position and release its handle.
+     */
+    void removeAt_(size_t nodeIdx)
+    {
+        handle_type const handle = arr_[nodeIdx].handle_;
+        if (nodeIdx + 1UL < arr_.size())
+        {
+            place_(nodeIdx, std::move(arr_.back()));
+            arr_.pop_back();
+            fix_(nodeIdx);
+        }
+        else
+        {
+            arr_.pop_back();
+        }
+        position_[handle] = npos;
+        freeHandles_.push_back(handle);
+    }
+
+    /**
+     * @brief Retrieve the position of a handle in the heap array.
+     *
+     * @throw std::out_of_range if the handle is not valid
+     */
+    size_t positionOf_(handle_type handle) const
+    {
+        if (!contains(handle))
+        {
+            throw std::out_of_range("invalid heap handle " + std::to_string(handle));
+        }
+        return position_[handle];
+    }
+
+  public:
+    indexed_heap()                        = default;
+    indexed_heap(indexed_heap const &rhs) = default;
+    indexed_heap(indexed_heap &&rhs)      = default;
+    virtual ~indexed_heap()               = default;
+
+    indexed_heap &operator=(indexed_heap const &rhs) = default;
+    indexed_heap &operator=(indexed_heap &&rhs)      = default;
+
+    /**
+     * @brief Construct an empty heap with a stateful comparison object.
+     *
+     * @param comp the comparison object
+     */
+    explicit indexed_heap(Compare const &comp)
+        : comp_(comp)
+    {
+    }
+
+    /**
+     * @brief Get the top element
+     * @return pointer to the top element, nullptr if heap is empty
+     */
+    T_ const *top() const
+    {
+        if (empty())
+        {
+            return nullptr;
+        }
+        return &arr_[0].value_;
+    }
+
+    /**
+     * @brief Get the handle of the top element.
+     *
+     * @return handle_type the handle, npos if the heap is empty
+     */
+    [[nodiscard]] handle_type topHandle() const
+    {
+        return empty() ? npos : arr_[0].handle_;
+    }
+
+    /**
+     * @brief Function to delete the top element from the heap. The handle of the top element becomes invalid.
+     */
+    void pop()
+    {
+        if (!empty())
+        {
+            removeAt_(0UL);
+        }
+    }
+
+    /**
+     * @brief Function to insert a new node to the heap
+     *
+     * @param key key to insert
+     * @return handle_type handle by which the element can be addressed until it is removed
+     */
+    handle_type insert(T_ key)
+    {
+        handle_type handle;
+        if (freeHandles_.empty())
+        {
+            handle = position_.size();
+            position_.push_back(arr_.size());
+        }
+        else
+        {
+            handle = freeHandles_.back();
+            freeHandles_.pop_back();
+            position_[handle] = arr_.size();
+        }
+        arr_.push_back(node{std::move(key), handle});
+        bubbleUp_(arr_.size() - 1);
+        return handle;
+    }
+
+    /**
+     * @brief Change the key of an element that is already in the heap.
+     *
+     * @param handle handle of the element as returned by insert()
+     * @param newKey the new key, which may move the element towards the top or the bottom
+     * @throw std::out_of_range if the handle is not valid
+     */
+    void update(handle_type handle, T_ newKey)
+    {
+        size_t const nodeIdx = positionOf_(handle);
+        arr_[nodeIdx].value_ = std::move(newKey);
+        fix_(nodeIdx);
+    }
+
+    /**
+     * @brief Remove an element from anywhere in the heap.
+     *
+     * @param handle handle of the element as returned by insert()
+     * @throw std::out_of_range if the handle is not valid
+     */
+    void erase(handle_type handle)
+    {
+        removeAt_(positionOf_(handle));
+    }
+
+    /**
+     * @brief Check whether a handle refers to an element currently in the heap.
+     *
+     * @param handle the handle to check
+     * @return true, if it does, false otherwise
+     */
+    [[nodiscard]] bool contains(handle_type handle) const
+    {
+        return handle < position_.size() && position_[handle] != npos;
+    }
+
+    /**
+     * @brief Retrieve the key of an element by its handle.
+     *
+     * @param handle handle of the element as returned by insert()
+     * @return T_ const& the key
+     * @throw std::out_of_range if the handle is not valid
+     */
+    T_ const &operator[](handle_type handle) const
+    {
+        return arr_[positionOf_(handle)].value_;
+    }
+
+    /**
+     * @brief Reserve storage for at least the given number of elements.
+     *
+     * @param capacity the number of elements to reserve space for
+     */
+    void reserve(size_t capacity)
+    {
+        arr_.reserve(capacity);
+        position_.reserve(capacity);
+    }
+
+    /**
+     * @brief Remove all elements from the heap. All handles become invalid.
+     */
+    void clear()
+    {
+        arr_.clear();
+        position_.clear();
+        freeHandles_.clear();
+    }
+
+    /**
+     * @brief Retrieve the size of the heap
+     *
+     * @return size_t the size
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return arr_.size();
+    }
+
+    /**
+     * @brief Check whether the heap is empty
+     *
+     * @return true, if it is, false otherwise
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return arr_.empty();
+    }
+};
+
+/**
+ * @brief a mergeable pairing heap
+ *
+ * Insertion and merging of two heaps are O(1), removal of the top element is O(log n) amortised. This makes the
+ * pairing heap the container of choice when many partial queues have to be combined, for example in k-way merges.
+ *
+ * @tparam T_ element type
+ * @tparam Compare comparison function type, by default comparison is std::greater, which results in a min-heap
+ */
+template <typename T_, typename Compare = std::greater<T_>>
+class pairing_heap
+{
+    struct node
+    {
+        T_    value_;
+        node *child_   = nullptr;
+        node *sibling_ = nullptr;
+    };
+
+    node                         *root_ = nullptr;
+    size_t                        size_ = 0UL;
+    std::vector<node *>           pairs_;
+    [[no_unique_address]] Compare comp_{};
+
+    /**
+     * @brief Link two trees, the root that compares better becomes the parent of the other.
+     *
+     * @param lhs first tree, must not be nullptr
+     * @param rhs second tree, may be nullptr
+     * @return node* the root of the linked tree
+     */
+    node *link_(node *lhs, node *rhs)
+    {
+        if (rhs == nullptr)
+        {
+            return lhs;
+        }
+        if (comp_(lhs->value_, rhs->value_))
+        {
+            std::swap(lhs, rhs);
+        }
+        rhs->sibling_ = lhs->child_;
+        lhs->child_   = rhs;
+        return lhs;
+    }
+
+    /**
+     * @brief Combine a list of siblings into a single tree using the two-pass pairing strategy.
+     *
+     * @param first first sibling of the list
+     * @return node* root of the combined tree
+     */
+    node *combineSiblings_(node *first)
+    {
+        pairs_.clear();
+        while (first != nullptr)
+        {
+            node *a     = first;
+            node *b     = a->sibling_;
+            first       = b != nullptr ? b->sibling_ : nullptr;
+            a->sibling_ = nullptr;
+            if (b != nullptr)
+            {
+                b->sibling_ = nullptr;
+            }
+            pairs_.push_back(link_(a, b));
+        }
+        node *combined = nullptr;
+        for (auto it = pairs_.rbegin(); it != pairs_.rend(); ++it)
+        {
+            combined = link_(*it, combined);
+        }
+        return combined;
+    }
+
+    /**
+     * @brief Free all nodes of a tree without recursion.
+     *
+     * @param n root of the tree
+     */
+    static void destroy_(node *n)
+    {
+        while (n != nullptr)
+        {
+            // rotate children into the sibling chain so that every node is visited once
+            if (n->child_ != nullptr)
+            {
+                node *child     = n->child_;
+                n->child_       = child->sibling_;
+                child->sibling_ = n;
+                n               = child;
+            }
+            else
+            {
+                node *next = n->sibling_;
+                delete n;
+                n = next;
+            }
+        }
+    }
+
+  public:
+    pairing_heap()                                   = default;
+    pairing_heap(pairing_heap const &rhs)            = delete;
+    pairing_heap &operator=(pairing_heap const &rhs) = delete;
+
+    /**
+     * @brief Construct an empty heap with a stateful comparison object.
+     *
+     * @param comp the comparison object
+     */
+    explicit pairing_heap(Compare const &comp)
+        : comp_(comp)
+    {
+    }
+
+    pairing_heap(pairing_heap &&rhs) noexcept
+        : root_(std::exchange(rhs.root_, nullptr))
+        , size_(std::exchange(rhs.size_, 0UL))
+        , comp_(std::move(rhs.comp_))
+    {
+    }
+
+    pairing_heap &operator=(pairing_heap &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            clear();
+            root_ = std::exchange(rhs.root_, nullptr);
+            size_ = std::exchange(rhs.size_, 0UL);
+            comp_ = std::move(rhs.comp_);
+        }
+        return *this;
+    }
+
+    virtual ~pairing_heap()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Get the top element
+     * @return pointer to the top element, nullptr if heap is empty
+     */
+    T_ *top()
+    {
+        return root_ != nullptr ? &root_->value_ : nullptr;
+    }
+
+    /**
+     * @brief Function to delete the top element from the heap
+     */
+    void pop()
+    {
+        if (root_ != nullptr)
+        {
+            node *oldRoot = root_;
+            root_         = combineSiblings_(oldRoot->child_);
+            delete oldRoot;
+            size_--;
+        }
+    }
+
+    /**
+     * @brief Function to insert a new node to the heap in O(1)
+     *
+     * @param key key to insert
+     */
+    void insert(T_ key)
+    {
+        node *n = new node{std::move(key)};
+        root_   = root_ == nullptr ? n : link_(n, root_);
+        size_++;
+    }
+
+    /**
+     * @brief Move all elements of another heap into this one in O(1), leaving the other heap empty.
+     *
+     * @param rhs the heap to merge into this one
+     */
+    void merge(pairing_heap &&rhs)
+    {
+        if (this == &rhs || rhs.root_ == nullptr)
+        {
+            return;
+        }
+        root_ = root_ == nullptr ? rhs.root_ : link_(root_, rhs.root_);
+        size_     += rhs.size_;
+        rhs.root_ = nullptr;
+        rhs.size_ = 0UL;
+    }
+
+    /**
+     * @brief Remove all elements from the heap.
+     */
+    void clear()
+    {
+        destroy_(root_);
+        root_ = nullptr;
+        size_ = 0UL;
+    }
+
+    /**
+     * @brief Retrieve the size of the heap
+     *
+     * @return size_t the size
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Check whether the heap is empty
+     *
+     * @return true, if it is, false otherwise
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return root_ == nullptr;
+    }
+};
+
+/**
+ * @brief a scalable concurrent priority queue with relaxed ordering (MultiQueue)
+ *
+ * Elements are distributed over a number of independently locked sub-heaps. An insertion locks one randomly chosen
+ * sub-heap, a removal looks at the tops of two randomly chosen sub-heaps and takes the better one. Threads therefore
+ * rarely contend for the same lock, at the price that try_pop() returns an element that is close to, but not
+ * necessarily exactly, the best element in the queue. With a single sub-heap the ordering is exact.
+ *
+ * @tparam T_ element type
+ * @tparam Compare comparison function type, by default comparison is std::greater, which results in a min-heap
+ * @tparam Arity_ number of children per node of the sub-heaps, one of 2, 4 or 8
+ */
+template <typename T_, typename Compare = std::greater<T_>, size_t Arity_ = 4UL>
+class concurrent_heap
+{
+    struct alignas(64) sub_heap
+    {
+        std::mutex                mtx_;
+        heap<T_, Compare, Arity_> heap_;
+    };
+
+    std::vector<sub_heap>         subHeaps_;
+    std::atomic<size_t>           size_{0UL};
+    [[no_unique_address]] Compare comp_{};
+
+    // number of sub-heaps, or pairs of them, that are tried without blocking before waiting for a lock
+    static constexpr size_t maxLockAttempts = 8UL;
+
+    /**
+     * @brief Retrieve the index of a randomly chosen sub-heap, using a cheap per-thread xorshift generator.
+     */
+    size_t randomIndex_()
+    {
+        thread_local uint64_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1UL;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<size_t>(state % subHeaps_.size());
+    }
+
+    /**
+     * @brief Try to pop from the better of the two given sub-heaps.
+     *
+     * @param block whether to wait for the locks of the sub-heaps rather than give up if they are held
+     *
+     * @return true if the sub-heaps could be locked, in which case out is set if an element was found
+     */
+    bool tryPopFrom_(size_t first, size_t second, std::optional<T_> &out, bool block)
+    {
+        std::unique_lock<std::mutex> firstLock(subHeaps_[first].mtx_, std::defer_lock);
+        std::unique_lock<std::mutex> secondLock;
+        if (second != first)
+        {
+            secondLock = std::unique_lock<std::mutex>(subHeaps_[second].mtx_, std::defer_lock);
+        }
+        if (block)
+        {
+            if (second != first)
+            {
+                std::lock(firstLock, secondLock);
+            }
+            else
+            {
+                firstLock.lock();
+            }
+        }
+        else if (!firstLock.try_lock() || (second != first && !secondLock.try_lock()))
+        {
+            return false;
+        }
+        auto *firstTop  = subHeaps_[first].heap_.top();
+        auto *secondTop = subHeaps_[second].heap_.top();
+        if (firstTop == nullptr && secondTop == nullptr)
+        {
+            return true;
+        }
+        size_t const bestIdx =
+            firstTop == nullptr || (secondTop != nullptr && comp_(*firstTop, *secondTop)) ? second : first;
+        auto &best = subHeaps_[bestIdx].heap_;
+        out        = std::move(*best.top());
+        best.pop();
+        size_--;
+        return true;
+    }
+
+  public:
+    /**
+     * @brief Construct a concurrent heap.
+     *
+     * @param numSubHeaps number of independently locked sub-heaps, a small multiple of the number of threads that
+     *                    access the heap gives the best throughput
+     * @param comp the comparison object
+     */
+    explicit concurrent_heap(
+        size_t         numSubHeaps = 2UL * std::max(1U, std::thread::hardware_concurrency()),
+        Compare const &comp        = Compare()
+    )
+        : subHeaps_(std::max(numSubHeaps, size_t{1UL}))
+        , comp_(comp)
+    {
+    }
+
+    concurrent_heap(concurrent_heap const &rhs)            = delete;
+    concurrent_heap &operator=(concurrent_heap const &rhs) = delete;
+    virtual ~concurrent_heap()                             = default;
+
+    /**
+     * @brief Insert an element. Safe to call from any number of threads. Sub-heaps whose lock is held are skipped a
+     * limited number of times, after which the insertion waits for a lock rather than spin.
+     *
+     * @param key key to insert
+     */
+    void insert(T_ key)
+    {
+        for (size_t attempt = 0UL; attempt < maxLockAttempts; attempt++)
+        {
+            auto                        &sub = subHeaps_[randomIndex_()];
+            std::unique_lock<std::mutex> lock(sub.mtx_, std::try_to_lock);
+            if (lock.owns_lock())
+            {
+                sub.heap_.insert(std::move(key));
+                size_++;
+                return;
+            }
+        }
+        auto                       &sub = subHeaps_[randomIndex_()];
+        std::lock_guard<std::mutex> lock(sub.mtx_);
+        sub.heap_.insert(std::move(key));
+        size_++;
+    }
+
+    /**
+     * @brief Remove and return one of the best elements. Safe to call from any number of threads.
+     *
+     * @return std::optional<T_> the removed element, or an empty optional if the heap was found empty
+     */
+    std::optional<T_> try_pop()
+    {
+        std::optional<T_> reval;
+        size_t            failedAttempts = 0UL;
+        while (size_.load() > 0UL)
+        {
+            if (!tryPopFrom_(randomIndex_(), randomIndex_(), reval, failedAttempts >= maxLockAttempts))
+            {
+                // contention on the chosen sub-heaps, try another pair, waiting for the locks once too many failed
+                failedAttempts++;
+                continue;
+            }
+            if (reval)
+            {
+                return reval;
+            }
+            // the randomly chosen sub-heaps were empty: sweep all of them before giving up
+            for (auto &sub: subHeaps_)
+            {
+                std::unique_lock<std::mutex> lock(sub.mtx_);
+                if (!sub.heap_.empty())
+                {
+                    reval = std::move(*sub.heap_.top());
+                    sub.heap_.pop();
+                    size_--;
+                    return reval;
+                }
+            }
+        }
+        return reval;
+    }
+
+    /**
+     * @brief Retrieve the number of elements. Only a snapshot if other threads modify the heap concurrently.
+     *
+     * @return size_t the size
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return size_.load();
+    }
+
+    /**
+     * @brief Check whether the heap is empty. Only a snapshot if other threads modify the heap concurrently.
+     *
+     * @return true, if it is, false otherwise
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0UL;
+    }
+};
+
+/**
+ * @brief a heap that retains only the best elements up to a given capacity
+ *
+ * Internally the retained elements are kept in a heap that has the worst retained element at the top. Once the
+ * capacity is reached, an element that is not better than the worst retained one is rejected with a single
+ * comparison, otherwise it replaces the worst one in O(log k).
+ *
+ * @tparam T_ element type
+ * @tparam Compare comparison function type, compare(a, b) is true if b is better than a, by default comparison is
+ *                 std::less, which retains the largest elements
+ * @tparam Arity_ number of children per node of the internal heap, one of 2, 4 or 8
+ */
+template <typename T_, typename Compare = std::less<T_>, size_t Arity_ = 4UL>
+class bounded_heap
+{
+    /**
+     * @brief Inverted comparison that moves the worst element to the top of the internal heap.
+     */
+    struct worst_on_top
+    {
+        [[no_unique_address]] Compare comp_{};
+
+        bool operator()(T_ const &lhs, T_ const &rhs) const
+        {
+            return comp_(rhs, lhs);
+        }
+    };
+
+    heap<T_, worst_on_top, Arity_> heap_;
+    size_t                         capacity_;
+    [[no_unique_address]] Compare  comp_{};
+
+  public:
+    /**
+     * @brief Construct a bounded heap.
+     *
+     * @param capacity maximum number of elements retained
+     * @param comp the comparison object
+     */
+    explicit bounded_heap(size_t capacity, Compare const &comp = Compare())
+        : heap_(worst_on_top{comp})
+        , capacity_(capacity)
+        , comp_(comp)
+    {
+        heap_.reserve(capacity_);
+    }
+
+    bounded_heap(bounded_heap const &rhs) = default;
+    virtual ~bounded_heap()               = default;
+
+    /**
+     * @brief Offer an element to the heap.
+     *
+     * @param key key to insert
+     * @return true if the element has been retained, false if it was rejected
+     */
+    bool push(T_ key)
+    {
+        if (heap_.size() < capacity_)
+        {
+            heap_.insert(std::move(key));
+            return true;
+        }
+        if (capacity_ == 0UL || !comp_(*heap_.top(), key))
+        {
+            return false;
+        }
+        heap_.replaceTop(std::move(key));
+        return true;
+    }
+
+    /**
+     * @brief Get the worst retained element, which is the threshold that new elements need to beat once the heap is
+     * full.
+     *
+     * @return const pointer to the worst element, nullptr if heap is empty
+     */
+    T_ const *worst() const
+    {
+        return heap_.top();
+    }
+
+    /**
+     * @brief Retrieve the retained elements, best first.
+     *
+     * @return std::vector<T_> the sorted elements
+     */
+    [[nodiscard]] std::vector<T_> sorted() const
+    {
+        auto            copy = heap_;
+        std::vector<T_> reval(copy.size());
+        for (size_t i = reval.size(); i > 0UL; i--)
+        {
+            reval[i - 1] = std::move(*copy.top());
+            copy.pop();
+        }
+        return reval;
+    }
+
+    /**
+     * @brief Remove all elements from the heap.
+     */
+    void clear()
+    {
+        heap_.clear();
+    }
+
+    /**
+     * @brief Retrieve the maximum number of elements retained.
+     *
+     * @return size_t the capacity
+     */
+    [[nodiscard]] size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    /**
+     * @brief Retrieve the size of the heap
+     *
+     * @return size_t the size
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return heap_.size();
+    }
+
+    /**
+     * @brief Check whether the heap is empty
+     *
+     * @return true, if it is, false otherwise
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return heap_.empty();
+    }
+};
+
+/**
+ * @brief retain the K best elements out of a stream of elements
+ *
+ * For small K the elements are kept in a sorted std::array. The insertion position is found by counting the retained
+ * elements that are worse than the new one over the whole fixed-size array, a branch-free loop that the compiler can
+ * vectorise for arithmetic types. For larger K a bounded_heap is used. In both cases an element that is not better
+ * than the current K-th best is rejected with a single comparison.
+ *
+ * @tparam T_ element type, must be default constructible for the small-K path
+ * @tparam K_ number of elements to retain
+ * @tparam Compare comparison function type, compare(a, b) is true if b is better than a, by default comparison is
+ *                 std::less, which retains the largest elements
+ */
+template <typename T_, size_t K_, typename Compare = std::less<T_>>
+class top_k
+{
+    static_assert(K_ > 0UL, "top_k needs to retain at least one element");
+
+  public:
+    static constexpr size_t smallK = 32UL;
+
+  private:
+    static constexpr bool isSmall_ = K_ <= smallK;
+
+    // small-K path: retained elements sorted worst first
+    std::array<T_, isSmall_ ? K_ : 0UL>      arr_{};
+    size_t                                   size_ = 0UL;
+    // large-K path
+    std::optional<bounded_heap<T_, Compare>> heap_;
+    [[no_unique_address]] Compare            comp_{};
+
+    /**
+     * @brief Count the retained elements that are worse than the given key.
+     */
+    size_t countWorse_(T_ const &key) const
+    {
+        size_t count = 0UL;
+        if (size_ == K_)
+        {
+            // fixed trip count, so that the loop can be unrolled and vectorised
+            for (size_t i = 0UL; i < K_; i++)
+            {
+                count += comp_(arr_[i], key) ? 1UL : 0UL;
+            }
+        }
+        else
+        {
+            for (size_t i = 0UL; i < size_; i++)
+            {
+                count += comp_(arr_[i], key) ? 1UL : 0UL;
+            }
+        }
+        return count;
+    }
+
+  public:
+    /**
+     * @brief Construct an empty top-k container.
+     *
+     * @param comp the comparison object
+     */
+    explicit top_k(Compare const &comp = Compare())
+        : comp_(comp)
+    {
+        if constexpr (!isSmall_)
+        {
+            heap_.emplace(K_, comp_);
+        }
+    }
+
+    /**
+     * @brief Offer an element.
+     *
+     * @param key key to insert
+     * @return true if the element has been retained, false if it was rejected
+     */
+    bool push(T_ key)
+    {
+        if constexpr (isSmall_)
+        {
+            if (size_ == K_ && !comp_(arr_[0], key))
+            {
+                return false;
+            }
+            size_t const pos = countWorse_(key);
+            if (size_ == K_)
+            {
+                // drop the worst element and make room at pos - 1
+                std::move(arr_.begin() + 1, arr_.begin() + pos, arr_.begin());
+                arr_[pos - 1] = std::move(key);
+            }
+            else
+            {
+                std::move_backward(arr_.begin() + pos, arr_.begin() + size_, arr_.begin() + size_ + 1);
+                arr_[pos] = std::move(key);
+                size_++;
+            }
+            return true;
+        }
+        else
+        {
+            return heap_->push(std::move(key));
+        }
+    }
+
+    /**
+     * @brief Get the worst retained element, which is the threshold that new elements need to beat once K elements
+     * have been retained.
+     *
+     * @return const pointer to the worst element, nullptr if nothing is retained
+     */
+    T_ const *worst() const
+    {
+        if constexpr (isSmall_)
+        {
+            return size_ > 0UL ? &arr_[0] : nullptr;
+        }
+        else
+        {
+            return heap_->worst();
+        }
+    }
+
+    /**
+     * @brief Retrieve the retained elements, best first.
+     *
+     * @return std::vector<T_> the sorted elements
+     */
+    [[nodiscard]] std::vector<T_> sorted() const
+    {
+        if constexpr (isSmall_)
+        {
+            return std::vector<T_>(arr_.rend() - size_, arr_.rend());
+        }
+        else
+        {
+            return heap_->sorted();
+        }
+    }
+
+    /**
+     * @brief Remove all elements.
+     */
+    void clear()
+    {
+        if constexpr (isSmall_)
+        {
+            size_ = 0UL;
+        }
+        else
+        {
+            heap_->clear();
+        }
+    }
+
+    /**
+     * @brief Retrieve the number of retained elements.
+     *
+     * @return size_t the size
+     */
+    [[nodiscard]] size_t size() const
+    {
+        if constexpr (isSmall_)
+        {
+            return size_;
+        }
+        else
+        {
+            return heap_->size();
+        }
+    }
+
+    /**
+     * @brief Check whether no element is retained
+     *
+     * @return true, if it is, false otherwise
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0UL;
+    }
+};
 }; // namespace util
 
 #endif // NS_UTIL_HEAP_H_INCLUDED
@@ -26,22 +26,32 @@
 #ifndef NS_UTIL_MATRIX_H_INCLUDED
 #define NS_UTIL_MATRIX_H_INCLUDED
 
+#include "gemm.h"
 #include "stringutil.h"
+#include "threadutil.h"
 #include "to_string.h"
 // #define DO_TRACE_
 #include "traceutil.h"
 
+#include <algorithm>
+#include <barrier>
 #include <cmath>
 #include <complex>
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <initializer_list>
 #include <ios>
 #include <iostream>
 #include <limits>
+#include <new>
+#include <numeric>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -68,6 +78,31 @@ inline long double normalMin(std::complex<long double> val)
     return std::numeric_limits<long double>::min();
 }
 
+template <typename T>
+inline long double machineEpsilon(T val)
+{
+    if constexpr (std::numeric_limits<T>::is_specialized && !std::numeric_limits<T>::is_exact)
+    {
+        return std::numeric_limits<T>::epsilon();
+    }
+    return 0.0L;
+}
+
+inline long double machineEpsilon(std::complex<float> val)
+{
+    return std::numeric_limits<float>::epsilon();
+}
+
+inline long double machineEpsilon(std::complex<double> val)
+{
+    return std::numeric_limits<double>::epsilon();
+}
+
+inline long double machineEpsilon(std::complex<long double> val)
+{
+    return std::numeric_limits<long double>::epsilon();
+}
+
 struct matrix_interface
 {
     virtual ~matrix_interface() = default;
@@ -254,9 +289,68 @@ class matrixIsSingular : public std::logic_error
 template <bool enable = false>
 void checkBounds(matrix_interface const &lhs, size_t x, size_t y, std::string const &location);
 
+/**
+ * @brief Minimal allocator that aligns every allocation to the given boundary, so that rows of a matrix can start on
+ * cache-line boundaries and be loaded with aligned vector instructions.
+ *
+ * @tparam T value type
+ * @tparam Alignment alignment in bytes, must be a power of 2
+ */
+template <typename T, size_t Alignment = 64UL>
+struct aligned_allocator
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of 2");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    aligned_allocator() noexcept = default;
+
+    template <typename U>
+    explicit aligned_allocator(aligned_allocator<U, Alignment> const &) noexcept
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{std::max(Alignment, alignof(T))}));
+    }
+
+    void deallocate(T *p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t{std::max(Alignment, alignof(T))});
+    }
+
+    friend bool operator==(aligned_allocator const &, aligned_allocator const &)
+    {
+        return true;
+    }
+};
+
 template <>
 void checkBounds<false>(matrix_interface const &lhs, size_t x, size_t y, std::string const &location);
 
+// defined in matrix_decomposition.h, which is included at the end of this header
+template <typename T, bool enableBoundsCheck>
+class lu_decomposition;
+
+template <typename Derived>
+class matrix_expression;
+
+template <typename T, bool enableBoundsCheck>
+class matrix_ref;
+
+template <typename T, bool enableBoundsCheck>
+class matrix_view;
+
+template <typename T, bool enableBoundsCheck>
+class matrix_span;
+
 /**
  * @brief matrix template
  *
@@ -265,7 +359,9 @@ void checkBounds<false>(matrix_interface const &lhs, size_t x, size_t y, std::st
  * users of this class are familiar with matrix algebra. We have not
  * defined any specialization of this template here, so all the instances
  * of matrix will be created implicitly by the compiler.
- * Note that this class is not optimized for performance.
+ * The elements are stored row-major in a single, 64-byte aligned buffer. Rows
+ * that are longer than a cache-line are padded, so that every row starts on an
+ * aligned boundary; stride() gives the distance between rows.
  *
  * @param T                 value-type, tested with float, double, long double,
  *                          complex<float>, complex<double> and complex<long double>
@@ -275,27 +371,63 @@ void checkBounds<false>(matrix_interface const &lhs, size_t x, size_t y, std::st
 template <typename T = long double, bool enableBoundsCheck = false>
 class matrix : public matrix_interface
 {
+  public:
+    using row_t     = std::vector<T>;
+    using storage_t = std::vector<T, aligned_allocator<T>>;
+
+    /**
+     * Alignment of the data buffer in bytes. Rows that are longer than this are padded to a multiple of it.
+     */
+    static constexpr size_t alignment = 64UL;
+
+    /**
+     * Estimated number of multiply-adds below which exec_policy::automatic keeps an operation on the calling thread,
+     * because starting the threads would cost more than it saves.
+     */
+    static constexpr size_t parallelThreshold = 1UL << 21;
+
+    /**
+     * True for value types with exact arithmetic, like integers. Determinants and adjugates of such matrices are
+     * calculated by fraction-free elimination, without rounding.
+     */
+    static constexpr bool hasExactArithmetic =
+        std::numeric_limits<T>::is_specialized && std::numeric_limits<T>::is_exact;
+
   private:
-    using row_t = std::vector<T>;
-    using mat_t = std::vector<row_t>;
+    /**
+     * Data-container: a single row-major buffer, row y starts at y * stride_.
+     */
+    storage_t m_;
+    size_t    sizeX_  = 0;
+    size_t    sizeY_  = 0;
+    size_t    stride_ = 0;
 
     /**
-     * Data-container.
+     * @brief Calculate the distance between the starts of two consecutive rows. Rows that do not fit into a single
+     * cache-line are padded so that every row starts on an aligned boundary.
+     *
+     * @param xDim x-dimension
+     *
+     * @return the stride in elements
      */
-    mat_t m_;
+    static size_t strideFor(size_t xDim)
+    {
+        if (alignment % sizeof(T) != 0 || xDim * sizeof(T) <= alignment)
+        {
+            return xDim;
+        }
+        constexpr size_t perLine = alignment / sizeof(T);
+        return (xDim + perLine - 1) / perLine * perLine;
+    }
 
     /**
      * @brief Initialize the data container by re-creating it with new dimensions.
      *
      * @param xDim new x-dimension
      * @param yDim new y-dimension
-     *
-     * @return the new initialized data-container
      */
-    mat_t &initializeData(size_t xDim = 0, size_t yDim = 0)
+    void initializeData(size_t xDim = 0, size_t yDim = 0)
     {
-        m_.clear();
-
         if (xDim == 0)
         {
             xDim = 1;
@@ -306,14 +438,491 @@ class matrix : public matrix_interface
             yDim = xDim;
         }
 
-        row_t newRow = row_t(xDim);
+        sizeX_  = xDim;
+        sizeY_  = yDim;
+        stride_ = strideFor(xDim);
+        m_.assign(stride_ * sizeY_, T(0));
+    }
+
+    /**
+     * @brief Swap two rows of the matrix.
+     *
+     * @param y1 first row index
+     * @param y2 second row index
+     */
+    void swapRows(size_t y1, size_t y2)
+    {
+        std::swap_ranges(rowPtr(y1), rowPtr(y1) + sizeX_, rowPtr(y2));
+    }
+
+    /**
+     * @brief Decide whether the product lhs * rhs uses the blocked, vectorised GEMM kernel: float and double products
+     * that are large enough. The decision is taken once for the whole product, so that all blocks of rows are
+     * computed by the same kernel and the result does not depend on how the rows are split between threads.
+     */
+    static bool useGemmKernel(matrix<T, enableBoundsCheck> const &lhs, matrix<T, enableBoundsCheck> const &rhs)
+    {
+        // below this number of multiply-adds packing the operands costs more than it saves
+        constexpr size_t gemmThreshold = 16UL * 16UL * 16UL;
+
+        return has_gemm_kernel_v<T> && lhs.sizeY() * lhs.sizeX() * rhs.sizeX() >= gemmThreshold;
+    }
+
+    /**
+     * @brief Accumulate the rows [y0, y1) of the product lhs * rhs into a row-major destination.
+     *
+     * With useGemm the blocked, vectorised GEMM kernel is used, otherwise a row-wise loop whose innermost loop streams
+     * through contiguous rows of rhs and dst.
+     *
+     * @param dst destination of (y1 - y0) rows of rhs.sizeX() elements each, must not overlap lhs or rhs
+     * @param ldd row stride of the destination
+     * @param lhs left-hand-side matrix
+     * @param rhs right-hand-side matrix
+     * @param y0 first row of lhs
+     * @param y1 one past the last row of lhs
+     * @param useGemm whether to use the GEMM kernel, as decided by useGemmKernel() for the whole product
+     */
+    static void multiplyRowsInto(
+        T                                  *dst,
+        size_t                              ldd,
+        matrix<T, enableBoundsCheck> const &lhs,
+        matrix<T, enableBoundsCheck> const &rhs,
+        size_t                              y0,
+        size_t                              y1,
+        bool                                useGemm
+    )
+    {
+        if constexpr (has_gemm_kernel_v<T>)
+        {
+            if (useGemm)
+            {
+                gemm_accumulate(
+                    y1 - y0,
+                    rhs.sizeX(),
+                    lhs.sizeX(),
+                    lhs.rowPtr(y0),
+                    lhs.stride_,
+                    rhs.data(),
+                    rhs.stride_,
+                    dst,
+                    ldd
+                );
+                return;
+            }
+        }
+        for (size_t y = y0; y < y1; y++)
+        {
+            T       *dstRow = dst + (y - y0) * ldd;
+            T const *lhsRow = lhs.rowPtr(y);
+            for (size_t k = 0; k < lhs.sizeX(); k++)
+            {
+                T const  a      = lhsRow[k];
+                T const *rhsRow = rhs.rowPtr(k);
+                for (size_t x = 0; x < rhs.sizeX(); x++)
+                {
+                    dstRow[x] += a * rhsRow[x];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Combine two matrices of equal dimensions element by element into dst, row by row. dst is resized if
+     * necessary and may be lhs or rhs, as every element only depends on the elements at the same position.
+     */
+    template <typename Op>
+    static void elementwiseInto(
+        matrix<T, enableBoundsCheck>       &dst,
+        matrix<T, enableBoundsCheck> const &lhs,
+        matrix<T, enableBoundsCheck> const &rhs,
+        Op                                  op,
+        exec_policy                         policy
+    )
+    {
+        if (dst.sizeX_ != lhs.sizeX_ || dst.sizeY_ != lhs.sizeY_)
+        {
+            dst.initializeData(lhs.sizeX_, lhs.sizeY_);
+        }
+        auto combineRows = [&dst, &lhs, &rhs, &op](size_t y0, size_t y1)
+        {
+            for (size_t y = y0; y < y1; y++)
+            {
+                T       *dstRow = dst.rowPtr(y);
+                T const *lhsRow = lhs.rowPtr(y);
+                T const *rhsRow = rhs.rowPtr(y);
+                for (size_t x = 0; x < lhs.sizeX_; x++)
+                {
+                    dstRow[x] = op(lhsRow[x], rhsRow[x]);
+                }
+            }
+        };
+
+        if (use_parallel(policy, lhs.sizeX_ * lhs.sizeY_, parallelThreshold))
+        {
+            parallel_for(0, lhs.sizeY_, combineRows);
+        }
+        else
+        {
+            combineRows(0, lhs.sizeY_);
+        }
+    }
+
+    /**
+     * @brief Compute the product lhs * rhs into dst, which must already have the dimensions of the product and must not
+     * be lhs or rhs.
+     */
+    static void productInto(
+        matrix<T, enableBoundsCheck>       &dst,
+        matrix<T, enableBoundsCheck> const &lhs,
+        matrix<T, enableBoundsCheck> const &rhs,
+        exec_policy                         policy
+    )
+    {
+        std::fill(dst.m_.begin(), dst.m_.end(), T(0));
+        bool const useGemm      = useGemmKernel(lhs, rhs);
+        auto       multiplyRows = [&dst, &lhs, &rhs, useGemm](size_t y0, size_t y1)
+        { multiplyRowsInto(dst.rowPtr(y0), dst.stride_, lhs, rhs, y0, y1, useGemm); };
+
+        if (use_parallel(policy, lhs.sizeY() * lhs.sizeX() * rhs.sizeX(), parallelThreshold))
+        {
+            parallel_for(0, lhs.sizeY(), multiplyRows);
+        }
+        else
+        {
+            multiplyRows(0, lhs.sizeY());
+        }
+    }
+
+    /**
+     * @brief Retrieve a pointer to the first element of row y.
+     */
+    T *rowPtr(size_t y)
+    {
+        return m_.data() + y * stride_;
+    }
+
+    /**
+     * @brief Retrieve a const pointer to the first element of row y.
+     */
+    T const *rowPtr(size_t y) const
+    {
+        return m_.data() + y * stride_;
+    }
+
+    /**
+     * @brief Gauss-Jordan elimination with partial pivoting: reduce a to the unit matrix and apply the same row
+     * operations to b, which thus becomes the solution of a * X = b.
+     *
+     * With a parallel policy every thread owns a contiguous block of rows and eliminates the pivot column from them;
+     * the threads synchronise once per pivot, and the pivot search and the normalisation of the pivot row are done in
+     * the completion step of the barrier.
+     *
+     * A pivot is treated as rounding residue of a singular matrix if it is negligible against the largest element of
+     * its original row and of its column alike, so that badly scaled but regular matrices such as diag(1e20, 1) are
+     * still solved.
+     *
+     * @param a square matrix, reduced to the unit matrix
+     * @param b right-hand sides with a.sizeY() rows, replaced by the solutions
+     * @param policy execution policy
+     * @param location location and message for the exception
+     *
+     * @throw matrixIsSingular
+     */
+    static void gaussJordan(
+        matrix<T, enableBoundsCheck> &a,
+        matrix<T, enableBoundsCheck> &b,
+        exec_policy                   policy,
+        std::string const            &location
+    )
+    {
+        using std::abs;
+        size_t const n = a.sizeX_;
+
+        // largest absolute value of every row and column, scaled to the size of the rounding residue; row scales
+        // follow their rows through the pivot swaps
+        long double const        residue = static_cast<long double>(n) * machineEpsilon(T(0));
+        std::vector<long double> rowScale(n, 0.0L);
+        std::vector<long double> colScale(n, 0.0L);
+        for (size_t y = 0; y < n; y++)
+        {
+            T const *row = a.rowPtr(y);
+            for (size_t x = 0; x < n; x++)
+            {
+                long double const val = static_cast<long double>(abs(row[x])) * residue;
+                rowScale[y]           = std::max(rowScale[y], val);
+                colScale[x]           = std::max(colScale[x], val);
+            }
+        }
+
+        // swap the pivot row into place and divide it by the pivot value, false if the matrix is singular
+        auto normalise = [&a, &b, &rowScale, &colScale, n](size_t k) noexcept
+        {
+            long long const swapped = a.pivot(k, &b);
+            if (swapped == -1)
+            {
+                return false;
+            }
+            if (swapped > 0)
+            {
+                std::swap(rowScale[k], rowScale[swapped]);
+            }
+            T const pivotValue = a.rowPtr(k)[k];
+            if (static_cast<long double>(abs(pivotValue)) <= std::min(rowScale[k], colScale[k]))
+            {
+                return false;
+            }
+            T      *aRow       = a.rowPtr(k);
+            T      *bRow       = b.rowPtr(k);
+            for (size_t x = k; x < n; x++)
+            {
+                aRow[x] /= pivotValue;
+            }
+            for (size_t x = 0; x < b.sizeX_; x++)
+            {
+                bRow[x] /= pivotValue;
+            }
+            return true;
+        };
+
+        // empty column k in the rows [y0, y1), except in the pivot row itself
+        auto eliminate = [&a, &b, n](size_t k, size_t y0, size_t y1)
+        {
+            T const *aPivotRow = a.rowPtr(k);
+            T const *bPivotRow = b.rowPtr(k);
+            for (size_t y = y0; y < y1; y++)
+            {
+                T const rowFactor = a.rowPtr(y)[k];
+                if (y == k || rowFactor == T(0))
+                {
+                    continue;
+                }
+                T *aRow = a.rowPtr(y);
+                T *bRow = b.rowPtr(y);
+                for (size_t x = k; x < n; x++)
+                {
+                    aRow[x] -= rowFactor * aPivotRow[x];
+                }
+                for (size_t x = 0; x < b.sizeX_; x++)
+                {
+                    bRow[x] -= rowFactor * bPivotRow[x];
+                }
+            }
+        };
+
+        size_t const numThreads = std::min(parallel_thread_count(), n);
+        if (numThreads <= 1 || !use_parallel(policy, n * n * (n + b.sizeX_), parallelThreshold))
+        {
+            for (size_t k = 0; k < n; k++)
+            {
+                if (!normalise(k))
+                {
+                    throw matrixIsSingular(location);
+                }
+                eliminate(k, 0, n);
+            }
+            return;
+        }
+
+        if (!normalise(0))
+        {
+            throw matrixIsSingular(location);
+        }
+        size_t k        = 0;
+        bool   singular = false;
+        auto   nextPivot = [&k, &singular, &normalise, n]() noexcept
+        {
+            k++;
+            if (k < n && !normalise(k))
+            {
+                singular = true;
+            }
+        };
+        std::barrier sync(static_cast<std::ptrdiff_t>(numThreads), nextPivot);
+        run_on_threads(
+            numThreads,
+            [&](size_t t, size_t threads)
+            {
+                size_t const y0 = n * t / threads;
+                size_t const y1 = n * (t + 1) / threads;
+                while (k < n && !singular)
+                {
+                    eliminate(k, y0, y1);
+                    sync.arrive_and_wait();
+                }
+            }
+        );
+        if (singular)
+        {
+            throw matrixIsSingular(location);
+        }
+    }
+
+    /**
+     * @brief Create the sub-matrix with column x and row y removed.
+     *
+     * @param x column to remove
+     * @param y row to remove
+     *
+     * @return the (sizeX() - 1) x (sizeY() - 1) sub-matrix
+     */
+    matrix<T, enableBoundsCheck> subMatrix(size_t x, size_t y) const
+    {
+        matrix<T, enableBoundsCheck> reval(sizeX_ - 1, sizeY_ - 1);
+
+        for (size_t y1 = 0, y2 = 0; y1 < sizeY_; y1++)
+        {
+            if (y1 == y)
+            {
+                continue;
+            }
+            T const *srcRow = rowPtr(y1);
+            T       *dstRow = reval.rowPtr(y2);
+            std::copy(srcRow, srcRow + x, dstRow);
+            std::copy(srcRow + x + 1, srcRow + sizeX_, dstRow + x);
+            y2++;
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Fraction-free (Bareiss) Gauss-Jordan elimination. Every division is exact, so for integer value types the
+     * determinant and the adjugate are exact, too.
+     *
+     * @param adjugate if not null, receives the adjugate, provided that the determinant is not 0
+     *
+     * @return the determinant
+     */
+    T bareiss(matrix<T, enableBoundsCheck> *adjugate) const
+    {
+        size_t const                 n = sizeX_;
+        matrix<T, enableBoundsCheck> a(*this);
+        matrix<T, enableBoundsCheck> b        = adjugate != nullptr ? scalar(n, T(1)) : matrix<T, enableBoundsCheck>();
+        T                            previous = T(1);
+        bool                         negate   = false;
+
+        for (size_t k = 0; k < n; k++)
+        {
+            size_t pivRow = k;
+            while (pivRow < n && a.rowPtr(pivRow)[k] == T(0))
+            {
+                pivRow++;
+            }
+            if (pivRow == n)
+            {
+                return T(0);
+            }
+            if (pivRow != k)
+            {
+                a.swapRows(k, pivRow);
+                if (adjugate != nullptr)
+                {
+                    b.swapRows(k, pivRow);
+                }
+                negate = !negate;
+            }
+
+            // for the determinant alone it suffices to eliminate below the pivot
+            T const  pivotValue = a.rowPtr(k)[k];
+            T const *aPivotRow  = a.rowPtr(k);
+            T const *bPivotRow  = b.rowPtr(k);
+            for (size_t y = adjugate != nullptr ? 0 : k + 1; y < n; y++)
+            {
+                if (y == k)
+                {
+                    continue;
+                }
+                T      *aRow   = a.rowPtr(y);
+                T const factor = aRow[k];
+                for (size_t x = adjugate != nullptr ? 0 : k + 1; x < n; x++)
+                {
+                    if (x != k)
+                    {
+                        aRow[x] = (pivotValue * aRow[x] - factor * aPivotRow[x]) / previous;
+                    }
+                }
+                aRow[k] = T(0);
+                if (adjugate != nullptr)
+                {
+                    T *bRow = b.rowPtr(y);
+                    for (size_t x = 0; x < n; x++)
+                    {
+                        bRow[x] = (pivotValue * bRow[x] - factor * bPivotRow[x]) / previous;
+                    }
+                }
+            }
+            previous = pivotValue;
+        }
+
+        // the row operations E turned P * A into det(P * A) * I, so E = det(P * A) * A^-1 = +/- adj(A)
+        if (adjugate != nullptr)
+        {
+            *adjugate = negate ? -b : b;
+        }
 
-        for (size_t y = 0; y < yDim; y++)
+        return negate ? -previous : previous;
+    }
+
+    /**
+     * @brief Fraction-free (Bareiss) reduction of a singular matrix to row echelon form, which finds whether it has
+     * rank n-1. Every division is exact, like in bareiss().
+     *
+     * @param missingRow receives the row that holds no pivot
+     * @param missingColumn receives the column that holds no pivot
+     *
+     * @return true if exactly one row and one column hold no pivot, so that their co-factor is not 0
+     */
+    bool bareissRankDeficit(size_t &missingRow, size_t &missingColumn) const
+    {
+        size_t const                 n = sizeX_;
+        matrix<T, enableBoundsCheck> a(*this);
+        std::vector<size_t>          rows(n);
+        std::iota(rows.begin(), rows.end(), size_t{0});
+        T      previous   = T(1);
+        size_t rank       = 0;
+        bool   hasMissing = false;
+
+        for (size_t k = 0; k < n; k++)
         {
-            m_.push_back(newRow);
+            size_t pivRow = rank;
+            while (pivRow < n && a.rowPtr(pivRow)[k] == T(0))
+            {
+                pivRow++;
+            }
+            if (pivRow == n)
+            {
+                if (hasMissing)
+                {
+                    return false;
+                }
+                hasMissing    = true;
+                missingColumn = k;
+                continue;
+            }
+            if (pivRow != rank)
+            {
+                a.swapRows(rank, pivRow);
+                std::swap(rows[rank], rows[pivRow]);
+            }
+
+            T const  pivotValue = a.rowPtr(rank)[k];
+            T const *aPivotRow  = a.rowPtr(rank);
+            for (size_t y = rank + 1; y < n; y++)
+            {
+                T      *aRow   = a.rowPtr(y);
+                T const factor = aRow[k];
+                for (size_t x = k + 1; x < n; x++)
+                {
+                    aRow[x] = (pivotValue * aRow[x] - factor * aPivotRow[x]) / previous;
+                }
+                aRow[k] = T(0);
+            }
+            previous = pivotValue;
+            rank++;
         }
+        missingRow = rows[n - 1];
 
-        return m_;
+        return rank + 1 == n;
     }
 
   public:
@@ -350,33 +959,124 @@ class matrix : public matrix_interface
     }
 
     /**
-     * @brief Move copy constructor.
-     * @param rhs right-hand-side matrix - will be reset
+     * @brief Move constructor, takes over the storage of rhs in O(1) without allocating.
+     * @param rhs right-hand-side matrix - will be left empty (0 x 0), so that it can only be assigned to or destroyed
      */
     matrix(matrix &&rhs) noexcept
-        : m_(rhs.m_)
+        : m_(std::move(rhs.m_))
+        , sizeX_(std::exchange(rhs.sizeX_, 0))
+        , sizeY_(std::exchange(rhs.sizeY_, 0))
+        , stride_(std::exchange(rhs.stride_, 0))
     {
-        rhs.initializeData();
+        rhs.m_.clear();
+    }
+
+    /**
+     * @brief Construct from a lazily evaluated expression, see matrix_expression.
+     * @param expr the expression, evaluated in a single fused pass
+     */
+    template <typename Derived>
+    matrix(matrix_expression<Derived> const &expr)
+    {
+        assign(expr);
     }
 
     ~matrix() override                   = default;
     matrix &operator=(matrix const &rhs) = default;
 
     /**
-     * @brief Move assignment operator.
-     * @param rhs right-hand-side matrix - will be reset
+     * @brief Move assignment operator, takes over the storage of rhs in O(1) without allocating.
+     * @param rhs right-hand-side matrix - will be left empty (0 x 0), so that it can only be assigned to or destroyed
      * @return this matrix set to what rhs previously was.
      */
-    matrix &operator=(matrix &&rhs)
+    matrix &operator=(matrix &&rhs) noexcept
     {
         if (this != &rhs)
         {
-            m_ = rhs.m_;
-            rhs.initializeData();
+            m_      = std::move(rhs.m_);
+            sizeX_  = std::exchange(rhs.sizeX_, 0);
+            sizeY_  = std::exchange(rhs.sizeY_, 0);
+            stride_ = std::exchange(rhs.stride_, 0);
+            rhs.m_.clear();
         }
         return *this;
     }
 
+    /**
+     * @brief Assign a lazily evaluated expression, see matrix_expression.
+     * @param expr the expression, evaluated in a single fused pass
+     * @return this matrix set to the value of the expression
+     */
+    template <typename Derived>
+    matrix &operator=(matrix_expression<Derived> const &expr)
+    {
+        return assign(expr);
+    }
+
+    /**
+     * @brief Evaluate a lazy expression into this matrix.
+     *
+     * The matrix products in the expression are calculated first, then every element of the result is calculated in
+     * a single loop, that fuses all element-wise operations. As no element depends on another position of an
+     * element-wise operand, this matrix may appear in the expression itself; only views that read it in a different
+     * layout, like its transpose, make the expression go through a temporary.
+     *
+     * @param expr the expression
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     *
+     * @return this matrix set to the value of the expression
+     */
+    template <typename Derived>
+    matrix &assign(matrix_expression<Derived> const &expr, exec_policy policy = exec_policy::automatic)
+    {
+        static_assert(
+            std::is_same_v<typename Derived::matrix_type, matrix<T, enableBoundsCheck>>,
+            "expression must evaluate to this matrix type"
+        );
+        Derived const &e = expr.derived();
+
+        if constexpr (Derived::isProduct)
+        {
+            *this = e.multiply(policy);
+        }
+        else if (e.aliases(data(), sizeX_, sizeY_, stride_, 1))
+        {
+            // a view reads this matrix in a different layout: evaluate into a temporary first
+            *this = e.eval(policy);
+        }
+        else
+        {
+            e.prepare(policy);
+            if (sizeX_ != e.sizeX() || sizeY_ != e.sizeY())
+            {
+                initializeData(e.sizeX(), e.sizeY());
+            }
+
+            auto evaluateRows = [this, &e](size_t y0, size_t y1)
+            {
+                for (size_t y = y0; y < y1; y++)
+                {
+                    T *row = rowPtr(y);
+                    for (size_t x = 0; x < sizeX_; x++)
+                    {
+                        row[x] = e(x, y);
+                    }
+                }
+            };
+
+            if (use_parallel(policy, sizeX_ * sizeY_, parallelThreshold))
+            {
+                parallel_for(0, sizeY_, evaluateRows);
+            }
+            else
+            {
+                evaluateRows(0, sizeY_);
+            }
+        }
+
+        return *this;
+    }
+
     /**
      * @brief Create a diagonal matrix.
      *
@@ -460,18 +1160,45 @@ class matrix : public matrix_interface
      * @brief Retrieve the horizontal extent of the matrix.
      * @return x-dimension
      */
-    [[nodiscard]] size_t sizeX() const
+    [[nodiscard]] size_t sizeX() const final
     {
-        return sizeY() == 0 ? 0 : m_[0].size();
+        return sizeX_;
     }
 
     /**
      * @brief Retrieve the vertical extent of the matrix.
      * @return y-dimension
      */
-    [[nodiscard]] size_t sizeY() const
+    [[nodiscard]] size_t sizeY() const final
+    {
+        return sizeY_;
+    }
+
+    /**
+     * @brief Retrieve the distance in elements between the starts of two consecutive rows in the data buffer.
+     * @return the row stride
+     */
+    [[nodiscard]] size_t stride() const
     {
-        return m_.size();
+        return stride_;
+    }
+
+    /**
+     * @brief Direct access to the row-major data buffer, element (x,y) is at data()[y * stride() + x].
+     * @return pointer to the first element
+     */
+    T *data()
+    {
+        return m_.data();
+    }
+
+    /**
+     * @brief Direct access to the row-major data buffer, element (x,y) is at data()[y * stride() + x].
+     * @return const pointer to the first element
+     */
+    T const *data() const
+    {
+        return m_.data();
     }
 
     /**
@@ -565,10 +1292,13 @@ class matrix : public matrix_interface
      */
     T &operator()(size_t x, size_t y)
     {
-        // if enableBoundsCheck==false, this will be an empty function
-        checkBounds<enableBoundsCheck>(*this, x, y, "T& matrix<T,enableBoundsCheck>::operator()");
+        // if enableBoundsCheck==false, this is compiled out, including the construction of the location string
+        if constexpr (enableBoundsCheck)
+        {
+            checkBounds<enableBoundsCheck>(*this, x, y, "T& matrix<T,enableBoundsCheck>::operator()");
+        }
 
-        return m_[y][x];
+        return m_[y * stride_ + x];
     }
 
     /**
@@ -581,10 +1311,13 @@ class matrix : public matrix_interface
      */
     T operator()(size_t x, size_t y) const
     {
-        // if enableBoundsCheck==false, this will be an empty function
-        checkBounds<enableBoundsCheck>(*this, x, y, "T matrix<T,enableBoundsCheck>::operator() const");
+        // if enableBoundsCheck==false, this is compiled out, including the construction of the location string
+        if constexpr (enableBoundsCheck)
+        {
+            checkBounds<enableBoundsCheck>(*this, x, y, "T matrix<T,enableBoundsCheck>::operator() const");
+        }
 
-        return m_[y][x];
+        return m_[y * stride_ + x];
     }
 
     /**
@@ -592,13 +1325,16 @@ class matrix : public matrix_interface
      *
      * @param y row index
      *
-     * @return reference to the data in row y
+     * @return span referencing the data in row y
      */
-    row_t &row(size_t y)
+    std::span<T> row(size_t y)
     {
-        checkBounds<enableBoundsCheck>(*this, 0, y, "row_t& matrix<T,enableBoundsCheck>::row(y)");
+        if constexpr (enableBoundsCheck)
+        {
+            checkBounds<enableBoundsCheck>(*this, 0, y, "std::span<T> matrix<T,enableBoundsCheck>::row(y)");
+        }
 
-        return m_[y];
+        return std::span<T>(rowPtr(y), sizeX_);
     }
 
     /**
@@ -610,9 +1346,95 @@ class matrix : public matrix_interface
      */
     row_t row(size_t y) const
     {
-        checkBounds<enableBoundsCheck>(*this, 0, y, "row_t& matrix<T,enableBoundsCheck>::row(y)");
+        if constexpr (enableBoundsCheck)
+        {
+            checkBounds<enableBoundsCheck>(*this, 0, y, "row_t matrix<T,enableBoundsCheck>::row(y) const");
+        }
 
-        return m_[y];
+        return row_t(rowPtr(y), rowPtr(y) + sizeX_);
+    }
+
+    /**
+     * @brief Read-only view of the whole matrix, see matrix_view.
+     */
+    matrix_view<T, enableBoundsCheck> view() const
+    {
+        return matrix_view<T, enableBoundsCheck>(*this);
+    }
+
+    /**
+     * @brief Writable view of the whole matrix, see matrix_span.
+     */
+    matrix_span<T, enableBoundsCheck> span()
+    {
+        return matrix_span<T, enableBoundsCheck>(*this);
+    }
+
+    /**
+     * @brief View a rectangular block without copying.
+     *
+     * @param x x-coordinate of the top-left element
+     * @param y y-coordinate of the top-left element
+     * @param xDim x-dimension of the block
+     * @param yDim y-dimension of the block
+     *
+     * @return the read-only view of the block
+     *
+     * @throw matrixIndexOutOfBounds if the block does not fit into the matrix
+     */
+    matrix_view<T, enableBoundsCheck> block(size_t x, size_t y, size_t xDim, size_t yDim) const
+    {
+        return view().block(x, y, xDim, yDim);
+    }
+
+    /**
+     * @brief View a rectangular block without copying, assigning to the view writes into the matrix.
+     * @throw matrixIndexOutOfBounds if the block does not fit into the matrix
+     */
+    matrix_span<T, enableBoundsCheck> block(size_t x, size_t y, size_t xDim, size_t yDim)
+    {
+        return span().block(x, y, xDim, yDim);
+    }
+
+    /**
+     * @brief View row y without copying.
+     * @throw matrixIndexOutOfBounds
+     */
+    matrix_view<T, enableBoundsCheck> rowView(size_t y) const
+    {
+        return view().rowView(y);
+    }
+
+    matrix_span<T, enableBoundsCheck> rowView(size_t y)
+    {
+        return span().rowView(y);
+    }
+
+    /**
+     * @brief View column x without copying.
+     * @throw matrixIndexOutOfBounds
+     */
+    matrix_view<T, enableBoundsCheck> colView(size_t x) const
+    {
+        return view().colView(x);
+    }
+
+    matrix_span<T, enableBoundsCheck> colView(size_t x)
+    {
+        return span().colView(x);
+    }
+
+    /**
+     * @brief View the transpose without copying, unlike operator~.
+     */
+    matrix_view<T, enableBoundsCheck> transposed() const
+    {
+        return view().transposed();
+    }
+
+    matrix_span<T, enableBoundsCheck> transposed()
+    {
+        return span().transposed();
     }
 
     /**
@@ -641,9 +1463,10 @@ class matrix : public matrix_interface
 
         for (size_t y = 0; y < temp.sizeY(); y++)
         {
+            T *tempRow = temp.rowPtr(y);
             for (size_t x = 0; x < temp.sizeX(); x++)
             {
-                temp(x, y) = -temp(x, y);
+                tempRow[x] = -tempRow[x];
             }
         }
 
@@ -665,9 +1488,11 @@ class matrix : public matrix_interface
         matrix<T, enableBoundsCheck> reval = lhs;
         for (size_t y = 0; y < reval.sizeY(); y++)
         {
+            T       *revalRow = reval.rowPtr(y);
+            T const *rhsRow   = rhs.rowPtr(y);
             for (size_t x = 0; x < reval.sizeX(); x++)
             {
-                reval(x, y) += rhs(x, y);
+                revalRow[x] += rhsRow[x];
             }
         }
 
@@ -684,11 +1509,22 @@ class matrix : public matrix_interface
     matrix<T, enableBoundsCheck> &operator+=(matrix<T, enableBoundsCheck> const &rhs)
     {
         assertCompatibleSizes(*this, rhs, operType::MatrixAdd, "operator+=(rhs)");
-        *this = *this + rhs;
+        elementwiseInto(*this, *this, rhs, std::plus<T>{}, exec_policy::automatic);
 
         return *this;
     }
 
+    /**
+     * @brief Add a lazy expression to this matrix in a single fused pass.
+     * @param expr the expression
+     * @return the sum of this with the expression
+     */
+    template <typename Derived>
+    matrix<T, enableBoundsCheck> &operator+=(matrix_expression<Derived> const &expr)
+    {
+        return assign(matrix_ref<T, enableBoundsCheck>(*this) + expr);
+    }
+
     /**
      * @brief Global matrix subtraction operator.
      *
@@ -706,9 +1542,11 @@ class matrix : public matrix_interface
 
         for (size_t y = 0; y < reval.sizeY(); y++)
         {
+            T       *revalRow = reval.rowPtr(y);
+            T const *rhsRow   = rhs.rowPtr(y);
             for (size_t x = 0; x < reval.sizeX(); x++)
             {
-                reval(x, y) -= rhs(x, y);
+                revalRow[x] -= rhsRow[x];
             }
         }
 
@@ -723,12 +1561,22 @@ class matrix : public matrix_interface
     matrix<T, enableBoundsCheck> &operator-=(matrix<T, enableBoundsCheck> const &rhs)
     {
         assertCompatibleSizes(*this, rhs, operType::MatrixSub, "operator-=(rhs)");
-
-        *this = *this - rhs;
+        elementwiseInto(*this, *this, rhs, std::minus<T>{}, exec_policy::automatic);
 
         return *this;
     }
 
+    /**
+     * @brief Subtract a lazy expression from this matrix in a single fused pass.
+     * @param expr the expression
+     * @return the result of *this - expr
+     */
+    template <typename Derived>
+    matrix<T, enableBoundsCheck> &operator-=(matrix_expression<Derived> const &expr)
+    {
+        return assign(matrix_ref<T, enableBoundsCheck>(*this) - expr);
+    }
+
     /**
      * @brief Global scalar multiplication operator.
      * @param lhs left-hand-side matrix
@@ -741,9 +1589,10 @@ class matrix : public matrix_interface
 
         for (size_t y = 0; y < reval.sizeY(); y++)
         {
+            T *revalRow = reval.rowPtr(y);
             for (size_t x = 0; x < reval.sizeX(); x++)
             {
-                reval(x, y) *= c;
+                revalRow[x] *= c;
             }
         }
 
@@ -764,9 +1613,10 @@ class matrix : public matrix_interface
 
         for (size_t y = 0; y < reval.sizeY(); y++)
         {
+            T *revalRow = reval.rowPtr(y);
             for (size_t x = 0; x < reval.sizeX(); x++)
             {
-                reval(x, y) *= c;
+                revalRow[x] *= c;
             }
         }
 
@@ -782,7 +1632,14 @@ class matrix : public matrix_interface
      */
     matrix<T, enableBoundsCheck> &operator*=(T const &c)
     {
-        *this = *this * c;
+        for (size_t y = 0; y < sizeY_; y++)
+        {
+            T *row = rowPtr(y);
+            for (size_t x = 0; x < sizeX_; x++)
+            {
+                row[x] *= c;
+            }
+        }
 
         return *this;
     }
@@ -795,27 +1652,110 @@ class matrix : public matrix_interface
      */
     friend matrix<T, enableBoundsCheck>
         operator*(matrix<T, enableBoundsCheck> const &lhs, matrix<T, enableBoundsCheck> const &rhs)
+    {
+        return multiply(lhs, rhs);
+    }
+
+    /**
+     * @brief Matrix multiplication with an explicit execution policy. In parallel the rows of the product are split
+     * into one block per thread. Every element is accumulated in the same order whatever the policy and the number of
+     * threads, so the result is bit-for-bit the same.
+     *
+     * @param lhs left-hand-side matrix
+     * @param rhs right-hand-side matrix
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @return the product lhs*rhs
+     */
+    static matrix<T, enableBoundsCheck> multiply(
+        matrix<T, enableBoundsCheck> const &lhs,
+        matrix<T, enableBoundsCheck> const &rhs,
+        exec_policy                         policy = exec_policy::automatic
+    )
     {
         assertCompatibleSizes(lhs, rhs, operType::MatrixMult, "operator*(lhs,rhs)");
 
         matrix<T, enableBoundsCheck> reval(rhs.sizeX(), lhs.sizeY());
+        productInto(reval, lhs, rhs, policy);
+
+        return reval;
+    }
+
+    /**
+     * @brief Matrix multiplication into a pre-allocated destination: dst = lhs * rhs. If dst already has the
+     * dimensions of the product, no memory is allocated, so hot loops can reuse their matrices. The result is
+     * bit-for-bit the one of multiply(), whatever the policy and the number of threads.
+     *
+     * @param dst destination, resized if necessary; may be lhs or rhs, which then costs a temporary
+     * @param lhs left-hand-side matrix
+     * @param rhs right-hand-side matrix
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @throw matrixSizesIncompatible
+     */
+    static void multiplyInto(
+        matrix<T, enableBoundsCheck>       &dst,
+        matrix<T, enableBoundsCheck> const &lhs,
+        matrix<T, enableBoundsCheck> const &rhs,
+        exec_policy                         policy = exec_policy::automatic
+    )
+    {
+        assertCompatibleSizes(lhs, rhs, operType::MatrixMult, "multiplyInto(dst,lhs,rhs)");
 
-        for (size_t y = 0; y < lhs.sizeY(); y++)
+        if (&dst == &lhs || &dst == &rhs)
         {
-            for (size_t x = 0; x < rhs.sizeX(); x++)
-            {
-                //                    reval(y, x) = T(0);
-                //                    for (size_t k = 0; k < lhs.sizeX(); k++)
-                //                        reval(y, x) += lhs(k, y) * rhs(x, k);
-                reval(x, y) = T(0);
-                for (size_t k = 0; k < lhs.sizeX(); k++)
-                {
-                    reval(x, y) += lhs(k, y) * rhs(x, k);
-                }
-            }
+            dst = multiply(lhs, rhs, policy);
+            return;
+        }
+        if (dst.sizeX_ != rhs.sizeX() || dst.sizeY_ != lhs.sizeY())
+        {
+            dst.initializeData(rhs.sizeX(), lhs.sizeY());
         }
+        productInto(dst, lhs, rhs, policy);
+    }
 
-        return reval;
+    /**
+     * @brief Matrix addition into a pre-allocated destination: dst = lhs + rhs, without allocating if dst already has
+     * the right dimensions.
+     *
+     * @param dst destination, resized if necessary; may be lhs or rhs
+     * @param lhs left-hand-side matrix
+     * @param rhs right-hand-side matrix
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     *
+     * @throw matrixSizesIncompatible
+     */
+    static void addInto(
+        matrix<T, enableBoundsCheck>       &dst,
+        matrix<T, enableBoundsCheck> const &lhs,
+        matrix<T, enableBoundsCheck> const &rhs,
+        exec_policy                         policy = exec_policy::automatic
+    )
+    {
+        assertCompatibleSizes(lhs, rhs, operType::MatrixAdd, "addInto(dst,lhs,rhs)");
+        elementwiseInto(dst, lhs, rhs, std::plus<T>{}, policy);
+    }
+
+    /**
+     * @brief Matrix subtraction into a pre-allocated destination: dst = lhs - rhs, without allocating if dst already
+     * has the right dimensions.
+     *
+     * @param dst destination, resized if necessary; may be lhs or rhs
+     * @param lhs left-hand-side matrix
+     * @param rhs right-hand-side matrix
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     *
+     * @throw matrixSizesIncompatible
+     */
+    static void subtractInto(
+        matrix<T, enableBoundsCheck>       &dst,
+        matrix<T, enableBoundsCheck> const &lhs,
+        matrix<T, enableBoundsCheck> const &rhs,
+        exec_policy                         policy = exec_policy::automatic
+    )
+    {
+        assertCompatibleSizes(lhs, rhs, operType::MatrixSub, "subtractInto(dst,lhs,rhs)");
+        elementwiseInto(dst, lhs, rhs, std::minus<T>{}, policy);
     }
 
     /**
@@ -827,7 +1767,47 @@ class matrix : public matrix_interface
      */
     matrix<T, enableBoundsCheck> &operator*=(matrix<T, enableBoundsCheck> const &rhs)
     {
-        *this = *this * rhs;
+        assertCompatibleSizes(*this, rhs, operType::MatrixMult, "operator*=(rhs)");
+
+        if (this == &rhs || !rhs.isSquare())
+        {
+            // the dimensions change, or rhs would be overwritten whilst it is being read
+            *this = *this * rhs;
+
+            return *this;
+        }
+
+        // a block of rows of the product only depends on the same rows of *this, so it can be computed into a
+        // scratch buffer that is reused between calls, and then copied back in place; the blocks are independent
+        // and can be computed in parallel, each thread with its own scratch buffer
+        static constexpr size_t blockRows = 64UL;
+        size_t const     ldd       = sizeX_;
+        size_t const     numBlocks = (sizeY_ + blockRows - 1) / blockRows;
+        bool const       useGemm   = useGemmKernel(*this, rhs);
+        auto             multiplyBlocks = [this, &rhs, ldd, useGemm](size_t b0, size_t b1)
+        {
+            thread_local storage_t scratch;
+            scratch.resize(std::min(blockRows, sizeY_) * ldd);
+            for (size_t y0 = b0 * blockRows; y0 < std::min(b1 * blockRows, sizeY_); y0 += blockRows)
+            {
+                size_t const y1 = std::min(y0 + blockRows, sizeY_);
+                std::fill(scratch.begin(), scratch.begin() + (y1 - y0) * ldd, T(0));
+                multiplyRowsInto(scratch.data(), ldd, *this, rhs, y0, y1, useGemm);
+                for (size_t y = y0; y < y1; y++)
+                {
+                    std::copy(scratch.data() + (y - y0) * ldd, scratch.data() + (y - y0 + 1) * ldd, rowPtr(y));
+                }
+            }
+        };
+
+        if (use_parallel(exec_policy::automatic, sizeY_ * sizeX_ * sizeX_, parallelThreshold))
+        {
+            parallel_for(0, numBlocks, multiplyBlocks);
+        }
+        else
+        {
+            multiplyBlocks(0, numBlocks);
+        }
 
         return *this;
     }
@@ -848,9 +1828,10 @@ class matrix : public matrix_interface
 
         for (size_t y = 0; y < reval.sizeY(); y++)
         {
+            T *revalRow = reval.rowPtr(y);
             for (size_t x = 0; x < reval.sizeX(); x++)
             {
-                reval(x, y) /= c;
+                revalRow[x] /= c;
             }
         }
 
@@ -893,7 +1874,14 @@ class matrix : public matrix_interface
     {
         assertNotZero(c, "operator/=(lhs,c)");
 
-        *this = *this / c;
+        for (size_t y = 0; y < sizeY_; y++)
+        {
+            T *row = rowPtr(y);
+            for (size_t x = 0; x < sizeX_; x++)
+            {
+                row[x] /= c;
+            }
+        }
 
         return *this;
     }
@@ -901,17 +1889,64 @@ class matrix : public matrix_interface
     /**
      * @brief Power operator.
      * @param pow power
-     * @return lhs ^ pow
+     * @return lhs ^ pow, the unit matrix for pow == 0
      */
     friend matrix<T, enableBoundsCheck> operator^(matrix<T, enableBoundsCheck> const &lhs, size_t const &pow)
     {
-        assertSquare(lhs, "operator^(lhs,pow)");
+        return power(lhs, pow);
+    }
+
+    /**
+     * @brief Raise a square matrix to an integral power by repeated squaring, with at most 2 * log2(pow) products
+     * instead of pow - 1. The products are computed into a scratch matrix that is reused for all of them.
+     *
+     * For real powers, or many powers of the same symmetric matrix, see symmetric_eigen::pow().
+     *
+     * @param lhs square matrix
+     * @param pow power
+     * @param policy execution policy for the products
+     *
+     * @return lhs ^ pow, the unit matrix for pow == 0
+     *
+     * @throw matrixMustBeSquare
+     */
+    static matrix<T, enableBoundsCheck>
+        power(matrix<T, enableBoundsCheck> const &lhs, size_t pow, exec_policy policy = exec_policy::automatic)
+    {
+        assertSquare(lhs, "power(lhs,pow)");
 
-        matrix<T, enableBoundsCheck> reval(lhs);
+        if (pow == 0)
+        {
+            return scalar(lhs.sizeX(), T(1.0L));
+        }
 
-        for (size_t i = 2; i <= pow; i++)
+        // invariant: lhs ^ pow(original) == reval * base ^ pow, where reval is still empty until the first factor
+        matrix<T, enableBoundsCheck> base(lhs);
+        matrix<T, enableBoundsCheck> reval;
+        matrix<T, enableBoundsCheck> scratch(lhs.sizeX(), lhs.sizeY());
+        bool                         haveFactor = false;
+        while (true)
         {
-            reval = lhs * reval;
+            if ((pow & 1UL) != 0)
+            {
+                if (haveFactor)
+                {
+                    productInto(scratch, reval, base, policy);
+                    std::swap(reval.m_, scratch.m_);
+                }
+                else
+                {
+                    reval      = base;
+                    haveFactor = true;
+                }
+            }
+            pow >>= 1;
+            if (pow == 0)
+            {
+                break;
+            }
+            productInto(scratch, base, base, policy);
+            std::swap(base.m_, scratch.m_);
         }
 
         return reval;
@@ -942,11 +1977,22 @@ class matrix : public matrix_interface
     {
         matrix<T, enableBoundsCheck> reval(rhs.sizeY(), rhs.sizeX());
 
-        for (size_t y = 0; y < rhs.sizeY(); y++)
+        // transpose in square tiles so that both source and destination stay cache-resident
+        constexpr size_t tile = 32;
+        for (size_t y0 = 0; y0 < rhs.sizeY(); y0 += tile)
         {
-            for (size_t x = 0; x < rhs.sizeX(); x++)
+            size_t const yEnd = std::min(y0 + tile, rhs.sizeY());
+            for (size_t x0 = 0; x0 < rhs.sizeX(); x0 += tile)
             {
-                reval(y, x) = rhs(x, y);
+                size_t const xEnd = std::min(x0 + tile, rhs.sizeX());
+                for (size_t y = y0; y < yEnd; y++)
+                {
+                    T const *rhsRow = rhs.rowPtr(y);
+                    for (size_t x = x0; x < xEnd; x++)
+                    {
+                        reval.rowPtr(x)[y] = rhsRow[x];
+                    }
+                }
             }
         }
 
@@ -972,14 +2018,17 @@ class matrix : public matrix_interface
             newYDim = sizeY();
         }
 
-        mat_t tmp = initializeData(newYDim, newXDim);
+        matrix<T, enableBoundsCheck> tmp(newXDim, newYDim);
 
         for (size_t y = 0; y < std::min(sizeY(), newYDim); y++)
         {
-            std::copy(row(y).begin(), row(y).begin() + (std::min(newXDim, sizeX())), tmp[y].begin());
+            std::copy(rowPtr(y), rowPtr(y) + std::min(newXDim, sizeX()), tmp.rowPtr(y));
         }
 
-        std::swap(tmp, m_);
+        std::swap(tmp.m_, m_);
+        sizeX_  = tmp.sizeX_;
+        sizeY_  = tmp.sizeY_;
+        stride_ = tmp.stride_;
     }
 
     /**
@@ -995,57 +2044,24 @@ class matrix : public matrix_interface
     }
 
     /**
-     * @brief Inversion function.
+     * @brief Inversion function. This matrix is reduced to the unit matrix in the process.
+     *
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
      *
      * @return the inverted square matrix if this matrix is not singular.
      */
-    matrix<T, enableBoundsCheck> inv()
+    matrix<T, enableBoundsCheck> inv(exec_policy policy = exec_policy::automatic)
     {
         assertSquare(*this, "matrix<T,enableBoundsCheck>::inv()");
 
         // initialize the return matrix as the unit-matrix of sizeX
         matrix<T, enableBoundsCheck> reval = matrix<T, enableBoundsCheck>::scalar(sizeX(), T(1.0L));
-
-        for (size_t k = 0; k < sizeX(); k++)
-        {
-            // if we can not find a new pivot-element then the matrix is
-            // singular and cannot be inverted
-            long long pivIdx = pivot(k);
-
-            if (pivIdx == -1)
-            {
-                throw matrixIsSingular("matrix<T,enableBoundsCheck>::operator!: Inversion of a singular matrix");
-            }
-
-            // swap rows so that the pivot element is on the diagonal at k
-            if (pivIdx != 0)
-            {
-                std::swap(row(k), row(pivIdx));
-            }
-
-            // divide all values at the row by the pivot value and thus
-            // ensuring that the value at (k,k) == 1
-            T pivotVal = (*this)(k, k);
-
-            for (size_t x = 0; x < sizeX(); x++)
-            {
-                (*this)(x, k) /= pivotVal;
-                reval(x, k) /= pivotVal;
-            }
-
-            for (size_t y = 0; y < sizeY(); y++)
-            {
-                if (y != k)
-                {
-                    T a2 = (*this)(k, y);
-                    for (size_t x = 0; x < sizeX(); x++)
-                    {
-                        (*this)(x, y) -= a2 * (*this)(x, k);
-                        reval(x, y) -= a2 * reval(x, k);
-                    }
-                }
-            }
-        }
+        gaussJordan(
+            *this,
+            reval,
+            policy,
+            "matrix<T,enableBoundsCheck>::operator!: Inversion of a singular matrix"
+        );
 
         return reval;
     }
@@ -1054,65 +2070,21 @@ class matrix : public matrix_interface
      * @brief Solve simultaneous equations.
      *
      * @param v matrix of values. Can be seen as set of vertical vectors
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
      *
      * @return matrix representing the solutions
      */
-    matrix<T, enableBoundsCheck> solve(matrix<T, enableBoundsCheck> const &v) const
+    matrix<T, enableBoundsCheck> solve(
+        matrix<T, enableBoundsCheck> const &v,
+        exec_policy                         policy = exec_policy::automatic
+    ) const
     {
         assertSquare(*this, "matrix<T,enableBoundsCheck>::solve(v)");
         assertCompatibleSizes(*this, v, operType::MatrixSolve, "matrix<T,enableBoundsCheck>::solve(v)");
 
         matrix<T, enableBoundsCheck> temp      = *this;
         matrix<T, enableBoundsCheck> solutions = v;
-
-        for (size_t pivIdx = 0; pivIdx < sizeX(); pivIdx++)
-        {
-            if (temp.pivot(pivIdx, &solutions) == -1)
-            {
-                throw matrixIsSingular("matrix<T,enableBoundsCheck>::solve(): Singular matrix!");
-            }
-
-            size_t x;
-            size_t y;
-
-            ////////////////////////////////////////////////////////////////
-            // Divide the pivot-row of the temporary matrix and the
-            // solution matrix by the pivot value leaving a "1" at the
-            // diagonal.
-            T pivotValue = temp(pivIdx, pivIdx);
-
-            for (x = pivIdx; x < temp.sizeX(); x++)
-            {
-                temp(x, pivIdx) /= pivotValue;
-            }
-
-            for (x = 0; x < solutions.sizeX(); x++)
-            {
-                solutions(x, pivIdx) /= pivotValue;
-            }
-            ////////////////////////////////////////////////////////////////
-
-            // empty the column except the diagonal of the temporary
-            for (y = 0; y < sizeY(); y++)
-            {
-                if (y != pivIdx)
-                {
-                    T rowFactor = temp(pivIdx, y);
-                    if (rowFactor != T(0))
-                    {
-                        for (x = pivIdx; x < temp.sizeX(); x++)
-                        {
-                            temp(x, y) -= rowFactor * temp(x, pivIdx);
-                        }
-
-                        for (x = 0; x < solutions.sizeX(); x++)
-                        {
-                            solutions(x, y) -= rowFactor * solutions(x, pivIdx);
-                        }
-                    }
-                }
-            }
-        }
+        gaussJordan(temp, solutions, policy, "matrix<T,enableBoundsCheck>::solve(): Singular matrix!");
 
         return solutions;
     }
@@ -1167,65 +2139,29 @@ class matrix : public matrix_interface
     }
 #endif // defined HAVE_LEGACY_DETERMINANT_METHOD
 
-  private: // make the recursive method private
     /**
-     * @brief Calculate the sub-determinant of this matrix at level n. This is a
-     * recursive method.
-     * @param n the level with first call to be level n == sizeX().
-     * @return the sub-determinant
+     * @brief Calculate the determinant of this matrix in O(n^3), by LU decomposition, or by fraction-free elimination
+     * if the value type has exact arithmetic.
+     *
+     * The determinant is the product of the actual pivots and is not thresholded; use isSingular() to test for
+     * numerical singularity.
+     *
+     * @param policy execution policy for the decomposition, automatic runs in parallel above parallelThreshold
+     *
+     * @return the determinant
      */
-    T determinantR(size_t n) const
+    T det(exec_policy policy = exec_policy::automatic) const
     {
         assertSquare(*this, "matrix<T,enableBoundsCheck>::det()");
-        T                            reval = T(0);
-        matrix<T, enableBoundsCheck> subMatrix(sizeX() - 1, sizeY() - 1);
-        if (n == 2)
+
+        if constexpr (hasExactArithmetic)
         {
-            return (*this)(0, 0) * (*this)(1, 1) - (*this)(1, 0) * (*this)(0, 1);
+            return bareiss(nullptr);
         }
         else
         {
-            T       pm    = T(1.0L);
-            T const minus = T(-1.0L);
-
-            for (size_t x = 0; x < n; x++)
-            {
-                size_t subi = 0;
-
-                for (size_t i = 1; i < n; i++)
-                {
-                    size_t subj = 0;
-
-                    for (size_t j = 0; j < n; j++)
-                    {
-                        if (j == x)
-                        {
-                            continue;
-                        }
-
-                        subMatrix(subi, subj) = (*this)(i, j);
-                        subj++;
-                    }
-                    subi++;
-                }
-
-                reval = reval + ((pm) * (*this)(0, x) * determinantR(n - 1));
-                pm *= minus;
-            }
+            return lu_decomposition<T, enableBoundsCheck>(*this, policy).det();
         }
-
-        return reval;
-    }
-
-  public:
-    /**
-     * @brief Calculate the determinant of this matrix.
-     *
-     * @return the determinant
-     */
-    T det() const
-    {
-        return determinantR(sizeX());
     }
 
     /**
@@ -1273,29 +2209,12 @@ class matrix : public matrix_interface
         assertSquare(*this, "cofact(x,y)");
         checkBounds(*this, x, y, "cofact(x,y)");
 
-        matrix<T, enableBoundsCheck> subMat(sizeX() - 1, sizeY() - 1);
-
-        for (size_t x1 = 0, x2 = 0; x1 < sizeX(); x1++)
+        if (sizeX() == 1)
         {
-            if (x1 == x)
-            {
-                continue;
-            }
-
-            for (size_t y1 = 0, y2 = 0; y1 < sizeY(); y1++)
-            {
-                if (y1 == y)
-                {
-                    continue;
-                }
-
-                subMat(x2, y2) = (*this)(x1, y1);
-                y2++;
-            }
-            x2++;
+            return T(1.0L);
         }
 
-        T cof = subMat.det();
+        T cof = subMatrix(x, y).det(exec_policy::sequential);
 
         if ((x + y) % 2 == 1)
         {
@@ -1306,21 +2225,128 @@ class matrix : public matrix_interface
     }
 
     /**
-     * @brief Calculate adjoin of a matrix.
+     * @brief Calculate the adjugate (classical adjoint) of a matrix, the transposed matrix of co-factors, so that
+     * adj() * m == m.det() * unit-matrix.
+     *
+     * A regular matrix is decomposed once and adj() = det() * inverse, in O(n^3). A singular matrix A can still have
+     * a non-zero adjugate; it is derived from the regular rank-one update B = A + b * e_k^T, where U(k,k) is the most
+     * negligible pivot of P * A = L * U and b = s * P^T * L * e_k, so that B is regular whenever A has rank n-1:
+     * adj(A) = det(A) * B^-1 + det(B) * B^-1 * b * e_k^T * B^-1, which is O(n^3) as well. If B is singular too, A
+     * has rank n-2 or less and its adjugate vanishes.
+     *
+     * For value types with exact arithmetic fraction-free elimination is used instead. For a singular matrix it finds
+     * a row r and a column c without pivot; if they are unique, B = A + e_r * e_c^T is regular and the adjugate is
+     * the exact quotient adj(A) = adj(B) * e_r * e_c^T * adj(B) / det(B), so that is O(n^3), too; the dividends are
+     * det(B) times larger than the adjugate, which fixed-width integer types must be able to hold.
      *
-     * @return the adjoin
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @return the adjugate
      */
-    matrix<T, enableBoundsCheck> adj() const
+    matrix<T, enableBoundsCheck> adj(exec_policy policy = exec_policy::automatic) const
     {
         assertSquare(*this, "matrix<T,enableBoundsCheck>::adj()");
 
-        matrix<T, enableBoundsCheck> reval(sizeX(), sizeY());
+        size_t const n = sizeX();
+        if (n == 1)
+        {
+            return scalar(1, T(1.0L));
+        }
 
-        for (size_t x = 0; x < sizeX(); x++)
+        matrix<T, enableBoundsCheck> reval(n, n);
+        if constexpr (hasExactArithmetic)
         {
-            for (size_t y = 0; y < sizeY(); y++)
+            if (bareiss(&reval) != T(0))
+            {
+                return reval;
+            }
+
+            size_t missingRow    = 0;
+            size_t missingColumn = 0;
+            if (!bareissRankDeficit(missingRow, missingColumn))
+            {
+                return matrix<T, enableBoundsCheck>(n, n);
+            }
+            matrix<T, enableBoundsCheck> updated = *this;
+            updated(missingColumn, missingRow) += T(1);
+            matrix<T, enableBoundsCheck> updatedAdj;
+            T const                      updatedDet = updated.bareiss(&updatedAdj);
+            for (size_t y = 0; y < n; y++)
+            {
+                T const factor = updatedAdj(missingRow, y);
+                for (size_t x = 0; x < n; x++)
+                {
+                    reval(x, y) = factor * updatedAdj(x, missingColumn) / updatedDet;
+                }
+            }
+        }
+        else
+        {
+            using std::abs;
+
+            lu_decomposition<T, enableBoundsCheck> lu(*this, policy);
+            T const                                detA = lu.det();
+            if (!lu.isSingular())
+            {
+                return lu.inv() * detA;
+            }
+
+            // the pivot that is smallest against its column, and the scale s of that column
+            matrix<T, enableBoundsCheck> const &factors = lu.factors();
+            std::vector<size_t> const          &perm    = lu.permutation();
+            size_t                              k       = 0;
+            long double                         s       = 1.0L;
+            long double                         minimum = -1.0L;
+            for (size_t x = 0; x < n; x++)
+            {
+                long double colMax = 0.0L;
+                for (size_t y = 0; y < n; y++)
+                {
+                    colMax = std::max(colMax, static_cast<long double>(abs((*this)(x, y))));
+                }
+                long double const ratio = colMax == 0.0L ? 0.0L
+                                                         : static_cast<long double>(abs(factors(x, x))) / colMax;
+                if (minimum < 0.0L || ratio < minimum)
+                {
+                    minimum = ratio;
+                    k       = x;
+                    s       = colMax == 0.0L ? 1.0L : colMax;
+                }
+            }
+
+            // b = s * P^T * L * e_k, added to column k
+            std::vector<T>               b(n, T(0));
+            matrix<T, enableBoundsCheck> updated = *this;
+            b[perm[k]]                           = T(s);
+            for (size_t y = k + 1; y < n; y++)
+            {
+                b[perm[y]] = T(s) * factors(k, y);
+            }
+            for (size_t y = 0; y < n; y++)
+            {
+                updated(k, y) += b[y];
+            }
+
+            lu_decomposition<T, enableBoundsCheck> updatedLu(std::move(updated), policy);
+            if (updatedLu.isSingular())
+            {
+                return reval;
+            }
+            T const                      detB    = updatedLu.det();
+            matrix<T, enableBoundsCheck> inverse = updatedLu.inv();
+            reval                                = inverse * detA;
+            for (size_t y = 0; y < n; y++)
             {
-                reval(x, y) = cofact(x, y);
+                T invB(0);
+                for (size_t x = 0; x < n; x++)
+                {
+                    invB += inverse(x, y) * b[x];
+                }
+                invB *= detB;
+                for (size_t x = 0; x < n; x++)
+                {
+                    reval(x, y) += invB * inverse(x, k);
+                }
             }
         }
 
@@ -1334,7 +2360,19 @@ class matrix : public matrix_interface
      */
     [[nodiscard]] bool isSingular() const
     {
-        return !isSquare() || det() == T(0);
+        if (!isSquare())
+        {
+            return true;
+        }
+
+        if constexpr (hasExactArithmetic)
+        {
+            return bareiss(nullptr) == T(0);
+        }
+        else
+        {
+            return lu_decomposition<T, enableBoundsCheck>(*this).isSingular();
+        }
     }
 
     /**
@@ -1537,7 +2575,18 @@ class matrix : public matrix_interface
      */
     friend bool operator==(matrix<T, enableBoundsCheck> const &lhs, matrix<T, enableBoundsCheck> const &rhs)
     {
-        return lhs.m_ == rhs.m_;
+        if (lhs.sizeX_ != rhs.sizeX_ || lhs.sizeY_ != rhs.sizeY_)
+        {
+            return false;
+        }
+        for (size_t y = 0; y < lhs.sizeY_; y++)
+        {
+            if (!std::equal(lhs.rowPtr(y), lhs.rowPtr(y) + lhs.sizeX_, rhs.rowPtr(y)))
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
     /**
@@ -1569,7 +2618,7 @@ class matrix : public matrix_interface
             {
                 T val;
                 istrm >> val;
-                m(y, x) = val;
+                m(x, y) = val;
             }
         }
 
@@ -1610,6 +2659,7 @@ class matrix : public matrix_interface
      */
     long long pivot(size_t pivX, matrix<T, enableBoundsCheck> *solutions = 0)
     {
+        using std::abs;
         long long   k    = pivX;
         long double amax = 0.0L;
 
@@ -1630,10 +2680,10 @@ class matrix : public matrix_interface
 
         if (k != static_cast<long long>(pivX))
         {
-            std::swap(row(k), row(pivX));
+            swapRows(k, pivX);
             if (solutions != 0)
             {
-                std::swap(solutions->row(k), solutions->row(pivX));
+                solutions->swapRows(k, pivX);
             }
 
             return k;
@@ -1662,4 +2712,11 @@ inline void checkBounds<false>(matrix_interface const &lhs, size_t x, size_t y,
 
 }; // namespace util
 
+// det(), adj() and isSingular() are implemented with lu_decomposition
+#include "matrix_decomposition.h"
+// lazily evaluated, fused arithmetic
+#include "matrix_expression.h"
+// zero-copy blocks, rows, columns and transposes
+#include "matrix_view.h"
+
 #endif // NS_UTIL_MATRIX_H_INCLUDED
@@ -0,0 +1,783 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/matrix_batch.h
+ * Description: Batches of small matrices in structure-of-arrays layout.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_MATRIX_BATCH_H_INCLUDED
+#define NS_UTIL_MATRIX_BATCH_H_INCLUDED
+
+#include "matrix.h"
+#include "static_matrix.h"
+#include "threadutil.h"
+#include "to_string.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace util
+{
+namespace batch_detail
+{
+/**
+ * @brief Width in bytes of the vector registers of the target.
+ */
+#if defined(__AVX512F__)
+constexpr size_t vectorBytes = 64UL;
+#elif defined(__AVX__)
+constexpr size_t vectorBytes = 32UL;
+#else
+constexpr size_t vectorBytes = 16UL;
+#endif
+
+/**
+ * @brief A fixed number of scalars that behaves like a single scalar, so that a closed-form formula written for
+ * scalars is evaluated for several matrices at once. Every operator is a loop with a compile-time trip count, which
+ * the compiler turns into a single vector instruction when the pack fills exactly one vector register; wider packs
+ * no longer fit the registers and are slower. The operators are always inlined, as a formula only vectorises as a
+ * whole.
+ *
+ * @tparam T scalar value-type
+ * @tparam W number of scalars
+ */
+template <typename T, size_t W = std::max(1UL, vectorBytes / sizeof(T))>
+struct lane_pack
+{
+    static constexpr size_t width = W;
+    std::array<T, W>        v{};
+
+    constexpr lane_pack() = default;
+
+    explicit constexpr lane_pack(T const &c)
+    {
+        v.fill(c);
+    }
+
+    [[gnu::always_inline]] void load(T const *src)
+    {
+        std::copy_n(src, W, v.data());
+    }
+
+    [[gnu::always_inline]] void store(T *dst) const
+    {
+        std::copy_n(v.data(), W, dst);
+    }
+
+    [[gnu::always_inline]] constexpr lane_pack &operator+=(lane_pack const &rhs)
+    {
+        for (size_t w = 0; w < W; w++)
+        {
+            v[w] += rhs.v[w];
+        }
+        return *this;
+    }
+
+    [[gnu::always_inline]] constexpr lane_pack &operator-=(lane_pack const &rhs)
+    {
+        for (size_t w = 0; w < W; w++)
+        {
+            v[w] -= rhs.v[w];
+        }
+        return *this;
+    }
+
+    [[gnu::always_inline]] constexpr lane_pack &operator*=(lane_pack const &rhs)
+    {
+        for (size_t w = 0; w < W; w++)
+        {
+            v[w] *= rhs.v[w];
+        }
+        return *this;
+    }
+
+    [[gnu::always_inline]] constexpr lane_pack &operator/=(lane_pack const &rhs)
+    {
+        for (size_t w = 0; w < W; w++)
+        {
+            v[w] /= rhs.v[w];
+        }
+        return *this;
+    }
+
+    [[gnu::always_inline]] friend constexpr lane_pack operator+(lane_pack lhs, lane_pack const &rhs)
+    {
+        return lhs += rhs;
+    }
+
+    [[gnu::always_inline]] friend constexpr lane_pack operator-(lane_pack lhs, lane_pack const &rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    [[gnu::always_inline]] friend constexpr lane_pack operator*(lane_pack lhs, lane_pack const &rhs)
+    {
+        return lhs *= rhs;
+    }
+
+    [[gnu::always_inline]] friend constexpr lane_pack operator/(lane_pack lhs, lane_pack const &rhs)
+    {
+        return lhs /= rhs;
+    }
+
+    [[gnu::always_inline]] friend constexpr lane_pack operator-(lane_pack rhs)
+    {
+        for (size_t w = 0; w < W; w++)
+        {
+            rhs.v[w] = -rhs.v[w];
+        }
+        return rhs;
+    }
+
+    [[gnu::always_inline]] friend constexpr bool operator==(lane_pack const &lhs, lane_pack const &rhs)
+    {
+        return lhs.v == rhs.v;
+    }
+};
+}; // namespace batch_detail
+
+/**
+ * @brief A batch of many small matrices of the same dimensions, stored as structure of arrays.
+ *
+ * Element (x, y) of all matrices of the batch is stored contiguously, so an operation on the whole batch is a
+ * sequence of loops over the batch index. These loops have no dependencies between matrices and no branches and are
+ * vectorised by the compiler across matrices, whereas a loop over individual matrix objects pays for an allocation
+ * per matrix and cannot be vectorised at all.
+ * The batch is processed in blocks of blockSize matrices; the storage is padded with zero matrices to a whole number
+ * of blocks, so that the vectorised loops need no remainder handling.
+ *
+ * Inversion and solving use the closed-form adjugate of static_matrix for up to 4x4 matrices. Larger matrices are
+ * inverted one by one, which is correct but not vectorised.
+ *
+ * @tparam T    value-type
+ * @tparam Rows number of rows of each matrix, the y-dimension
+ * @tparam Cols number of columns of each matrix, the x-dimension
+ */
+template <typename T, size_t Rows, size_t Cols = Rows>
+class matrix_batch
+{
+    static_assert(Rows > 0 && Cols > 0, "matrix_batch dimensions must not be 0");
+
+  public:
+    using value_type   = T;
+    using element_type = static_matrix<T, Rows, Cols>;
+
+    /**
+     * @brief Number of matrices processed together, every element array is padded to a multiple of this.
+     */
+    static constexpr size_t blockSize = 64UL;
+
+    /**
+     * @brief Number of scalar multiply-adds above which automatic execution policy runs batch operations in parallel.
+     */
+    static constexpr size_t parallelThreshold = 1UL << 21;
+
+    /**
+     * @brief Index that stands for no matrix of the batch.
+     */
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+  private:
+    using storage_t = std::vector<T, aligned_allocator<T>>;
+
+    storage_t m_;
+    size_t    size_   = 0;
+    size_t    stride_ = 0;
+
+    template <typename, size_t, size_t>
+    friend class matrix_batch;
+
+    /**
+     * @brief Allocate zero-filled storage for count matrices.
+     */
+    void initializeData(size_t count)
+    {
+        size_   = count;
+        stride_ = std::max(blockSize, (count + blockSize - 1) / blockSize * blockSize);
+        m_.assign(stride_ * Rows * Cols, T(0));
+    }
+
+    /**
+     * @brief Pointer to element (x, y) of the first matrix of the batch.
+     */
+    T *lane(size_t x, size_t y)
+    {
+        return m_.data() + (y * Cols + x) * stride_;
+    }
+
+    /**
+     * @brief Pointer to element (x, y) of the first matrix of the batch.
+     */
+    T const *lane(size_t x, size_t y) const
+    {
+        return m_.data() + (y * Cols + x) * stride_;
+    }
+
+    /**
+     * @brief Run func(k0) for the first matrix index k0 of every block, in parallel if worthwhile.
+     */
+    template <typename Func>
+    void forBlocks(size_t work, exec_policy policy, Func func) const
+    {
+        size_t const blocks     = stride_ / blockSize;
+        auto         blockRange = [&func](size_t b0, size_t b1)
+        {
+            for (size_t b = b0; b < b1; b++)
+            {
+                func(b * blockSize);
+            }
+        };
+
+        if (use_parallel(policy, work, parallelThreshold))
+        {
+            parallel_for(0, blocks, blockRange);
+        }
+        else
+        {
+            blockRange(0, blocks);
+        }
+    }
+
+    /**
+     * @brief Throw matrixSizesIncompatible if two batches differ in the number of matrices.
+     */
+    static void assertSameSize(size_t lhs, size_t rhs, std::string const &location)
+    {
+        if (lhs != rhs)
+        {
+            throw matrixSizesIncompatible(
+                location + ": batch-sizes " + toString(lhs) + " and " + toString(rhs) + " differ"
+            );
+        }
+    }
+
+    /**
+     * @brief Throw matrixIsSingular naming the first singular matrix of the batch, judged like matrix::inv() does.
+     */
+    void assertRegular(std::string const &location) const
+    {
+        for (size_t k = 0; k < size_; k++)
+        {
+            if (get(k).toMatrix().isSingular())
+            {
+                throwSingular(location, k);
+            }
+        }
+    }
+
+    /**
+     * @brief Throw matrixIsSingular naming matrix k of the batch.
+     */
+    static void throwSingular(std::string const &location, size_t k)
+    {
+        throw matrixIsSingular(location + ": matrix " + toString(k) + " of the batch is singular");
+    }
+
+    /**
+     * @brief Throw matrixIsSingular naming the first singular matrix found by solveBlock() in any block.
+     */
+    static void assertRegular(std::vector<size_t> const &firstSingular, std::string const &location)
+    {
+        size_t const k = *std::min_element(firstSingular.begin(), firstSingular.end());
+        if (k != npos)
+        {
+            throwSingular(location, k);
+        }
+    }
+
+    /**
+     * @brief Invert the matrices of the block starting at k0 into dst, or if invert is false, solve them for rhs.
+     * The closed forms of static_matrix are evaluated on packs of matrices, so that every scalar operation of the
+     * formula becomes a short loop across matrices.
+     *
+     * Every matrix is judged by static_matrix::isSingular() from the original values, before anything is stored, so
+     * dst may be this batch; only the few matrices with a small determinant are checked with an LU decomposition.
+     *
+     * @return the index of the first singular matrix of the block, npos if there is none
+     */
+    template <size_t RhsCols, bool invert>
+    size_t solveBlock(
+        matrix_batch<T, Rows, RhsCols>       &dst,
+        matrix_batch<T, Rows, RhsCols> const *rhs,
+        size_t                                k0
+    ) const
+    {
+        using pack           = batch_detail::lane_pack<T>;
+        size_t firstSingular = npos;
+
+        for (size_t k = k0; k < k0 + blockSize; k += pack::width)
+        {
+            static_matrix<pack, Rows, Cols> m;
+            for (size_t i = 0; i < Rows * Cols; i++)
+            {
+                m.data()[i].load(m_.data() + i * stride_ + k);
+            }
+            auto const adj = m.adj();
+            pack       det(T(0));
+            for (size_t i = 0; i < Rows; i++)
+            {
+                det += m(i, 0) * adj(0, i);
+            }
+            // the zero matrices padding the last block are singular, too, but must not be reported or divided by
+            for (size_t w = 0; w < pack::width && k + w < size_; w++)
+            {
+                element_type single;
+                for (size_t i = 0; i < Rows * Cols; i++)
+                {
+                    single.data()[i] = m.data()[i].v[w];
+                }
+                if (firstSingular == npos && single.isSingular(det.v[w]))
+                {
+                    firstSingular = k + w;
+                }
+            }
+            for (size_t w = 0; w < pack::width; w++)
+            {
+                if (det.v[w] == T(0))
+                {
+                    det.v[w] = T(1);
+                }
+            }
+            pack const invDet = pack(T(1)) / det;
+
+            if constexpr (invert)
+            {
+                for (size_t i = 0; i < Rows * Cols; i++)
+                {
+                    (adj.data()[i] * invDet).store(dst.m_.data() + i * dst.stride_ + k);
+                }
+            }
+            else
+            {
+                static_matrix<pack, Rows, RhsCols> b;
+                for (size_t i = 0; i < Rows * RhsCols; i++)
+                {
+                    b.data()[i].load(rhs->m_.data() + i * rhs->stride_ + k);
+                }
+                b = adj * b;
+                for (size_t i = 0; i < Rows * RhsCols; i++)
+                {
+                    (b.data()[i] * invDet).store(dst.m_.data() + i * dst.stride_ + k);
+                }
+            }
+        }
+
+        return firstSingular;
+    }
+
+  public:
+    /**
+     * @brief Construct a batch of count matrices, all set to the same value.
+     *
+     * @param count number of matrices
+     * @param value the value of each matrix, the zero matrix by default
+     */
+    explicit matrix_batch(size_t count = 0, element_type const &value = element_type{})
+    {
+        initializeData(count);
+        if (value != element_type{})
+        {
+            for (size_t i = 0; i < Rows * Cols; i++)
+            {
+                std::fill_n(m_.data() + i * stride_, size_, value.data()[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Retrieve the number of matrices in the batch.
+     * @return the batch size
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Retrieve the horizontal extent of each matrix.
+     * @return x-dimension, the number of columns
+     */
+    [[nodiscard]] static constexpr size_t sizeX()
+    {
+        return Cols;
+    }
+
+    /**
+     * @brief Retrieve the vertical extent of each matrix.
+     * @return y-dimension, the number of rows
+     */
+    [[nodiscard]] static constexpr size_t sizeY()
+    {
+        return Rows;
+    }
+
+    /**
+     * @brief Change the number of matrices, keeping the first ones; new matrices are zero.
+     *
+     * @param count new number of matrices
+     */
+    void resize(size_t count)
+    {
+        matrix_batch reval(count);
+        size_t const keep = std::min(count, size_);
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            std::copy_n(m_.data() + i * stride_, keep, reval.m_.data() + i * reval.stride_);
+        }
+        *this = std::move(reval);
+    }
+
+    /**
+     * @brief Element (x, y) of all matrices of the batch, as a contiguous array.
+     *
+     * @param x x-coordinate (column)
+     * @param y y-coordinate (row)
+     *
+     * @return the size() values of element (x, y), indexed by the batch index
+     */
+    std::span<T> elements(size_t x, size_t y)
+    {
+        return {lane(x, y), size_};
+    }
+
+    /**
+     * @brief Element (x, y) of all matrices of the batch, as a contiguous array.
+     *
+     * @param x x-coordinate (column)
+     * @param y y-coordinate (row)
+     *
+     * @return the size() values of element (x, y), indexed by the batch index
+     */
+    std::span<T const> elements(size_t x, size_t y) const
+    {
+        return {lane(x, y), size_};
+    }
+
+    /**
+     * @brief Subscript operator to get/set individual elements, without bounds-check.
+     *
+     * @param k index of the matrix in the batch
+     * @param x x-coordinate (column)
+     * @param y y-coordinate (row)
+     *
+     * @return reference to the element
+     */
+    T &operator()(size_t k, size_t x, size_t y)
+    {
+        return lane(x, y)[k];
+    }
+
+    /**
+     * @brief Subscript operator to get individual elements, without bounds-check.
+     *
+     * @param k index of the matrix in the batch
+     * @param x x-coordinate (column)
+     * @param y y-coordinate (row)
+     *
+     * @return const reference to the element
+     */
+    T const &operator()(size_t k, size_t x, size_t y) const
+    {
+        return lane(x, y)[k];
+    }
+
+    /**
+     * @brief Gather a single matrix of the batch, without bounds-check.
+     *
+     * @param k index of the matrix in the batch
+     *
+     * @return a copy of the matrix
+     */
+    [[nodiscard]] element_type get(size_t k) const
+    {
+        element_type reval;
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            reval.data()[i] = m_[i * stride_ + k];
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Scatter a single matrix into the batch, without bounds-check.
+     *
+     * @param k index of the matrix in the batch
+     * @param value the new value of the matrix
+     */
+    void set(size_t k, element_type const &value)
+    {
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            m_[i * stride_ + k] = value.data()[i];
+        }
+    }
+
+    /**
+     * @brief Multiply the matrices of two batches pairwise into a pre-allocated destination: dst[k] = lhs[k] * rhs[k].
+     * If dst already has the size of the batches, no memory is allocated.
+     *
+     * @param dst destination, resized if necessary; may be lhs or rhs, which then costs a temporary
+     * @param lhs left-hand-side batch of Rows x Cols matrices
+     * @param rhs right-hand-side batch of Cols x RhsCols matrices
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @throw matrixSizesIncompatible if the batches differ in size
+     */
+    template <size_t RhsCols>
+    static void multiplyInto(
+        matrix_batch<T, Rows, RhsCols>       &dst,
+        matrix_batch const                   &lhs,
+        matrix_batch<T, Cols, RhsCols> const &rhs,
+        exec_policy                           policy = exec_policy::automatic
+    )
+    {
+        assertSameSize(lhs.size(), rhs.size(), "matrix_batch::multiplyInto(dst,lhs,rhs)");
+
+        if (static_cast<void const *>(&dst) == &lhs || static_cast<void const *>(&dst) == &rhs)
+        {
+            dst = multiply(lhs, rhs, policy);
+            return;
+        }
+        if (dst.size() != lhs.size())
+        {
+            dst.initializeData(lhs.size());
+        }
+        lhs.forBlocks(
+            lhs.size() * Rows * Cols * RhsCols,
+            policy,
+            [&dst, &lhs, &rhs](size_t k0)
+            {
+                for (size_t y = 0; y < Rows; y++)
+                {
+                    for (size_t x = 0; x < RhsCols; x++)
+                    {
+                        T *d = dst.lane(x, y) + k0;
+                        std::fill_n(d, blockSize, T(0));
+                        for (size_t j = 0; j < Cols; j++)
+                        {
+                            T const *a = lhs.lane(j, y) + k0;
+                            T const *b = rhs.lane(x, j) + k0;
+#pragma GCC ivdep
+                            for (size_t k = 0; k < blockSize; k++)
+                            {
+                                d[k] += a[k] * b[k];
+                            }
+                        }
+                    }
+                }
+            }
+        );
+    }
+
+    /**
+     * @brief Multiply the matrices of two batches pairwise.
+     *
+     * @param lhs left-hand-side batch of Rows x Cols matrices
+     * @param rhs right-hand-side batch of Cols x RhsCols matrices
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @return the batch of products lhs[k] * rhs[k]
+     *
+     * @throw matrixSizesIncompatible if the batches differ in size
+     */
+    template <size_t RhsCols>
+    static matrix_batch<T, Rows, RhsCols> multiply(
+        matrix_batch const                   &lhs,
+        matrix_batch<T, Cols, RhsCols> const &rhs,
+        exec_policy                           policy = exec_policy::automatic
+    )
+    {
+        matrix_batch<T, Rows, RhsCols> reval(lhs.size());
+        multiplyInto(reval, lhs, rhs, policy);
+
+        return reval;
+    }
+
+    template <size_t RhsCols>
+    friend matrix_batch<T, Rows, RhsCols> operator*(matrix_batch const &lhs, matrix_batch<T, Cols, RhsCols> const &rhs)
+    {
+        return multiply(lhs, rhs);
+    }
+
+    /**
+     * @brief Invert all matrices of the batch into a pre-allocated destination, without allocating if dst already has
+     * the size of this batch.
+     *
+     * @param dst destination, resized if necessary; may be this batch
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @throw matrixIsSingular if any matrix of the batch is singular; dst is then unspecified
+     */
+    void invInto(matrix_batch &dst, exec_policy policy = exec_policy::automatic) const
+    {
+        static_assert(Rows == Cols, "only square matrices can be inverted");
+
+        if (dst.size() != size_)
+        {
+            dst.initializeData(size_);
+        }
+        if constexpr (Rows <= 4)
+        {
+            std::vector<size_t> firstSingular(stride_ / blockSize, npos);
+            forBlocks(
+                size_ * Rows * Rows * Rows,
+                policy,
+                [this, &dst, &firstSingular](size_t k0)
+                { firstSingular[k0 / blockSize] = solveBlock<Cols, true>(dst, nullptr, k0); }
+            );
+            assertRegular(firstSingular, "matrix_batch::inv()");
+        }
+        else
+        {
+            assertRegular("matrix_batch::inv()");
+            for (size_t k = 0; k < size_; k++)
+            {
+                dst.set(k, get(k).inv());
+            }
+        }
+    }
+
+    /**
+     * @brief Invert all matrices of the batch.
+     *
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @return the batch of inverses
+     *
+     * @throw matrixIsSingular if any matrix of the batch is singular
+     */
+    matrix_batch inv(exec_policy policy = exec_policy::automatic) const
+    {
+        matrix_batch reval(size_);
+        invInto(reval, policy);
+
+        return reval;
+    }
+
+    /**
+     * @brief This operator has been used to calculate inversion of all matrices of the batch.
+     */
+    friend matrix_batch operator!(matrix_batch const &rhs)
+    {
+        return rhs.inv();
+    }
+
+    /**
+     * @brief Solve the systems of linear equations (*this)[k] * dst[k] = rhs[k] into a pre-allocated destination.
+     *
+     * @param dst destination, resized if necessary; may be rhs
+     * @param rhs batch of right-hand-sides, a single column each for vectors
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @throw matrixSizesIncompatible if the batches differ in size
+     * @throw matrixIsSingular if any matrix of the batch is singular; dst is then unspecified
+     */
+    template <size_t RhsCols>
+    void solveInto(
+        matrix_batch<T, Rows, RhsCols>       &dst,
+        matrix_batch<T, Rows, RhsCols> const &rhs,
+        exec_policy                           policy = exec_policy::automatic
+    ) const
+    {
+        static_assert(Rows == Cols, "only square systems of linear equations can be solved");
+        assertSameSize(size_, rhs.size(), "matrix_batch::solveInto(dst,rhs)");
+
+        if (dst.size() != size_)
+        {
+            dst.initializeData(size_);
+        }
+        if constexpr (Rows <= 4)
+        {
+            std::vector<size_t> firstSingular(stride_ / blockSize, npos);
+            forBlocks(
+                size_ * Rows * Rows * (Rows + RhsCols),
+                policy,
+                [this, &dst, &rhs, &firstSingular](size_t k0)
+                { firstSingular[k0 / blockSize] = solveBlock<RhsCols, false>(dst, &rhs, k0); }
+            );
+            assertRegular(firstSingular, "matrix_batch::solve()");
+        }
+        else
+        {
+            assertRegular("matrix_batch::solve()");
+            for (size_t k = 0; k < size_; k++)
+            {
+                dst.set(k, get(k).inv() * rhs.get(k));
+            }
+        }
+    }
+
+    /**
+     * @brief Solve the systems of linear equations (*this)[k] * x[k] = rhs[k].
+     *
+     * @param rhs batch of right-hand-sides, a single column each for vectors
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold multiply-adds
+     *
+     * @return the batch of solutions x
+     *
+     * @throw matrixSizesIncompatible if the batches differ in size
+     * @throw matrixIsSingular if any matrix of the batch is singular
+     */
+    template <size_t RhsCols>
+    matrix_batch<T, Rows, RhsCols> solve(
+        matrix_batch<T, Rows, RhsCols> const &rhs,
+        exec_policy                           policy = exec_policy::automatic
+    ) const
+    {
+        matrix_batch<T, Rows, RhsCols> reval(size_);
+        solveInto(reval, rhs, policy);
+
+        return reval;
+    }
+
+    friend bool operator==(matrix_batch const &lhs, matrix_batch const &rhs)
+    {
+        if (lhs.size_ != rhs.size_)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            if (!std::equal(lhs.lane(0, 0) + i * lhs.stride_,
+                            lhs.lane(0, 0) + i * lhs.stride_ + lhs.size_,
+                            rhs.lane(0, 0) + i * rhs.stride_))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    friend bool operator!=(matrix_batch const &lhs, matrix_batch const &rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+}; // namespace util
+
+#endif // NS_UTIL_MATRIX_BATCH_H_INCLUDED
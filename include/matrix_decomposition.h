@@ -0,0 +1,1166 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/matrix_decomposition.h
+ * Description: LU, Cholesky and QR factorisations of matrices that can be reused for many right-hand sides.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_MATRIX_DECOMPOSITION_H_INCLUDED
+#define NS_UTIL_MATRIX_DECOMPOSITION_H_INCLUDED
+
+#include "matrix.h"
+#include "threadutil.h"
+
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+class matrixNotPositiveDefinite : public std::logic_error
+{
+  public:
+    explicit matrixNotPositiveDefinite(std::string const &what_arg)
+        : logic_error(what_arg)
+    {
+    }
+};
+
+namespace decomposition_detail
+{
+template <typename T>
+struct is_complex : std::false_type
+{
+};
+
+template <typename R>
+struct is_complex<std::complex<R>> : std::true_type
+{
+};
+
+/**
+ * @brief Complex conjugate of a complex value, the value itself for real types.
+ */
+template <typename T>
+inline T conjugate(T const &val)
+{
+    if constexpr (is_complex<T>::value)
+    {
+        return std::conj(val);
+    }
+    else
+    {
+        return val;
+    }
+}
+
+/**
+ * @brief Absolute value as long double, for complex and real types alike.
+ */
+template <typename T>
+inline long double magnitude(T const &val)
+{
+    using std::abs;
+    return static_cast<long double>(abs(val));
+}
+
+/**
+ * @brief Rounding-residue thresholds of the rows and columns of a matrix: the largest absolute value of every row and
+ * column, times max(rows, columns) * machine epsilon.
+ *
+ * A pivot is negligible if it is within the thresholds of its original row and of its column alike. This is the
+ * criterion of matrix::inv() and matrix::solve(), so badly scaled but regular matrices such as diag(1e20, 1) are not
+ * classed as singular.
+ */
+struct scale_tolerance
+{
+    std::vector<long double> row;
+    std::vector<long double> col;
+
+    /**
+     * @brief Check whether a pivot of magnitude val from original row y and column x is rounding residue.
+     */
+    [[nodiscard]] bool negligible(long double val, size_t y, size_t x) const
+    {
+        return val <= std::min(row[y], col[x]);
+    }
+};
+
+/**
+ * @brief Compute the row and column thresholds of a.
+ */
+template <typename T, bool enableBoundsCheck>
+scale_tolerance scaleTolerance(matrix<T, enableBoundsCheck> const &a)
+{
+    long double const residue = static_cast<long double>(std::max(a.sizeX(), a.sizeY())) * machineEpsilon(T(0));
+    scale_tolerance   reval{std::vector<long double>(a.sizeY(), 0.0L), std::vector<long double>(a.sizeX(), 0.0L)};
+    for (size_t y = 0; y < a.sizeY(); y++)
+    {
+        T const *row = a.data() + y * a.stride();
+        for (size_t x = 0; x < a.sizeX(); x++)
+        {
+            long double const val = magnitude(row[x]) * residue;
+            reval.row[y]          = std::max(reval.row[y], val);
+            reval.col[x]          = std::max(reval.col[x], val);
+        }
+    }
+    return reval;
+}
+} // namespace decomposition_detail
+
+/**
+ * @brief LU decomposition with partial pivoting, P * A = L * U.
+ *
+ * The matrix is factorised once, in O(n^3); afterwards every solve for a right-hand side, the determinant and the
+ * inverse are computed from the stored factors, a solve for k right-hand sides in O(n^2 * k). L has a unit diagonal and
+ * is stored below the diagonal of the factors, U on and above it.
+ *
+ * @tparam T value-type
+ * @tparam enableBoundsCheck bounds-check setting of the matrices
+ */
+template <typename T = long double, bool enableBoundsCheck = false>
+class lu_decomposition
+{
+  public:
+    using matrix_type = matrix<T, enableBoundsCheck>;
+
+  private:
+    matrix_type         lu_;
+    std::vector<size_t> perm_;
+    bool                oddPermutation_ = false;
+    bool                singular_       = false;
+
+    T *rowPtr(size_t y)
+    {
+        return lu_.data() + y * lu_.stride();
+    }
+
+    T const *rowPtr(size_t y) const
+    {
+        return lu_.data() + y * lu_.stride();
+    }
+
+    /**
+     * @brief Factorise lu_ in place. With a parallel policy the rows below the pivot are distributed cyclically over
+     * the threads, so that the shrinking trailing matrix stays balanced, and the threads synchronise once per column.
+     */
+    void factorise(exec_policy policy)
+    {
+        size_t const      n         = lu_.sizeX();
+        decomposition_detail::scale_tolerance const tolerance = decomposition_detail::scaleTolerance(lu_);
+
+        // choose the pivot of column k and swap it into row k; a pivot that is negligible against its original row
+        // and column marks the matrix as singular but is still eliminated, so that det() remains the product of the
+        // actual pivots; false if the column is exactly zero
+        auto selectPivot = [this, n, &tolerance](size_t k) noexcept
+        {
+            size_t      pivRow = k;
+            long double amax   = 0.0L;
+            for (size_t y = k; y < n; y++)
+            {
+                long double const val = decomposition_detail::magnitude(rowPtr(y)[k]);
+                if (val > amax)
+                {
+                    amax   = val;
+                    pivRow = y;
+                }
+            }
+            if (tolerance.negligible(amax, perm_[pivRow], k))
+            {
+                singular_ = true;
+            }
+            if (rowPtr(pivRow)[k] == T(0))
+            {
+                return false;
+            }
+            if (pivRow != k)
+            {
+                std::swap_ranges(rowPtr(k), rowPtr(k) + n, rowPtr(pivRow));
+                std::swap(perm_[k], perm_[pivRow]);
+                oddPermutation_ = !oddPermutation_;
+            }
+            return true;
+        };
+
+        // eliminate column k from every step-th row below the pivot, starting with row k + 1 + first
+        auto eliminate = [this, n](size_t k, size_t first, size_t step)
+        {
+            T const *pivotRow = rowPtr(k);
+            for (size_t y = k + 1 + first; y < n; y += step)
+            {
+                T      *row    = rowPtr(y);
+                T const factor = row[k] / pivotRow[k];
+                row[k]         = factor;
+                if (factor == T(0))
+                {
+                    continue;
+                }
+                for (size_t x = k + 1; x < n; x++)
+                {
+                    row[x] -= factor * pivotRow[x];
+                }
+            }
+        };
+
+        size_t const numThreads = std::min(parallel_thread_count(), n);
+        if (numThreads <= 1 || !use_parallel(policy, n * n * n / 3, matrix_type::parallelThreshold))
+        {
+            for (size_t k = 0; k < n; k++)
+            {
+                if (selectPivot(k))
+                {
+                    eliminate(k, 0, 1);
+                }
+            }
+            return;
+        }
+
+        size_t k          = 0;
+        bool   hasPivot   = selectPivot(0);
+        auto   nextColumn = [&k, &hasPivot, &selectPivot, n]() noexcept
+        {
+            k++;
+            hasPivot = k < n && selectPivot(k);
+        };
+        std::barrier sync(static_cast<std::ptrdiff_t>(numThreads), nextColumn);
+        run_on_threads(
+            numThreads,
+            [&](size_t t, size_t threads)
+            {
+                while (k < n)
+                {
+                    if (hasPivot)
+                    {
+                        eliminate(k, t, threads);
+                    }
+                    sync.arrive_and_wait();
+                }
+            }
+        );
+    }
+
+  public:
+    /**
+     * @brief Factorise a square matrix.
+     *
+     * @param a the matrix, moved in to factorise it in place without a copy
+     * @param policy execution policy, automatic runs in parallel above matrix::parallelThreshold multiply-adds
+     *
+     * @throw matrixMustBeSquare
+     */
+    explicit lu_decomposition(matrix_type a, exec_policy policy = exec_policy::automatic)
+        : lu_(std::move(a))
+        , perm_(lu_.sizeY())
+    {
+        matrix_type::assertSquare(lu_, "lu_decomposition<T,enableBoundsCheck>::lu_decomposition(a)");
+        std::iota(perm_.begin(), perm_.end(), size_t{0});
+        factorise(policy);
+    }
+
+    /**
+     * @brief Retrieve the dimension of the factorised matrix.
+     * @return the number of rows and columns
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return lu_.sizeX();
+    }
+
+    /**
+     * @brief Check whether the factorised matrix is (numerically) singular.
+     * @return true if so, false otherwise
+     */
+    [[nodiscard]] bool isSingular() const
+    {
+        return singular_;
+    }
+
+    /**
+     * @brief Retrieve the combined factors: L strictly below the diagonal, U on and above it.
+     * @return the factors
+     */
+    matrix_type const &factors() const
+    {
+        return lu_;
+    }
+
+    /**
+     * @brief Retrieve the row permutation: row y of L * U is row permutation()[y] of the original matrix.
+     * @return the permutation
+     */
+    std::vector<size_t> const &permutation() const
+    {
+        return perm_;
+    }
+
+    /**
+     * @brief Retrieve the unit lower triangular factor L.
+     * @return L
+     */
+    matrix_type lower() const
+    {
+        matrix_type reval = matrix_type::scalar(size(), T(1.0L));
+        for (size_t y = 1; y < size(); y++)
+        {
+            std::copy(rowPtr(y), rowPtr(y) + y, reval.data() + y * reval.stride());
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Retrieve the upper triangular factor U.
+     * @return U
+     */
+    matrix_type upper() const
+    {
+        matrix_type reval(size(), size());
+        for (size_t y = 0; y < size(); y++)
+        {
+            std::copy(rowPtr(y) + y, rowPtr(y) + size(), reval.data() + y * reval.stride() + y);
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Solve A * X = b from the stored factors, by forward and back substitution.
+     *
+     * @param b right-hand sides, one per column
+     *
+     * @return X
+     *
+     * @throw matrixSizesIncompatible, matrixIsSingular
+     */
+    matrix_type solve(matrix_type const &b) const
+    {
+        matrix_type::assertCompatibleSizes(
+            lu_,
+            b,
+            operType::MatrixSolve,
+            "lu_decomposition<T,enableBoundsCheck>::solve(b)"
+        );
+        if (singular_)
+        {
+            throw matrixIsSingular("lu_decomposition<T,enableBoundsCheck>::solve(b): Singular matrix!");
+        }
+
+        size_t const n    = size();
+        size_t const cols = b.sizeX();
+        matrix_type  reval(cols, n);
+        auto         xRow = [&reval](size_t y) { return reval.data() + y * reval.stride(); };
+
+        // forward substitution L * Y = P * b, rows of Y are linear combinations of whole rows
+        for (size_t y = 0; y < n; y++)
+        {
+            T const *bRow = b.data() + perm_[y] * b.stride();
+            T       *row  = xRow(y);
+            std::copy(bRow, bRow + cols, row);
+            T const *l = rowPtr(y);
+            for (size_t k = 0; k < y; k++)
+            {
+                if (l[k] != T(0))
+                {
+                    T const *src = xRow(k);
+                    for (size_t x = 0; x < cols; x++)
+                    {
+                        row[x] -= l[k] * src[x];
+                    }
+                }
+            }
+        }
+
+        // back substitution U * X = Y
+        for (size_t y = n; y-- > 0;)
+        {
+            T       *row = xRow(y);
+            T const *u   = rowPtr(y);
+            for (size_t k = y + 1; k < n; k++)
+            {
+                if (u[k] != T(0))
+                {
+                    T const *src = xRow(k);
+                    for (size_t x = 0; x < cols; x++)
+                    {
+                        row[x] -= u[k] * src[x];
+                    }
+                }
+            }
+            for (size_t x = 0; x < cols; x++)
+            {
+                row[x] /= u[y];
+            }
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the determinant from the diagonal of U, in O(n). The pivots are not thresholded, so a matrix
+     * for which isSingular() holds can still have a small non-zero determinant.
+     * @return the product of the pivots, with the sign of the row permutation
+     */
+    T det() const
+    {
+        T reval = oddPermutation_ ? T(-1.0L) : T(1.0L);
+        for (size_t k = 0; k < size(); k++)
+        {
+            reval *= rowPtr(k)[k];
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the inverse by solving for the unit matrix.
+     *
+     * @return the inverse
+     *
+     * @throw matrixIsSingular
+     */
+    matrix_type inv() const
+    {
+        return solve(matrix_type::scalar(size(), T(1.0L)));
+    }
+};
+
+/**
+ * @brief Cholesky decomposition A = L * L^H of a symmetric (hermitian) positive definite matrix.
+ *
+ * Only the lower triangle of A is read. The factorisation costs about half as much as an LU decomposition and needs
+ * no pivoting; solves for k right-hand sides take O(n^2 * k).
+ *
+ * @tparam T value-type, real or complex
+ * @tparam enableBoundsCheck bounds-check setting of the matrices
+ */
+template <typename T = long double, bool enableBoundsCheck = false>
+class cholesky
+{
+  public:
+    using matrix_type = matrix<T, enableBoundsCheck>;
+
+  private:
+    matrix_type l_;
+
+    T *rowPtr(size_t y)
+    {
+        return l_.data() + y * l_.stride();
+    }
+
+    T const *rowPtr(size_t y) const
+    {
+        return l_.data() + y * l_.stride();
+    }
+
+  public:
+    /**
+     * @brief Factorise a symmetric (hermitian) positive definite matrix.
+     *
+     * @param a the matrix, moved in to factorise it in place without a copy
+     *
+     * @throw matrixMustBeSquare, matrixNotPositiveDefinite
+     */
+    explicit cholesky(matrix_type a)
+        : l_(std::move(a))
+    {
+        using decomposition_detail::conjugate;
+        using std::sqrt;
+
+        matrix_type::assertSquare(l_, "cholesky<T,enableBoundsCheck>::cholesky(a)");
+        size_t const                              n         = l_.sizeX();
+        decomposition_detail::scale_tolerance const tolerance = decomposition_detail::scaleTolerance(l_);
+
+        for (size_t j = 0; j < n; j++)
+        {
+            T *rowJ = rowPtr(j);
+
+            // diagonal: a(j,j) - |L(j,0..j)|^2 must be real and positive
+            T diag = rowJ[j];
+            for (size_t k = 0; k < j; k++)
+            {
+                diag -= rowJ[k] * conjugate(rowJ[k]);
+            }
+            long double const realDiag = static_cast<long double>(std::real(std::complex<long double>(diag)));
+            if (tolerance.negligible(realDiag, j, j))
+            {
+                throw matrixNotPositiveDefinite(
+                    "cholesky<T,enableBoundsCheck>::cholesky(a): matrix is not positive definite"
+                );
+            }
+            rowJ[j] = T(sqrt(realDiag));
+            std::fill(rowJ + j + 1, rowJ + n, T(0));
+
+            // column j below the diagonal, each a dot product of two contiguous row prefixes
+            for (size_t i = j + 1; i < n; i++)
+            {
+                T *rowI = rowPtr(i);
+                T  sum  = rowI[j];
+                for (size_t k = 0; k < j; k++)
+                {
+                    sum -= rowI[k] * conjugate(rowJ[k]);
+                }
+                rowI[j] = sum / rowJ[j];
+            }
+        }
+    }
+
+    /**
+     * @brief Retrieve the dimension of the factorised matrix.
+     * @return the number of rows and columns
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return l_.sizeX();
+    }
+
+    /**
+     * @brief Retrieve the lower triangular factor L.
+     * @return L
+     */
+    matrix_type const &lower() const
+    {
+        return l_;
+    }
+
+    /**
+     * @brief Solve A * X = b from the stored factor, by forward substitution with L and back substitution with L^H.
+     *
+     * @param b right-hand sides, one per column
+     *
+     * @return X
+     *
+     * @throw matrixSizesIncompatible
+     */
+    matrix_type solve(matrix_type const &b) const
+    {
+        using decomposition_detail::conjugate;
+
+        matrix_type::assertCompatibleSizes(l_, b, operType::MatrixSolve, "cholesky<T,enableBoundsCheck>::solve(b)");
+
+        size_t const n     = size();
+        size_t const cols  = b.sizeX();
+        matrix_type  reval = b;
+        auto         xRow  = [&reval](size_t y) { return reval.data() + y * reval.stride(); };
+
+        for (size_t y = 0; y < n; y++)
+        {
+            T       *row = xRow(y);
+            T const *l   = rowPtr(y);
+            for (size_t k = 0; k < y; k++)
+            {
+                T const *src = xRow(k);
+                for (size_t x = 0; x < cols; x++)
+                {
+                    row[x] -= l[k] * src[x];
+                }
+            }
+            for (size_t x = 0; x < cols; x++)
+            {
+                row[x] /= l[y];
+            }
+        }
+
+        // L^H is upper triangular, its row y is the conjugated column y of L
+        for (size_t y = n; y-- > 0;)
+        {
+            T *row = xRow(y);
+            for (size_t k = y + 1; k < n; k++)
+            {
+                T const  lky = conjugate(rowPtr(k)[y]);
+                T const *src = xRow(k);
+                for (size_t x = 0; x < cols; x++)
+                {
+                    row[x] -= lky * src[x];
+                }
+            }
+            for (size_t x = 0; x < cols; x++)
+            {
+                row[x] /= rowPtr(y)[y];
+            }
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the determinant as the squared product of the diagonal of L, in O(n).
+     * @return the determinant
+     */
+    T det() const
+    {
+        T reval = T(1.0L);
+        for (size_t k = 0; k < size(); k++)
+        {
+            reval *= rowPtr(k)[k] * rowPtr(k)[k];
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the inverse by solving for the unit matrix.
+     * @return the inverse
+     */
+    matrix_type inv() const
+    {
+        return solve(matrix_type::scalar(size(), T(1.0L)));
+    }
+};
+
+/**
+ * @brief QR decomposition A = Q * R by Householder reflections.
+ *
+ * A may have more rows than columns; solve() then returns the least-squares solution. R is stored on and above the
+ * diagonal, the Householder vectors below it, with their first elements and scale factors kept separately. Q is never
+ * formed explicitly unless q() is called.
+ *
+ * @tparam T value-type, real or complex
+ * @tparam enableBoundsCheck bounds-check setting of the matrices
+ */
+template <typename T = long double, bool enableBoundsCheck = false>
+class qr
+{
+  public:
+    using matrix_type = matrix<T, enableBoundsCheck>;
+
+  private:
+    matrix_type    qr_;
+    std::vector<T> vHead_;
+    std::vector<T> beta_;
+    size_t         reflections_   = 0;
+    bool           rankDeficient_ = false;
+
+    T *rowPtr(size_t y)
+    {
+        return qr_.data() + y * qr_.stride();
+    }
+
+    T const *rowPtr(size_t y) const
+    {
+        return qr_.data() + y * qr_.stride();
+    }
+
+    /**
+     * @brief Apply the reflections H(k) = I - beta(k) * v(k) * v(k)^H, in the given order, to the columns of b.
+     */
+    void applyReflections(matrix_type &b, bool reverse) const
+    {
+        using decomposition_detail::conjugate;
+
+        size_t const   rows  = qr_.sizeY();
+        size_t const   steps = beta_.size();
+        size_t const   cols  = b.sizeX();
+        std::vector<T> dots(cols);
+        for (size_t s = 0; s < steps; s++)
+        {
+            size_t const k = reverse ? steps - 1 - s : s;
+            if (beta_[k] == T(0))
+            {
+                continue;
+            }
+            // dots = v^H * b, accumulated row by row so that b is read contiguously
+            std::fill(dots.begin(), dots.end(), T(0));
+            for (size_t i = k; i < rows; i++)
+            {
+                T const  vi   = conjugate(i == k ? vHead_[k] : rowPtr(i)[k]);
+                T const *bRow = b.data() + i * b.stride();
+                for (size_t x = 0; x < cols; x++)
+                {
+                    dots[x] += vi * bRow[x];
+                }
+            }
+            for (size_t i = k; i < rows; i++)
+            {
+                T const vi   = beta_[k] * (i == k ? vHead_[k] : rowPtr(i)[k]);
+                T      *bRow = b.data() + i * b.stride();
+                for (size_t x = 0; x < cols; x++)
+                {
+                    bRow[x] -= vi * dots[x];
+                }
+            }
+        }
+    }
+
+  public:
+    /**
+     * @brief Factorise a matrix with at least as many rows as columns.
+     *
+     * @param a the matrix, moved in to factorise it in place without a copy
+     *
+     * @throw matrixSizesIncompatible
+     */
+    explicit qr(matrix_type a)
+        : qr_(std::move(a))
+    {
+        using decomposition_detail::conjugate;
+        using decomposition_detail::magnitude;
+        using std::sqrt;
+
+        size_t const rows = qr_.sizeY();
+        size_t const cols = qr_.sizeX();
+        if (rows < cols)
+        {
+            throw matrixSizesIncompatible(
+                "qr<T,enableBoundsCheck>::qr(a): matrix needs at least as many rows as columns, but has " +
+                toString(rows) + " rows and " + toString(cols) + " columns."
+            );
+        }
+        decomposition_detail::scale_tolerance const tolerance = decomposition_detail::scaleTolerance(qr_);
+        size_t const                              steps     = std::min(rows - 1, cols);
+        vHead_.assign(steps, T(0));
+        beta_.assign(steps, T(0));
+        std::vector<T> dots(cols);
+
+        for (size_t k = 0; k < steps; k++)
+        {
+            long double norm2 = 0.0L;
+            for (size_t i = k; i < rows; i++)
+            {
+                long double const m = magnitude(rowPtr(i)[k]);
+                norm2 += m * m;
+            }
+            if (norm2 == 0.0L)
+            {
+                continue;
+            }
+
+            // alpha has the opposite phase of x0, so that v0 = x0 - alpha does not cancel
+            long double const norm  = sqrt(norm2);
+            T const           x0    = rowPtr(k)[k];
+            long double const absX0 = magnitude(x0);
+            T const           phase = absX0 == 0.0L ? T(1.0L) : T(x0 / T(absX0));
+            T const           alpha = -phase * T(norm);
+            vHead_[k]               = x0 - alpha;
+            beta_[k]                = T(1.0L / (norm2 + norm * absX0));
+            reflections_++;
+
+            // apply H(k) to the columns right of k, reading the rows contiguously
+            std::fill(dots.begin() + k + 1, dots.end(), T(0));
+            for (size_t i = k; i < rows; i++)
+            {
+                T const *row = rowPtr(i);
+                T const  vi  = conjugate(i == k ? vHead_[k] : row[k]);
+                for (size_t x = k + 1; x < cols; x++)
+                {
+                    dots[x] += vi * row[x];
+                }
+            }
+            for (size_t i = k; i < rows; i++)
+            {
+                T      *row = rowPtr(i);
+                T const vi  = beta_[k] * (i == k ? vHead_[k] : row[k]);
+                for (size_t x = k + 1; x < cols; x++)
+                {
+                    row[x] -= vi * dots[x];
+                }
+            }
+            rowPtr(k)[k] = alpha;
+        }
+
+        // the reflections mix the rows, so a diagonal element of R is only measured against its column
+        for (size_t k = 0; k < cols; k++)
+        {
+            if (magnitude(rowPtr(k)[k]) <= tolerance.col[k])
+            {
+                rankDeficient_ = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Check whether the columns of the factorised matrix are (numerically) linearly dependent.
+     * @return true if so, false otherwise
+     */
+    [[nodiscard]] bool isRankDeficient() const
+    {
+        return rankDeficient_;
+    }
+
+    /**
+     * @brief Form the orthogonal (unitary) factor Q explicitly.
+     * @return the sizeY() x sizeY() matrix Q
+     */
+    matrix_type q() const
+    {
+        matrix_type reval = matrix_type::scalar(qr_.sizeY(), T(1.0L));
+        applyReflections(reval, true);
+
+        return reval;
+    }
+
+    /**
+     * @brief Retrieve the upper triangular factor R.
+     * @return the sizeY() x sizeX() matrix R
+     */
+    matrix_type r() const
+    {
+        matrix_type reval(qr_.sizeX(), qr_.sizeY());
+        for (size_t y = 0; y < std::min(qr_.sizeX(), qr_.sizeY()); y++)
+        {
+            std::copy(rowPtr(y) + y, rowPtr(y) + qr_.sizeX(), reval.data() + y * reval.stride() + y);
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Solve A * X = b, in the least-squares sense if A has more rows than columns.
+     *
+     * @param b right-hand sides, one per column
+     *
+     * @return X
+     *
+     * @throw matrixSizesIncompatible, matrixIsSingular
+     */
+    matrix_type solve(matrix_type const &b) const
+    {
+        matrix_type::assertCompatibleSizes(qr_, b, operType::MatrixSolve, "qr<T,enableBoundsCheck>::solve(b)");
+        if (rankDeficient_)
+        {
+            throw matrixIsSingular("qr<T,enableBoundsCheck>::solve(b): matrix is rank deficient!");
+        }
+
+        size_t const n    = qr_.sizeX();
+        size_t const cols = b.sizeX();
+        matrix_type  qhb  = b;
+        applyReflections(qhb, false);
+
+        matrix_type reval(cols, n);
+        for (size_t y = n; y-- > 0;)
+        {
+            T       *row = reval.data() + y * reval.stride();
+            T const *r   = rowPtr(y);
+            std::copy(qhb.data() + y * qhb.stride(), qhb.data() + y * qhb.stride() + cols, row);
+            for (size_t k = y + 1; k < n; k++)
+            {
+                T const *src = reval.data() + k * reval.stride();
+                for (size_t x = 0; x < cols; x++)
+                {
+                    row[x] -= r[k] * src[x];
+                }
+            }
+            for (size_t x = 0; x < cols; x++)
+            {
+                row[x] /= r[y];
+            }
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the determinant of a square matrix from the diagonal of R; every reflection contributes -1. The
+     * diagonal is not thresholded, isRankDeficient() can hold for a small non-zero determinant.
+     *
+     * @return the determinant
+     *
+     * @throw matrixMustBeSquare
+     */
+    T det() const
+    {
+        matrix_type::assertSquare(qr_, "qr<T,enableBoundsCheck>::det()");
+
+        T reval = reflections_ % 2 == 1 ? T(-1.0L) : T(1.0L);
+        for (size_t k = 0; k < qr_.sizeX(); k++)
+        {
+            reval *= rowPtr(k)[k];
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the inverse of a square matrix by solving for the unit matrix.
+     *
+     * @return the inverse
+     *
+     * @throw matrixMustBeSquare, matrixIsSingular
+     */
+    matrix_type inv() const
+    {
+        matrix_type::assertSquare(qr_, "qr<T,enableBoundsCheck>::inv()");
+
+        return solve(matrix_type::scalar(qr_.sizeX(), T(1.0L)));
+    }
+};
+
+/**
+ * @brief Eigen-decomposition A = V * D * V^T of a real symmetric matrix by cyclic Jacobi rotations.
+ *
+ * Only the lower triangle of A is read. The decomposition costs O(n^3) per sweep and typically converges in well under
+ * ten sweeps; afterwards any function of A, such as a real power or the exponential, costs one diagonal scaling and
+ * one matrix product: f(A) = V * f(D) * V^T. The eigenvalues are sorted in ascending order.
+ *
+ * @tparam T value-type, real
+ * @tparam enableBoundsCheck bounds-check setting of the matrices
+ */
+template <typename T = long double, bool enableBoundsCheck = false>
+class symmetric_eigen
+{
+    static_assert(!decomposition_detail::is_complex<T>::value, "symmetric_eigen is only defined for real matrices");
+
+  public:
+    using matrix_type = matrix<T, enableBoundsCheck>;
+
+    /**
+     * Upper limit of Jacobi sweeps; convergence is quadratic, so this is never reached in practice.
+     */
+    static constexpr size_t maxSweeps = 64;
+
+  private:
+    std::vector<T> values_;
+    matrix_type    w_; // the eigenvectors in rows, W = V^T, so that rotations update two contiguous rows
+    size_t         sweeps_ = 0;
+
+    T *rowPtr(size_t y)
+    {
+        return w_.data() + y * w_.stride();
+    }
+
+    /**
+     * @brief Rotate rows p and q of a row-major block by the Jacobi rotation (c, s), with tau = s / (1 + c).
+     */
+    static void rotateRows(T *rowP, T *rowQ, size_t n, T s, T tau)
+    {
+        for (size_t r = 0; r < n; r++)
+        {
+            T const ap = rowP[r];
+            T const aq = rowQ[r];
+            rowP[r]    = ap - s * (aq + tau * ap);
+            rowQ[r]    = aq + s * (ap - tau * aq);
+        }
+    }
+
+  public:
+    /**
+     * @brief Decompose a real symmetric matrix.
+     *
+     * @param a the matrix, moved in to use it as work space without a copy
+     *
+     * @throw matrixMustBeSquare
+     */
+    explicit symmetric_eigen(matrix_type a)
+    {
+        using std::abs;
+        using std::sqrt;
+
+        matrix_type::assertSquare(a, "symmetric_eigen<T,enableBoundsCheck>::symmetric_eigen(a)");
+        size_t const n = a.sizeX();
+        auto         A = [&a](size_t x, size_t y) -> T & { return a.data()[y * a.stride() + x]; };
+
+        // mirror the lower triangle and measure the matrix for the convergence test
+        long double norm2 = 0.0L;
+        for (size_t y = 0; y < n; y++)
+        {
+            for (size_t x = 0; x < y; x++)
+            {
+                A(y, x) = A(x, y);
+                norm2 += 2.0L * static_cast<long double>(A(x, y) * A(x, y));
+            }
+            norm2 += static_cast<long double>(A(y, y) * A(y, y));
+        }
+        long double const eps = machineEpsilon(T(0));
+        w_                    = matrix_type::scalar(n, T(1.0L));
+
+        for (sweeps_ = 0; sweeps_ < maxSweeps; sweeps_++)
+        {
+            long double off = 0.0L;
+            for (size_t q = 1; q < n; q++)
+            {
+                for (size_t p = 0; p < q; p++)
+                {
+                    off += 2.0L * static_cast<long double>(A(q, p) * A(q, p));
+                }
+            }
+            if (off <= eps * eps * norm2)
+            {
+                break;
+            }
+
+            for (size_t p = 0; p + 1 < n; p++)
+            {
+                for (size_t q = p + 1; q < n; q++)
+                {
+                    T const apq = A(q, p);
+                    if (apq == T(0))
+                    {
+                        continue;
+                    }
+                    // the rotation that annihilates a(p,q), taking the smaller angle for stability
+                    T const theta = (A(q, q) - A(p, p)) / (T(2) * apq);
+                    T const t     = (theta >= T(0) ? T(1) : T(-1)) / (abs(theta) + sqrt(theta * theta + T(1)));
+                    T const c     = T(1) / sqrt(t * t + T(1));
+                    T const s     = t * c;
+                    T const tau   = s / (T(1) + c);
+
+                    // rotate the contiguous rows p and q, then mirror them into columns p and q; the 2x2 block at
+                    // the intersection is set directly
+                    T const app = A(p, p);
+                    T const aqq = A(q, q);
+                    rotateRows(a.data() + p * a.stride(), a.data() + q * a.stride(), n, s, tau);
+                    for (size_t r = 0; r < n; r++)
+                    {
+                        A(p, r) = A(r, p);
+                        A(q, r) = A(r, q);
+                    }
+                    A(p, p) = app - t * apq;
+                    A(q, q) = aqq + t * apq;
+                    A(q, p) = T(0);
+                    A(p, q) = T(0);
+                    rotateRows(rowPtr(p), rowPtr(q), n, s, tau);
+                }
+            }
+        }
+
+        // sort ascending, together with the eigenvectors
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&A](size_t i, size_t j) { return A(i, i) < A(j, j); });
+        matrix_type sorted(n, n);
+        values_.resize(n);
+        for (size_t k = 0; k < n; k++)
+        {
+            values_[k] = A(order[k], order[k]);
+            std::copy(rowPtr(order[k]), rowPtr(order[k]) + n, sorted.data() + k * sorted.stride());
+        }
+        w_ = std::move(sorted);
+    }
+
+    /**
+     * @brief Retrieve the dimension of the decomposed matrix.
+     * @return the number of rows and columns
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return values_.size();
+    }
+
+    /**
+     * @brief Retrieve the number of Jacobi sweeps the decomposition took.
+     */
+    [[nodiscard]] size_t sweeps() const
+    {
+        return sweeps_;
+    }
+
+    /**
+     * @brief Retrieve the eigenvalues in ascending order.
+     */
+    std::vector<T> const &eigenvalues() const
+    {
+        return values_;
+    }
+
+    /**
+     * @brief Retrieve the orthonormal eigenvectors V: column k belongs to eigenvalues()[k].
+     */
+    matrix_type eigenvectors() const
+    {
+        return ~w_;
+    }
+
+    /**
+     * @brief Apply a function to the matrix through its eigenvalues: f(A) = V * f(D) * V^T.
+     *
+     * @param f function of a single eigenvalue
+     * @param policy execution policy for the matrix product
+     *
+     * @return f(A)
+     */
+    template <typename Func>
+    matrix_type function(Func &&f, exec_policy policy = exec_policy::automatic) const
+    {
+        size_t const n = size();
+        matrix_type  scaled(w_);
+        for (size_t k = 0; k < n; k++)
+        {
+            T const fk  = f(values_[k]);
+            T      *row = scaled.data() + k * scaled.stride();
+            for (size_t x = 0; x < n; x++)
+            {
+                row[x] *= fk;
+            }
+        }
+
+        return matrix_type::multiply(~w_, scaled, policy);
+    }
+
+    /**
+     * @brief Raise the matrix to a real power. Every further power of the same matrix costs one diagonal scaling and
+     * one product, independent of the size of the exponent.
+     *
+     * @param p the power, may be negative or fractional
+     * @param policy execution policy for the matrix product
+     *
+     * @return A ^ p
+     *
+     * @throw matrixNotPositiveDefinite if p is fractional and A has a negative eigenvalue,
+     *        matrixIsSingular if p is negative and A has a zero eigenvalue
+     */
+    matrix_type pow(T p, exec_policy policy = exec_policy::automatic) const
+    {
+        using std::floor;
+
+        bool const integral = floor(p) == p;
+        for (T const &lambda : values_)
+        {
+            if (!integral && lambda < T(0))
+            {
+                throw matrixNotPositiveDefinite(
+                    "symmetric_eigen<T,enableBoundsCheck>::pow(p): fractional power of a matrix with negative "
+                    "eigenvalues"
+                );
+            }
+            if (p < T(0) && lambda == T(0))
+            {
+                throw matrixIsSingular(
+                    "symmetric_eigen<T,enableBoundsCheck>::pow(p): negative power of a singular matrix"
+                );
+            }
+        }
+
+        return function([p](T const &lambda) { return T(std::pow(lambda, p)); }, policy);
+    }
+
+    /**
+     * @brief Calculate the matrix exponential exp(t * A).
+     *
+     * @param t factor of the matrix, e.g. the time in exp(t * A) * x0, the solution of x' = A * x
+     * @param policy execution policy for the matrix product
+     *
+     * @return exp(t * A)
+     */
+    matrix_type exp(T t = T(1.0L), exec_policy policy = exec_policy::automatic) const
+    {
+        return function([t](T const &lambda) { return T(std::exp(t * lambda)); }, policy);
+    }
+};
+}; // namespace util
+
+#endif // NS_UTIL_MATRIX_DECOMPOSITION_H_INCLUDED
@@ -0,0 +1,555 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/matrix_expression.h
+ * Description: Expression templates for lazily evaluated matrix arithmetic.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_MATRIX_EXPRESSION_H_INCLUDED
+#define NS_UTIL_MATRIX_EXPRESSION_H_INCLUDED
+
+#include "matrix.h"
+#include "threadutil.h"
+#include "to_string.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace util
+{
+/**
+ * @brief Base of all lazily evaluated matrix expressions.
+ *
+ * The arithmetic operators of matrix return a new matrix for every operator, so a chain like
+ * A * B + C - D * 2.0 creates a temporary for each step. Starting the chain with lazy() builds an expression tree
+ * instead, that is evaluated when it is assigned to a matrix: all element-wise operations are fused into a single
+ * loop over the result, without intermediate matrices. Matrix products are kept as dedicated nodes, that are
+ * calculated up front with the blocked GEMM kernel, and then read like any other operand.
+ *
+ * Only operators with an expression operand are lazy, so a sub-expression of plain matrices, like d * 2.0, needs its
+ * own lazy(). Expressions hold references to the matrices they were built from, so they must be evaluated before
+ * these go out of scope. Note that auto deduces the expression type, not a matrix:
+ * @code
+ * matrix<double> r = lazy(a) * b + c - lazy(d) * 2.0; // one GEMM and one fused loop
+ * auto           e = lazy(a) + b;                     // an expression, evaluate with e.eval()
+ * @endcode
+ *
+ * @tparam Derived the concrete expression type
+ */
+template <typename Derived>
+class matrix_expression
+{
+  public:
+    /**
+     * @brief Downcast to the concrete expression.
+     * @return the derived expression
+     */
+    Derived const &derived() const
+    {
+        return static_cast<Derived const &>(*this);
+    }
+
+    /**
+     * @brief Evaluate the expression into a new matrix.
+     *
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     *
+     * @return the result matrix
+     */
+    auto eval(exec_policy policy = exec_policy::automatic) const
+    {
+        typename Derived::matrix_type reval;
+        reval.assign(*this, policy);
+
+        return reval;
+    }
+};
+
+namespace expression_detail
+{
+/**
+ * @brief Assert that two operands of an element-wise operation have the same dimensions.
+ * @throw matrixSizesIncompatible
+ */
+inline void assertSameSize(size_t lhsX, size_t lhsY, size_t rhsX, size_t rhsY, std::string const &location)
+{
+    if (lhsX != rhsX || lhsY != rhsY)
+    {
+        throw matrixSizesIncompatible(
+            location + ": matrix-size lhs (" + toString(lhsX) + "," + toString(lhsY) +
+            ") is not equal matrix-size rhs(" + toString(rhsX) + "," + toString(rhsY) + ")."
+        );
+    }
+}
+
+/**
+ * @brief Operation that puts the scalar on the left-hand side: c * m instead of m * c.
+ */
+template <typename Op>
+struct scalar_first
+{
+    template <typename T>
+    T operator()(T const &val, T const &c) const
+    {
+        return Op{}(c, val);
+    }
+};
+}; // namespace expression_detail
+
+/**
+ * @brief Leaf of an expression: a reference to an existing matrix.
+ */
+template <typename T, bool enableBoundsCheck>
+class matrix_ref : public matrix_expression<matrix_ref<T, enableBoundsCheck>>
+{
+  public:
+    using value_type                = T;
+    using matrix_type               = matrix<T, enableBoundsCheck>;
+    static constexpr bool isLeaf    = true;
+    static constexpr bool isProduct = false;
+
+  private:
+    matrix_type const *matrix_;
+    T const           *data_;
+    size_t             stride_;
+
+  public:
+    explicit matrix_ref(matrix_type const &m)
+        : matrix_(&m)
+        , data_(m.data())
+        , stride_(m.stride())
+    {
+    }
+
+    [[nodiscard]] size_t sizeX() const
+    {
+        return matrix_->sizeX();
+    }
+
+    [[nodiscard]] size_t sizeY() const
+    {
+        return matrix_->sizeY();
+    }
+
+    /**
+     * @brief The referenced matrix.
+     */
+    matrix_type const &get() const
+    {
+        return *matrix_;
+    }
+
+    T operator()(size_t x, size_t y) const
+    {
+        return data_[y * stride_ + x];
+    }
+
+    void prepare(exec_policy) const
+    {
+    }
+
+    /**
+     * @brief Check whether the referenced matrix shares memory with a strided destination, other than element for
+     * element in the same layout.
+     */
+    bool aliases(T const *data, size_t xDim, size_t yDim, size_t rowStride, size_t colStride) const
+    {
+        return matrix_view<T, enableBoundsCheck>(*matrix_).aliases(data, xDim, yDim, rowStride, colStride);
+    }
+};
+
+/**
+ * @brief Element-wise combination of two expressions of equal size, like sum and difference.
+ */
+template <typename Lhs, typename Rhs, typename Op>
+class matrix_binary_expr : public matrix_expression<matrix_binary_expr<Lhs, Rhs, Op>>
+{
+  public:
+    using value_type                = typename Lhs::value_type;
+    using matrix_type               = typename Lhs::matrix_type;
+    static constexpr bool isLeaf    = false;
+    static constexpr bool isProduct = false;
+    static_assert(std::is_same_v<matrix_type, typename Rhs::matrix_type>, "operands must have the same matrix type");
+
+  private:
+    Lhs lhs_;
+    Rhs rhs_;
+
+  public:
+    matrix_binary_expr(Lhs const &lhs, Rhs const &rhs, std::string const &location)
+        : lhs_(lhs)
+        , rhs_(rhs)
+    {
+        expression_detail::assertSameSize(lhs.sizeX(), lhs.sizeY(), rhs.sizeX(), rhs.sizeY(), location);
+    }
+
+    [[nodiscard]] size_t sizeX() const
+    {
+        return lhs_.sizeX();
+    }
+
+    [[nodiscard]] size_t sizeY() const
+    {
+        return lhs_.sizeY();
+    }
+
+    value_type operator()(size_t x, size_t y) const
+    {
+        return Op{}(lhs_(x, y), rhs_(x, y));
+    }
+
+    void prepare(exec_policy policy) const
+    {
+        lhs_.prepare(policy);
+        rhs_.prepare(policy);
+    }
+
+    bool aliases(value_type const *data, size_t xDim, size_t yDim, size_t rowStride, size_t colStride) const
+    {
+        return lhs_.aliases(data, xDim, yDim, rowStride, colStride) ||
+               rhs_.aliases(data, xDim, yDim, rowStride, colStride);
+    }
+};
+
+/**
+ * @brief Element-wise combination of an expression with a scalar, like scaling and division.
+ */
+template <typename Expr, typename Op>
+class matrix_scalar_expr : public matrix_expression<matrix_scalar_expr<Expr, Op>>
+{
+  public:
+    using value_type                = typename Expr::value_type;
+    using matrix_type               = typename Expr::matrix_type;
+    static constexpr bool isLeaf    = false;
+    static constexpr bool isProduct = false;
+
+  private:
+    Expr       expr_;
+    value_type c_;
+
+  public:
+    matrix_scalar_expr(Expr const &expr, value_type const &c)
+        : expr_(expr)
+        , c_(c)
+    {
+    }
+
+    [[nodiscard]] size_t sizeX() const
+    {
+        return expr_.sizeX();
+    }
+
+    [[nodiscard]] size_t sizeY() const
+    {
+        return expr_.sizeY();
+    }
+
+    value_type operator()(size_t x, size_t y) const
+    {
+        return Op{}(expr_(x, y), c_);
+    }
+
+    void prepare(exec_policy policy) const
+    {
+        expr_.prepare(policy);
+    }
+
+    bool aliases(value_type const *data, size_t xDim, size_t yDim, size_t rowStride, size_t colStride) const
+    {
+        return expr_.aliases(data, xDim, yDim, rowStride, colStride);
+    }
+};
+
+/**
+ * @brief Element-wise negation of an expression.
+ */
+template <typename Expr>
+class matrix_negate_expr : public matrix_expression<matrix_negate_expr<Expr>>
+{
+  public:
+    using value_type                = typename Expr::value_type;
+    using matrix_type               = typename Expr::matrix_type;
+    static constexpr bool isLeaf    = false;
+    static constexpr bool isProduct = false;
+
+  private:
+    Expr expr_;
+
+  public:
+    explicit matrix_negate_expr(Expr const &expr)
+        : expr_(expr)
+    {
+    }
+
+    [[nodiscard]] size_t sizeX() const
+    {
+        return expr_.sizeX();
+    }
+
+    [[nodiscard]] size_t sizeY() const
+    {
+        return expr_.sizeY();
+    }
+
+    value_type operator()(size_t x, size_t y) const
+    {
+        return -expr_(x, y);
+    }
+
+    void prepare(exec_policy policy) const
+    {
+        expr_.prepare(policy);
+    }
+
+    bool aliases(value_type const *data, size_t xDim, size_t yDim, size_t rowStride, size_t colStride) const
+    {
+        return expr_.aliases(data, xDim, yDim, rowStride, colStride);
+    }
+};
+
+/**
+ * @brief Matrix product of two expressions.
+ *
+ * A product cannot be fused element by element, as every element depends on a whole row and column. prepare()
+ * therefore calculates it with matrix::multiply() into a buffer owned by the node, once, before the surrounding
+ * element-wise loop reads from it. Operands that are expressions themselves are evaluated first.
+ */
+template <typename Lhs, typename Rhs>
+class matrix_product_expr : public matrix_expression<matrix_product_expr<Lhs, Rhs>>
+{
+  public:
+    using value_type                = typename Lhs::value_type;
+    using matrix_type               = typename Lhs::matrix_type;
+    static constexpr bool isLeaf    = false;
+    static constexpr bool isProduct = true;
+    static_assert(std::is_same_v<matrix_type, typename Rhs::matrix_type>, "operands must have the same matrix type");
+
+  private:
+    Lhs                       lhs_;
+    Rhs                       rhs_;
+    mutable matrix_type       product_;
+    mutable value_type const *data_   = nullptr;
+    mutable size_t            stride_ = 0;
+
+    /**
+     * @brief The operand as a matrix: the referenced matrix for a leaf, otherwise the evaluated expression.
+     */
+    template <typename Expr>
+    static decltype(auto) operand(Expr const &expr, exec_policy policy)
+    {
+        if constexpr (Expr::isLeaf)
+        {
+            return (expr.get());
+        }
+        else
+        {
+            return expr.eval(policy);
+        }
+    }
+
+  public:
+    matrix_product_expr(Lhs const &lhs, Rhs const &rhs)
+        : lhs_(lhs)
+        , rhs_(rhs)
+    {
+        if (lhs.sizeX() != rhs.sizeY())
+        {
+            throw matrixSizesIncompatible(
+                "operator*(lhs,rhs): x-dimension of lhs-matrix (" + toString(lhs.sizeX()) +
+                ") is not equal to y-dimension rhs (" + toString(rhs.sizeY()) + ")."
+            );
+        }
+    }
+
+    [[nodiscard]] size_t sizeX() const
+    {
+        return rhs_.sizeX();
+    }
+
+    [[nodiscard]] size_t sizeY() const
+    {
+        return lhs_.sizeY();
+    }
+
+    /**
+     * @brief Calculate the product as a new matrix, without storing it in the node.
+     *
+     * @param policy execution policy for the multiplication
+     *
+     * @return the product
+     */
+    matrix_type multiply(exec_policy policy) const
+    {
+        return matrix_type::multiply(operand(lhs_, policy), operand(rhs_, policy), policy);
+    }
+
+    value_type operator()(size_t x, size_t y) const
+    {
+        return data_[y * stride_ + x];
+    }
+
+    void prepare(exec_policy policy) const
+    {
+        product_ = multiply(policy);
+        data_    = product_.data();
+        stride_  = product_.stride();
+    }
+
+    /**
+     * @brief A product never aliases the destination, as prepare() calculates it before anything is written.
+     */
+    bool aliases(value_type const *, size_t, size_t, size_t, size_t) const
+    {
+        return false;
+    }
+};
+
+/**
+ * @brief Start a lazily evaluated expression.
+ *
+ * @param m the matrix to reference, must outlive the expression
+ *
+ * @return a leaf expression referencing m
+ */
+template <typename T, bool enableBoundsCheck>
+matrix_ref<T, enableBoundsCheck> lazy(matrix<T, enableBoundsCheck> const &m)
+{
+    return matrix_ref<T, enableBoundsCheck>(m);
+}
+
+/**
+ * @brief Element-wise sum of two expressions.
+ * @throw matrixSizesIncompatible
+ */
+template <typename Lhs, typename Rhs>
+matrix_binary_expr<Lhs, Rhs, std::plus<>>
+    operator+(matrix_expression<Lhs> const &lhs, matrix_expression<Rhs> const &rhs)
+{
+    return {lhs.derived(), rhs.derived(), "operator+(lhs,rhs)"};
+}
+
+template <typename Lhs, typename T, bool enableBoundsCheck>
+matrix_binary_expr<Lhs, matrix_ref<T, enableBoundsCheck>, std::plus<>>
+    operator+(matrix_expression<Lhs> const &lhs, matrix<T, enableBoundsCheck> const &rhs)
+{
+    return {lhs.derived(), lazy(rhs), "operator+(lhs,rhs)"};
+}
+
+template <typename T, bool enableBoundsCheck, typename Rhs>
+matrix_binary_expr<matrix_ref<T, enableBoundsCheck>, Rhs, std::plus<>>
+    operator+(matrix<T, enableBoundsCheck> const &lhs, matrix_expression<Rhs> const &rhs)
+{
+    return {lazy(lhs), rhs.derived(), "operator+(lhs,rhs)"};
+}
+
+/**
+ * @brief Element-wise difference of two expressions.
+ * @throw matrixSizesIncompatible
+ */
+template <typename Lhs, typename Rhs>
+matrix_binary_expr<Lhs, Rhs, std::minus<>>
+    operator-(matrix_expression<Lhs> const &lhs, matrix_expression<Rhs> const &rhs)
+{
+    return {lhs.derived(), rhs.derived(), "operator-(lhs,rhs)"};
+}
+
+template <typename Lhs, typename T, bool enableBoundsCheck>
+matrix_binary_expr<Lhs, matrix_ref<T, enableBoundsCheck>, std::minus<>>
+    operator-(matrix_expression<Lhs> const &lhs, matrix<T, enableBoundsCheck> const &rhs)
+{
+    return {lhs.derived(), lazy(rhs), "operator-(lhs,rhs)"};
+}
+
+template <typename T, bool enableBoundsCheck, typename Rhs>
+matrix_binary_expr<matrix_ref<T, enableBoundsCheck>, Rhs, std::minus<>>
+    operator-(matrix<T, enableBoundsCheck> const &lhs, matrix_expression<Rhs> const &rhs)
+{
+    return {lazy(lhs), rhs.derived(), "operator-(lhs,rhs)"};
+}
+
+/**
+ * @brief Element-wise negation of an expression.
+ */
+template <typename Expr>
+matrix_negate_expr<Expr> operator-(matrix_expression<Expr> const &expr)
+{
+    return matrix_negate_expr<Expr>(expr.derived());
+}
+
+/**
+ * @brief Matrix product of two expressions, evaluated with the GEMM kernel.
+ * @throw matrixSizesIncompatible
+ */
+template <typename Lhs, typename Rhs>
+matrix_product_expr<Lhs, Rhs> operator*(matrix_expression<Lhs> const &lhs, matrix_expression<Rhs> const &rhs)
+{
+    return {lhs.derived(), rhs.derived()};
+}
+
+template <typename Lhs, typename T, bool enableBoundsCheck>
+matrix_product_expr<Lhs, matrix_ref<T, enableBoundsCheck>>
+    operator*(matrix_expression<Lhs> const &lhs, matrix<T, enableBoundsCheck> const &rhs)
+{
+    return {lhs.derived(), lazy(rhs)};
+}
+
+template <typename T, bool enableBoundsCheck, typename Rhs>
+matrix_product_expr<matrix_ref<T, enableBoundsCheck>, Rhs>
+    operator*(matrix<T, enableBoundsCheck> const &lhs, matrix_expression<Rhs> const &rhs)
+{
+    return {lazy(lhs), rhs.derived()};
+}
+
+/**
+ * @brief Multiply every element of an expression with a scalar.
+ */
+template <typename Expr>
+matrix_scalar_expr<Expr, std::multiplies<>>
+    operator*(matrix_expression<Expr> const &expr, typename Expr::value_type const &c)
+{
+    return {expr.derived(), c};
+}
+
+template <typename Expr>
+matrix_scalar_expr<Expr, expression_detail::scalar_first<std::multiplies<>>>
+    operator*(typename Expr::value_type const &c, matrix_expression<Expr> const &expr)
+{
+    return {expr.derived(), c};
+}
+
+/**
+ * @brief Divide every element of an expression by a scalar.
+ * @throw matrixScalarMustNotBeZero
+ */
+template <typename Expr>
+matrix_scalar_expr<Expr, std::divides<>>
+    operator/(matrix_expression<Expr> const &expr, typename Expr::value_type const &c)
+{
+    Expr::matrix_type::assertNotZero(c, "operator/(lhs,c)");
+
+    return {expr.derived(), c};
+}
+
+}; // namespace util
+
+#endif // NS_UTIL_MATRIX_EXPRESSION_H_INCLUDED
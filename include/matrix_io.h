@@ -0,0 +1,449 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/matrix_io.h
+ * Description: Binary serialisation of matrices with memory-mapped loading.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_MATRIX_IO_H_INCLUDED
+#define NS_UTIL_MATRIX_IO_H_INCLUDED
+
+#include "matrix.h"
+#include "matrix_view.h"
+#include "to_string.h"
+
+#include <bit>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace util
+{
+/**
+ * @brief Thrown when a binary matrix file cannot be read or written, or does not hold the expected matrix.
+ */
+class matrixFileError : public std::runtime_error
+{
+  public:
+    explicit matrixFileError(std::string const &what_arg)
+        : runtime_error(what_arg)
+    {
+    }
+};
+
+/**
+ * @brief Header of the binary matrix format.
+ *
+ * The header is followed, at dataOffset, by the sizeY rows of sizeX elements each, without padding, in the byte order
+ * of the writing machine. The data starts on a 64-byte boundary, so a memory-mapped file can be used in place.
+ */
+struct matrix_file_header
+{
+    static constexpr char     magicValue[8] = {'U', 'T', 'I', 'L', 'M', 'T', 'X', '\0'};
+    static constexpr uint16_t formatVersion = 1;
+    static constexpr uint16_t byteOrderMark = 0x0102;
+
+    char     magic[8]    = {'U', 'T', 'I', 'L', 'M', 'T', 'X', '\0'};
+    uint16_t version     = formatVersion;
+    uint16_t byteOrder   = byteOrderMark;
+    uint16_t elementType = 0; ///< matrix_io_detail::elementType<T>()
+    uint16_t elementSize = 0; ///< sizeof(T)
+    uint64_t sizeX       = 0;
+    uint64_t sizeY       = 0;
+    uint64_t dataOffset  = sizeof(matrix_file_header);
+    char     reserved[24]{};
+};
+
+static_assert(sizeof(matrix_file_header) == 64, "the data of a matrix file starts on a 64-byte boundary");
+static_assert(std::is_trivially_copyable_v<matrix_file_header>);
+
+namespace matrix_io_detail
+{
+/**
+ * @brief Code for the element type stored in the file header, so that a file is only read back as the type it was
+ * written with.
+ */
+template <typename T>
+constexpr uint16_t elementType()
+{
+    if constexpr (decomposition_detail::is_complex<T>::value)
+    {
+        return 0x100 | elementType<typename T::value_type>();
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        return 0x10 | sizeof(T);
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+    {
+        return 0x20 | sizeof(T);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        return 0x40 | sizeof(T);
+    }
+    else
+    {
+        static_assert(std::is_arithmetic_v<T>, "binary matrix files hold arithmetic or std::complex elements");
+        return 0;
+    }
+}
+
+/**
+ * @brief Check a header read from a file against the element type T.
+ *
+ * @param header the header
+ * @param available number of bytes in the file, or 0 if unknown
+ * @param location where the header was read, for the error message
+ *
+ * @throw matrixFileError
+ */
+template <typename T>
+void validate(matrix_file_header const &header, uint64_t available, std::string const &location)
+{
+    if (std::memcmp(header.magic, matrix_file_header::magicValue, sizeof(header.magic)) != 0)
+    {
+        throw matrixFileError(location + ": not a binary matrix file.");
+    }
+    if (header.version != matrix_file_header::formatVersion)
+    {
+        throw matrixFileError(location + ": unsupported format version " + toString(header.version) + ".");
+    }
+    if (header.byteOrder != matrix_file_header::byteOrderMark)
+    {
+        throw matrixFileError(location + ": the file has been written with a different byte order.");
+    }
+    if (header.elementType != elementType<T>() || header.elementSize != sizeof(T))
+    {
+        throw matrixFileError(
+            location + ": element type " + toString(header.elementType) + " of size " + toString(header.elementSize) +
+            " does not match the requested type " + toString(elementType<T>()) + " of size " + toString(sizeof(T)) +
+            "."
+        );
+    }
+    if (header.sizeX == 0 || header.sizeY == 0 || header.dataOffset < sizeof(matrix_file_header) ||
+        header.sizeX > (UINT64_MAX - header.dataOffset) / sizeof(T) / header.sizeY)
+    {
+        throw matrixFileError(location + ": invalid dimensions in header.");
+    }
+    if (available != 0 && available < header.dataOffset + header.sizeX * header.sizeY * sizeof(T))
+    {
+        throw matrixFileError(location + ": file is truncated.");
+    }
+}
+}; // namespace matrix_io_detail
+
+/**
+ * @brief Write a matrix to a binary stream: a matrix_file_header followed by the raw rows.
+ *
+ * Unlike operator<<, which formats every element as text, this writes each row with one call and is bounded by the
+ * speed of the stream. The stream must be opened in binary mode.
+ *
+ * @param ostrm the output stream
+ * @param m the matrix to write
+ *
+ * @throw matrixFileError if the stream fails
+ */
+template <typename T, bool enableBoundsCheck>
+void writeBinary(std::ostream &ostrm, matrix<T, enableBoundsCheck> const &m)
+{
+    static_assert(std::endian::native == std::endian::little || std::endian::native == std::endian::big);
+    matrix_file_header header;
+    header.elementType = matrix_io_detail::elementType<T>();
+    header.elementSize = sizeof(T);
+    header.sizeX       = m.sizeX();
+    header.sizeY       = m.sizeY();
+    ostrm.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    if (m.stride() == m.sizeX())
+    {
+        ostrm.write(reinterpret_cast<char const *>(m.data()), std::streamsize(m.sizeX() * m.sizeY() * sizeof(T)));
+    }
+    else
+    {
+        for (size_t y = 0; y < m.sizeY(); y++)
+        {
+            ostrm.write(
+                reinterpret_cast<char const *>(m.data() + y * m.stride()),
+                std::streamsize(m.sizeX() * sizeof(T))
+            );
+        }
+    }
+    if (!ostrm)
+    {
+        throw matrixFileError("writeBinary(): failed to write matrix to stream.");
+    }
+}
+
+/**
+ * @brief Read a matrix written by writeBinary() from a binary stream.
+ *
+ * @param istrm the input stream, opened in binary mode
+ *
+ * @return the matrix
+ *
+ * @throw matrixFileError if the stream does not hold a matrix of element type T
+ */
+template <typename T, bool enableBoundsCheck = false>
+matrix<T, enableBoundsCheck> readBinary(std::istream &istrm)
+{
+    matrix_file_header header;
+    istrm.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!istrm)
+    {
+        throw matrixFileError("readBinary(): failed to read matrix header from stream.");
+    }
+    matrix_io_detail::validate<T>(header, 0, "readBinary()");
+    istrm.ignore(std::streamsize(header.dataOffset - sizeof(header)));
+
+    matrix<T, enableBoundsCheck> reval(header.sizeX, header.sizeY);
+    for (size_t y = 0; y < reval.sizeY(); y++)
+    {
+        istrm.read(
+            reinterpret_cast<char *>(reval.data() + y * reval.stride()),
+            std::streamsize(reval.sizeX() * sizeof(T))
+        );
+    }
+    if (!istrm)
+    {
+        throw matrixFileError("readBinary(): stream ended before all matrix elements were read.");
+    }
+
+    return reval;
+}
+
+/**
+ * @brief Save a matrix to a binary file.
+ *
+ * @param filename name of the file, which is overwritten
+ * @param m the matrix to save
+ *
+ * @throw matrixFileError
+ */
+template <typename T, bool enableBoundsCheck>
+void saveBinary(std::string const &filename, matrix<T, enableBoundsCheck> const &m)
+{
+    std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+    {
+        throw matrixFileError("saveBinary(): cannot open '" + filename + "' for writing.");
+    }
+    writeBinary(ofs, m);
+    ofs.close();
+    if (!ofs)
+    {
+        throw matrixFileError("saveBinary(): failed to write '" + filename + "'.");
+    }
+}
+
+/**
+ * @brief Read-only matrix in a memory-mapped binary file.
+ *
+ * The file is mapped, not read: opening is O(1) and pages are loaded by the operating system as they are first used,
+ * so a matrix larger than the memory can be processed block by block through view(). The mapping lives as long as the
+ * object; views must not outlive it.
+ *
+ * @tparam T                 value-type, must be the element type the file was written with
+ * @tparam enableBoundsCheck check the boundaries when accessing elements through the view
+ */
+template <typename T, bool enableBoundsCheck = false>
+class mapped_matrix
+{
+  private:
+    void    *mapping_ = nullptr;
+    size_t   length_  = 0;
+    T const *data_    = nullptr;
+    size_t   sizeX_   = 0;
+    size_t   sizeY_   = 0;
+
+    void unmap() noexcept
+    {
+        if (mapping_ != nullptr)
+        {
+            ::munmap(mapping_, length_);
+        }
+        mapping_ = nullptr;
+        length_  = 0;
+        data_    = nullptr;
+        sizeX_   = 0;
+        sizeY_   = 0;
+    }
+
+  public:
+    /**
+     * @brief Map a file written by saveBinary() or writeBinary().
+     *
+     * @param filename name of the file
+     *
+     * @throw matrixFileError if the file cannot be mapped or does not hold a matrix of element type T
+     */
+    explicit mapped_matrix(std::string const &filename)
+    {
+        int const fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw matrixFileError("mapped_matrix: cannot open '" + filename + "'.");
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(matrix_file_header))
+        {
+            ::close(fd);
+            throw matrixFileError("mapped_matrix: '" + filename + "' is too short to be a matrix file.");
+        }
+        length_  = size_t(st.st_size);
+        mapping_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping_ == MAP_FAILED)
+        {
+            mapping_ = nullptr;
+            throw matrixFileError("mapped_matrix: cannot map '" + filename + "'.");
+        }
+
+        matrix_file_header header;
+        std::memcpy(&header, mapping_, sizeof(header));
+        try
+        {
+            matrix_io_detail::validate<T>(header, length_, "mapped_matrix('" + filename + "')");
+            if (header.dataOffset % alignof(T) != 0)
+            {
+                throw matrixFileError("mapped_matrix('" + filename + "'): data is not aligned.");
+            }
+        }
+        catch (...)
+        {
+            unmap();
+            throw;
+        }
+        data_  = reinterpret_cast<T const *>(static_cast<char const *>(mapping_) + header.dataOffset);
+        sizeX_ = header.sizeX;
+        sizeY_ = header.sizeY;
+        ::madvise(mapping_, length_, MADV_SEQUENTIAL);
+    }
+
+    mapped_matrix(mapped_matrix const &)            = delete;
+    mapped_matrix &operator=(mapped_matrix const &) = delete;
+
+    mapped_matrix(mapped_matrix &&rhs) noexcept
+        : mapping_(std::exchange(rhs.mapping_, nullptr))
+        , length_(std::exchange(rhs.length_, 0))
+        , data_(std::exchange(rhs.data_, nullptr))
+        , sizeX_(std::exchange(rhs.sizeX_, 0))
+        , sizeY_(std::exchange(rhs.sizeY_, 0))
+    {
+    }
+
+    mapped_matrix &operator=(mapped_matrix &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            unmap();
+            mapping_ = std::exchange(rhs.mapping_, nullptr);
+            length_  = std::exchange(rhs.length_, 0);
+            data_    = std::exchange(rhs.data_, nullptr);
+            sizeX_   = std::exchange(rhs.sizeX_, 0);
+            sizeY_   = std::exchange(rhs.sizeY_, 0);
+        }
+
+        return *this;
+    }
+
+    ~mapped_matrix()
+    {
+        unmap();
+    }
+
+    /**
+     * @brief Retrieve the horizontal extent of the matrix.
+     * @return x-dimension
+     */
+    [[nodiscard]] size_t sizeX() const
+    {
+        return sizeX_;
+    }
+
+    /**
+     * @brief Retrieve the vertical extent of the matrix.
+     * @return y-dimension
+     */
+    [[nodiscard]] size_t sizeY() const
+    {
+        return sizeY_;
+    }
+
+    /**
+     * @brief Pointer to the elements in the mapping, row by row without padding.
+     */
+    T const *data() const
+    {
+        return data_;
+    }
+
+    /**
+     * @brief A view of the mapped elements, which can be used like a const matrix without copying.
+     */
+    matrix_view<T, enableBoundsCheck> view() const
+    {
+        return matrix_view<T, enableBoundsCheck>(data_, sizeX_, sizeY_, sizeX_);
+    }
+
+    /**
+     * @brief Copy the mapped elements into a matrix, row by row.
+     */
+    matrix<T, enableBoundsCheck> toMatrix() const
+    {
+        matrix<T, enableBoundsCheck> reval(sizeX_, sizeY_);
+        for (size_t y = 0; y < sizeY_; y++)
+        {
+            std::memcpy(reval.data() + y * reval.stride(), data_ + y * sizeX_, sizeX_ * sizeof(T));
+        }
+
+        return reval;
+    }
+};
+
+/**
+ * @brief Load a matrix from a binary file by memory-mapping it and copying its rows.
+ *
+ * @param filename name of the file written by saveBinary()
+ *
+ * @return the matrix
+ *
+ * @throw matrixFileError if the file cannot be read or does not hold a matrix of element type T
+ */
+template <typename T, bool enableBoundsCheck = false>
+matrix<T, enableBoundsCheck> loadBinary(std::string const &filename)
+{
+    return mapped_matrix<T, enableBoundsCheck>(filename).toMatrix();
+}
+
+}; // namespace util
+
+#endif // NS_UTIL_MATRIX_IO_H_INCLUDED
@@ -0,0 +1,572 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/matrix_view.h
+ * Description: Non-owning, strided views of matrix data for zero-copy blocks, rows, columns and transposes.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_MATRIX_VIEW_H_INCLUDED
+#define NS_UTIL_MATRIX_VIEW_H_INCLUDED
+
+#include "matrix.h"
+#include "matrix_expression.h"
+#include "threadutil.h"
+
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace util
+{
+/**
+ * @brief Read-only, non-owning view of a rectangular part of matrix data.
+ *
+ * Element (x,y) of the view is at data()[y * rowStride() + x * colStride()], so blocks, single rows and columns and
+ * the transpose of a matrix or of another view are all views of the same data, created without copying. A view is a
+ * matrix_expression: it can be an operand of all the arithmetic operators, which are evaluated lazily, and it converts
+ * to a matrix. Matrix products copy a view operand into a contiguous matrix for the GEMM kernel.
+ *
+ * A view must not outlive the data it refers to, and is invalidated when the matrix is resized.
+ *
+ * @tparam T                 value-type
+ * @tparam enableBoundsCheck check the boundaries when accessing elements if set to true
+ */
+template <typename T, bool enableBoundsCheck>
+class matrix_view : public matrix_expression<matrix_view<T, enableBoundsCheck>>
+{
+  public:
+    using value_type                = T;
+    using matrix_type               = matrix<T, enableBoundsCheck>;
+    static constexpr bool isLeaf    = false;
+    static constexpr bool isProduct = false;
+
+  protected:
+    T const *data_      = nullptr;
+    size_t   sizeX_     = 0;
+    size_t   sizeY_     = 0;
+    size_t   rowStride_ = 0;
+    size_t   colStride_ = 1;
+
+    /**
+     * @brief Check the element (x,y) against the extent of the view.
+     * @throw matrixIndexOutOfBounds
+     */
+    void checkIndex(size_t x, size_t y, std::string const &location) const
+    {
+        if (x >= sizeX_ || y >= sizeY_)
+        {
+            std::stringstream ss;
+            ss << location << ": index (" << x << "," << y << ") is out of bounds (" << sizeX_ << "," << sizeY_
+               << ").";
+            throw matrixIndexOutOfBounds(ss.str());
+        }
+    }
+
+    /**
+     * @brief Check that a block fits into the view.
+     * @throw matrixIndexOutOfBounds
+     */
+    void checkBlock(size_t x, size_t y, size_t xDim, size_t yDim, std::string const &location) const
+    {
+        if (x + xDim > sizeX_ || y + yDim > sizeY_)
+        {
+            std::stringstream ss;
+            ss << location << ": block (" << x << "," << y << ")+(" << xDim << "," << yDim << ") is out of bounds ("
+               << sizeX_ << "," << sizeY_ << ").";
+            throw matrixIndexOutOfBounds(ss.str());
+        }
+    }
+
+  public:
+    matrix_view() = default;
+
+    /**
+     * @brief Construct a view of strided data.
+     *
+     * @param data address of element (0,0)
+     * @param xDim x-dimension
+     * @param yDim y-dimension
+     * @param rowStride distance in elements between (x,y) and (x,y+1)
+     * @param colStride distance in elements between (x,y) and (x+1,y)
+     */
+    matrix_view(T const *data, size_t xDim, size_t yDim, size_t rowStride, size_t colStride = 1)
+        : data_(data)
+        , sizeX_(xDim)
+        , sizeY_(yDim)
+        , rowStride_(rowStride)
+        , colStride_(colStride)
+    {
+    }
+
+    /**
+     * @brief View the whole of a matrix.
+     * @param m the matrix
+     */
+    matrix_view(matrix_type const &m)
+        : matrix_view(m.data(), m.sizeX(), m.sizeY(), m.stride())
+    {
+    }
+
+    [[nodiscard]] size_t sizeX() const
+    {
+        return sizeX_;
+    }
+
+    [[nodiscard]] size_t sizeY() const
+    {
+        return sizeY_;
+    }
+
+    [[nodiscard]] size_t rowStride() const
+    {
+        return rowStride_;
+    }
+
+    [[nodiscard]] size_t colStride() const
+    {
+        return colStride_;
+    }
+
+    T const *data() const
+    {
+        return data_;
+    }
+
+    /**
+     * @brief Subscript operator to get individual elements.
+     *
+     * @param x x-coordinate
+     * @param y y-coordinate
+     *
+     * @return the element at (x,y)
+     */
+    T const &operator()(size_t x, size_t y) const
+    {
+        if constexpr (enableBoundsCheck)
+        {
+            checkIndex(x, y, "matrix_view<T,enableBoundsCheck>::operator()");
+        }
+
+        return data_[y * rowStride_ + x * colStride_];
+    }
+
+    /**
+     * @brief View a rectangular block.
+     *
+     * @param x x-coordinate of the top-left element
+     * @param y y-coordinate of the top-left element
+     * @param xDim x-dimension of the block
+     * @param yDim y-dimension of the block
+     *
+     * @return the view of the block
+     *
+     * @throw matrixIndexOutOfBounds if the block does not fit into this view
+     */
+    matrix_view block(size_t x, size_t y, size_t xDim, size_t yDim) const
+    {
+        checkBlock(x, y, xDim, yDim, "matrix_view<T,enableBoundsCheck>::block()");
+
+        return matrix_view(data_ + y * rowStride_ + x * colStride_, xDim, yDim, rowStride_, colStride_);
+    }
+
+    /**
+     * @brief View row y, as a horizontal vector.
+     * @throw matrixIndexOutOfBounds
+     */
+    matrix_view rowView(size_t y) const
+    {
+        return block(0, y, sizeX_, 1);
+    }
+
+    /**
+     * @brief View column x, as a vertical vector.
+     * @throw matrixIndexOutOfBounds
+     */
+    matrix_view colView(size_t x) const
+    {
+        return block(x, 0, 1, sizeY_);
+    }
+
+    /**
+     * @brief View the transpose, by swapping dimensions and strides.
+     */
+    matrix_view transposed() const
+    {
+        return matrix_view(data_, sizeY_, sizeX_, colStride_, rowStride_);
+    }
+
+    /**
+     * @brief This operator is used to return the transposition as a view, without copying.
+     */
+    friend matrix_view operator~(matrix_view const &rhs)
+    {
+        return rhs.transposed();
+    }
+
+    /**
+     * @brief Check whether the view and a strided destination share memory, other than element for element in the
+     * same layout, so that writing the destination in one pass could modify elements that are still to be read.
+     */
+    bool aliases(T const *data, size_t xDim, size_t yDim, size_t rowStride, size_t colStride) const
+    {
+        if (xDim == 0 || yDim == 0 || sizeX_ == 0 || sizeY_ == 0 ||
+            (data == data_ && xDim == sizeX_ && yDim == sizeY_ && rowStride == rowStride_ && colStride == colStride_))
+        {
+            return false;
+        }
+        T const *last      = data_ + (sizeY_ - 1) * rowStride_ + (sizeX_ - 1) * colStride_;
+        T const *otherLast = data + (yDim - 1) * rowStride + (xDim - 1) * colStride;
+
+        return data_ <= otherLast && data <= last;
+    }
+
+    void prepare(exec_policy) const
+    {
+    }
+
+    /**
+     * @brief Compare the elements of two views.
+     */
+    friend bool operator==(matrix_view const &lhs, matrix_view const &rhs)
+    {
+        if (lhs.sizeX_ != rhs.sizeX_ || lhs.sizeY_ != rhs.sizeY_)
+        {
+            return false;
+        }
+        for (size_t y = 0; y < lhs.sizeY_; y++)
+        {
+            for (size_t x = 0; x < lhs.sizeX_; x++)
+            {
+                if (lhs.data_[y * lhs.rowStride_ + x * lhs.colStride_] !=
+                    rhs.data_[y * rhs.rowStride_ + x * rhs.colStride_])
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    friend bool operator!=(matrix_view const &lhs, matrix_view const &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend std::ostream &operator<<(std::ostream &ostrm, matrix_view const &v)
+    {
+        for (size_t y = 0; y < v.sizeY(); y++)
+        {
+            for (size_t x = 0; x < v.sizeX(); x++)
+            {
+                ostrm << v(x, y) << '\t';
+            }
+
+            ostrm << std::endl;
+        }
+        return ostrm;
+    }
+};
+
+/**
+ * @brief Writable, non-owning view of a rectangular part of matrix data.
+ *
+ * A span is a matrix_view whose elements can be modified: assigning a matrix, an expression or another view to a span
+ * writes the elements, it does not re-bind the span. This allows block algorithms to work on submatrices in place:
+ * @code
+ * m.block(0, 0, 2, 2) = lazy(a) * 2.0;        // write into the top-left block of m
+ * m.colView(1) += m.colView(0);               // add column 0 to column 1
+ * m.block(0, 0, 3, 3) = ~m.block(0, 0, 3, 3); // in-place transpose, evaluated via a temporary
+ * @endcode
+ * If the right-hand side overlaps the span, other than element for element, it is evaluated into a temporary first.
+ *
+ * @tparam T                 value-type
+ * @tparam enableBoundsCheck check the boundaries when accessing elements if set to true
+ */
+template <typename T, bool enableBoundsCheck>
+class matrix_span : public matrix_view<T, enableBoundsCheck>
+{
+    using base = matrix_view<T, enableBoundsCheck>;
+    using base::checkBlock;
+    using base::checkIndex;
+    using base::colStride_;
+    using base::data_;
+    using base::rowStride_;
+    using base::sizeX_;
+    using base::sizeY_;
+
+    /**
+     * @brief Pointer to element (x,y), the span has been created from writable data.
+     */
+    T *elementPtr(size_t x, size_t y) const
+    {
+        return const_cast<T *>(data_ + y * rowStride_ + x * colStride_);
+    }
+
+    /**
+     * @brief Write every element (x,y) of the span as op(element, value(x, y)), rows in parallel if the policy asks
+     * for it.
+     */
+    template <typename Value, typename Op>
+    void update(Value const &value, Op op, exec_policy policy) const
+    {
+        auto updateRows = [this, &value, &op](size_t y0, size_t y1)
+        {
+            for (size_t y = y0; y < y1; y++)
+            {
+                for (size_t x = 0; x < sizeX_; x++)
+                {
+                    T &element = *elementPtr(x, y);
+                    element    = op(element, value(x, y));
+                }
+            }
+        };
+
+        if (use_parallel(policy, sizeX_ * sizeY_, matrix<T, enableBoundsCheck>::parallelThreshold))
+        {
+            parallel_for(0, sizeY_, updateRows);
+        }
+        else
+        {
+            updateRows(0, sizeY_);
+        }
+    }
+
+    /**
+     * @brief Combine the elements with an expression of the same size, via a temporary if the expression reads
+     * elements that are written before they are read.
+     */
+    template <typename Derived, typename Op>
+    matrix_span &combine(matrix_expression<Derived> const &expr, Op op, exec_policy policy)
+    {
+        Derived const &e = expr.derived();
+        expression_detail::assertSameSize(sizeX_, sizeY_, e.sizeX(), e.sizeY(), "matrix_span<T,enableBoundsCheck>");
+
+        if (e.aliases(data_, sizeX_, sizeY_, rowStride_, colStride_))
+        {
+            update(e.eval(policy), op, policy);
+        }
+        else
+        {
+            e.prepare(policy);
+            update(e, op, policy);
+        }
+
+        return *this;
+    }
+
+  public:
+    matrix_span() = default;
+
+    /**
+     * @brief Construct a writable view of strided data.
+     *
+     * @param data address of element (0,0)
+     * @param xDim x-dimension
+     * @param yDim y-dimension
+     * @param rowStride distance in elements between (x,y) and (x,y+1)
+     * @param colStride distance in elements between (x,y) and (x+1,y)
+     */
+    matrix_span(T *data, size_t xDim, size_t yDim, size_t rowStride, size_t colStride = 1)
+        : base(data, xDim, yDim, rowStride, colStride)
+    {
+    }
+
+    /**
+     * @brief Writable view of the whole of a matrix.
+     * @param m the matrix
+     */
+    matrix_span(matrix<T, enableBoundsCheck> &m)
+        : base(m)
+    {
+    }
+
+    matrix_span(matrix_span const &rhs) = default;
+
+    T *data() const
+    {
+        return const_cast<T *>(data_);
+    }
+
+    /**
+     * @brief Subscript operator to get/set individual elements.
+     *
+     * @param x x-coordinate
+     * @param y y-coordinate
+     *
+     * @return reference to the element at (x,y)
+     */
+    T &operator()(size_t x, size_t y) const
+    {
+        if constexpr (enableBoundsCheck)
+        {
+            checkIndex(x, y, "matrix_span<T,enableBoundsCheck>::operator()");
+        }
+
+        return *elementPtr(x, y);
+    }
+
+    /**
+     * @brief Writable view of a rectangular block.
+     * @throw matrixIndexOutOfBounds if the block does not fit into this span
+     */
+    matrix_span block(size_t x, size_t y, size_t xDim, size_t yDim) const
+    {
+        checkBlock(x, y, xDim, yDim, "matrix_span<T,enableBoundsCheck>::block()");
+
+        return matrix_span(elementPtr(x, y), xDim, yDim, rowStride_, colStride_);
+    }
+
+    /**
+     * @brief Writable view of row y.
+     * @throw matrixIndexOutOfBounds
+     */
+    matrix_span rowView(size_t y) const
+    {
+        return block(0, y, sizeX_, 1);
+    }
+
+    /**
+     * @brief Writable view of column x.
+     * @throw matrixIndexOutOfBounds
+     */
+    matrix_span colView(size_t x) const
+    {
+        return block(x, 0, 1, sizeY_);
+    }
+
+    /**
+     * @brief Writable view of the transpose.
+     */
+    matrix_span transposed() const
+    {
+        return matrix_span(data(), sizeY_, sizeX_, colStride_, rowStride_);
+    }
+
+    friend matrix_span operator~(matrix_span const &rhs)
+    {
+        return rhs.transposed();
+    }
+
+    /**
+     * @brief Copy the elements of another view of the same size.
+     * @throw matrixSizesIncompatible
+     */
+    matrix_span &operator=(matrix_span const &rhs)
+    {
+        return assign(rhs);
+    }
+
+    /**
+     * @brief Assign the elements of a matrix of the same size.
+     * @throw matrixSizesIncompatible
+     */
+    matrix_span &operator=(matrix<T, enableBoundsCheck> const &rhs)
+    {
+        return assign(lazy(rhs));
+    }
+
+    /**
+     * @brief Assign the elements of an expression of the same size.
+     * @throw matrixSizesIncompatible
+     */
+    template <typename Derived>
+    matrix_span &operator=(matrix_expression<Derived> const &rhs)
+    {
+        return assign(rhs);
+    }
+
+    /**
+     * @brief Evaluate an expression of the same size into the span.
+     *
+     * @param expr the expression
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold elements
+     *
+     * @return this span
+     *
+     * @throw matrixSizesIncompatible
+     */
+    template <typename Derived>
+    matrix_span &assign(matrix_expression<Derived> const &expr, exec_policy policy = exec_policy::automatic)
+    {
+        return combine(expr, [](T const &, T const &val) { return val; }, policy);
+    }
+
+    template <typename Derived>
+    matrix_span &operator+=(matrix_expression<Derived> const &rhs)
+    {
+        return combine(rhs, std::plus<>{}, exec_policy::automatic);
+    }
+
+    matrix_span &operator+=(matrix<T, enableBoundsCheck> const &rhs)
+    {
+        return *this += lazy(rhs);
+    }
+
+    template <typename Derived>
+    matrix_span &operator-=(matrix_expression<Derived> const &rhs)
+    {
+        return combine(rhs, std::minus<>{}, exec_policy::automatic);
+    }
+
+    matrix_span &operator-=(matrix<T, enableBoundsCheck> const &rhs)
+    {
+        return *this -= lazy(rhs);
+    }
+
+    /**
+     * @brief Multiply every element with a scalar.
+     */
+    matrix_span &operator*=(T const &c)
+    {
+        update([&c](size_t, size_t) { return c; }, std::multiplies<>{}, exec_policy::automatic);
+
+        return *this;
+    }
+
+    /**
+     * @brief Divide every element by a scalar.
+     * @throw matrixScalarMustNotBeZero
+     */
+    matrix_span &operator/=(T const &c)
+    {
+        matrix<T, enableBoundsCheck>::assertNotZero(c, "matrix_span<T,enableBoundsCheck>::operator/=(c)");
+        update([&c](size_t, size_t) { return c; }, std::divides<>{}, exec_policy::automatic);
+
+        return *this;
+    }
+
+    /**
+     * @brief Set all elements to the same value.
+     */
+    matrix_span &fill(T const &c)
+    {
+        update([&c](size_t, size_t) { return c; }, [](T const &, T const &val) { return val; }, exec_policy::automatic);
+
+        return *this;
+    }
+};
+
+}; // namespace util
+
+#endif // NS_UTIL_MATRIX_VIEW_H_INCLUDED
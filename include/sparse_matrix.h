@@ -0,0 +1,971 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/sparse_matrix.h
+ * Description: Compressed sparse row/column matrices with parallel products and iterative solvers.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_SPARSE_MATRIX_H_INCLUDED
+#define NS_UTIL_SPARSE_MATRIX_H_INCLUDED
+
+#include "grid.h"
+#include "matrix.h"
+#include "matrix_decomposition.h"
+#include "threadutil.h"
+#include "to_string.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+/**
+ * @brief Storage order of a sparse_matrix.
+ */
+enum class sparse_format
+{
+    csr, ///< compressed sparse rows: the non-zeros are stored row by row
+    csc  ///< compressed sparse columns: the non-zeros are stored column by column
+};
+
+/**
+ * @brief A single element of a sparse matrix, used to build one.
+ */
+template <typename T>
+struct sparse_triplet
+{
+    size_t x;     ///< column
+    size_t y;     ///< row
+    T      value; ///< value of the element
+};
+
+/**
+ * @brief Sparse matrix in compressed row (CSR) or compressed column (CSC) format.
+ *
+ * Only the non-zero elements are stored: for CSR the column indices and values of each row are kept contiguously,
+ * sorted by column, and offsets_[y] is the position of the first element of row y; CSC is the same with rows and
+ * columns swapped. Memory is O(rows + non-zeros), so systems with millions of rows fit easily.
+ *
+ * The matrix is immutable once built, from triplets, a sparse_grid or a dense matrix. Products with vectors and dense
+ * matrices are split across threads by rows of the result, so no two threads write the same element; the iterative
+ * solvers conjugate_gradient() and bicgstab() only need these products.
+ * Elements are addressed like in matrix: x is the column, y the row.
+ *
+ * @tparam T      value-type
+ * @tparam Format storage order, CSR for fast products, CSC for fast column access
+ */
+template <typename T = long double, sparse_format Format = sparse_format::csr>
+class sparse_matrix
+{
+  public:
+    using value_type = T;
+
+    /**
+     * Number of non-zeros below which exec_policy::automatic keeps a product on the calling thread.
+     */
+    static constexpr size_t parallelThreshold = 1UL << 16;
+
+  private:
+    template <typename, sparse_format>
+    friend class sparse_matrix;
+
+    size_t              sizeX_ = 0;
+    size_t              sizeY_ = 0;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> indices_;
+    std::vector<T>      values_;
+
+    /**
+     * @brief Number of compressed lines: rows for CSR, columns for CSC.
+     */
+    [[nodiscard]] size_t outerSize() const
+    {
+        return Format == sparse_format::csr ? sizeY_ : sizeX_;
+    }
+
+    /**
+     * @brief Fill the compressed arrays from unsorted triplets: sort by line, then by index within the line, add up
+     * duplicates and drop zeros.
+     */
+    void build(std::vector<sparse_triplet<T>> triplets)
+    {
+        for (auto const &t : triplets)
+        {
+            if (t.x >= sizeX_ || t.y >= sizeY_)
+            {
+                throw matrixIndexOutOfBounds(
+                    "sparse_matrix: index (" + toString(t.x) + "," + toString(t.y) + ") is out of bounds (" +
+                    toString(sizeX_) + "," + toString(sizeY_) + ")."
+                );
+            }
+        }
+
+        auto outerOf = [](sparse_triplet<T> const &t) { return Format == sparse_format::csr ? t.y : t.x; };
+        auto innerOf = [](sparse_triplet<T> const &t) { return Format == sparse_format::csr ? t.x : t.y; };
+        std::stable_sort(
+            triplets.begin(),
+            triplets.end(),
+            [&outerOf, &innerOf](sparse_triplet<T> const &lhs, sparse_triplet<T> const &rhs)
+            {
+                return outerOf(lhs) < outerOf(rhs) || (outerOf(lhs) == outerOf(rhs) && innerOf(lhs) < innerOf(rhs));
+            }
+        );
+
+        offsets_.assign(outerSize() + 1, 0);
+        indices_.clear();
+        values_.clear();
+        indices_.reserve(triplets.size());
+        values_.reserve(triplets.size());
+        for (size_t i = 0; i < triplets.size();)
+        {
+            size_t const outer = outerOf(triplets[i]);
+            size_t const inner = innerOf(triplets[i]);
+            T            sum   = T(0);
+            for (; i < triplets.size() && outerOf(triplets[i]) == outer && innerOf(triplets[i]) == inner; i++)
+            {
+                sum += triplets[i].value;
+            }
+            if (sum != T(0))
+            {
+                indices_.push_back(inner);
+                values_.push_back(sum);
+                offsets_[outer + 1]++;
+            }
+        }
+        std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+    }
+
+    /**
+     * @brief Split the rows of the result into one block per thread: for CSR blocks of roughly equal numbers of
+     * non-zeros, for CSC blocks of equal numbers of rows.
+     */
+    [[nodiscard]] std::vector<size_t> rowBlocks(size_t numThreads) const
+    {
+        std::vector<size_t> bounds(numThreads + 1, sizeY_);
+        for (size_t t = 0; t < numThreads; t++)
+        {
+            if constexpr (Format == sparse_format::csr)
+            {
+                size_t const target = values_.size() * t / numThreads;
+                bounds[t]           = std::lower_bound(offsets_.begin(), offsets_.end() - 1, target) - offsets_.begin();
+            }
+            else
+            {
+                bounds[t] = sizeY_ * t / numThreads;
+            }
+        }
+
+        return bounds;
+    }
+
+    /**
+     * @brief Call func(y, x, value) for all non-zeros in the rows [y0, y1); for CSR row by row, for CSC column by
+     * column, so func may only accumulate into row y.
+     */
+    template <typename Func>
+    void forEachInRows(size_t y0, size_t y1, Func &&func) const
+    {
+        if constexpr (Format == sparse_format::csr)
+        {
+            for (size_t y = y0; y < y1; y++)
+            {
+                for (size_t k = offsets_[y]; k < offsets_[y + 1]; k++)
+                {
+                    func(y, indices_[k], values_[k]);
+                }
+            }
+        }
+        else
+        {
+            for (size_t x = 0; x < sizeX_; x++)
+            {
+                auto const first = indices_.begin() + offsets_[x];
+                auto const last  = indices_.begin() + offsets_[x + 1];
+                for (auto it = y0 == 0 ? first : std::lower_bound(first, last, y0); it != last && *it < y1; it++)
+                {
+                    size_t const k = it - indices_.begin();
+                    func(*it, x, values_[k]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Run rowsFunc(y0, y1) on blocks of rows of the result, in parallel if the policy asks for it.
+     */
+    template <typename Func>
+    void forRowBlocks(exec_policy policy, Func &&rowsFunc) const
+    {
+        if (use_parallel(policy, values_.size(), parallelThreshold))
+        {
+            std::vector<size_t> const bounds = rowBlocks(parallel_thread_count());
+            run_on_threads(
+                bounds.size() - 1,
+                [&rowsFunc, &bounds](size_t t, size_t) { rowsFunc(bounds[t], bounds[t + 1]); }
+            );
+        }
+        else
+        {
+            rowsFunc(0, sizeY_);
+        }
+    }
+
+  public:
+    /**
+     * @brief Construct an all-zero matrix.
+     *
+     * @param xDim x-dimension, the number of columns
+     * @param yDim y-dimension, the number of rows
+     */
+    explicit sparse_matrix(size_t xDim = 0, size_t yDim = 0)
+        : sizeX_(xDim)
+        , sizeY_(yDim)
+        , offsets_(outerSize() + 1, 0)
+    {
+    }
+
+    /**
+     * @brief Construct from a list of (x, y, value) triplets in any order. Values given for the same element are
+     * added up, zeros are not stored.
+     *
+     * @param xDim x-dimension, the number of columns
+     * @param yDim y-dimension, the number of rows
+     * @param triplets the non-zero elements
+     *
+     * @throw matrixIndexOutOfBounds if a triplet lies outside of the dimensions
+     */
+    sparse_matrix(size_t xDim, size_t yDim, std::vector<sparse_triplet<T>> triplets)
+        : sizeX_(xDim)
+        , sizeY_(yDim)
+    {
+        build(std::move(triplets));
+    }
+
+    /**
+     * @brief Construct from the cells that have been set in a sparse_grid. Cells that have not been set are zero,
+     * whatever the default value of the grid.
+     *
+     * @param grid the grid, its dimensions become the dimensions of the matrix
+     */
+    explicit sparse_matrix(sparse_grid<T> const &grid)
+        : sizeX_(grid.sizeX())
+        , sizeY_(grid.sizeY())
+    {
+        std::vector<sparse_triplet<T>> triplets;
+        for (auto const &[index, value] : grid)
+        {
+            triplets.push_back({index.x(), index.y(), value});
+        }
+        build(std::move(triplets));
+    }
+
+    /**
+     * @brief Construct from the non-zero elements of a dense matrix.
+     */
+    template <bool enableBoundsCheck>
+    explicit sparse_matrix(matrix<T, enableBoundsCheck> const &m)
+        : sizeX_(m.sizeX())
+        , sizeY_(m.sizeY())
+    {
+        std::vector<sparse_triplet<T>> triplets;
+        for (size_t y = 0; y < sizeY_; y++)
+        {
+            for (size_t x = 0; x < sizeX_; x++)
+            {
+                if (m(x, y) != T(0))
+                {
+                    triplets.push_back({x, y, m(x, y)});
+                }
+            }
+        }
+        build(std::move(triplets));
+    }
+
+    /**
+     * @brief Convert between CSR and CSC.
+     */
+    template <sparse_format OtherFormat>
+    explicit sparse_matrix(sparse_matrix<T, OtherFormat> const &rhs)
+        : sizeX_(rhs.sizeX_)
+        , sizeY_(rhs.sizeY_)
+    {
+        if constexpr (OtherFormat == Format)
+        {
+            offsets_ = rhs.offsets_;
+            indices_ = rhs.indices_;
+            values_  = rhs.values_;
+        }
+        else
+        {
+            // counting sort of the elements by their index within the line
+            offsets_.assign(outerSize() + 1, 0);
+            for (size_t const inner : rhs.indices_)
+            {
+                offsets_[inner + 1]++;
+            }
+            std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+            indices_.resize(rhs.indices_.size());
+            values_.resize(rhs.values_.size());
+            std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+            for (size_t outer = 0; outer + 1 < rhs.offsets_.size(); outer++)
+            {
+                for (size_t k = rhs.offsets_[outer]; k < rhs.offsets_[outer + 1]; k++)
+                {
+                    size_t const pos = next[rhs.indices_[k]]++;
+                    indices_[pos]    = outer;
+                    values_[pos]     = rhs.values_[k];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Retrieve the horizontal extent of the matrix.
+     * @return x-dimension
+     */
+    [[nodiscard]] size_t sizeX() const
+    {
+        return sizeX_;
+    }
+
+    /**
+     * @brief Retrieve the vertical extent of the matrix.
+     * @return y-dimension
+     */
+    [[nodiscard]] size_t sizeY() const
+    {
+        return sizeY_;
+    }
+
+    /**
+     * @brief Retrieve the number of stored, non-zero elements.
+     */
+    [[nodiscard]] size_t nonZeros() const
+    {
+        return values_.size();
+    }
+
+    /**
+     * @brief Line offsets: the elements of row (CSR) or column (CSC) i are at [offsets()[i], offsets()[i + 1]).
+     */
+    std::vector<size_t> const &offsets() const
+    {
+        return offsets_;
+    }
+
+    /**
+     * @brief Column (CSR) or row (CSC) indices of the stored elements.
+     */
+    std::vector<size_t> const &indices() const
+    {
+        return indices_;
+    }
+
+    /**
+     * @brief Values of the stored elements.
+     */
+    std::vector<T> const &values() const
+    {
+        return values_;
+    }
+
+    /**
+     * @brief Get an element, by binary search within its row (CSR) or column (CSC).
+     *
+     * @param x x-coordinate
+     * @param y y-coordinate
+     *
+     * @return the element at (x,y), zero if it is not stored
+     *
+     * @throw matrixIndexOutOfBounds
+     */
+    T operator()(size_t x, size_t y) const
+    {
+        if (x >= sizeX_ || y >= sizeY_)
+        {
+            throw matrixIndexOutOfBounds(
+                "sparse_matrix::operator(): index (" + toString(x) + "," + toString(y) + ") is out of bounds (" +
+                toString(sizeX_) + "," + toString(sizeY_) + ")."
+            );
+        }
+        size_t const outer = Format == sparse_format::csr ? y : x;
+        size_t const inner = Format == sparse_format::csr ? x : y;
+        auto const   first = indices_.begin() + offsets_[outer];
+        auto const   last  = indices_.begin() + offsets_[outer + 1];
+        auto const   it    = std::lower_bound(first, last, inner);
+
+        return it != last && *it == inner ? values_[it - indices_.begin()] : T(0);
+    }
+
+    /**
+     * @brief The transpose, which re-interprets the same arrays in the other format without sorting.
+     */
+    sparse_matrix<T, Format == sparse_format::csr ? sparse_format::csc : sparse_format::csr> transposed() const
+    {
+        sparse_matrix<T, Format == sparse_format::csr ? sparse_format::csc : sparse_format::csr> reval(sizeY_, sizeX_);
+        reval.offsets_ = offsets_;
+        reval.indices_ = indices_;
+        reval.values_  = values_;
+
+        return reval;
+    }
+
+    /**
+     * @brief Convert into a dense matrix.
+     */
+    template <bool enableBoundsCheck = false>
+    matrix<T, enableBoundsCheck> toMatrix() const
+    {
+        matrix<T, enableBoundsCheck> reval(sizeX_, sizeY_);
+        forEachInRows(0, sizeY_, [&reval](size_t y, size_t x, T const &val) { reval(x, y) = val; });
+
+        return reval;
+    }
+
+    /**
+     * @brief Sparse matrix-vector product result = this * v, without allocating.
+     *
+     * @param v vector of sizeX() elements
+     * @param result receives the sizeY() elements of the product, must not be v
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold non-zeros
+     *
+     * @throw matrixSizesIncompatible
+     */
+    void multiplyInto(
+        std::vector<T> const &v,
+        std::vector<T>       &result,
+        exec_policy           policy = exec_policy::automatic
+    ) const
+    {
+        if (v.size() != sizeX_)
+        {
+            throw matrixSizesIncompatible(
+                "sparse_matrix::multiply(v): x-dimension of matrix (" + toString(sizeX_) +
+                ") is not equal to size of vector (" + toString(v.size()) + ")."
+            );
+        }
+        result.resize(sizeY_);
+        forRowBlocks(
+            policy,
+            [this, &v, &result](size_t y0, size_t y1)
+            {
+                if constexpr (Format == sparse_format::csr)
+                {
+                    for (size_t y = y0; y < y1; y++)
+                    {
+                        T sum = T(0);
+                        for (size_t k = offsets_[y]; k < offsets_[y + 1]; k++)
+                        {
+                            sum += values_[k] * v[indices_[k]];
+                        }
+                        result[y] = sum;
+                    }
+                }
+                else
+                {
+                    std::fill(result.begin() + y0, result.begin() + y1, T(0));
+                    forEachInRows(y0, y1, [&v, &result](size_t y, size_t x, T const &val) { result[y] += val * v[x]; });
+                }
+            }
+        );
+    }
+
+    /**
+     * @brief Sparse matrix-vector product.
+     *
+     * @param v vector of sizeX() elements
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold non-zeros
+     *
+     * @return the product, a vector of sizeY() elements
+     *
+     * @throw matrixSizesIncompatible
+     */
+    std::vector<T> multiply(std::vector<T> const &v, exec_policy policy = exec_policy::automatic) const
+    {
+        std::vector<T> reval;
+        multiplyInto(v, reval, policy);
+
+        return reval;
+    }
+
+    friend std::vector<T> operator*(sparse_matrix const &lhs, std::vector<T> const &v)
+    {
+        return lhs.multiply(v);
+    }
+
+    /**
+     * @brief Sparse times dense matrix product: every non-zero (x,y) adds a multiple of row x of rhs to row y of the
+     * result, so the innermost loop streams through contiguous rows.
+     *
+     * @param rhs dense matrix with sizeX() rows
+     * @param policy execution policy, automatic runs in parallel above parallelThreshold non-zeros
+     *
+     * @return the dense product
+     *
+     * @throw matrixSizesIncompatible
+     */
+    template <bool enableBoundsCheck>
+    matrix<T, enableBoundsCheck>
+        multiply(matrix<T, enableBoundsCheck> const &rhs, exec_policy policy = exec_policy::automatic) const
+    {
+        if (rhs.sizeY() != sizeX_)
+        {
+            throw matrixSizesIncompatible(
+                "sparse_matrix::multiply(rhs): x-dimension of lhs-matrix (" + toString(sizeX_) +
+                ") is not equal to y-dimension rhs (" + toString(rhs.sizeY()) + ")."
+            );
+        }
+        matrix<T, enableBoundsCheck> reval(rhs.sizeX(), sizeY_);
+        size_t const                 width = rhs.sizeX();
+        forRowBlocks(
+            policy,
+            [this, &rhs, &reval, width](size_t y0, size_t y1)
+            {
+                forEachInRows(
+                    y0,
+                    y1,
+                    [&rhs, &reval, width](size_t y, size_t x, T const &val)
+                    {
+                        T       *dstRow = reval.data() + y * reval.stride();
+                        T const *rhsRow = rhs.data() + x * rhs.stride();
+                        for (size_t i = 0; i < width; i++)
+                        {
+                            dstRow[i] += val * rhsRow[i];
+                        }
+                    }
+                );
+            }
+        );
+
+        return reval;
+    }
+
+    template <bool enableBoundsCheck>
+    friend matrix<T, enableBoundsCheck> operator*(sparse_matrix const &lhs, matrix<T, enableBoundsCheck> const &rhs)
+    {
+        return lhs.multiply(rhs);
+    }
+
+    /**
+     * @brief Retrieve the diagonal elements.
+     */
+    [[nodiscard]] std::vector<T> diagonal() const
+    {
+        std::vector<T> reval(std::min(sizeX_, sizeY_), T(0));
+        for (size_t i = 0; i < reval.size(); i++)
+        {
+            reval[i] = (*this)(i, i);
+        }
+
+        return reval;
+    }
+};
+
+/**
+ * @brief Outcome of an iterative solver.
+ */
+template <typename T>
+struct iterative_solution
+{
+    std::vector<T> x;                ///< the approximate solution
+    size_t         iterations = 0;   ///< number of iterations done
+    long double    residual   = 0.0; ///< final relative residual |b - A x| / |b|
+    bool           converged  = false;
+};
+
+namespace sparse_detail
+{
+using decomposition_detail::conjugate;
+
+/**
+ * @brief Apply func(lo, hi, sums) to blocks of the index range [0, n), in parallel for long vectors, where func adds
+ * the contributions of its block to K_ sums. This lets an iteration update its vectors and compute the inner products
+ * of the result in a single pass. The blocks are added up in order, so the sums do not depend on timing.
+ *
+ * @return the K_ sums
+ */
+template <size_t K_, typename T, typename Func>
+std::array<T, K_> sumBlocks(size_t n, exec_policy policy, Func &&func)
+{
+    size_t const                   numBlocks = use_parallel(policy, n, 1UL << 16) ? parallel_thread_count() : 1;
+    std::vector<std::array<T, K_>> partial(numBlocks);
+    run_on_threads(
+        numBlocks,
+        [&func, &partial, n, numBlocks](size_t t, size_t)
+        {
+            std::array<T, K_> sums;
+            sums.fill(T(0));
+            func(n * t / numBlocks, n * (t + 1) / numBlocks, sums);
+            partial[t] = sums;
+        }
+    );
+
+    std::array<T, K_> reval;
+    reval.fill(T(0));
+    for (auto const &sums : partial)
+    {
+        for (size_t k = 0; k < K_; k++)
+        {
+            reval[k] += sums[k];
+        }
+    }
+
+    return reval;
+}
+
+/**
+ * @brief Inner product sum(conj(a[i]) * b[i]), block-wise in parallel for long vectors.
+ */
+template <typename T>
+T dot(std::vector<T> const &a, std::vector<T> const &b, exec_policy policy)
+{
+    return sumBlocks<1, T>(
+        a.size(),
+        policy,
+        [&a, &b](size_t lo, size_t hi, std::array<T, 1> &sums)
+        {
+            for (size_t i = lo; i < hi; i++)
+            {
+                sums[0] += conjugate(a[i]) * b[i];
+            }
+        }
+    )[0];
+}
+
+/**
+ * @brief Euclidean norm of a vector from its inner product with itself.
+ */
+template <typename T>
+long double normOf(T const &selfDot)
+{
+    return std::sqrt(decomposition_detail::magnitude(selfDot));
+}
+
+/**
+ * @brief Euclidean norm of a vector.
+ */
+template <typename T>
+long double norm(std::vector<T> const &a, exec_policy policy)
+{
+    return normOf(dot(a, a, policy));
+}
+
+/**
+ * @brief Apply func(lo, hi) to blocks of the index range [0, n), in parallel for long vectors.
+ */
+template <typename Func>
+void forBlocks(size_t n, exec_policy policy, Func &&func)
+{
+    if (use_parallel(policy, n, 1UL << 16))
+    {
+        parallel_for(0, n, func);
+    }
+    else
+    {
+        func(0, n);
+    }
+}
+
+/**
+ * @brief Check the system and set up the start vector and the Jacobi preconditioner, the inverse of the diagonal,
+ * replaced by 1 where the diagonal is zero.
+ */
+template <typename T, sparse_format Format>
+std::vector<T> prepareSystem(
+    sparse_matrix<T, Format> const &a,
+    std::vector<T> const           &b,
+    std::vector<T>                 &x,
+    std::string const              &location
+)
+{
+    if (a.sizeX() != a.sizeY())
+    {
+        throw matrixMustBeSquare(location + ": operation only defined for square matrices.");
+    }
+    if (b.size() != a.sizeY() || (!x.empty() && x.size() != a.sizeX()))
+    {
+        throw matrixSizesIncompatible(
+            location + ": matrix-y-dimension " + toString(a.sizeY()) + " is not equal to the size of the vectors."
+        );
+    }
+    if (x.empty())
+    {
+        x.assign(a.sizeX(), T(0));
+    }
+    std::vector<T> inverseDiagonal = a.diagonal();
+    for (auto &d : inverseDiagonal)
+    {
+        d = d != T(0) ? T(1) / d : T(1);
+    }
+
+    return inverseDiagonal;
+}
+}; // namespace sparse_detail
+
+/**
+ * @brief Solve a x = b with the Jacobi-preconditioned conjugate gradient method.
+ *
+ * The matrix must be symmetric (hermitian for complex types) and positive definite. Every iteration costs one sparse
+ * matrix-vector product and three passes over the vectors, which compute the inner products along with the updates;
+ * all of them run in parallel for large systems.
+ *
+ * @param a square, symmetric positive definite matrix
+ * @param b right-hand side
+ * @param tolerance stop when the relative residual |b - A x| / |b| is at most this
+ * @param maxIterations iteration limit, 0 means the number of rows
+ * @param policy execution policy for the products and vector operations
+ * @param x0 start vector, zero if empty
+ *
+ * @return the solution, with the number of iterations and the final residual
+ *
+ * @throw matrixMustBeSquare, matrixSizesIncompatible
+ */
+template <typename T, sparse_format Format>
+iterative_solution<T> conjugate_gradient(
+    sparse_matrix<T, Format> const &a,
+    std::vector<T> const           &b,
+    long double                     tolerance     = 1e-10L,
+    size_t                          maxIterations = 0,
+    exec_policy                     policy        = exec_policy::automatic,
+    std::vector<T>                  x0            = {}
+)
+{
+    using namespace sparse_detail;
+    iterative_solution<T> reval{std::move(x0)};
+    std::vector<T> const  inverseDiagonal = prepareSystem(a, b, reval.x, "conjugate_gradient()");
+    size_t const          n               = b.size();
+    long double const     bNorm           = norm(b, policy) > 0.0L ? norm(b, policy) : 1.0L;
+    maxIterations                         = maxIterations == 0 ? n : maxIterations;
+
+    std::vector<T> r(n);
+    std::vector<T> z(n);
+    std::vector<T> p(n);
+    std::vector<T> ap(n);
+    a.multiplyInto(reval.x, ap, policy);
+    auto [rz, rr] = sumBlocks<2, T>(
+        n,
+        policy,
+        [&](size_t lo, size_t hi, std::array<T, 2> &sums)
+        {
+            for (size_t i = lo; i < hi; i++)
+            {
+                r[i] = b[i] - ap[i];
+                z[i] = inverseDiagonal[i] * r[i];
+                p[i] = z[i];
+                sums[0] += conjugate(r[i]) * z[i];
+                sums[1] += conjugate(r[i]) * r[i];
+            }
+        }
+    );
+    reval.residual = normOf(rr) / bNorm;
+
+    while (reval.residual > tolerance && reval.iterations < maxIterations)
+    {
+        a.multiplyInto(p, ap, policy);
+        T const pap = dot(p, ap, policy);
+        if (pap == T(0))
+        {
+            break;
+        }
+        T const alpha               = rz / pap;
+        auto const [rzNext, rrNext] = sumBlocks<2, T>(
+            n,
+            policy,
+            [&](size_t lo, size_t hi, std::array<T, 2> &sums)
+            {
+                for (size_t i = lo; i < hi; i++)
+                {
+                    reval.x[i] += alpha * p[i];
+                    r[i] -= alpha * ap[i];
+                    z[i] = inverseDiagonal[i] * r[i];
+                    sums[0] += conjugate(r[i]) * z[i];
+                    sums[1] += conjugate(r[i]) * r[i];
+                }
+            }
+        );
+        T const beta = rzNext / rz;
+        rz           = rzNext;
+        forBlocks(
+            n,
+            policy,
+            [&](size_t lo, size_t hi)
+            {
+                for (size_t i = lo; i < hi; i++)
+                {
+                    p[i] = z[i] + beta * p[i];
+                }
+            }
+        );
+        reval.iterations++;
+        reval.residual = normOf(rrNext) / bNorm;
+    }
+    reval.converged = reval.residual <= tolerance;
+
+    return reval;
+}
+
+/**
+ * @brief Solve a x = b with the Jacobi-preconditioned stabilised bi-conjugate gradient method (BiCGSTAB).
+ *
+ * Unlike conjugate_gradient() this works for general, non-symmetric matrices, at the cost of two sparse
+ * matrix-vector products per iteration. The inner products are computed along with the vector updates, so that an
+ * iteration makes five passes over the vectors besides the products. The iteration stops without convergence if the
+ * method breaks down.
+ *
+ * @param a square matrix
+ * @param b right-hand side
+ * @param tolerance stop when the relative residual |b - A x| / |b| is at most this
+ * @param maxIterations iteration limit, 0 means the number of rows
+ * @param policy execution policy for the products and vector operations
+ * @param x0 start vector, zero if empty
+ *
+ * @return the solution, with the number of iterations and the final residual
+ *
+ * @throw matrixMustBeSquare, matrixSizesIncompatible
+ */
+template <typename T, sparse_format Format>
+iterative_solution<T> bicgstab(
+    sparse_matrix<T, Format> const &a,
+    std::vector<T> const           &b,
+    long double                     tolerance     = 1e-10L,
+    size_t                          maxIterations = 0,
+    exec_policy                     policy        = exec_policy::automatic,
+    std::vector<T>                  x0            = {}
+)
+{
+    using namespace sparse_detail;
+    iterative_solution<T> reval{std::move(x0)};
+    std::vector<T> const  inverseDiagonal = prepareSystem(a, b, reval.x, "bicgstab()");
+    size_t const          n               = b.size();
+    long double const     bNorm           = norm(b, policy) > 0.0L ? norm(b, policy) : 1.0L;
+    maxIterations                         = maxIterations == 0 ? n : maxIterations;
+
+    std::vector<T> r(n);
+    a.multiplyInto(reval.x, r, policy);
+    forBlocks(
+        n,
+        policy,
+        [&](size_t lo, size_t hi)
+        {
+            for (size_t i = lo; i < hi; i++)
+            {
+                r[i] = b[i] - r[i];
+            }
+        }
+    );
+    std::vector<T> const rHat = r;
+    std::vector<T>       p(n, T(0));
+    std::vector<T>       v(n, T(0));
+    std::vector<T>       y(n);
+    std::vector<T>       s(n);
+    std::vector<T>       z(n);
+    std::vector<T>       t(n);
+    T                    rho     = T(1);
+    T                    alpha   = T(1);
+    T                    omega   = T(1);
+    T                    rhoNext = dot(rHat, r, policy); // rHat is r, so this is also |r|^2
+    reval.residual               = normOf(rhoNext) / bNorm;
+
+    while (reval.residual > tolerance && reval.iterations < maxIterations)
+    {
+        if (rhoNext == T(0) || omega == T(0))
+        {
+            break;
+        }
+        T const beta = (rhoNext / rho) * (alpha / omega);
+        rho          = rhoNext;
+        forBlocks(
+            n,
+            policy,
+            [&](size_t lo, size_t hi)
+            {
+                for (size_t i = lo; i < hi; i++)
+                {
+                    p[i] = r[i] + beta * (p[i] - omega * v[i]);
+                    y[i] = inverseDiagonal[i] * p[i];
+                }
+            }
+        );
+        a.multiplyInto(y, v, policy);
+        T const rHatV = dot(rHat, v, policy);
+        if (rHatV == T(0))
+        {
+            break;
+        }
+        alpha = rho / rHatV;
+        forBlocks(
+            n,
+            policy,
+            [&](size_t lo, size_t hi)
+            {
+                for (size_t i = lo; i < hi; i++)
+                {
+                    s[i] = r[i] - alpha * v[i];
+                    z[i] = inverseDiagonal[i] * s[i];
+                }
+            }
+        );
+        a.multiplyInto(z, t, policy);
+        auto const [tt, ts] = sumBlocks<2, T>(
+            n,
+            policy,
+            [&](size_t lo, size_t hi, std::array<T, 2> &sums)
+            {
+                for (size_t i = lo; i < hi; i++)
+                {
+                    sums[0] += conjugate(t[i]) * t[i];
+                    sums[1] += conjugate(t[i]) * s[i];
+                }
+            }
+        );
+        omega                  = tt != T(0) ? ts / tt : T(0);
+        auto const [rHatR, rr] = sumBlocks<2, T>(
+            n,
+            policy,
+            [&](size_t lo, size_t hi, std::array<T, 2> &sums)
+            {
+                for (size_t i = lo; i < hi; i++)
+                {
+                    reval.x[i] += alpha * y[i] + omega * z[i];
+                    r[i] = s[i] - omega * t[i];
+                    sums[0] += conjugate(rHat[i]) * r[i];
+                    sums[1] += conjugate(r[i]) * r[i];
+                }
+            }
+        );
+        rhoNext = rHatR;
+        reval.iterations++;
+        reval.residual = normOf(rr) / bNorm;
+    }
+    reval.converged = reval.residual <= tolerance;
+
+    return reval;
+}
+
+}; // namespace util
+
+#endif // NS_UTIL_SPARSE_MATRIX_H_INCLUDED
@@ -0,0 +1,641 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/static_matrix.h
+ * Description: Matrices with dimensions fixed at compile time.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_STATIC_MATRIX_H_INCLUDED
+#define NS_UTIL_STATIC_MATRIX_H_INCLUDED
+
+#include "matrix.h"
+#include "to_string.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace util
+{
+/**
+ * @brief Matrix with dimensions that are fixed at compile time.
+ *
+ * Small transforms like 2x2, 3x3 and 4x4 matrices do not need the flexibility of matrix: static_matrix keeps its
+ * elements in a std::array, so it lives on the stack without any allocation, has no virtual functions, and all its
+ * loops have compile-time trip counts, which lets the compiler unroll them. All operations are constexpr, apart from
+ * the determinant and the inverse of matrices larger than 4x4, which are delegated to matrix.
+ * Elements are addressed like in matrix: m(x, y) is the element in column x of row y.
+ *
+ * static_matrix converts implicitly to matrix, and explicitly from a matrix of matching size.
+ *
+ * @tparam T    value-type
+ * @tparam Rows number of rows, the y-dimension
+ * @tparam Cols number of columns, the x-dimension
+ */
+template <typename T, size_t Rows, size_t Cols>
+class static_matrix
+{
+    static_assert(Rows > 0 && Cols > 0, "static_matrix dimensions must not be 0");
+
+  public:
+    using value_type = T;
+
+  private:
+    std::array<T, Rows * Cols> m_{};
+
+    /**
+     * @brief Dot product of row y of lhs with column x of rhs, unrolled over the inner dimension.
+     */
+    template <size_t RhsCols, size_t... K>
+    static constexpr T dot(
+        static_matrix<T, Rows, Cols> const    &lhs,
+        static_matrix<T, Cols, RhsCols> const &rhs,
+        size_t                                 x,
+        size_t                                 y,
+        std::index_sequence<K...>
+    )
+    {
+        return ((lhs(K, y) * rhs(x, K)) + ...);
+    }
+
+    /**
+     * @brief Throw matrixIsSingular if this matrix with the given determinant is singular.
+     */
+    constexpr void assertRegular(T const &determinant) const
+    {
+        if (isSingular(determinant))
+        {
+            throw matrixIsSingular("static_matrix<T,Rows,Cols>::inv(): Inversion of a singular matrix");
+        }
+    }
+
+  public:
+    /**
+     * @brief Default constructor: all elements are zero.
+     */
+    constexpr static_matrix() = default;
+
+    /**
+     * @brief Construct from a list of values in row-major order, missing values are zero.
+     *
+     * @param l the values, row by row
+     */
+    constexpr static_matrix(std::initializer_list<T> l)
+    {
+        size_t i = 0;
+        for (auto it = l.begin(); it != l.end() && i < Rows * Cols; it++, i++)
+        {
+            m_[i] = *it;
+        }
+    }
+
+    /**
+     * @brief Construct from a dynamic matrix of the same size.
+     *
+     * @param m the dynamic matrix
+     *
+     * @throw matrixSizesIncompatible if the dimensions of m differ from Cols x Rows
+     */
+    template <bool enableBoundsCheck>
+    explicit static_matrix(matrix<T, enableBoundsCheck> const &m)
+    {
+        if (m.sizeX() != Cols || m.sizeY() != Rows)
+        {
+            throw matrixSizesIncompatible(
+                "static_matrix<T,Rows,Cols>(matrix): matrix-size (" + toString(m.sizeX()) + "," +
+                toString(m.sizeY()) + ") is not equal static size (" + toString(Cols) + "," + toString(Rows) + ")."
+            );
+        }
+        for (size_t y = 0; y < Rows; y++)
+        {
+            for (size_t x = 0; x < Cols; x++)
+            {
+                (*this)(x, y) = m(x, y);
+            }
+        }
+    }
+
+    /**
+     * @brief Convert into a dynamic matrix.
+     * @return a matrix with the same dimensions and elements
+     */
+    template <bool enableBoundsCheck>
+    operator matrix<T, enableBoundsCheck>() const
+    {
+        matrix<T, enableBoundsCheck> reval(Cols, Rows);
+        for (size_t y = 0; y < Rows; y++)
+        {
+            std::copy(m_.begin() + y * Cols, m_.begin() + (y + 1) * Cols, reval.data() + y * reval.stride());
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Convert into a dynamic matrix.
+     * @return a matrix with the same dimensions and elements
+     */
+    template <bool enableBoundsCheck = false>
+    matrix<T, enableBoundsCheck> toMatrix() const
+    {
+        return *this;
+    }
+
+    /**
+     * @brief Create a scalar matrix, the unit matrix by default.
+     *
+     * @param c the value of the diagonal elements
+     *
+     * @return c times the unit matrix
+     */
+    static constexpr static_matrix scalar(T const &c = T(1))
+    {
+        static_assert(Rows == Cols, "scalar matrices are square");
+        static_matrix reval;
+        for (size_t i = 0; i < Rows; i++)
+        {
+            reval(i, i) = c;
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Retrieve the horizontal extent of the matrix.
+     * @return x-dimension, the number of columns
+     */
+    [[nodiscard]] static constexpr size_t sizeX()
+    {
+        return Cols;
+    }
+
+    /**
+     * @brief Retrieve the vertical extent of the matrix.
+     * @return y-dimension, the number of rows
+     */
+    [[nodiscard]] static constexpr size_t sizeY()
+    {
+        return Rows;
+    }
+
+    /**
+     * @brief Check whether this matrix is square.
+     * @return true if so, false otherwise
+     */
+    [[nodiscard]] static constexpr bool isSquare()
+    {
+        return Rows == Cols;
+    }
+
+    /**
+     * @brief Subscript operator to get/set individual elements, without bounds-check.
+     *
+     * @param x x-coordinate (column)
+     * @param y y-coordinate (row)
+     *
+     * @return reference to the element
+     */
+    constexpr T &operator()(size_t x, size_t y)
+    {
+        return m_[y * Cols + x];
+    }
+
+    /**
+     * @brief Subscript operator to get individual elements, without bounds-check.
+     *
+     * @param x x-coordinate (column)
+     * @param y y-coordinate (row)
+     *
+     * @return const reference to the element
+     */
+    constexpr T const &operator()(size_t x, size_t y) const
+    {
+        return m_[y * Cols + x];
+    }
+
+    /**
+     * @brief Direct access to the row-major data, element (x,y) is at data()[y * sizeX() + x].
+     */
+    constexpr T *data()
+    {
+        return m_.data();
+    }
+
+    /**
+     * @brief Direct access to the row-major data, element (x,y) is at data()[y * sizeX() + x].
+     */
+    constexpr T const *data() const
+    {
+        return m_.data();
+    }
+
+    friend constexpr static_matrix operator+(static_matrix const &rhs)
+    {
+        return rhs;
+    }
+
+    friend constexpr static_matrix operator-(static_matrix const &rhs)
+    {
+        static_matrix reval;
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            reval.m_[i] = -rhs.m_[i];
+        }
+
+        return reval;
+    }
+
+    constexpr static_matrix &operator+=(static_matrix const &rhs)
+    {
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            m_[i] += rhs.m_[i];
+        }
+
+        return *this;
+    }
+
+    friend constexpr static_matrix operator+(static_matrix lhs, static_matrix const &rhs)
+    {
+        return lhs += rhs;
+    }
+
+    constexpr static_matrix &operator-=(static_matrix const &rhs)
+    {
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            m_[i] -= rhs.m_[i];
+        }
+
+        return *this;
+    }
+
+    friend constexpr static_matrix operator-(static_matrix lhs, static_matrix const &rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    constexpr static_matrix &operator*=(T const &c)
+    {
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            m_[i] *= c;
+        }
+
+        return *this;
+    }
+
+    friend constexpr static_matrix operator*(static_matrix lhs, T const &c)
+    {
+        return lhs *= c;
+    }
+
+    friend constexpr static_matrix operator*(T const &c, static_matrix const &rhs)
+    {
+        static_matrix reval;
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            reval.m_[i] = c * rhs.m_[i];
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Combined scalar division and assignment operator.
+     * @throw matrixScalarMustNotBeZero
+     */
+    constexpr static_matrix &operator/=(T const &c)
+    {
+        if (c == T(0))
+        {
+            throw matrixScalarMustNotBeZero("static_matrix<T,Rows,Cols>::operator/=(c): scalar must not be 0(Zero).");
+        }
+        for (size_t i = 0; i < Rows * Cols; i++)
+        {
+            m_[i] /= c;
+        }
+
+        return *this;
+    }
+
+    friend constexpr static_matrix operator/(static_matrix lhs, T const &c)
+    {
+        return lhs /= c;
+    }
+
+    /**
+     * @brief Matrix multiplication, the inner dimension is unrolled.
+     *
+     * @param lhs left-hand-side Rows x Cols matrix
+     * @param rhs right-hand-side Cols x RhsCols matrix
+     *
+     * @return the Rows x RhsCols product
+     */
+    template <size_t RhsCols>
+    friend constexpr static_matrix<T, Rows, RhsCols>
+        operator*(static_matrix const &lhs, static_matrix<T, Cols, RhsCols> const &rhs)
+    {
+        static_matrix<T, Rows, RhsCols> reval;
+        for (size_t y = 0; y < Rows; y++)
+        {
+            for (size_t x = 0; x < RhsCols; x++)
+            {
+                reval(x, y) = dot(lhs, rhs, x, y, std::make_index_sequence<Cols>{});
+            }
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Combined multiplication and assignment operator, only for square matrices.
+     */
+    constexpr static_matrix &operator*=(static_matrix const &rhs)
+    {
+        static_assert(Rows == Cols, "in-place multiplication needs square matrices");
+
+        return *this = *this * rhs;
+    }
+
+    /**
+     * @brief This operator is used to return the transposition of the matrix.
+     */
+    friend constexpr static_matrix<T, Cols, Rows> operator~(static_matrix const &rhs)
+    {
+        static_matrix<T, Cols, Rows> reval;
+        for (size_t y = 0; y < Rows; y++)
+        {
+            for (size_t x = 0; x < Cols; x++)
+            {
+                reval(y, x) = rhs(x, y);
+            }
+        }
+
+        return reval;
+    }
+
+    /**
+     * @brief Calculate the determinant, in closed form for up to 4x4 matrices.
+     * @return the determinant
+     */
+    constexpr T det() const
+    {
+        static_assert(Rows == Cols, "the determinant is only defined for square matrices");
+        auto const &a = *this;
+
+        if constexpr (Rows == 1)
+        {
+            return a(0, 0);
+        }
+        else if constexpr (Rows == 2)
+        {
+            return a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+        }
+        else if constexpr (Rows == 3)
+        {
+            return a(0, 0) * (a(1, 1) * a(2, 2) - a(2, 1) * a(1, 2)) -
+                   a(1, 0) * (a(0, 1) * a(2, 2) - a(2, 1) * a(0, 2)) +
+                   a(2, 0) * (a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2));
+        }
+        else if constexpr (Rows == 4)
+        {
+            // expansion by the 2x2 minors of the top two and the bottom two rows
+            T const s0 = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+            T const s1 = a(0, 0) * a(2, 1) - a(0, 1) * a(2, 0);
+            T const s2 = a(0, 0) * a(3, 1) - a(0, 1) * a(3, 0);
+            T const s3 = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+            T const s4 = a(1, 0) * a(3, 1) - a(1, 1) * a(3, 0);
+            T const s5 = a(2, 0) * a(3, 1) - a(2, 1) * a(3, 0);
+            T const c5 = a(2, 2) * a(3, 3) - a(2, 3) * a(3, 2);
+            T const c4 = a(1, 2) * a(3, 3) - a(1, 3) * a(3, 2);
+            T const c3 = a(1, 2) * a(2, 3) - a(1, 3) * a(2, 2);
+            T const c2 = a(0, 2) * a(3, 3) - a(0, 3) * a(3, 2);
+            T const c1 = a(0, 2) * a(2, 3) - a(0, 3) * a(2, 2);
+            T const c0 = a(0, 2) * a(1, 3) - a(0, 3) * a(1, 2);
+
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        }
+        else
+        {
+            return toMatrix().det();
+        }
+    }
+
+    /**
+     * @brief Calculate the adjugate, the transposed matrix of co-factors, in closed form for up to 4x4 matrices, so
+     * that adj() * m == m.det() * unit-matrix.
+     *
+     * @return the adjugate
+     */
+    constexpr static_matrix adj() const
+    {
+        static_assert(Rows == Cols, "the adjugate is only defined for square matrices");
+        auto const &a = *this;
+
+        if constexpr (Rows == 1)
+        {
+            return static_matrix{T(1)};
+        }
+        else if constexpr (Rows == 2)
+        {
+            return static_matrix{a(1, 1), -a(1, 0), -a(0, 1), a(0, 0)};
+        }
+        else if constexpr (Rows == 3)
+        {
+            return static_matrix{
+                a(1, 1) * a(2, 2) - a(2, 1) * a(1, 2),
+                a(2, 0) * a(1, 2) - a(1, 0) * a(2, 2),
+                a(1, 0) * a(2, 1) - a(2, 0) * a(1, 1),
+                a(2, 1) * a(0, 2) - a(0, 1) * a(2, 2),
+                a(0, 0) * a(2, 2) - a(2, 0) * a(0, 2),
+                a(2, 0) * a(0, 1) - a(0, 0) * a(2, 1),
+                a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2),
+                a(1, 0) * a(0, 2) - a(0, 0) * a(1, 2),
+                a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1)
+            };
+        }
+        else if constexpr (Rows == 4)
+        {
+            // the 2x2 minors of the top two and the bottom two rows
+            T const s0 = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+            T const s1 = a(0, 0) * a(2, 1) - a(0, 1) * a(2, 0);
+            T const s2 = a(0, 0) * a(3, 1) - a(0, 1) * a(3, 0);
+            T const s3 = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+            T const s4 = a(1, 0) * a(3, 1) - a(1, 1) * a(3, 0);
+            T const s5 = a(2, 0) * a(3, 1) - a(2, 1) * a(3, 0);
+            T const c5 = a(2, 2) * a(3, 3) - a(2, 3) * a(3, 2);
+            T const c4 = a(1, 2) * a(3, 3) - a(1, 3) * a(3, 2);
+            T const c3 = a(1, 2) * a(2, 3) - a(1, 3) * a(2, 2);
+            T const c2 = a(0, 2) * a(3, 3) - a(0, 3) * a(3, 2);
+            T const c1 = a(0, 2) * a(2, 3) - a(0, 3) * a(2, 2);
+            T const c0 = a(0, 2) * a(1, 3) - a(0, 3) * a(1, 2);
+
+            return static_matrix{
+                a(1, 1) * c5 - a(2, 1) * c4 + a(3, 1) * c3,
+                -a(1, 0) * c5 + a(2, 0) * c4 - a(3, 0) * c3,
+                a(1, 3) * s5 - a(2, 3) * s4 + a(3, 3) * s3,
+                -a(1, 2) * s5 + a(2, 2) * s4 - a(3, 2) * s3,
+                -a(0, 1) * c5 + a(2, 1) * c2 - a(3, 1) * c1,
+                a(0, 0) * c5 - a(2, 0) * c2 + a(3, 0) * c1,
+                -a(0, 3) * s5 + a(2, 3) * s2 - a(3, 3) * s1,
+                a(0, 2) * s5 - a(2, 2) * s2 + a(3, 2) * s1,
+                a(0, 1) * c4 - a(1, 1) * c2 + a(3, 1) * c0,
+                -a(0, 0) * c4 + a(1, 0) * c2 - a(3, 0) * c0,
+                a(0, 3) * s4 - a(1, 3) * s2 + a(3, 3) * s0,
+                -a(0, 2) * s4 + a(1, 2) * s2 - a(3, 2) * s0,
+                -a(0, 1) * c3 + a(1, 1) * c1 - a(2, 1) * c0,
+                a(0, 0) * c3 - a(1, 0) * c1 + a(2, 0) * c0,
+                -a(0, 3) * s3 + a(1, 3) * s1 - a(2, 3) * s0,
+                a(0, 2) * s3 - a(1, 2) * s1 + a(2, 2) * s0
+            };
+        }
+        else
+        {
+            return static_matrix(toMatrix().adj());
+        }
+    }
+
+    /**
+     * @brief Check whether this matrix is singular, given its determinant, by the criterion of matrix::inv().
+     *
+     * A matrix that matrix::inv() rejects has a pivot within n * eps of its row, and partial pivoting grows the other
+     * pivots by at most 2^(n-1), so its determinant is at most n * 2^((n-1)^2) * eps * max|a|^n, plus the n! * eps *
+     * max|a|^n rounding of the closed form. Only determinants below that bound are checked with matrix::isSingular().
+     * Value types with exact arithmetic, and constant evaluation, only treat a zero determinant as singular.
+     *
+     * @param determinant the determinant of this matrix, as from det()
+     *
+     * @return true if so, false otherwise
+     */
+    constexpr bool isSingular(T const &determinant) const
+    {
+        static_assert(Rows == Cols, "only square matrices can be singular");
+
+        if (determinant == T(0))
+        {
+            return true;
+        }
+        if constexpr (std::numeric_limits<T>::is_specialized && std::numeric_limits<T>::is_exact)
+        {
+            return false;
+        }
+        else if constexpr (Rows > 4)
+        {
+            return toMatrix().isSingular();
+        }
+        else
+        {
+            if (std::is_constant_evaluated())
+            {
+                return false;
+            }
+
+            using std::abs;
+            constexpr size_t growth    = Rows * (size_t{1} << ((Rows - 1) * (Rows - 1)));
+            constexpr size_t factorial = Rows == 1 ? 1 : Rows == 2 ? 2 : Rows == 3 ? 6 : 24;
+            long double      maxAbs    = 0.0L;
+            for (auto const &val : m_)
+            {
+                maxAbs = std::max(maxAbs, static_cast<long double>(abs(val)));
+            }
+            long double bound = static_cast<long double>(growth + factorial) * machineEpsilon(T(0));
+            for (size_t i = 0; i < Rows; i++)
+            {
+                bound *= maxAbs;
+            }
+
+            return static_cast<long double>(abs(determinant)) <= bound && toMatrix().isSingular();
+        }
+    }
+
+    /**
+     * @brief Calculate the inverse, in closed form for up to 4x4 matrices.
+     *
+     * @return the inverse matrix
+     *
+     * @throw matrixIsSingular if the matrix is singular, judged like matrix::inv() does
+     */
+    constexpr static_matrix inv() const
+    {
+        static_assert(Rows == Cols, "only square matrices can be inverted");
+
+        if constexpr (Rows <= 4)
+        {
+            // the determinant is the product of the first row with the first column of the adjugate
+            static_matrix reval = adj();
+            T             d     = T(0);
+            for (size_t i = 0; i < Rows; i++)
+            {
+                d += (*this)(i, 0) * reval(0, i);
+            }
+            assertRegular(d);
+
+            return reval / d;
+        }
+        else
+        {
+            return static_matrix(toMatrix().inv());
+        }
+    }
+
+    /**
+     * @brief This operator has been used to calculate inversion of matrix.
+     */
+    friend constexpr static_matrix operator!(static_matrix const &rhs)
+    {
+        return rhs.inv();
+    }
+
+    friend constexpr bool operator==(static_matrix const &lhs, static_matrix const &rhs)
+    {
+        return lhs.m_ == rhs.m_;
+    }
+
+    friend constexpr bool operator!=(static_matrix const &lhs, static_matrix const &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend std::ostream &operator<<(std::ostream &ostrm, static_matrix const &m)
+    {
+        for (size_t y = 0; y < Rows; y++)
+        {
+            for (size_t x = 0; x < Cols; x++)
+            {
+                ostrm << m(x, y) << '\t';
+            }
+
+            ostrm << std::endl;
+        }
+        return ostrm;
+    }
+};
+
+}; // namespace util
+
+#endif // NS_UTIL_STATIC_MATRIX_H_INCLUDED
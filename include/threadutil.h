@@ -26,8 +26,11 @@
 #ifndef NS_UTIL_THREADUTIL_H_INCLUDED
 #define NS_UTIL_THREADUTIL_H_INCLUDED
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <exception>
 #include <functional>
 #include <future>
 #include <iostream>
@@ -96,6 +99,261 @@ auto make_exception_safe_future(Func&& func, Args&&... args) -> std::future<decl
     return future;
 }
 
+/**
+ * @brief Execution policy for algorithms that can split their work across cores.
+ */
+enum class exec_policy
+{
+    sequential, ///< always run on the calling thread
+    parallel,   ///< always split the work across all cores
+    automatic   ///< split the work only if it exceeds the algorithm's threshold
+};
+
+/**
+ * @brief Decide whether an algorithm should run in parallel.
+ *
+ * @param policy the requested policy
+ * @param work estimated amount of work, in the algorithm's own unit
+ * @param threshold amount of work below which the automatic policy stays serial
+ * @return true, if the work should be split across cores, false otherwise
+ */
+inline bool use_parallel(exec_policy policy, size_t work, size_t threshold)
+{
+    return policy == exec_policy::parallel || (policy == exec_policy::automatic && work >= threshold);
+}
+
+/**
+ * @brief Storage for the thread count set by set_parallel_thread_count(), 0 means "use all hardware threads".
+ */
+inline std::atomic<size_t>& parallelThreadCountSetting()
+{
+    static std::atomic<size_t> numThreads{0};
+    return numThreads;
+}
+
+/**
+ * @brief Set the number of threads used by parallel algorithms.
+ *
+ * @param numThreads number of threads, 0 restores the default of one thread per hardware thread
+ */
+inline void set_parallel_thread_count(size_t numThreads)
+{
+    parallelThreadCountSetting().store(numThreads, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Retrieve the number of threads used by parallel algorithms.
+ *
+ * @return size_t the number set by set_parallel_thread_count(), or else the number of hardware threads, at least 1
+ */
+inline size_t parallel_thread_count()
+{
+    size_t const numThreads = parallelThreadCountSetting().load(std::memory_order_relaxed);
+    return numThreads != 0 ? numThreads : std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Persistent worker threads for run_on_threads(), so that parallel kernels called many times in a row do not
+ * pay for creating and joining threads on every call.
+ *
+ * Every worker runs at most one task per job, so all tasks of a job run concurrently and may synchronise with each
+ * other, e.g. on a std::barrier. The pool grows on demand and its workers sleep between jobs. Only one job runs at a
+ * time; a caller that finds the pool busy, including a task that itself calls run_on_threads(), gets false from
+ * tryRun() and has to start its own threads.
+ */
+class parallel_worker_pool
+{
+  public:
+    /**
+     * @brief Retrieve the process-wide pool.
+     */
+    static parallel_worker_pool& instance()
+    {
+        static parallel_worker_pool pool;
+        return pool;
+    }
+
+    parallel_worker_pool(parallel_worker_pool const&)            = delete;
+    parallel_worker_pool& operator=(parallel_worker_pool const&) = delete;
+
+    ~parallel_worker_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker: workers_)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Run task(1) ... task(numTasks) on the workers and task(0) on the calling thread, and wait for all of
+     * them. The tasks must not throw.
+     *
+     * @param numTasks number of tasks to run on workers
+     * @param task the task, invoked with its index
+     * @return true if the job was run, false if the pool is busy with another job
+     */
+    template <typename Task_>
+    bool tryRun(size_t numTasks, Task_&& task)
+    {
+        std::unique_lock<std::mutex> busy(busy_, std::try_to_lock);
+        if (!busy.owns_lock())
+        {
+            return false;
+        }
+        std::function<void(size_t)> const job(std::ref(task));
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            while (workers_.size() < numTasks)
+            {
+                workers_.emplace_back(&parallel_worker_pool::work, this, workers_.size());
+            }
+            job_      = &job;
+            numTasks_ = numTasks;
+            pending_  = numTasks;
+            generation_++;
+        }
+        wake_.notify_all();
+        task(size_t{0});
+        std::unique_lock<std::mutex> lock(mtx_);
+        done_.wait(lock, [this]() { return pending_ == 0; });
+        job_ = nullptr;
+
+        return true;
+    }
+
+  private:
+    parallel_worker_pool() = default;
+
+    void work(size_t index)
+    {
+        size_t                       seen = 0;
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (true)
+        {
+            wake_.wait(lock, [this, &seen]() { return stop_ || generation_ != seen; });
+            if (stop_)
+            {
+                return;
+            }
+            seen = generation_;
+            if (index < numTasks_)
+            {
+                auto const* job = job_;
+                lock.unlock();
+                (*job)(index + 1);
+                lock.lock();
+                if (--pending_ == 0)
+                {
+                    done_.notify_one();
+                }
+            }
+        }
+    }
+
+    std::mutex                         busy_;
+    std::mutex                         mtx_;
+    std::condition_variable            wake_;
+    std::condition_variable            done_;
+    std::vector<std::thread>           workers_;
+    std::function<void(size_t)> const* job_        = nullptr;
+    size_t                             numTasks_   = 0;
+    size_t                             pending_    = 0;
+    size_t                             generation_ = 0;
+    bool                               stop_       = false;
+};
+
+/**
+ * @brief Run a function on a number of threads and wait for all of them to finish. The calling thread takes part as
+ * thread 0. If any invocation throws, the first exception is re-thrown after all threads have finished.
+ *
+ * The other threads are taken from parallel_worker_pool; only if the pool is busy, e.g. for nested calls, are threads
+ * created and joined for this call.
+ *
+ * @tparam Func_ function type, invoked as func(threadIndex, numThreads)
+ * @param numThreads number of threads, including the calling thread
+ * @param func the function to run
+ */
+template <typename Func_>
+void run_on_threads(size_t numThreads, Func_&& func)
+{
+    numThreads = std::max(numThreads, size_t{1});
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto                            task = [&func, &errors, numThreads](size_t t) noexcept
+    {
+        try
+        {
+            func(t, numThreads);
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+    if (numThreads == 1 || !parallel_worker_pool::instance().tryRun(numThreads - 1, task))
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (size_t t = 1; t < numThreads; t++)
+        {
+            threads.emplace_back(task, t);
+        }
+        task(size_t{0});
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+    }
+    for (auto const& error: errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * @brief Split the index range [begin, end) into one contiguous block per thread and process the blocks in parallel.
+ *
+ * @tparam Func_ function type, invoked as func(blockBegin, blockEnd)
+ * @param begin first index
+ * @param end one past the last index
+ * @param func the function to run on each block
+ * @param numThreads maximum number of threads to use
+ */
+template <typename Func_>
+void parallel_for(size_t begin, size_t end, Func_&& func, size_t numThreads = parallel_thread_count())
+{
+    if (end <= begin)
+    {
+        return;
+    }
+    numThreads = std::min(numThreads, end - begin);
+    if (numThreads <= 1)
+    {
+        func(begin, end);
+        return;
+    }
+    run_on_threads(
+        numThreads,
+        [&func, begin, end](size_t t, size_t n)
+        {
+            size_t const count = end - begin;
+            size_t const lo    = begin + count * t / n;
+            size_t const hi    = begin + count * (t + 1) / n;
+            if (lo < hi)
+            {
+                func(lo, hi);
+            }
+        }
+    );
+}
+
 /**
  * @brief Base for any thread-function
  */
@@ -0,0 +1,887 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   include/tiled_grid.h
+ * Description: Grid stored in square tiles of a memory-mapped file.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_TILED_GRID_H_INCLUDED
+#define NS_UTIL_TILED_GRID_H_INCLUDED
+
+#include "grid.h"
+#include "to_string.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace util
+{
+/**
+ * @brief Header of a tiled grid file.
+ *
+ * The header is followed, at dataOffset, by tileRows rows of tilePitch tiles each, every tile holding the rows of
+ * its square of elements without padding, in the byte order of the writing machine. A bitmap of the tiles that have
+ * been written follows the tiles.
+ */
+struct tiled_grid_file_header
+{
+    static constexpr char     magicValue[8] = {'U', 'T', 'I', 'L', 'T', 'G', 'D', '\0'};
+    static constexpr uint16_t formatVersion = 1;
+    static constexpr uint16_t byteOrderMark = 0x0102;
+    static constexpr uint64_t headerSpace   = 4096; ///< tiles start on a page boundary
+
+    char          magic[8]     = {'U', 'T', 'I', 'L', 'T', 'G', 'D', '\0'};
+    uint16_t      version      = formatVersion;
+    uint16_t      byteOrder    = byteOrderMark;
+    uint16_t      elementSize  = 0; ///< sizeof(EL_TYPE)
+    uint16_t      tileEdge     = 0; ///< number of elements along each edge of a tile
+    uint64_t      sizeX        = 0;
+    uint64_t      sizeY        = 0;
+    uint64_t      tilePitch    = 0; ///< number of tiles in a row of the file, at least the number in a row of the grid
+    uint64_t      tileRows     = 0;
+    uint64_t      dataOffset   = headerSpace;
+    unsigned char defaultValue[32]{};
+    char          reserved[40]{};
+};
+
+static_assert(sizeof(tiled_grid_file_header) == 128);
+static_assert(std::is_trivially_copyable_v<tiled_grid_file_header>);
+
+/**
+ * @brief Specialisation of the gridBase class for grids that are larger than the memory.
+ *
+ * The elements are stored in a file in square tiles of TILE_EDGE x TILE_EDGE elements. A tile is memory-mapped when
+ * one of its elements is accessed, and at most maxResidentTiles tiles are mapped at any time: when another one is
+ * needed, a tile that has not been used recently is written back, if it has been changed, and unmapped. Tiles that
+ * have never been written take no space on disk and read as the default value, so changing the default value only
+ * affects them.
+ *
+ * References to elements are valid until their tile is unmapped, that is, until tiles are accessed or the grid is
+ * resized. As tiles are mapped on demand, even const member functions must not be called concurrently.
+ *
+ * @tparam EL_TYPE   element-type, trivially copyable
+ * @tparam TILE_EDGE number of elements along each edge of a tile, a power of two
+ */
+template <typename EL_TYPE = double, size_t TILE_EDGE = 64>
+class tiled_grid : public gridBase<EL_TYPE>
+{
+    static_assert(std::is_trivially_copyable_v<EL_TYPE>, "tiles are mapped from a file");
+    static_assert(
+        sizeof(EL_TYPE) <= sizeof(tiled_grid_file_header::defaultValue), "the default value is stored in the header"
+    );
+    static_assert(std::has_single_bit(TILE_EDGE) && TILE_EDGE <= 0x8000, "the tile edge is a power of two");
+
+  public:
+    static constexpr size_t tileEdge     = TILE_EDGE;
+    static constexpr size_t tileElements = TILE_EDGE * TILE_EDGE;
+    static constexpr size_t tileBytes    = tileElements * sizeof(EL_TYPE);
+
+    /**
+     * @brief Create a new grid, replacing the file if it exists.
+     *
+     * @param filename name of the file to store the tiles in
+     * @param dimX X-dimension
+     * @param dimY Y-dimension
+     * @param defaultValue value of the elements that have not been set
+     * @param mode auto-grow behaviour
+     * @param maxResidentTiles maximal number of tiles mapped at the same time
+     *
+     * @throw grid_file_error if the file cannot be created
+     */
+    tiled_grid(
+        std::string const                     &filename,
+        size_t const                           dimX,
+        size_t const                           dimY,
+        EL_TYPE const                          defaultValue     = EL_TYPE(),
+        typename util::gridBase<EL_TYPE>::Mode mode             = util::gridBase<EL_TYPE>::Mode::AutoGrow,
+        size_t const                           maxResidentTiles = 256
+    )
+        : gridBase<EL_TYPE>(defaultValue)
+        , filename_(filename)
+        , outsideValue_(defaultValue)
+        , maxResidentTiles_(std::max(size_t{1}, maxResidentTiles))
+    {
+        this->setMode(mode);
+        fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+        {
+            throw grid_file_error("tiled_grid: cannot create '" + filename + "'.");
+        }
+        try
+        {
+            resize(dimX, dimY);
+            writeMetadata();
+        }
+        catch (...)
+        {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Open a grid that has been created by a tiled_grid with the same element type and tile edge.
+     *
+     * @param filename name of the file the tiles are stored in
+     * @param mode auto-grow behaviour
+     * @param maxResidentTiles maximal number of tiles mapped at the same time
+     *
+     * @throw grid_file_error if the file cannot be opened or does not hold a grid of this type
+     */
+    explicit tiled_grid(
+        std::string const                     &filename,
+        typename util::gridBase<EL_TYPE>::Mode mode             = util::gridBase<EL_TYPE>::Mode::AutoGrow,
+        size_t const                           maxResidentTiles = 256
+    )
+        : filename_(filename)
+        , maxResidentTiles_(std::max(size_t{1}, maxResidentTiles))
+    {
+        this->setMode(mode);
+        fd_ = ::open(filename.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd_ < 0)
+        {
+            throw grid_file_error("tiled_grid: cannot open '" + filename + "'.");
+        }
+        try
+        {
+            readMetadata();
+        }
+        catch (...)
+        {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    tiled_grid(tiled_grid const &)            = delete;
+    tiled_grid &operator=(tiled_grid const &) = delete;
+
+    /**
+     * @brief Write back all changes and close the file.
+     */
+    virtual ~tiled_grid()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            // destructors must not throw: the tiles are still written back by unmapping them
+        }
+        unmapAll();
+        ::close(fd_);
+    }
+
+    /**
+     * @brief Retrieve the size in x-dimension.
+     * @return the size in x-dimension
+     */
+    size_t sizeX() const
+    {
+        return sizeX_;
+    }
+
+    /**
+     * @brief Retrieve the size in y-dimension.
+     * @return the size in y-dimension
+     */
+    size_t sizeY() const
+    {
+        return sizeY_;
+    }
+
+    /**
+     * @brief Retrieve the number of tiles in x-dimension.
+     * @return the number of tiles in a row
+     */
+    size_t tilesX() const
+    {
+        return tileCount(sizeX_);
+    }
+
+    /**
+     * @brief Retrieve the number of tiles in y-dimension.
+     * @return the number of tiles in a column
+     */
+    size_t tilesY() const
+    {
+        return tileCount(sizeY_);
+    }
+
+    /**
+     * @brief Retrieve the number of tiles that are currently mapped.
+     * @return the number of resident tiles
+     */
+    size_t residentTiles() const
+    {
+        return resident_.size();
+    }
+
+    /**
+     * @brief Retrieve the number of mapped tiles that have been changed since they were last written back.
+     * @return the number of dirty tiles
+     */
+    size_t dirtyTiles() const
+    {
+        return std::count_if(resident_.begin(), resident_.end(), [](auto const &tile) { return tile.dirty; });
+    }
+
+    /**
+     * @brief Check whether the tile containing element (x, y) has ever been written.
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return true, if the tile holds values, false if all its elements read as the default value
+     */
+    bool isWritten(size_t const x, size_t const y) const
+    {
+        return x < sizeX_ && y < sizeY_ && written_[tileSlot(x, y)];
+    }
+
+    /**
+     * @brief Write the changed tiles and the layout back to the file.
+     *
+     * @throw grid_file_error if writing fails
+     */
+    void flush()
+    {
+        for (auto &tile : resident_)
+        {
+            if (tile.dirty)
+            {
+                if (::msync(tile.mapping, tile.length, MS_SYNC) != 0)
+                {
+                    throw grid_file_error("tiled_grid: cannot write back a tile to '" + filename_ + "'.");
+                }
+                tile.dirty = false;
+            }
+        }
+        writeMetadata();
+    }
+
+    /**
+     * @brief Resize the grid to new dimensions. Elements that become part of the grid read as the default value.
+     * Tiles that drop out of the grid are discarded, and the file is extended or truncated accordingly.
+     *
+     * @param newX new X-dimension
+     * @param newY new Y-dimension
+     *
+     * @throw grid_file_error if the file cannot be resized
+     */
+    void resize(size_t const newX, size_t const newY)
+    {
+        syncOutsideValue();
+
+        size_t const oldTilesX = tilesX();
+        size_t const oldTilesY = tilesY();
+        size_t const newTilesX = tileCount(newX);
+        size_t const newTilesY = tileCount(newY);
+
+        // elements that drop out of the grid get the default value, tiles that drop out are forgotten
+        if (newX < sizeX_ || newY < sizeY_)
+        {
+            for (size_t ty = 0; ty < std::min(oldTilesY, newTilesY); ty++)
+            {
+                for (size_t tx = 0; tx < std::min(oldTilesX, newTilesX); tx++)
+                {
+                    if (tx + 1 == newTilesX || ty + 1 == newTilesY)
+                    {
+                        fillOutside(tx, ty, newX, newY, outsideValue_);
+                    }
+                }
+            }
+            for (size_t ty = 0; ty < oldTilesY; ty++)
+            {
+                for (size_t tx = 0; tx < oldTilesX; tx++)
+                {
+                    if (tx >= newTilesX || ty >= newTilesY)
+                    {
+                        forgetTile(ty * tilePitch_ + tx);
+                    }
+                }
+            }
+        }
+
+        if (newTilesX > tilePitch_)
+        {
+            relayout(std::max(newTilesX, 2 * tilePitch_));
+        }
+        if (newTilesY != tileRows_)
+        {
+            tileRows_ = newTilesY;
+            written_.resize(tilePitch_ * tileRows_);
+            resizeFile();
+        }
+        sizeX_ = newX;
+        sizeY_ = newY;
+    }
+
+    /**
+     * @brief Retrieve the element at position (x, y), growing the grid if it is out of bounds and the mode allows.
+     * The tile of the element is written and considered changed.
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the element
+     * @throw grid_error if (x, y) is out of bounds and the grid cannot grow
+     */
+    EL_TYPE &get(size_t const x, size_t const y)
+    {
+        growToInclude(x, y, "Get");
+
+        return writableTile(tileSlot(x, y))[tileOffset(x, y)];
+    }
+
+    /**
+     * @brief Retrieve the element at position (x, y).
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the element, or the default value if (x, y) is out of bounds
+     */
+    EL_TYPE get(size_t const x, size_t const y) const
+    {
+        if (x >= sizeX_ || y >= sizeY_)
+        {
+            return this->util::gridBase<EL_TYPE>::getDefaultValue();
+        }
+        EL_TYPE const *tile = readableTile(tileSlot(x, y));
+
+        return tile == nullptr ? this->util::gridBase<EL_TYPE>::getDefaultValue() : tile[tileOffset(x, y)];
+    }
+
+    /**
+     * @brief Set a new value for element (x, y), growing the grid if it is out of bounds and the mode allows.
+     * Setting the default value in a tile that has never been written does not write it.
+     *
+     * @param x X-position
+     * @param y Y-position
+     * @param value the value to set
+     *
+     * @throw grid_error if (x, y) is out of bounds and the grid cannot grow
+     */
+    void set(size_t const x, size_t const y, const EL_TYPE &value)
+    {
+        growToInclude(x, y, "Set");
+
+        size_t const slot = tileSlot(x, y);
+        if (written_[slot] || !(value == this->util::gridBase<EL_TYPE>::getDefaultValue()))
+        {
+            writableTile(slot)[tileOffset(x, y)] = value;
+        }
+    }
+
+    /**
+     * @brief Retrieve a reference to the element at position (x, y), growing the grid if it is out of bounds and the
+     * mode allows.
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the element
+     * @throw grid_error if (x, y) is out of bounds and the grid cannot grow
+     */
+    EL_TYPE &operator()(size_t const x, size_t const y)
+    {
+        return get(x, y);
+    }
+
+    /**
+     * @brief Retrieve the element at position (x, y).
+     *
+     * @param x X-position
+     * @param y Y-position
+     *
+     * @return the element, or the default value if (x, y) is out of bounds
+     */
+    EL_TYPE operator()(size_t const x, size_t const y) const
+    {
+        return get(x, y);
+    }
+
+    /**
+     * @brief Clear the grid and set all values to the same value. All tiles are discarded, which releases their space
+     * on disk.
+     *
+     * @param value the new value
+     */
+    void setAll(const EL_TYPE &value)
+    {
+        unmapAll();
+        std::fill(written_.begin(), written_.end(), false);
+        this->setDefaultValue(value);
+        outsideValue_ = value;
+        if (::ftruncate(fd_, off_t(dataOffset)) != 0)
+        {
+            throw grid_file_error("tiled_grid: cannot truncate '" + filename_ + "'.");
+        }
+        resizeFile();
+    }
+
+    /**
+     * @brief Show the grid on cout stream
+     *
+     * @param mode display mode, Full shows all the elements, Stats the use of tiles
+     */
+    void show(typename util::gridBase<EL_TYPE>::DisplayMode mode = util::gridBase<EL_TYPE>::DisplayMode::Stats)
+    {
+        std::cout << "tiled grid sizeX=" << sizeX() << " sizeY=" << sizeY() << std::endl;
+        if (util::gridBase<EL_TYPE>::hasFlag(mode, util::gridBase<EL_TYPE>::DisplayMode::Stats))
+        {
+            std::cout << "\ttiles written:" << std::count(written_.begin(), written_.end(), true) << " of "
+                      << tilesX() * tilesY() << ", resident:" << residentTiles() << ", dirty:" << dirtyTiles()
+                      << std::endl;
+        }
+        if (util::gridBase<EL_TYPE>::hasFlag(mode, util::gridBase<EL_TYPE>::DisplayMode::Full))
+        {
+            for (size_t y = 0; y < sizeY(); y++)
+            {
+                for (size_t x = 0; x < sizeX(); x++)
+                {
+                    std::cout << (x > 0 ? "," : "") << static_cast<tiled_grid const &>(*this).get(x, y);
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+
+  private:
+    static constexpr size_t   npos       = ~size_t(0);
+    static constexpr uint64_t dataOffset = tiled_grid_file_header::headerSpace;
+    static constexpr unsigned edgeShift  = std::countr_zero(TILE_EDGE);
+
+    /**
+     * @brief A tile that is mapped into memory.
+     */
+    struct resident_tile
+    {
+        size_t   slot;
+        void    *mapping;
+        size_t   length;
+        EL_TYPE *data;
+        bool     dirty;
+        bool     referenced;
+    };
+
+    std::string       filename_;
+    int               fd_        = -1;
+    size_t            sizeX_     = 0;
+    size_t            sizeY_     = 0;
+    size_t            tilePitch_ = 0;
+    size_t            tileRows_  = 0;
+    std::vector<bool> written_;
+    EL_TYPE           outsideValue_{};
+    size_t            maxResidentTiles_;
+
+    mutable std::vector<resident_tile>         resident_;
+    mutable std::unordered_map<size_t, size_t> residentIndex_;
+    mutable size_t                             clockHand_ = 0;
+    mutable size_t                             lastSlot_  = npos;
+    mutable size_t                             lastIndex_ = 0;
+
+    static size_t tileCount(size_t const dim)
+    {
+        return (dim + TILE_EDGE - 1) >> edgeShift;
+    }
+
+    size_t tileSlot(size_t const x, size_t const y) const
+    {
+        return (y >> edgeShift) * tilePitch_ + (x >> edgeShift);
+    }
+
+    static size_t tileOffset(size_t const x, size_t const y)
+    {
+        return ((y & (TILE_EDGE - 1)) << edgeShift) + (x & (TILE_EDGE - 1));
+    }
+
+    /**
+     * @brief Find the mapped tile in the given slot of the file, mapping it if necessary.
+     *
+     * @return index of the tile in resident_
+     */
+    size_t mapTile(size_t const slot) const
+    {
+        if (slot == lastSlot_)
+        {
+            resident_[lastIndex_].referenced = true;
+            return lastIndex_;
+        }
+
+        size_t index;
+        auto   found = residentIndex_.find(slot);
+        if (found != residentIndex_.end())
+        {
+            index = found->second;
+        }
+        else
+        {
+            if (resident_.size() < maxResidentTiles_)
+            {
+                index = resident_.size();
+                resident_.push_back(resident_tile{});
+            }
+            else
+            {
+                index = evictTile();
+            }
+
+            // tiles are page-aligned unless the page size exceeds the size of a tile
+            static size_t const pageSize = size_t(::sysconf(_SC_PAGESIZE));
+            size_t const        offset   = dataOffset + slot * tileBytes;
+            size_t const        skip     = offset % pageSize;
+            void *mapping =
+                ::mmap(nullptr, skip + tileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, off_t(offset - skip));
+            if (mapping == MAP_FAILED)
+            {
+                resident_.erase(resident_.begin() + index);
+                rebuildIndex();
+                throw grid_file_error("tiled_grid: cannot map a tile of '" + filename_ + "'.");
+            }
+            EL_TYPE *data    = reinterpret_cast<EL_TYPE *>(static_cast<char *>(mapping) + skip);
+            resident_[index] = resident_tile{slot, mapping, skip + tileBytes, data, false, true};
+            residentIndex_[slot] = index;
+        }
+        resident_[index].referenced = true;
+        lastSlot_                   = slot;
+        lastIndex_                  = index;
+
+        return index;
+    }
+
+    /**
+     * @brief Unmap a tile that has not been used recently, by the clock algorithm, writing it back if it has changed.
+     *
+     * @return index of the freed entry in resident_
+     */
+    size_t evictTile() const
+    {
+        while (resident_[clockHand_].referenced)
+        {
+            resident_[clockHand_].referenced = false;
+            clockHand_                       = (clockHand_ + 1) % resident_.size();
+        }
+        size_t const index  = clockHand_;
+        auto        &victim = resident_[index];
+        if (victim.dirty)
+        {
+            // start writing back now, so that changed pages do not pile up in memory
+            ::msync(victim.mapping, victim.length, MS_ASYNC);
+        }
+        ::munmap(victim.mapping, victim.length);
+        residentIndex_.erase(victim.slot);
+        if (lastSlot_ == victim.slot)
+        {
+            lastSlot_ = npos;
+        }
+        clockHand_ = (clockHand_ + 1) % resident_.size();
+
+        return index;
+    }
+
+    /**
+     * @brief The elements of a tile for reading.
+     *
+     * @return the elements, or nullptr if the tile has never been written
+     */
+    EL_TYPE const *readableTile(size_t const slot) const
+    {
+        if (slot == lastSlot_)
+        {
+            // only written tiles are mapped
+            resident_[lastIndex_].referenced = true;
+            return resident_[lastIndex_].data;
+        }
+
+        return written_[slot] ? resident_[mapTile(slot)].data : nullptr;
+    }
+
+    /**
+     * @brief The elements of a tile for writing: the tile is marked as changed and set to the default value if it has
+     * never been written.
+     */
+    EL_TYPE *writableTile(size_t const slot)
+    {
+        if (slot == lastSlot_ && resident_[lastIndex_].dirty)
+        {
+            resident_[lastIndex_].referenced = true;
+            return resident_[lastIndex_].data;
+        }
+        if (!written_[slot])
+        {
+            syncOutsideValue();
+        }
+        auto &tile = resident_[mapTile(slot)];
+        if (!written_[slot])
+        {
+            std::fill_n(tile.data, tileElements, outsideValue_);
+            written_[slot] = true;
+        }
+        tile.dirty = true;
+
+        return tile.data;
+    }
+
+    /**
+     * @brief Set the elements of a written tile that are outside the given bounds to a value.
+     */
+    void fillOutside(size_t const tx, size_t const ty, size_t const limitX, size_t const limitY, EL_TYPE const &value)
+    {
+        size_t const slot = ty * tilePitch_ + tx;
+        if (!written_[slot])
+        {
+            return;
+        }
+        EL_TYPE *data = writableTile(slot);
+        for (size_t row = 0; row < TILE_EDGE; row++)
+        {
+            size_t const y    = (ty << edgeShift) + row;
+            size_t const x    = tx << edgeShift;
+            size_t const from = y >= limitY ? 0 : std::min(TILE_EDGE, limitX > x ? limitX - x : 0);
+            std::fill(data + (row << edgeShift) + from, data + ((row + 1) << edgeShift), value);
+        }
+    }
+
+    /**
+     * @brief Make the elements outside the grid hold the default value, so that they read as such when the grid
+     * grows, after the default value has been changed.
+     */
+    void syncOutsideValue()
+    {
+        EL_TYPE const defaultValue = this->util::gridBase<EL_TYPE>::getDefaultValue();
+        if (!(outsideValue_ == defaultValue))
+        {
+            for (size_t ty = 0; ty < tilesY(); ty++)
+            {
+                for (size_t tx = 0; tx < tilesX(); tx++)
+                {
+                    if (tx + 1 == tilesX() || ty + 1 == tilesY())
+                    {
+                        fillOutside(tx, ty, sizeX_, sizeY_, defaultValue);
+                    }
+                }
+            }
+            outsideValue_ = defaultValue;
+        }
+    }
+
+    /**
+     * @brief Discard the tile in the given slot: it reads as the default value afterwards.
+     */
+    void forgetTile(size_t const slot)
+    {
+        auto found = residentIndex_.find(slot);
+        if (found != residentIndex_.end())
+        {
+            ::munmap(resident_[found->second].mapping, resident_[found->second].length);
+            resident_.erase(resident_.begin() + found->second);
+            rebuildIndex();
+        }
+        written_[slot] = false;
+    }
+
+    void rebuildIndex() const
+    {
+        residentIndex_.clear();
+        for (size_t index = 0; index < resident_.size(); index++)
+        {
+            residentIndex_[resident_[index].slot] = index;
+        }
+        clockHand_ = 0;
+        lastSlot_  = npos;
+    }
+
+    void unmapAll() const
+    {
+        for (auto const &tile : resident_)
+        {
+            ::munmap(tile.mapping, tile.length);
+        }
+        resident_.clear();
+        residentIndex_.clear();
+        clockHand_ = 0;
+        lastSlot_  = npos;
+    }
+
+    /**
+     * @brief Move the tiles in the file so that rows of tiles hold newPitch tiles.
+     */
+    void relayout(size_t const newPitch)
+    {
+        flush();
+        unmapAll();
+
+        std::vector<bool> newWritten(newPitch * tileRows_);
+        size_t const      oldPitch = tilePitch_;
+        tilePitch_                 = newPitch;
+        resizeFile();
+
+        // the new slot of a tile is not before the old one, so moving the last tile first overwrites no tile that is
+        // still to be moved
+        std::vector<char> buffer(tileBytes);
+        for (size_t slot = oldPitch * tileRows_; slot-- > 0;)
+        {
+            if (written_[slot])
+            {
+                size_t const newSlot = (slot / oldPitch) * newPitch + slot % oldPitch;
+                off_t const  from    = off_t(dataOffset + slot * tileBytes);
+                off_t const  to      = off_t(dataOffset + newSlot * tileBytes);
+                if (::pread(fd_, buffer.data(), tileBytes, from) != ssize_t(tileBytes) ||
+                    ::pwrite(fd_, buffer.data(), tileBytes, to) != ssize_t(tileBytes))
+                {
+                    throw grid_file_error("tiled_grid: cannot move a tile in '" + filename_ + "'.");
+                }
+                newWritten[newSlot] = true;
+            }
+        }
+        written_.swap(newWritten);
+    }
+
+    /**
+     * @brief Set the length of the file to hold all tiles, followed by the bitmap of written tiles.
+     */
+    void resizeFile()
+    {
+        size_t const length = dataOffset + tilePitch_ * tileRows_ * tileBytes + (tilePitch_ * tileRows_ + 7) / 8;
+        if (::ftruncate(fd_, off_t(length)) != 0)
+        {
+            throw grid_file_error("tiled_grid: cannot resize '" + filename_ + "'.");
+        }
+    }
+
+    void writeMetadata()
+    {
+        tiled_grid_file_header header;
+        header.elementSize = sizeof(EL_TYPE);
+        header.tileEdge    = TILE_EDGE;
+        header.sizeX       = sizeX_;
+        header.sizeY       = sizeY_;
+        header.tilePitch   = tilePitch_;
+        header.tileRows    = tileRows_;
+        EL_TYPE const defaultValue = this->util::gridBase<EL_TYPE>::getDefaultValue();
+        std::memcpy(header.defaultValue, &defaultValue, sizeof(EL_TYPE));
+
+        std::vector<unsigned char> bitmap((written_.size() + 7) / 8);
+        for (size_t slot = 0; slot < written_.size(); slot++)
+        {
+            bitmap[slot / 8] |= written_[slot] ? (1U << (slot % 8)) : 0U;
+        }
+        if (::pwrite(fd_, &header, sizeof(header), 0) != ssize_t(sizeof(header)) ||
+            ::pwrite(fd_, bitmap.data(), bitmap.size(), off_t(dataOffset + written_.size() * tileBytes)) !=
+                ssize_t(bitmap.size()))
+        {
+            throw grid_file_error("tiled_grid: cannot write the layout to '" + filename_ + "'.");
+        }
+    }
+
+    void readMetadata()
+    {
+        tiled_grid_file_header header;
+        if (::pread(fd_, &header, sizeof(header), 0) != ssize_t(sizeof(header)) ||
+            std::memcmp(header.magic, tiled_grid_file_header::magicValue, sizeof(header.magic)) != 0)
+        {
+            throw grid_file_error("tiled_grid('" + filename_ + "'): not a tiled grid file.");
+        }
+        if (header.version != tiled_grid_file_header::formatVersion ||
+            header.byteOrder != tiled_grid_file_header::byteOrderMark || header.dataOffset != dataOffset)
+        {
+            throw grid_file_error("tiled_grid('" + filename_ + "'): unsupported format or byte order.");
+        }
+        if (header.elementSize != sizeof(EL_TYPE) || header.tileEdge != TILE_EDGE)
+        {
+            throw grid_file_error(
+                "tiled_grid('" + filename_ + "'): elements of size " + toString(header.elementSize) +
+                " in tiles of " + toString(header.tileEdge) + " do not match the requested " +
+                toString(sizeof(EL_TYPE)) + " in tiles of " + toString(TILE_EDGE) + "."
+            );
+        }
+
+        size_t const slots = header.tilePitch * header.tileRows;
+        struct stat  st{};
+        if (header.tilePitch < tileCount(header.sizeX) || header.tileRows != tileCount(header.sizeY) ||
+            ::fstat(fd_, &st) != 0 || uint64_t(st.st_size) < dataOffset + slots * tileBytes + (slots + 7) / 8)
+        {
+            throw grid_file_error("tiled_grid('" + filename_ + "'): the file is truncated or inconsistent.");
+        }
+        std::vector<unsigned char> bitmap((slots + 7) / 8);
+        if (::pread(fd_, bitmap.data(), bitmap.size(), off_t(dataOffset + slots * tileBytes)) != ssize_t(bitmap.size()))
+        {
+            throw grid_file_error("tiled_grid('" + filename_ + "'): cannot read the written tiles.");
+        }
+
+        sizeX_     = header.sizeX;
+        sizeY_     = header.sizeY;
+        tilePitch_ = header.tilePitch;
+        tileRows_  = header.tileRows;
+        written_.resize(slots);
+        for (size_t slot = 0; slot < slots; slot++)
+        {
+            written_[slot] = (bitmap[slot / 8] >> (slot % 8)) & 1U;
+        }
+        EL_TYPE defaultValue;
+        std::memcpy(&defaultValue, header.defaultValue, sizeof(EL_TYPE));
+        this->setDefaultValue(defaultValue);
+        outsideValue_ = defaultValue;
+    }
+
+    /**
+     * @brief Grow the grid, if necessary, so that (x, y) is within its bounds.
+     *
+     * @throw grid_error if (x, y) is out of bounds and the mode does not allow to grow
+     */
+    void growToInclude(size_t const x, size_t const y, char const *operation)
+    {
+        if (x >= sizeX_ || y >= sizeY_)
+        {
+            if ((x < sizeX_ || this->util::gridBase<EL_TYPE>::isAutoGrowX()) &&
+                (y < sizeY_ || this->util::gridBase<EL_TYPE>::isAutoGrowY()))
+            {
+                resize(std::max(x + 1, sizeX_), std::max(y + 1, sizeY_));
+            }
+            else
+            {
+                throw grid_error(
+                    std::string(operation) + " a value at " + toString(index_pair(x, y)) + " out of bounds" +
+                    toString(index_pair(sizeX_, sizeY_)) + "."
+                );
+            }
+        }
+    }
+};
+
+}; // namespace util
+
+#endif // NS_UTIL_TILED_GRID_H_INCLUDED
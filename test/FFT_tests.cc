@@ -26,8 +26,11 @@
 #include "FFT.h"
 #include "to_string.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <gtest/gtest.h>
+#include <iostream>
+#include <memory>
 #include <random>
 #include <string>
 
@@ -85,6 +88,37 @@ class FFTTest : public ::testing::Test
     FFT                    fft;
 };
 
+namespace
+{
+// the transform of a random tape of 2^logN points by both transforms agrees with a discrete Fourier transform
+template<typename T_>
+void checkAgainstDFT(int64_t logN, long double tolerance)
+{
+    basic_fft<T_>                      fft(logN);
+    int64_t const                      n = fft.numberOfPoints();
+    std::default_random_engine         generator(static_cast<unsigned>(logN));
+    std::uniform_real_distribution<T_> distribution(-1.0, 1.0);
+    vector<T_>                         samples;
+    for(int64_t i = 0; i < n; i++)
+        samples.push_back(distribution(generator));
+    fft.loadFloatVector(samples);
+
+    auto const complexSpectrum = fft.transform();
+    auto const realSpectrum    = fft.transformReal();
+    ASSERT_EQ(int64_t(realSpectrum.size()), n);
+    for(int64_t k = 0; k < n; k++)
+    {
+        complex<long double> expected;
+        for(int64_t i = 0; i < n; i++)
+            expected += (long double)samples[i] * polar(1.0L, -2.0L * numbers::pi_v<long double> * i * k / n);
+        ASSERT_NEAR(realSpectrum[k].real(), expected.real(), tolerance) << n << ":" << k;
+        ASSERT_NEAR(realSpectrum[k].imag(), expected.imag(), tolerance) << n << ":" << k;
+        ASSERT_NEAR(complexSpectrum[k].real(), expected.real(), tolerance) << n << ":" << k;
+        ASSERT_NEAR(complexSpectrum[k].imag(), expected.imag(), tolerance) << n << ":" << k;
+    }
+}
+} // namespace
+
 // 1.Input random data
 TEST_F(FFTTest, random_data_test)
 {
@@ -177,3 +211,125 @@ TEST_F(FFTTest, impulse_test)
 TEST_F(FFTTest, time_shift_test)
 {
 }
+
+TEST_F(FFTTest, precision_and_real_transform_test)
+{
+    for(int64_t logN = 0; logN <= 9; logN++)
+    {
+        checkAgainstDFT<float>(logN, 1e-4 * double(1 << logN));
+        checkAgainstDFT<double>(logN, 1e-12);
+        checkAgainstDFT<long double>(logN, 1e-12);
+    }
+}
+
+TEST_F(FFTTest, large_impulse_test)
+{
+    // a unit impulse at sample 1 transforms to exp(-2 PI i k / N): every twiddle factor of a large table is checked
+    int64_t const     logN = 16;
+    basic_fft<double> fft(logN);
+    basic_fft<double> copyOfFFT(fft);
+    int64_t const     n = fft.numberOfPoints();
+    vector<double>    impulse(n, 0.0);
+    impulse[1] = 1.0;
+    fft.loadFloatVector(impulse);
+    copyOfFFT.loadFloatVector(impulse);
+
+    auto const complexSpectrum = fft.transform();
+    auto const realSpectrum    = fft.transformReal();
+    auto const copySpectrum    = copyOfFFT.transform();
+    for(int64_t k = 0; k < n; k++)
+    {
+        auto const expected = polar(1.0L, -2.0L * numbers::pi_v<long double> * k / n);
+        ASSERT_NEAR(complexSpectrum[k].real(), expected.real(), 1e-12) << k;
+        ASSERT_NEAR(complexSpectrum[k].imag(), expected.imag(), 1e-12) << k;
+        ASSERT_NEAR(realSpectrum[k].real(), expected.real(), 1e-12) << k;
+        ASSERT_NEAR(realSpectrum[k].imag(), expected.imag(), 1e-12) << k;
+        ASSERT_EQ(copySpectrum[k], complexSpectrum[k]);
+    }
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(FFTTest, large_transform_performance_test)
+#else
+TEST_F(FFTTest, DISABLED_large_transform_performance_test)
+#endif
+{
+    // construct FFTs of 2^20 points: the first calculates the twiddle factors, the others share them
+    int64_t const logN      = 20;
+    size_t const  instances = 8;
+
+    auto                                  start = chrono::steady_clock::now();
+    vector<unique_ptr<basic_fft<double>>> ffts;
+    ffts.push_back(make_unique<basic_fft<double>>(logN));
+    chrono::duration<double> firstTime = chrono::steady_clock::now() - start;
+    start                              = chrono::steady_clock::now();
+    for(size_t i = 1; i < instances; i++)
+        ffts.push_back(make_unique<basic_fft<double>>(logN));
+    chrono::duration<double> othersTime = chrono::steady_clock::now() - start;
+
+    vector<double> samples(ffts[0]->numberOfPoints());
+    for(size_t i = 0; i < samples.size(); i++)
+        samples[i] = sin(double(i) * 0.01);
+    start = chrono::steady_clock::now();
+    for(auto &fft: ffts)
+    {
+        fft->loadFloatVector(samples);
+        fft->transformReal();
+    }
+    chrono::duration<double> transformTime = chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(ffts[0]->realAt(5), ffts[instances - 1]->realAt(5));
+    cout << "constructing an FFT of " << ffts[0]->numberOfPoints() << " points: first " << firstTime.count()
+         << "s, " << instances - 1 << " more " << othersTime.count() << "s; " << instances << " real transforms "
+         << transformTime.count() << "s" << endl;
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(FFTTest, real_transform_performance_test)
+#else
+TEST_F(FFTTest, DISABLED_real_transform_performance_test)
+#endif
+{
+    // transform 2^12 real samples repeatedly: as complex data in long double, as the FFT used to, versus packed into
+    // half as many complex values in float
+    int64_t const logN   = 12;
+    size_t const  rounds = 2000;
+
+    FFT                                   longDoubleFFT(logN);
+    basic_fft<float>                      floatFFT(logN);
+    vector<FFT::FLOATTYPE>                longDoubleSamples;
+    vector<float>                         floatSamples;
+    std::default_random_engine            generator;
+    std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+    for(int64_t i = 0; i < longDoubleFFT.numberOfPoints(); i++)
+    {
+        floatSamples.push_back(distribution(generator));
+        longDoubleSamples.push_back(floatSamples.back());
+    }
+
+    auto               start = chrono::steady_clock::now();
+    FFT::COMPLEXVECTOR longDoubleSpectrum;
+    for(size_t r = 0; r < rounds; r++)
+    {
+        longDoubleFFT.loadFloatVector(longDoubleSamples);
+        longDoubleSpectrum = longDoubleFFT.transform();
+    }
+    chrono::duration<double> longDoubleTime = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    basic_fft<float>::COMPLEXVECTOR floatSpectrum;
+    for(size_t r = 0; r < rounds; r++)
+    {
+        floatFFT.loadFloatVector(floatSamples);
+        floatSpectrum = floatFFT.transformReal();
+    }
+    chrono::duration<double> floatTime = chrono::steady_clock::now() - start;
+
+    for(size_t k = 0; k < floatSpectrum.size(); k++)
+    {
+        ASSERT_NEAR(floatSpectrum[k].real(), longDoubleSpectrum[k].real(), 1e-2);
+        ASSERT_NEAR(floatSpectrum[k].imag(), longDoubleSpectrum[k].imag(), 1e-2);
+    }
+    cout << rounds << " transforms of " << longDoubleFFT.numberOfPoints() << " real samples: complex long double "
+         << longDoubleTime.count() << "s, real float " << floatTime.count() << "s" << endl;
+}
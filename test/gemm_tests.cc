@@ -0,0 +1,222 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/gemm_tests.cc
+ * Description: Unit tests for the blocked matrix multiplication kernels.
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+#include "gemm.h"
+#include "matrix.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class GemmTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+template <typename T_>
+matrix<T_> randomMatrix(size_t xDim, size_t yDim)
+{
+    matrix<T_> reval(xDim, yDim);
+    for (size_t y = 0; y < yDim; y++)
+    {
+        for (size_t x = 0; x < xDim; x++)
+        {
+            reval(x, y) = static_cast<T_>(std::rand() % 201 - 100) / T_(50);
+        }
+    }
+    return reval;
+}
+
+template <typename T_>
+matrix<T_> naiveProduct(matrix<T_> const &lhs, matrix<T_> const &rhs)
+{
+    matrix<T_> reval(rhs.sizeX(), lhs.sizeY());
+    for (size_t y = 0; y < lhs.sizeY(); y++)
+    {
+        for (size_t x = 0; x < rhs.sizeX(); x++)
+        {
+            long double sum = 0.0L;
+            for (size_t k = 0; k < lhs.sizeX(); k++)
+            {
+                sum += static_cast<long double>(lhs(k, y)) * static_cast<long double>(rhs(x, k));
+            }
+            reval(x, y) = static_cast<T_>(sum);
+        }
+    }
+    return reval;
+}
+
+template <typename T_>
+void assertNear(matrix<T_> const &expected, matrix<T_> const &actual, T_ tolerance)
+{
+    ASSERT_EQ(expected.sizeX(), actual.sizeX());
+    ASSERT_EQ(expected.sizeY(), actual.sizeY());
+    for (size_t y = 0; y < expected.sizeY(); y++)
+    {
+        for (size_t x = 0; x < expected.sizeX(); x++)
+        {
+            ASSERT_NEAR(expected(x, y), actual(x, y), tolerance) << "at (" << x << "," << y << ")";
+        }
+    }
+}
+
+template <typename T_>
+void checkProducts(T_ tolerance)
+{
+    std::srand(4711);
+    // sizes that are not multiples of the register and cache blocks
+    for (auto [m, k, n]: std::vector<std::tuple<size_t, size_t, size_t>>{
+             {1, 1, 1},
+             {3, 5, 7},
+             {17, 33, 65},
+             {100, 300, 37},
+             {130, 257, 2100}
+         })
+    {
+        auto lhs      = randomMatrix<T_>(k, m);
+        auto rhs      = randomMatrix<T_>(n, k);
+        auto expected = naiveProduct(lhs, rhs);
+        assertNear(expected, lhs * rhs, tolerance);
+
+        // every kernel variant that the CPU supports has to give the same result
+        matrix<T_> generic(n, m);
+        gemm_detail::gemmBlocked<T_, 16>(
+            m,
+            n,
+            k,
+            lhs.data(),
+            lhs.stride(),
+            rhs.data(),
+            rhs.stride(),
+            generic.data(),
+            generic.stride(),
+            gemm_detail::microKernelGeneric<T_>
+        );
+        assertNear(expected, generic, tolerance);
+#if defined DKYB_GEMM_X86_DISPATCH_
+        if (detected_simd_level() != simd_level::generic)
+        {
+            matrix<T_> avx2(n, m);
+            gemm_detail::gemmBlocked<T_, 32>(
+                m,
+                n,
+                k,
+                lhs.data(),
+                lhs.stride(),
+                rhs.data(),
+                rhs.stride(),
+                avx2.data(),
+                avx2.stride(),
+                gemm_detail::microKernelAvx2<T_>
+            );
+            assertNear(expected, avx2, tolerance);
+        }
+#endif
+    }
+}
+
+TEST_F(GemmTest, gemm_product_test)
+{
+    checkProducts<float>(1e-2f);
+    checkProducts<double>(1e-9);
+}
+
+TEST_F(GemmTest, in_place_product_test)
+{
+    std::srand(4711);
+    auto lhs      = randomMatrix<double>(70, 150);
+    auto square   = randomMatrix<double>(70, 70);
+    auto expected = lhs * square;
+    auto inPlace  = lhs;
+    inPlace *= square;
+    assertNear(expected, inPlace, 1e-9);
+
+    // non-square right-hand side changes the dimensions
+    auto wide = randomMatrix<double>(90, 70);
+    inPlace   = lhs;
+    inPlace *= wide;
+    assertNear(lhs * wide, inPlace, 1e-9);
+
+    // self-multiplication must not read overwritten rows
+    auto self = square;
+    self *= self;
+    assertNear(square * square, self, 1e-9);
+
+    auto small = matrix<long double>(2, 2, {1.0L, 2.0L, 3.0L, 4.0L});
+    small *= matrix<long double>(2, 2, {0.0L, 1.0L, 1.0L, 0.0L});
+    ASSERT_EQ(small, matrix<long double>(2, 2, {2.0L, 1.0L, 4.0L, 3.0L}));
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(GemmTest, gemm_performance_test)
+#else
+TEST_F(GemmTest, DISABLED_gemm_performance_test)
+#endif
+{
+    std::cout << "simd level: " << static_cast<int>(detected_simd_level()) << std::endl;
+    std::cout << "dim\ttype\trow-wise[s]\tgemm[s]\tGFLOP/s" << std::endl;
+    for (size_t dim = 256; dim <= 2048; dim *= 2)
+    {
+        auto lhs = randomMatrix<double>(dim, dim);
+        auto rhs = randomMatrix<double>(dim, dim);
+
+        matrix<double> rowWise(dim, dim);
+        auto           start = std::chrono::steady_clock::now();
+        for (size_t y = 0; y < dim; y++)
+        {
+            for (size_t k = 0; k < dim; k++)
+            {
+                double const a = lhs(k, y);
+                for (size_t x = 0; x < dim; x++)
+                {
+                    rowWise(x, y) += a * rhs(x, k);
+                }
+            }
+        }
+        std::chrono::duration<double> rowWiseTime = std::chrono::steady_clock::now() - start;
+
+        start                                  = std::chrono::steady_clock::now();
+        auto                          product  = lhs * rhs;
+        std::chrono::duration<double> gemmTime = std::chrono::steady_clock::now() - start;
+
+        double const flops = 2.0 * static_cast<double>(dim * dim * dim);
+        std::cout << dim << "\tdouble\t" << rowWiseTime.count() << "\t" << gemmTime.count() << "\t"
+                  << flops / gemmTime.count() / 1e9 << std::endl;
+        assertNear(rowWise, product, 1e-6);
+    }
+}
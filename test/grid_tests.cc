@@ -0,0 +1,846 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/grid_tests.cc
+ * Description: Unit tests for grids
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "grid.h"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <malloc.h>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class GridTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+namespace
+{
+unsigned long nextRandom(unsigned long &seed)
+{
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    return seed >> 33;
+}
+
+// the cells of the grid in iteration order
+template<typename T_>
+vector<pair<index_pair, T_>> cellsOf(sparse_grid<T_> const &grid)
+{
+    vector<pair<index_pair, T_>> reval;
+    for(auto const &[index, value]: grid)
+        reval.emplace_back(index, value);
+    return reval;
+}
+
+// the cells that a map, ordered like the grid, holds
+template<typename T_>
+vector<pair<index_pair, T_>> cellsOf(map<index_pair, T_> const &reference)
+{
+    return vector<pair<index_pair, T_>>(reference.begin(), reference.end());
+}
+
+size_t allocatedBytes()
+{
+    return mallinfo2().uordblks;
+}
+
+// the element-wise view of a grid, row by row
+template<typename T_>
+vector<vector<T_>> rowsOf(grid<T_> const &g)
+{
+    vector<vector<T_>> reval(g.sizeY(), vector<T_>(g.sizeX()));
+    for(size_t y = 0; y < g.sizeY(); y++)
+        for(size_t x = 0; x < g.sizeX(); x++)
+            reval[y][x] = g(x, y);
+    return reval;
+}
+} // namespace
+
+TEST_F(GridTest, sparse_grid_test)
+{
+    sparse_grid<int>        grid(5, 4, -1);
+    sparse_grid<int> const &cgrid = grid;
+    ASSERT_EQ(grid.sizeX(), 5UL);
+    ASSERT_EQ(grid.sizeY(), 4UL);
+    ASSERT_EQ(grid.size(), 0UL);
+    ASSERT_EQ(cgrid.get(3, 2), -1);
+    ASSERT_TRUE(grid.begin() == grid.end());
+
+    // cells are iterated by row, then column, whatever order they were set in
+    grid.set(4, 3, 43);
+    grid.set(1, 0, 10);
+    grid.set(2, 3, 23);
+    grid.set(1, 2, 12);
+    grid.set(0, 3, 3);
+    ASSERT_EQ(grid.size(), 5UL);
+    vector<pair<index_pair, int>> expected{{index_pair(1, 0), 10},
+                                           {index_pair(1, 2), 12},
+                                           {index_pair(0, 3), 3},
+                                           {index_pair(2, 3), 23},
+                                           {index_pair(4, 3), 43}};
+    ASSERT_EQ(cellsOf(grid), expected);
+    ASSERT_EQ(grid.begin()->first, index_pair(1, 0));
+    ASSERT_EQ(grid.begin()->second, 10);
+    grid.begin()->second = 11;
+    ASSERT_EQ(cgrid.get(1, 0), 11);
+
+    // the indices of the cells in a row or a column
+    ASSERT_EQ(vector<size_t>(grid.beginX(3), grid.endX(3)), (vector<size_t>{0, 2, 4}));
+    ASSERT_EQ(vector<size_t>(grid.beginY(1), grid.endY(1)), (vector<size_t>{0, 2}));
+    ASSERT_EQ(vector<size_t>(grid.beginY(4), grid.endY(4)), (vector<size_t>{3}));
+    ASSERT_FALSE(grid.iteratorXValid(grid.beginX(1)));
+    ASSERT_FALSE(grid.iteratorYValid(grid.beginY(3)));
+    ASSERT_TRUE(grid.iteratorXValid(grid.beginX(0)));
+
+    // setting the default value removes a cell, getting a reference creates one
+    grid.set(2, 3, -1);
+    ASSERT_EQ(grid.size(), 4UL);
+    ASSERT_EQ(vector<size_t>(grid.beginX(3), grid.endX(3)), (vector<size_t>{0, 4}));
+    grid.get(3, 1) = 31;
+    grid(0, 0)     = 0;
+    ASSERT_EQ(grid.size(), 6UL);
+    ASSERT_EQ(cgrid(3, 1), 31);
+    ASSERT_EQ(vector<size_t>(grid.beginY(3), grid.endY(3)), (vector<size_t>{1}));
+
+    // auto-growth and bounds
+    grid.set(7, 9, 97);
+    ASSERT_EQ(grid.sizeX(), 8UL);
+    ASSERT_EQ(grid.sizeY(), 10UL);
+    sparse_grid<int> fixed(3, 3, 0, gridBase<int>::Mode::NoAutoGrow);
+    ASSERT_THROW(fixed.set(3, 0, 1), grid_error);
+    ASSERT_THROW(fixed.get(0, 3), grid_error);
+    ASSERT_THROW(grid.set(0xFFFFFFFFUL, 0, 1), grid_error);
+
+    // shrinking drops the cells outside, copies are independent
+    auto copy = grid;
+    grid.resize(4, 4);
+    ASSERT_EQ(grid.size(), 5UL);
+    ASSERT_EQ(cgrid.get(7, 9), -1);
+    ASSERT_EQ(cgrid.get(4, 3), -1);
+    ASSERT_EQ(vector<size_t>(grid.beginX(3), grid.endX(3)), (vector<size_t>{0}));
+    ASSERT_EQ(as_const(copy).get(7, 9), 97);
+    ASSERT_EQ(copy.size(), 7UL);
+
+    // setAll clears the grid and sets the new default
+    grid.setAll(5);
+    ASSERT_EQ(grid.size(), 0UL);
+    ASSERT_EQ(cgrid.get(1, 1), 5);
+    ASSERT_TRUE(grid.begin() == grid.end());
+}
+
+TEST_F(GridTest, sparse_grid_random_test)
+{
+    // random sets, some of them erasing, agree with a map
+    sparse_grid<long>     grid(100, 100, 0L);
+    map<index_pair, long> reference;
+    unsigned long         seed = 42;
+    for(size_t i = 0; i < 50000; i++)
+    {
+        size_t const x     = nextRandom(seed) % 100;
+        size_t const y     = nextRandom(seed) % 100;
+        long const   value = long(nextRandom(seed) % 4);
+        grid.set(x, y, value);
+        if(value == 0)
+            reference.erase(index_pair(x, y));
+        else
+            reference[index_pair(x, y)] = value;
+
+        if(i % 997 == 0)
+        {
+            ASSERT_EQ(grid.size(), reference.size());
+            ASSERT_EQ(cellsOf(grid), cellsOf(reference));
+            set<size_t> row;
+            set<size_t> column;
+            for(auto const &[index, value]: reference)
+            {
+                if(index.y() == y)
+                    row.insert(index.x());
+                if(index.x() == x)
+                    column.insert(index.y());
+            }
+            ASSERT_EQ(vector<size_t>(grid.beginX(y), grid.endX(y)), vector<size_t>(row.begin(), row.end()));
+            ASSERT_EQ(vector<size_t>(grid.beginY(x), grid.endY(x)), vector<size_t>(column.begin(), column.end()));
+        }
+    }
+    for(size_t y = 0; y < 100; y++)
+        for(size_t x = 0; x < 100; x++)
+        {
+            auto const found = reference.find(index_pair(x, y));
+            ASSERT_EQ(as_const(grid).get(x, y), found == reference.end() ? 0L : found->second);
+        }
+
+    // iterating after every single change merges the changes into the ordered views, while the table grows
+    sparse_grid<long>     small(30, 30, 0L);
+    map<index_pair, long> smallReference;
+    for(size_t i = 0; i < 3000; i++)
+    {
+        size_t const x     = nextRandom(seed) % 30;
+        size_t const y     = nextRandom(seed) % 30;
+        long const   value = i < 600 ? 1L : long(nextRandom(seed) % 3);
+        small.set(x, y, value);
+        if(value == 0)
+            smallReference.erase(index_pair(x, y));
+        else
+            smallReference[index_pair(x, y)] = value;
+        ASSERT_EQ(cellsOf(small), cellsOf(smallReference)) << i;
+        vector<size_t> column;
+        for(auto const &[index, value]: smallReference)
+            if(index.x() == x)
+                column.push_back(index.y());
+        ASSERT_EQ(vector<size_t>(small.beginY(x), small.endY(x)), column) << i;
+    }
+
+    // const readers may bring the ordered views up to date concurrently
+    for(size_t x = 0; x < 100; x += 3)
+    {
+        grid.set(x, 99 - x, 7L);
+        reference[index_pair(x, 99 - x)] = 7L;
+    }
+    sparse_grid<long> const &cgrid = grid;
+    vector<size_t>           counted(4, 0);
+    vector<thread>           readers;
+    for(size_t t = 0; t < counted.size(); t++)
+        readers.emplace_back(
+            [&cgrid, &counted, t]
+            {
+                // half of the readers walk the row-major view, the other half the column-major one
+                if(t % 2 == 0)
+                    counted[t] = size_t(distance(cgrid.begin(), cgrid.end()));
+                else
+                    for(size_t const count: cgrid.reduceColumns(0UL, [](size_t c, long) { return c + 1; }, exec_policy::sequential))
+                        counted[t] += count;
+            }
+        );
+    for(auto &reader: readers)
+        reader.join();
+    ASSERT_EQ(counted, vector<size_t>(counted.size(), reference.size()));
+}
+
+TEST_F(GridTest, sparse_grid_statistics_test)
+{
+    // the counters agree with counts over a map through random sets, resizes, gets that create cells and transforms
+    sparse_grid<long>        grid(60, 40, 0L);
+    sparse_grid<long> const &cgrid = grid;
+    ASSERT_EQ(cgrid.boundingBox(), make_pair(index_pair(0, 0), index_pair(0, 0)));
+    // removing the last cell empties the box again
+    grid.set(3, 4, 1L);
+    ASSERT_EQ(cgrid.boundingBox(), make_pair(index_pair(3, 4), index_pair(4, 5)));
+    grid.set(3, 4, 0L);
+    ASSERT_EQ(cgrid.boundingBox(), make_pair(index_pair(0, 0), index_pair(0, 0)));
+    unsigned long seed = 4711;
+    for(size_t i = 0; i < 20000; i++)
+    {
+        size_t const x = nextRandom(seed) % 60;
+        size_t const y = nextRandom(seed) % 40;
+        if(i % 5000 == 4999)
+        {
+            grid.resize(30 + x % 20, 20 + y % 10);
+            grid.resize(60, 40);
+        }
+        else if(i % 3001 == 3000)
+            grid.transform([](long v) { return v == 1 ? 0 : v; }, exec_policy::sequential);
+        else if(i % 7 == 0)
+            grid.get(x, y);
+        else
+            grid.set(x, y, long(nextRandom(seed) % 3));
+
+        if(i % 101 == 0 || i % 5000 == 4999 || i % 3001 == 3000)
+        {
+            map<size_t, size_t> rows;
+            map<size_t, size_t> columns;
+            index_pair          boxBegin(60, 40);
+            index_pair          boxEnd(0, 0);
+            for(auto const &[index, value]: cgrid)
+            {
+                boxBegin = index_pair(min(boxBegin.x(), index.x()), min(boxBegin.y(), index.y()));
+                boxEnd   = index_pair(max(boxEnd.x(), index.x() + 1), max(boxEnd.y(), index.y() + 1));
+                rows[index.y()]++;
+                columns[index.x()]++;
+            }
+            if(rows.empty())
+                boxBegin = index_pair(0, 0);
+            ASSERT_EQ(cgrid.rowsOccupied(), rows.size());
+            ASSERT_EQ(cgrid.columnsOccupied(), columns.size());
+            for(size_t line = 0; line < 61; line++)
+            {
+                ASSERT_EQ(cgrid.cellsInRow(line), rows.contains(line) ? rows[line] : 0UL);
+                ASSERT_EQ(cgrid.cellsInColumn(line), columns.contains(line) ? columns[line] : 0UL);
+            }
+            ASSERT_EQ(cgrid.boundingBox(), make_pair(boxBegin, boxEnd)) << i;
+        }
+    }
+    ASSERT_EQ(cgrid.cellsInRow(size_t(1) << 40), 0UL);
+
+    // the statistics are streamed
+    ostringstream stats;
+    grid.show(stats, gridBase<long>::DisplayMode::Stats);
+    ASSERT_NE(stats.str().find("rows:" + to_string(cgrid.rowsOccupied())), string::npos);
+
+    // the binary dump reads back as the same grid
+    stringstream dump;
+    grid.writeBinary(dump);
+    auto const readBack = sparse_grid<long>::readBinary(dump);
+    ASSERT_EQ(readBack.sizeX(), grid.sizeX());
+    ASSERT_EQ(readBack.sizeY(), grid.sizeY());
+    ASSERT_EQ(readBack.getDefaultValue(), 0L);
+    ASSERT_EQ(cellsOf(readBack), cellsOf(grid));
+    ASSERT_EQ(readBack.boundingBox(), cgrid.boundingBox());
+    ASSERT_EQ(readBack.rowsOccupied(), cgrid.rowsOccupied());
+
+    // dumps of elements of another size, truncated dumps and other data are rejected
+    stringstream other;
+    sparse_grid<int>(3, 3, 1).writeBinary(other);
+    ASSERT_THROW(sparse_grid<long>::readBinary(other), grid_file_error);
+    string const  truncated = dump.str().substr(0, dump.str().size() - 4);
+    istringstream truncatedDump(truncated);
+    ASSERT_THROW(sparse_grid<long>::readBinary(truncatedDump), grid_file_error);
+    istringstream notADump("not a sparse grid");
+    ASSERT_THROW(sparse_grid<long>::readBinary(notADump), grid_file_error);
+    // a corrupt key is rejected even if it lies within the dimensions of the grid
+    stringstream hugeDump;
+    sparse_grid<long> huge(size_t(1) << 40, size_t(1) << 40, 0L);
+    huge.set(3, 4, 1L);
+    huge.writeBinary(hugeDump);
+    string corrupt = hugeDump.str();
+    corrupt.replace(corrupt.size() - sizeof(long) - sizeof(uint64_t), sizeof(uint64_t), sizeof(uint64_t), '\xff');
+    istringstream corruptDump(corrupt);
+    ASSERT_THROW(sparse_grid<long>::readBinary(corruptDump), grid_file_error);
+
+    grid.setAll(5);
+    ASSERT_EQ(cgrid.rowsOccupied(), 0UL);
+    ASSERT_EQ(cgrid.boundingBox(), make_pair(index_pair(0, 0), index_pair(0, 0)));
+}
+
+TEST_F(GridTest, grid_test)
+{
+    grid<int>        g(3, 2, 7);
+    grid<int> const &cg = g;
+    ASSERT_EQ(g.sizeX(), 3UL);
+    ASSERT_EQ(g.sizeY(), 2UL);
+    ASSERT_EQ(rowsOf(g), (vector<vector<int>>{{7, 7, 7}, {7, 7, 7}}));
+
+    // growing sets the new elements to the default value and keeps the others
+    g.set(1, 1, 11);
+    g(2, 0) = 20;
+    g.set(4, 3, 43);
+    ASSERT_EQ(g.sizeX(), 5UL);
+    ASSERT_EQ(g.sizeY(), 4UL);
+    ASSERT_EQ(
+        rowsOf(g), (vector<vector<int>>{{7, 7, 20, 7, 7}, {7, 11, 7, 7, 7}, {7, 7, 7, 7, 7}, {7, 7, 7, 7, 43}})
+    );
+    ASSERT_EQ(cg.get(9, 9), 7);
+    ASSERT_THROW(cg(5, 0), grid_error);
+
+    // shrinking and growing again does not bring back old values
+    g.resize(2, 2);
+    ASSERT_EQ(rowsOf(g), (vector<vector<int>>{{7, 7}, {7, 11}}));
+    g.resize(3, 3);
+    ASSERT_EQ(rowsOf(g), (vector<vector<int>>{{7, 7, 7}, {7, 11, 7}, {7, 7, 7}}));
+    g.setDefaultValue(8);
+    g.resize(4, 3);
+    g.setDefaultValue(7);
+    ASSERT_EQ(rowsOf(g), (vector<vector<int>>{{7, 7, 7, 8}, {7, 11, 7, 8}, {7, 7, 7, 8}}));
+    g.resize(3, 3);
+
+    // capacity grows geometrically
+    grid<int> growing;
+    size_t    reallocations = 0;
+    for(size_t i = 0; i < 1000; i++)
+    {
+        size_t const capacity = growing.capacityX() * growing.capacityY();
+        growing.set(i, i / 2, int(i));
+        if(capacity != growing.capacityX() * growing.capacityY())
+            reallocations++;
+    }
+    ASSERT_LT(reallocations, 25UL);
+    for(size_t i = 0; i < 1000; i++)
+        ASSERT_EQ(growing.get(i, i / 2), int(i));
+    growing.reserve(2000, 2000);
+    ASSERT_EQ(growing.capacityX(), 2000UL);
+    ASSERT_EQ(growing.sizeX(), 1000UL);
+    ASSERT_EQ(growing.get(999, 499), 999);
+
+    // growing is restricted by the mode
+    grid<int> fixedX(2, 2, 0, gridBase<int>::Mode::AutoGrowY);
+    fixedX.set(1, 5, 15);
+    ASSERT_EQ(fixedX.sizeY(), 6UL);
+    ASSERT_THROW(fixedX.set(2, 0, 1), grid_error);
+    ASSERT_THROW(fixedX.get(2, 0), grid_error);
+
+    // filling and copying rectangles
+    g.setAll(1);
+    ASSERT_EQ(rowsOf(g), (vector<vector<int>>{{1, 1, 1}, {1, 1, 1}, {1, 1, 1}}));
+    g.fill(2, 1, 1, 2, 2);
+    ASSERT_EQ(rowsOf(g), (vector<vector<int>>{{1, 1, 1}, {1, 2, 2}, {1, 2, 2}}));
+    ASSERT_THROW(g.fill(3, 2, 2, 2, 1), grid_error);
+    grid<int> source(2, 2, 0);
+    source.set(0, 0, 5);
+    source.set(1, 1, 6);
+    g.copy(source, 0, 0, 2, 2, 2, 3);
+    ASSERT_EQ(
+        rowsOf(g), (vector<vector<int>>{{1, 1, 1, 7}, {1, 2, 2, 7}, {1, 2, 2, 7}, {7, 7, 5, 0}, {7, 7, 0, 6}})
+    );
+    ASSERT_THROW(g.copy(source, 1, 0, 2, 1, 0, 0), grid_error);
+
+    // overlapping copies within a grid
+    grid<int> line(6, 1, 0);
+    for(size_t x = 0; x < 6; x++)
+        line.set(x, 0, int(x));
+    line.copy(line, 0, 0, 4, 1, 2, 0);
+    ASSERT_EQ(rowsOf(line), (vector<vector<int>>{{0, 1, 0, 1, 2, 3}}));
+    line.copy(line, 2, 0, 4, 1, 0, 0);
+    ASSERT_EQ(rowsOf(line), (vector<vector<int>>{{0, 1, 2, 3, 2, 3}}));
+    grid<int> column(1, 4, 0);
+    for(size_t y = 0; y < 4; y++)
+        column.set(0, y, int(y));
+    column.copy(column, 0, 0, 1, 3, 0, 1);
+    ASSERT_EQ(rowsOf(column), (vector<vector<int>>{{0}, {0}, {1}, {2}}));
+
+    // copies are independent
+    auto copy = g;
+    g.setAll(0);
+    ASSERT_EQ(copy(2, 3), 5);
+}
+
+TEST_F(GridTest, grid_bulk_operations_test)
+{
+    // a grid wider than a tile of columns and higher than a band of rows, with a default value that is not 0
+    grid<long> g(600, 70, -1);
+    for(size_t y = 0; y < g.sizeY(); y++)
+        for(size_t x = 0; x < g.sizeX(); x++)
+            g.set(x, y, long(x % 17) + 10 * long(y % 13));
+    grid<long> const &cg = g;
+
+    // the sum of the 3x3 neighbourhood and the maximum of the 5x5 neighbourhood of each element
+    auto sum3 = [](grid_neighbourhood<long> const &n)
+    {
+        long reval = 0;
+        for(long dy = -1; dy <= 1; dy++)
+            for(long dx = -1; dx <= 1; dx++)
+                reval += n(dx, dy);
+        return reval;
+    };
+    auto max5 = [](grid_neighbourhood<long> const &n)
+    {
+        long reval = n(0, 0);
+        for(long dy = -2; dy <= 2; dy++)
+            for(long dx = -2; dx <= 2; dx++)
+                reval = max(reval, n(dx, dy));
+        return reval;
+    };
+    grid<long> kernel(3, 3, 0);
+    kernel.set(0, 0, 1);
+    kernel.set(2, 1, 2);
+    kernel.set(1, 2, -3);
+
+    for(auto policy: {exec_policy::sequential, exec_policy::parallel})
+    {
+        set_parallel_thread_count(4);
+        auto const sums      = cg.stencil(1, sum3, policy);
+        auto const maxima    = cg.stencil(2, max5, policy);
+        auto const weighted  = cg.applyKernel(kernel, policy);
+        auto const rowSums   = cg.reduceRows(0L, plus<long>(), policy);
+        auto const colMaxima = cg.reduceColumns(-100L, [](long a, long b) { return max(a, b); }, policy);
+        set_parallel_thread_count(0);
+
+        ASSERT_EQ(sums.sizeX(), g.sizeX());
+        ASSERT_EQ(sums.sizeY(), g.sizeY());
+        ASSERT_EQ(sums.getDefaultValue(), -1);
+        for(size_t y = 0; y < g.sizeY(); y++)
+            for(size_t x = 0; x < g.sizeX(); x++)
+            {
+                long expectedSum = 0;
+                long expectedMax = cg(x, y);
+                for(long dy = -2; dy <= 2; dy++)
+                    for(long dx = -2; dx <= 2; dx++)
+                    {
+                        // coordinates below 0 wrap around, and get() returns the default value out of bounds
+                        expectedMax = max(expectedMax, cg.get(x + dx, y + dy));
+                        if(abs(dx) <= 1 && abs(dy) <= 1)
+                            expectedSum += cg.get(x + dx, y + dy);
+                    }
+                long const expectedWeighted =
+                    cg.get(x - 1, y - 1) + 2 * cg.get(x + 1, y) - 3 * cg.get(x, y + 1);
+                ASSERT_EQ(sums(x, y), expectedSum) << x << "," << y;
+                ASSERT_EQ(maxima(x, y), expectedMax) << x << "," << y;
+                ASSERT_EQ(weighted(x, y), expectedWeighted) << x << "," << y;
+            }
+
+        ASSERT_EQ(rowSums.size(), g.sizeY());
+        for(size_t y = 0; y < g.sizeY(); y++)
+        {
+            long expected = 0;
+            for(size_t x = 0; x < g.sizeX(); x++)
+                expected += cg(x, y);
+            ASSERT_EQ(rowSums[y], expected);
+        }
+        ASSERT_EQ(colMaxima.size(), g.sizeX());
+        for(size_t x = 0; x < g.sizeX(); x++)
+            ASSERT_EQ(colMaxima[x], long(x % 17) + 120);
+    }
+
+    auto copy = g;
+    g.transform([](long v) { return 2 * v + 1; }, exec_policy::sequential);
+    set_parallel_thread_count(4);
+    copy.transform([](long v) { return 2 * v + 1; }, exec_policy::parallel);
+    set_parallel_thread_count(0);
+    ASSERT_EQ(rowsOf(g), rowsOf(copy));
+    ASSERT_EQ(cg(5, 3), 2 * (5 + 30) + 1);
+    ASSERT_EQ(cg.getDefaultValue(), -1);
+
+    // kernels must be square with odd size
+    ASSERT_THROW(cg.applyKernel(grid<long>(3, 2, 0)), grid_error);
+    ASSERT_THROW(cg.applyKernel(grid<long>(2, 2, 0)), grid_error);
+
+    // stencils of an empty grid
+    grid<long> const empty(0, 0, 0);
+    ASSERT_EQ(empty.stencil(1, sum3).sizeX(), 0UL);
+    ASSERT_TRUE(empty.reduceRows(0L, plus<long>()).empty());
+}
+
+TEST_F(GridTest, sparse_grid_bulk_operations_test)
+{
+    sparse_grid<long> s(30, 20, 0);
+    s.set(0, 0, 1);
+    s.set(1, 0, 2);
+    s.set(29, 19, 3);
+    s.set(10, 5, 4);
+    s.set(10, 7, -5);
+    s.set(12, 5, 6);
+    sparse_grid<long> const &cs = s;
+
+    auto sum3 = [](grid_neighbourhood<long> const &n)
+    {
+        long reval = 0;
+        for(long dy = -1; dy <= 1; dy++)
+            for(long dx = -1; dx <= 1; dx++)
+                reval += n(dx, dy);
+        return reval;
+    };
+
+    for(auto policy: {exec_policy::sequential, exec_policy::parallel})
+    {
+        set_parallel_thread_count(4);
+        auto const sums     = cs.stencil(1, sum3, policy);
+        auto const shifted  = cs.stencil(1, [&sum3](grid_neighbourhood<long> const &n) { return sum3(n) + 1; }, policy);
+        auto const rowSums  = cs.reduceRows(0L, plus<long>(), policy);
+        auto const colCount = cs.reduceColumns(0UL, [](size_t count, long) { return count + 1; }, policy);
+        set_parallel_thread_count(0);
+
+        // only the neighbourhoods of cells that are set are stored, and only if they do not sum to 0
+        size_t nonZero = 0;
+        for(size_t y = 0; y < s.sizeY(); y++)
+            for(size_t x = 0; x < s.sizeX(); x++)
+            {
+                long expected = 0;
+                for(size_t ny = y - 1; ny != y + 2; ny++)
+                    for(size_t nx = x - 1; nx != x + 2; nx++)
+                        expected += cs.get(nx, ny);
+                nonZero += expected != 0 ? 1 : 0;
+                ASSERT_EQ(sums.get(x, y), expected) << x << "," << y;
+                ASSERT_EQ(shifted.get(x, y), expected + 1) << x << "," << y;
+            }
+        ASSERT_EQ(sums.size(), nonZero);
+        ASSERT_EQ(sums.sizeX(), s.sizeX());
+        ASSERT_EQ(sums.sizeY(), s.sizeY());
+        ASSERT_EQ(shifted.getDefaultValue(), 1);
+        ASSERT_EQ(shifted.size(), nonZero);
+
+        // rows and columns without cells keep the initial value
+        ASSERT_EQ(rowSums, (vector<long>{3, 0, 0, 0, 0, 10, 0, -5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3}));
+        ASSERT_EQ(colCount.size(), s.sizeX());
+        ASSERT_EQ(colCount[0], 1UL);
+        ASSERT_EQ(colCount[10], 2UL);
+        ASSERT_EQ(colCount[11], 0UL);
+        ASSERT_EQ(colCount[29], 1UL);
+    }
+
+    // the kernel applies to the cells like to the elements of a dense grid
+    grid<long> kernel(3, 3, 1);
+    ASSERT_EQ(cellsOf(cs.applyKernel(kernel)), cellsOf(cs.stencil(1, sum3)));
+    ASSERT_THROW(cs.applyKernel(grid<long>(1, 3, 1)), grid_error);
+
+    // transform maps the default value too and removes the cells that become default
+    auto copy = s;
+    s.transform([](long v) { return v % 2; }, exec_policy::sequential);
+    ASSERT_EQ(s.size(), 3UL);
+    ASSERT_EQ(cs.get(0, 0), 1);
+    ASSERT_EQ(cs.get(1, 0), 0);
+    ASSERT_EQ(cs.get(10, 7), -1);
+    ASSERT_EQ(cellsOf(cs), (vector<pair<index_pair, long>>{{{0, 0}, 1}, {{10, 7}, -1}, {{29, 19}, 1}}));
+    set_parallel_thread_count(4);
+    copy.transform([](long v) { return v + 5; }, exec_policy::parallel);
+    set_parallel_thread_count(0);
+    ASSERT_EQ(copy.getDefaultValue(), 5);
+    ASSERT_EQ(copy.size(), 6UL);
+    ASSERT_EQ(as_const(copy).get(10, 7), 0);
+    ASSERT_EQ(as_const(copy).get(12, 5), 11);
+    ASSERT_EQ(as_const(copy).get(13, 5), 5);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(GridTest, sparse_grid_performance_test)
+#else
+TEST_F(GridTest, DISABLED_sparse_grid_performance_test)
+#endif
+{
+    // 10^7 random cells of a 10^5 x 10^5 grid: a map with index sets, as sparse_grid used to store its cells, versus
+    // the hash table
+    size_t const count = 10000000;
+    size_t const dim   = 100000;
+
+    unsigned long            seed   = 1;
+    size_t                   before = allocatedBytes();
+    auto                     start  = chrono::steady_clock::now();
+    map<index_pair, double>  cells;
+    map<size_t, set<size_t>> xIndices;
+    map<size_t, set<size_t>> yIndices;
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t const x          = nextRandom(seed) % dim;
+        size_t const y          = nextRandom(seed) % dim;
+        cells[index_pair(x, y)] = double(i);
+        xIndices[y].insert(x);
+        yIndices[x].insert(y);
+    }
+    double mapSum = 0.0;
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t const x     = nextRandom(seed) % dim;
+        size_t const y     = nextRandom(seed) % dim;
+        auto const   found = cells.find(index_pair(x, y));
+        mapSum += found == cells.end() ? 0.0 : found->second;
+    }
+    chrono::duration<double> mapTime  = chrono::steady_clock::now() - start;
+    size_t const             mapBytes = allocatedBytes() - before;
+    size_t const             mapCells = cells.size();
+    cells.clear();
+    xIndices.clear();
+    yIndices.clear();
+
+    seed   = 1;
+    before = allocatedBytes();
+    start  = chrono::steady_clock::now();
+    sparse_grid<double> grid(dim, dim, 0.0);
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t const x = nextRandom(seed) % dim;
+        size_t const y = nextRandom(seed) % dim;
+        grid.set(x, y, double(i));
+    }
+    double gridSum = 0.0;
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t const x = nextRandom(seed) % dim;
+        size_t const y = nextRandom(seed) % dim;
+        gridSum += as_const(grid).get(x, y);
+    }
+    chrono::duration<double> gridTime  = chrono::steady_clock::now() - start;
+    size_t const             gridBytes = allocatedBytes() - before;
+
+    // cell 0 may be set to the default value 0.0, the map keeps it, the grid does not
+    ASSERT_LE(mapCells - grid.size(), 1UL);
+    ASSERT_EQ(mapSum, gridSum);
+    cout << count << " random set and get: map and index sets " << mapTime.count() << "s "
+         << double(mapBytes) / double(mapCells) << " bytes per cell, sparse_grid " << gridTime.count() << "s "
+         << double(gridBytes) / double(grid.size()) << " bytes per cell" << endl;
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(GridTest, sparse_grid_statistics_performance_test)
+#else
+TEST_F(GridTest, DISABLED_sparse_grid_statistics_performance_test)
+#endif
+{
+    // query the statistics of a grid of 2M cells after each of 20 changes: counted from the cells in order, as the
+    // statistics used to be, versus the counters; then dump the grid as text and in binary
+    size_t const      dim     = 1UL << 20;
+    size_t const      count   = 2000000;
+    size_t const      changes = 20;
+    sparse_grid<long> grid(dim, dim, 0L);
+    unsigned long     seed = 42;
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t const x = nextRandom(seed) % dim;
+        size_t const y = nextRandom(seed) % dim;
+        grid.set(x, y, long(i + 1));
+    }
+    sparse_grid<long> const &cgrid = grid;
+
+    auto   start       = chrono::steady_clock::now();
+    size_t countedRows = 0;
+    for(size_t i = 0; i < changes; i++)
+    {
+        grid.set(nextRandom(seed) % dim, nextRandom(seed) % dim, 1L);
+        countedRows  = 0;
+        size_t lastY = dim;
+        for(auto const &[index, value]: cgrid)
+        {
+            countedRows += index.y() != lastY ? 1 : 0;
+            lastY = index.y();
+        }
+    }
+    chrono::duration<double> countedTime = chrono::steady_clock::now() - start;
+
+    start              = chrono::steady_clock::now();
+    size_t counterRows = 0;
+    for(size_t i = 0; i < changes; i++)
+    {
+        grid.set(nextRandom(seed) % dim, nextRandom(seed) % dim, 1L);
+        counterRows = cgrid.rowsOccupied();
+    }
+    chrono::duration<double> counterTime = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    ostringstream text;
+    grid.show(text, gridBase<long>::DisplayMode::Sparse);
+    chrono::duration<double> textTime = chrono::steady_clock::now() - start;
+    start                             = chrono::steady_clock::now();
+    ostringstream binary;
+    grid.writeBinary(binary);
+    chrono::duration<double> binaryTime = chrono::steady_clock::now() - start;
+
+    ASSERT_LE(counterRows - countedRows, 2 * changes);
+    ASSERT_EQ(binary.str().size(), sizeof(sparse_grid_file_header) + cgrid.size() * (sizeof(uint64_t) + sizeof(long)));
+    cout << changes << " statistics queries after changes to " << cgrid.size() << " cells: counted "
+         << countedTime.count() << "s, counters " << counterTime.count() << "s; dump as text " << textTime.count()
+         << "s, binary " << binaryTime.count() << "s" << endl;
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(GridTest, grid_performance_test)
+#else
+TEST_F(GridTest, DISABLED_grid_performance_test)
+#endif
+{
+    // grow a grid one cell at a time along the diagonal, then overwrite it repeatedly: a vector of columns, as grid
+    // used to store its elements, versus the single buffer
+    size_t const dim    = 4000;
+    size_t const rounds = 20;
+
+    auto                   start = chrono::steady_clock::now();
+    vector<vector<double>> columns;
+    for(size_t i = 0; i < dim; i++)
+    {
+        columns.resize(i + 1);
+        for(auto &column: columns)
+            column.resize(i + 1);
+        columns[i][i] = double(i);
+    }
+    chrono::duration<double> columnsGrowTime = chrono::steady_clock::now() - start;
+    start                                    = chrono::steady_clock::now();
+    for(size_t r = 0; r < rounds; r++)
+        for(size_t x = 0; x < dim; x++)
+            for(size_t y = 0; y < dim; y++)
+                columns[x][y] = double(r);
+    chrono::duration<double> columnsSetAllTime = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    grid<double> g;
+    for(size_t i = 0; i < dim; i++)
+        g.set(i, i, double(i));
+    chrono::duration<double> gridGrowTime = chrono::steady_clock::now() - start;
+    start                                 = chrono::steady_clock::now();
+    for(size_t r = 0; r < rounds; r++)
+        g.setAll(double(r));
+    chrono::duration<double> gridSetAllTime = chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(g.sizeX(), dim);
+    ASSERT_EQ(g.sizeY(), dim);
+    ASSERT_EQ(g(dim - 1, 0), columns[dim - 1][0]);
+    cout << "growing a " << dim << "x" << dim << " grid by the cell: vector of columns " << columnsGrowTime.count()
+         << "s, grid " << gridGrowTime.count() << "s; setting all " << rounds << " times: vector of columns "
+         << columnsSetAllTime.count() << "s, grid " << gridSetAllTime.count() << "s" << endl;
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(GridTest, grid_bulk_operations_performance_test)
+#else
+TEST_F(GridTest, DISABLED_grid_bulk_operations_performance_test)
+#endif
+{
+    // blur a 4096x4096 grid with a 3x3 kernel and sum its columns: element by element through the accessors, versus
+    // the bulk operations
+    size_t const dim = 4096;
+    grid<double> g(dim, dim, 0.0);
+    for(size_t y = 0; y < dim; y++)
+        for(size_t x = 0; x < dim; x++)
+            g.set(x, y, double((x * 7 + y * 3) % 11));
+    grid<double> const &cg = g;
+    grid<double>        kernel(3, 3, 1.0 / 9.0);
+
+    auto         start = chrono::steady_clock::now();
+    grid<double> blurredByElement(dim, dim, 0.0);
+    for(size_t y = 0; y < dim; y++)
+        for(size_t x = 0; x < dim; x++)
+        {
+            double sum = 0.0;
+            for(size_t ky = 0; ky < 3; ky++)
+                for(size_t kx = 0; kx < 3; kx++)
+                    sum += as_const(kernel)(kx, ky) * cg.get(x + kx - 1, y + ky - 1);
+            blurredByElement.set(x, y, sum);
+        }
+    vector<double> columnSumsByElement(dim, 0.0);
+    for(size_t x = 0; x < dim; x++)
+        for(size_t y = 0; y < dim; y++)
+            columnSumsByElement[x] += as_const(blurredByElement)(x, y);
+    chrono::duration<double> byElementTime = chrono::steady_clock::now() - start;
+
+    start                            = chrono::steady_clock::now();
+    auto const blurred               = cg.applyKernel(kernel, exec_policy::sequential);
+    auto const columnSums            = blurred.reduceColumns(0.0, plus<double>(), exec_policy::sequential);
+    chrono::duration<double> bulkTime = chrono::steady_clock::now() - start;
+
+    set_parallel_thread_count(4);
+    start                                 = chrono::steady_clock::now();
+    auto const blurredParallel            = cg.applyKernel(kernel, exec_policy::parallel);
+    auto const columnSumsParallel         = blurredParallel.reduceColumns(0.0, plus<double>(), exec_policy::parallel);
+    chrono::duration<double> parallelTime = chrono::steady_clock::now() - start;
+    set_parallel_thread_count(0);
+
+    for(size_t x = 0; x < dim; x++)
+    {
+        ASSERT_NEAR(columnSums[x], columnSumsByElement[x], 1e-6);
+        ASSERT_EQ(columnSums[x], columnSumsParallel[x]);
+    }
+    cout << "blurring a " << dim << "x" << dim << " grid and summing its columns: by element " << byElementTime.count()
+         << "s, bulk operations " << bulkTime.count() << "s, bulk operations on 4 threads " << parallelTime.count()
+         << "s" << endl;
+}
@@ -23,10 +23,19 @@
  * @author: Dieter J Kybelksties
  */
 #include "heap.h"
+#include "performance_timer.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <gtest/gtest.h>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <queue>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 using namespace std;
 using namespace util;
@@ -152,3 +161,617 @@ TEST_F(HeapTest, std_heap_test)
     ASSERT_EQ(hipp.size(), 0UL);
     ASSERT_EQ(hipp.top(), nullptr);
 }
+
+template <size_t Arity_>
+void checkDaryHeapOrder()
+{
+    heap<int32_t, std::greater<int32_t>, Arity_> minHeap;
+    std::vector<int32_t>                         elements;
+    std::srand(4711);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        elements.push_back(std::rand() % 100);
+        minHeap.insert(elements.back());
+    }
+    std::sort(elements.begin(), elements.end());
+    ASSERT_EQ(minHeap.size(), elements.size());
+    for (auto const &expected: elements)
+    {
+        ASSERT_NE(minHeap.top(), nullptr);
+        ASSERT_EQ(*minHeap.top(), expected);
+        minHeap.pop();
+    }
+    ASSERT_TRUE(minHeap.empty());
+    ASSERT_EQ(minHeap.top(), nullptr);
+}
+
+TEST_F(HeapTest, dary_heap_test)
+{
+    checkDaryHeapOrder<2>();
+    checkDaryHeapOrder<4>();
+    checkDaryHeapOrder<8>();
+
+    heap<std::string, std::less<std::string>, 4> maxHeap;
+    maxHeap.insert("b");
+    maxHeap.insert("d");
+    maxHeap.insert("a");
+    maxHeap.insert("c");
+    ASSERT_EQ(*maxHeap.top(), "d");
+    ASSERT_THROW(maxHeap[4], std::out_of_range);
+    maxHeap.pop();
+    ASSERT_EQ(*maxHeap.top(), "c");
+    maxHeap.clear();
+    ASSERT_TRUE(maxHeap.empty());
+}
+
+template <typename HeapT_>
+void benchmarkHeap(std::vector<int32_t> const &elements, int64_t &checksum)
+{
+    HeapT_ h;
+    for (auto const &element: elements)
+    {
+        h.insert(element);
+    }
+    while (!h.empty())
+    {
+        checksum += *h.top();
+        h.pop();
+    }
+}
+
+void benchmarkPriorityQueue(std::vector<int32_t> const &elements, int64_t &checksum)
+{
+    std::priority_queue<int32_t, std::vector<int32_t>, std::greater<int32_t>> h;
+    for (auto const &element: elements)
+    {
+        h.push(element);
+    }
+    while (!h.empty())
+    {
+        checksum += h.top();
+        h.pop();
+    }
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(HeapTest, heap_performance_test)
+#else
+TEST_F(HeapTest, DISABLED_heap_performance_test)
+#endif
+{
+    RESET_PERF;
+    std::vector<int32_t> elements;
+    std::srand(4711);
+    for (size_t i = 0; i < 2'000'000; i++)
+    {
+        elements.push_back(std::rand());
+    }
+    int64_t checksum = 0;
+
+    START_NAMED_PERF(heap_2ary);
+    benchmarkHeap<heap<int32_t, std::greater<int32_t>, 2>>(elements, checksum);
+    END_PERF;
+    START_NAMED_PERF(heap_4ary);
+    benchmarkHeap<heap<int32_t, std::greater<int32_t>, 4>>(elements, checksum);
+    END_PERF;
+    START_NAMED_PERF(heap_8ary);
+    benchmarkHeap<heap<int32_t, std::greater<int32_t>, 8>>(elements, checksum);
+    END_PERF;
+    START_NAMED_PERF(std_heap);
+    benchmarkHeap<std_heap<int32_t>>(elements, checksum);
+    END_PERF;
+    START_NAMED_PERF(priority_queue);
+    benchmarkPriorityQueue(elements, checksum);
+    END_PERF;
+    START_NAMED_PERF(heap_4ary_bulk_build);
+    heap<int32_t, std::greater<int32_t>, 4> bulkHeap(elements.begin(), elements.end());
+    END_PERF;
+    checksum += *bulkHeap.top();
+
+    ASSERT_NE(checksum, 0L);
+    std::cout << util::performance_timer::instance() << std::endl;
+}
+
+TEST_F(HeapTest, indexed_heap_test)
+{
+    indexed_heap<int32_t> minHeap;
+    ASSERT_TRUE(minHeap.empty());
+    ASSERT_EQ(minHeap.top(), nullptr);
+    ASSERT_EQ(minHeap.topHandle(), indexed_heap<int32_t>::npos);
+
+    auto h5  = minHeap.insert(5);
+    auto h10 = minHeap.insert(10);
+    auto h7  = minHeap.insert(7);
+    auto h1  = minHeap.insert(1);
+    ASSERT_EQ(minHeap.size(), 4UL);
+    ASSERT_EQ(*minHeap.top(), 1);
+    ASSERT_EQ(minHeap.topHandle(), h1);
+    ASSERT_EQ(minHeap[h7], 7);
+
+    // decrease-key moves the element to the top
+    minHeap.update(h10, 0);
+    ASSERT_EQ(*minHeap.top(), 0);
+    ASSERT_EQ(minHeap.topHandle(), h10);
+
+    // increase-key moves the element down
+    minHeap.update(h10, 20);
+    ASSERT_EQ(*minHeap.top(), 1);
+
+    minHeap.erase(h1);
+    ASSERT_FALSE(minHeap.contains(h1));
+    ASSERT_THROW(minHeap.erase(h1), std::out_of_range);
+    ASSERT_THROW(minHeap.update(h1, 3), std::out_of_range);
+    ASSERT_EQ(*minHeap.top(), 5);
+    ASSERT_EQ(minHeap.topHandle(), h5);
+
+    // released handles are reused
+    auto h3 = minHeap.insert(3);
+    ASSERT_EQ(h3, h1);
+    ASSERT_EQ(*minHeap.top(), 3);
+
+    std::vector<int32_t> popped;
+    while (!minHeap.empty())
+    {
+        popped.push_back(*minHeap.top());
+        minHeap.pop();
+    }
+    ASSERT_EQ(popped, (std::vector<int32_t>{3, 5, 7, 20}));
+}
+
+TEST_F(HeapTest, indexed_heap_random_update_test)
+{
+    indexed_heap<int32_t, std::less<int32_t>, 2> maxHeap;
+    std::vector<int32_t>                         keys(500);
+    std::vector<size_t>                          handles(keys.size());
+    std::srand(4711);
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        keys[i]    = std::rand() % 1000;
+        handles[i] = maxHeap.insert(keys[i]);
+    }
+    for (size_t i = 0; i < keys.size(); i += 3)
+    {
+        keys[i] = std::rand() % 1000;
+        maxHeap.update(handles[i], keys[i]);
+    }
+    std::vector<int32_t> expected;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (i % 5 == 1)
+        {
+            maxHeap.erase(handles[i]);
+        }
+        else
+        {
+            expected.push_back(keys[i]);
+        }
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<int32_t>());
+    ASSERT_EQ(maxHeap.size(), expected.size());
+    for (auto const &key: expected)
+    {
+        ASSERT_EQ(*maxHeap.top(), key);
+        maxHeap.pop();
+    }
+    ASSERT_TRUE(maxHeap.empty());
+}
+
+TEST_F(HeapTest, indexed_heap_dijkstra_test)
+{
+    // adjacency list: (target, weight)
+    std::vector<std::vector<std::pair<size_t, int32_t>>> graph{
+        {{1, 4}, {2, 1}},
+        {{3, 1}},
+        {{1, 2}, {3, 5}},
+        {{4, 3}},
+        {}
+    };
+    using dist_t = std::pair<int32_t, size_t>;
+    std::vector<int32_t> dist(graph.size(), std::numeric_limits<int32_t>::max());
+    std::vector<size_t>  handles(graph.size(), indexed_heap<dist_t>::npos);
+    indexed_heap<dist_t> queue;
+    dist[0]    = 0;
+    handles[0] = queue.insert({0, 0});
+    while (!queue.empty())
+    {
+        auto [d, u] = *queue.top();
+        queue.pop();
+        for (auto const &[v, w]: graph[u])
+        {
+            if (d + w < dist[v])
+            {
+                dist[v] = d + w;
+                if (queue.contains(handles[v]))
+                {
+                    queue.update(handles[v], {dist[v], v});
+                }
+                else
+                {
+                    handles[v] = queue.insert({dist[v], v});
+                }
+            }
+        }
+    }
+    ASSERT_EQ(dist, (std::vector<int32_t>{0, 3, 1, 4, 7}));
+}
+
+TEST_F(HeapTest, heap_bulk_construction_test)
+{
+    std::vector<int32_t> elements;
+    std::srand(4711);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        elements.push_back(std::rand() % 500);
+    }
+
+    heap<int32_t, std::greater<int32_t>, 4> minHeap(elements.begin(), elements.end());
+    ASSERT_EQ(minHeap.size(), elements.size());
+    heap<int32_t, std::greater<int32_t>, 4> otherHeap;
+    otherHeap.assign(elements.begin(), elements.begin() + 10);
+    ASSERT_EQ(otherHeap.size(), 10UL);
+    otherHeap.assign(elements.begin() + 10, elements.end());
+    ASSERT_EQ(otherHeap.size(), elements.size() - 10);
+
+    // merge a large heap and a small heap in both directions
+    heap<int32_t, std::greater<int32_t>, 4> smallHeap(elements.begin(), elements.begin() + 10);
+    otherHeap.merge(std::move(smallHeap));
+    ASSERT_TRUE(smallHeap.empty());
+    minHeap.merge(std::move(otherHeap));
+    ASSERT_TRUE(otherHeap.empty());
+    // merging a heap into itself is a no-op
+    minHeap.merge(std::move(minHeap));
+    ASSERT_EQ(minHeap.size(), 2 * elements.size());
+
+    // two integral arguments must not be taken for an iterator range
+    static_assert(!std::is_constructible_v<heap<size_t>, size_t, size_t>);
+
+    std::vector<int32_t> expected = elements;
+    expected.insert(expected.end(), elements.begin(), elements.end());
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(minHeap.size(), expected.size());
+    for (auto const &key: expected)
+    {
+        ASSERT_EQ(*minHeap.top(), key);
+        minHeap.pop();
+    }
+    ASSERT_TRUE(minHeap.empty());
+}
+
+TEST_F(HeapTest, pairing_heap_test)
+{
+    pairing_heap<int32_t, std::less<int32_t>> maxHeap;
+    ASSERT_TRUE(maxHeap.empty());
+    ASSERT_EQ(maxHeap.top(), nullptr);
+    maxHeap.pop();
+    ASSERT_TRUE(maxHeap.empty());
+
+    for (auto const &element: {5, 10, 7, 1, 1, 10})
+    {
+        maxHeap.insert(element);
+    }
+    ASSERT_EQ(maxHeap.size(), 6UL);
+    ASSERT_EQ(*maxHeap.top(), 10);
+
+    pairing_heap<int32_t, std::less<int32_t>> otherHeap;
+    otherHeap.insert(8);
+    otherHeap.insert(12);
+    maxHeap.merge(std::move(otherHeap));
+    ASSERT_TRUE(otherHeap.empty());
+    ASSERT_EQ(maxHeap.size(), 8UL);
+
+    std::vector<int32_t> popped;
+    while (!maxHeap.empty())
+    {
+        popped.push_back(*maxHeap.top());
+        maxHeap.pop();
+    }
+    ASSERT_EQ(popped, (std::vector<int32_t>{12, 10, 10, 8, 7, 5, 1, 1}));
+
+    // destruction of a non-empty heap must release all nodes
+    pairing_heap<int32_t> leftOver;
+    for (int32_t i = 0; i < 1000; i++)
+    {
+        leftOver.insert(i);
+    }
+    leftOver.pop();
+    auto moved = std::move(leftOver);
+    ASSERT_TRUE(leftOver.empty());
+    ASSERT_EQ(moved.size(), 999UL);
+    ASSERT_EQ(*moved.top(), 1);
+}
+
+TEST_F(HeapTest, pairing_heap_k_way_merge_test)
+{
+    using entry_t = std::pair<int32_t, size_t>;  // (value, shard)
+    std::vector<std::vector<int32_t>> shards(8);
+    std::vector<int32_t>              expected;
+    std::srand(4711);
+    for (auto &shard: shards)
+    {
+        for (size_t i = 0; i < 100; i++)
+        {
+            shard.push_back(std::rand() % 10000);
+        }
+        std::sort(shard.begin(), shard.end());
+        expected.insert(expected.end(), shard.begin(), shard.end());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    // each shard contributes a partial queue, the partial queues are merged into one
+    pairing_heap<entry_t> merged;
+    std::vector<size_t>   next(shards.size(), 1UL);
+    for (size_t s = 0; s < shards.size(); s++)
+    {
+        pairing_heap<entry_t> partial;
+        partial.insert({shards[s][0], s});
+        merged.merge(std::move(partial));
+    }
+    std::vector<int32_t> result;
+    while (!merged.empty())
+    {
+        auto [value, s] = *merged.top();
+        merged.pop();
+        result.push_back(value);
+        if (next[s] < shards[s].size())
+        {
+            merged.insert({shards[s][next[s]++], s});
+        }
+    }
+    ASSERT_EQ(result, expected);
+}
+
+TEST_F(HeapTest, concurrent_heap_single_queue_test)
+{
+    // with a single sub-heap the ordering is exact
+    concurrent_heap<int32_t> minHeap(1);
+    ASSERT_TRUE(minHeap.empty());
+    ASSERT_FALSE(minHeap.try_pop().has_value());
+    for (auto const &element: {5, 10, 7, 1, 1, 10})
+    {
+        minHeap.insert(element);
+    }
+    ASSERT_EQ(minHeap.size(), 6UL);
+    std::vector<int32_t> popped;
+    while (auto element = minHeap.try_pop())
+    {
+        popped.push_back(*element);
+    }
+    ASSERT_EQ(popped, (std::vector<int32_t>{1, 1, 5, 7, 10, 10}));
+    ASSERT_TRUE(minHeap.empty());
+}
+
+TEST_F(HeapTest, concurrent_heap_multi_thread_test)
+{
+    constexpr size_t         numThreads = 4;
+    constexpr int32_t        perThread  = 10'000;
+    concurrent_heap<int32_t> sharedHeap(8);
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < numThreads; t++)
+    {
+        producers.emplace_back(
+            [&sharedHeap, t]()
+            {
+                for (int32_t i = 0; i < perThread; i++)
+                {
+                    sharedHeap.insert(static_cast<int32_t>(t) * perThread + i);
+                }
+            }
+        );
+    }
+    for (auto &producer: producers)
+    {
+        producer.join();
+    }
+    ASSERT_EQ(sharedHeap.size(), numThreads * perThread);
+
+    std::vector<std::vector<int32_t>> consumed(numThreads);
+    std::vector<std::thread>          consumers;
+    for (size_t t = 0; t < numThreads; t++)
+    {
+        consumers.emplace_back(
+            [&sharedHeap, &consumed, t]()
+            {
+                while (auto element = sharedHeap.try_pop())
+                {
+                    consumed[t].push_back(*element);
+                }
+            }
+        );
+    }
+    for (auto &consumer: consumers)
+    {
+        consumer.join();
+    }
+    ASSERT_TRUE(sharedHeap.empty());
+
+    std::vector<int32_t> all;
+    for (auto const &part: consumed)
+    {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), numThreads * perThread);
+    for (int32_t i = 0; i < static_cast<int32_t>(all.size()); i++)
+    {
+        ASSERT_EQ(all[i], i);
+    }
+}
+
+/**
+ * @brief Mutex-protected heap as baseline for the concurrent heap benchmark.
+ */
+struct locked_heap
+{
+    std::mutex                              mtx_;
+    heap<int32_t, std::greater<int32_t>, 4> heap_;
+
+    void insert(int32_t key)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        heap_.insert(key);
+    }
+
+    std::optional<int32_t> try_pop()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (heap_.empty())
+        {
+            return {};
+        }
+        auto reval = *heap_.top();
+        heap_.pop();
+        return reval;
+    }
+};
+
+template <typename HeapT_>
+void benchmarkContention(HeapT_ &sharedHeap, size_t numThreads, size_t opsPerThread)
+{
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back(
+            [&sharedHeap, opsPerThread, t]()
+            {
+                // every thread is both producer and consumer
+                for (size_t i = 0; i < opsPerThread; i++)
+                {
+                    sharedHeap.insert(static_cast<int32_t>((i * 7919 + t) % 100'000));
+                    if (i % 2 == 1)
+                    {
+                        sharedHeap.try_pop();
+                        sharedHeap.try_pop();
+                    }
+                }
+            }
+        );
+    }
+    for (auto &thread: threads)
+    {
+        thread.join();
+    }
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(HeapTest, concurrent_heap_performance_test)
+#else
+TEST_F(HeapTest, DISABLED_concurrent_heap_performance_test)
+#endif
+{
+    RESET_PERF;
+    size_t const numThreads   = std::max(2U, std::thread::hardware_concurrency());
+    size_t const opsPerThread = 500'000;
+
+    locked_heap lockedHeap;
+    START_NAMED_PERF(locked_heap);
+    benchmarkContention(lockedHeap, numThreads, opsPerThread);
+    END_PERF;
+
+    concurrent_heap<int32_t> concurrentHeap;
+    START_NAMED_PERF(concurrent_heap);
+    benchmarkContention(concurrentHeap, numThreads, opsPerThread);
+    END_PERF;
+
+    std::cout << "threads: " << numThreads << ", operations per thread: " << 2 * opsPerThread << std::endl;
+    std::cout << util::performance_timer::instance() << std::endl;
+}
+
+template <size_t K_, typename Compare>
+void checkTopK(std::vector<int32_t> const &elements)
+{
+    top_k<int32_t, K_, Compare>    best;
+    bounded_heap<int32_t, Compare> bounded(K_);
+    ASSERT_TRUE(best.empty());
+    ASSERT_EQ(best.worst(), nullptr);
+    for (auto const &element: elements)
+    {
+        best.push(element);
+        bounded.push(element);
+    }
+    std::vector<int32_t> expected = elements;
+    std::sort(expected.begin(), expected.end(), [](auto const &lhs, auto const &rhs) { return Compare()(rhs, lhs); });
+    expected.resize(std::min(K_, expected.size()));
+    ASSERT_EQ(best.size(), expected.size());
+    ASSERT_EQ(best.sorted(), expected);
+    ASSERT_EQ(bounded.sorted(), expected);
+    ASSERT_EQ(*best.worst(), expected.back());
+    ASSERT_EQ(*bounded.worst(), expected.back());
+}
+
+TEST_F(HeapTest, top_k_test)
+{
+    std::vector<int32_t> elements;
+    std::srand(4711);
+    for (size_t i = 0; i < 10'000; i++)
+    {
+        elements.push_back(std::rand() % 5000);
+    }
+    checkTopK<1, std::less<int32_t>>(elements);
+    checkTopK<10, std::less<int32_t>>(elements);
+    checkTopK<10, std::greater<int32_t>>(elements);
+    checkTopK<32, std::less<int32_t>>(elements);
+    checkTopK<100, std::less<int32_t>>(elements);
+    checkTopK<100, std::greater<int32_t>>(elements);
+    // fewer elements than K
+    checkTopK<10, std::less<int32_t>>({3, 1, 2});
+    checkTopK<50, std::less<int32_t>>({3, 1, 2});
+
+    top_k<int32_t, 3> best;
+    ASSERT_TRUE(best.push(5));
+    ASSERT_TRUE(best.push(1));
+    ASSERT_TRUE(best.push(7));
+    ASSERT_FALSE(best.push(1));  // not better than the current 3rd best
+    ASSERT_TRUE(best.push(6));
+    ASSERT_EQ(best.sorted(), (std::vector<int32_t>{7, 6, 5}));
+    best.clear();
+    ASSERT_TRUE(best.empty());
+
+    bounded_heap<int32_t> none(0);
+    ASSERT_FALSE(none.push(1));
+    ASSERT_TRUE(none.empty());
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(HeapTest, top_k_performance_test)
+#else
+TEST_F(HeapTest, DISABLED_top_k_performance_test)
+#endif
+{
+    RESET_PERF;
+    std::vector<int32_t> elements;
+    std::srand(4711);
+    for (size_t i = 0; i < 10'000'000; i++)
+    {
+        elements.push_back(std::rand());
+    }
+
+    START_NAMED_PERF(top_k_16);
+    top_k<int32_t, 16> best16;
+    for (auto const &element: elements)
+    {
+        best16.push(element);
+    }
+    END_PERF;
+    START_NAMED_PERF(bounded_heap_16);
+    bounded_heap<int32_t> bounded16(16);
+    for (auto const &element: elements)
+    {
+        bounded16.push(element);
+    }
+    END_PERF;
+    START_NAMED_PERF(partial_sort_copy_16);
+    std::vector<int32_t> sorted16(16);
+    std::partial_sort_copy(elements.begin(), elements.end(), sorted16.begin(), sorted16.end(), std::greater<int32_t>());
+    END_PERF;
+    START_NAMED_PERF(top_k_1000);
+    top_k<int32_t, 1000> best1000;
+    for (auto const &element: elements)
+    {
+        best1000.push(element);
+    }
+    END_PERF;
+
+    ASSERT_EQ(best16.sorted(), sorted16);
+    ASSERT_EQ(bounded16.sorted(), sorted16);
+    std::cout << util::performance_timer::instance() << std::endl;
+}
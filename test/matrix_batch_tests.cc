@@ -0,0 +1,285 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/matrix_batch_tests.cc
+ * Description: Unit tests for batches of small matrices
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "matrix.h"
+#include "matrix_batch.h"
+#include "static_matrix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace std;
+using namespace util;
+
+class MatrixBatchTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+namespace
+{
+template<typename T_, size_t Rows_, size_t Cols_>
+double maxAbsDiff(static_matrix<T_, Rows_, Cols_> const &lhs, static_matrix<T_, Rows_, Cols_> const &rhs)
+{
+    double reval = 0.0;
+    for(size_t y = 0; y < Rows_; y++)
+        for(size_t x = 0; x < Cols_; x++)
+            reval = std::max(reval, static_cast<double>(std::abs(lhs(x, y) - rhs(x, y))));
+    return reval;
+}
+
+// a batch of diagonally dominant, hence well-conditioned, matrices with reproducible values
+template<typename T_, size_t Rows_, size_t Cols_ = Rows_>
+matrix_batch<T_, Rows_, Cols_> randomBatch(size_t count, unsigned seed)
+{
+    matrix_batch<T_, Rows_, Cols_> reval(count);
+    for(size_t k = 0; k < count; k++)
+    {
+        for(size_t y = 0; y < Rows_; y++)
+            for(size_t x = 0; x < Cols_; x++)
+            {
+                seed           = seed * 1103515245U + 12345U;
+                reval(k, x, y) = T_(static_cast<double>((seed >> 16) % 1000) / 500.0 - 1.0);
+            }
+        for(size_t i = 0; i < std::min(Rows_, Cols_); i++)
+            reval(k, i, i) += T_(double(Rows_));
+    }
+    return reval;
+}
+} // namespace
+
+template<typename T_, size_t Dim_>
+void testBatchT(size_t count, double tolerance)
+{
+    using batch = matrix_batch<T_, Dim_>;
+    auto a      = randomBatch<T_, Dim_>(count, 1U);
+    auto b      = randomBatch<T_, Dim_>(count, 2U);
+    auto v      = randomBatch<T_, Dim_, 1>(count, 3U);
+
+    // every operation agrees with the individual static matrices
+    auto product = a * b;
+    auto inverse = a.inv();
+    auto solved  = a.solve(v);
+    auto columns = a * v;
+    ASSERT_EQ(product.size(), count);
+    for(size_t k = 0; k < count; k++)
+    {
+        ASSERT_LT(maxAbsDiff(product.get(k), a.get(k) * b.get(k)), tolerance);
+        ASSERT_LT(maxAbsDiff(columns.get(k), a.get(k) * v.get(k)), tolerance);
+        ASSERT_LT(maxAbsDiff(inverse.get(k), a.get(k).inv()), tolerance);
+        ASSERT_LT(maxAbsDiff(a.get(k) * solved.get(k), v.get(k)), tolerance);
+    }
+
+    // the into-variants work in place
+    auto inPlace = a;
+    inPlace.invInto(inPlace);
+    ASSERT_EQ(inPlace, inverse);
+    batch::multiplyInto(inPlace, a, inPlace);
+    for(size_t k = 0; k < count; k++)
+        ASSERT_LT(maxAbsDiff(inPlace.get(k), static_matrix<T_, Dim_, Dim_>::scalar()), tolerance);
+    auto rhs = v;
+    a.solveInto(rhs, rhs);
+    ASSERT_EQ(rhs, solved);
+
+    // a single singular matrix is reported with its index
+    if(count > 0)
+    {
+        auto singular = a;
+        singular.set(count - 1, static_matrix<T_, Dim_, Dim_>());
+        try
+        {
+            auto ignored = singular.inv();
+            FAIL() << "inverting a batch with a singular matrix must throw";
+        }
+        catch(matrixIsSingular const &e)
+        {
+            ASSERT_NE(string(e.what()).find("matrix " + to_string(count - 1) + " "), string::npos) << e.what();
+        }
+        ASSERT_THROW(singular.solve(v), matrixIsSingular);
+    }
+    ASSERT_THROW(a * batch(count + 1), matrixSizesIncompatible);
+    ASSERT_THROW(a.solve(matrix_batch<T_, Dim_, 1>(count + 1)), matrixSizesIncompatible);
+}
+
+TEST_F(MatrixBatchTest, matrix_batch_test)
+{
+    testBatchT<double, 1>(5, 1e-12);
+    testBatchT<double, 2>(64, 1e-12);
+    testBatchT<double, 3>(1000, 1e-12);
+    testBatchT<double, 4>(130, 1e-12);
+    testBatchT<float, 4>(77, 1e-5);
+    testBatchT<long double, 3>(10, 1e-15);
+    testBatchT<complex<double>, 4>(70, 1e-12);
+    testBatchT<double, 5>(9, 1e-12);
+    testBatchT<double, 3>(0, 1e-12);
+
+    // element access, broadcasting and resizing
+    auto const                 unit = static_matrix<double, 2, 3>{1, 2, 3, 4, 5, 6};
+    matrix_batch<double, 2, 3> b(3, unit);
+    ASSERT_EQ(b.sizeX(), 3UL);
+    ASSERT_EQ(b.sizeY(), 2UL);
+    ASSERT_EQ(b.get(2), unit);
+    ASSERT_EQ(b(1, 2, 0), 3.0);
+    b.elements(0, 1)[1] = -4.0;
+    ASSERT_EQ(b(1, 0, 1), -4.0);
+    ASSERT_EQ(b.elements(2, 1).size(), 3UL);
+    b.resize(100);
+    ASSERT_EQ(b.size(), 100UL);
+    ASSERT_EQ(b.get(2), unit);
+    ASSERT_EQ(b.get(99), (static_matrix<double, 2, 3>()));
+    b.resize(2);
+    auto expected = matrix_batch<double, 2, 3>(2, unit);
+    ASSERT_NE(b, expected);
+    expected(1, 0, 1) = -4.0;
+    ASSERT_EQ(b, expected);
+
+    // parallel operations give the results of the sequential ones
+    set_parallel_thread_count(4);
+    auto a = randomBatch<double, 4>(1000, 4U);
+    auto c = randomBatch<double, 4>(1000, 5U);
+    using batch44 = matrix_batch<double, 4>;
+    ASSERT_EQ(batch44::multiply(a, c, exec_policy::parallel), batch44::multiply(a, c, exec_policy::sequential));
+    ASSERT_EQ(a.inv(exec_policy::parallel), a.inv(exec_policy::sequential));
+    ASSERT_EQ(a.solve(c, exec_policy::parallel), a.solve(c, exec_policy::sequential));
+    set_parallel_thread_count(0);
+
+    // singularity is judged like matrix::inv() does, not only by an exactly vanishing determinant
+    matrix_batch<float, 2> nearlySingular(3, static_matrix<float, 2, 2>::scalar());
+    nearlySingular.set(1, static_matrix<float, 2, 2>{2.0f, 1.0f, 1.0f, std::nextafter(0.5f, 1.0f)});
+    ASSERT_NE(nearlySingular.get(1).det(), 0.0f);
+    ASSERT_TRUE(nearlySingular.get(1).toMatrix().isSingular());
+    try
+    {
+        auto ignored = nearlySingular.inv();
+        FAIL() << "inverting a batch with a nearly singular matrix must throw";
+    }
+    catch(matrixIsSingular const &e)
+    {
+        ASSERT_NE(string(e.what()).find("matrix 1 "), string::npos) << e.what();
+    }
+    ASSERT_THROW(nearlySingular.solve(matrix_batch<float, 2, 1>(3)), matrixIsSingular);
+    matrix_batch<double, 2> badlyScaled(70, static_matrix<double, 2, 2>{1e20, 0.0, 0.0, 1.0});
+    auto const              scaledInverse = badlyScaled.inv();
+    ASSERT_EQ(scaledInverse.get(69), (static_matrix<double, 2, 2>{1e-20, 0.0, 0.0, 1.0}));
+
+    // in place, singularity is judged from the original matrices, not from the inverses already stored
+    static_matrix<float, 3, 3> dependentRows{-5.108f, -8.622f, 3.729f, -5.622f, -10.243f, 9.567f};
+    for(size_t x = 0; x < 3; x++)
+        dependentRows(x, 2) = dependentRows(x, 0) * 0.3f + dependentRows(x, 1) * 0.7f;
+    matrix_batch<float, 3> inPlace(5, static_matrix<float, 3, 3>::scalar());
+    inPlace.set(3, dependentRows);
+    ASSERT_THROW(inPlace.inv(), matrixIsSingular);
+    ASSERT_THROW(inPlace.invInto(inPlace), matrixIsSingular);
+    auto zeroInPlace = randomBatch<double, 3>(200, 6U);
+    zeroInPlace.set(130, static_matrix<double, 3, 3>());
+    try
+    {
+        zeroInPlace.invInto(zeroInPlace);
+        FAIL() << "inverting a batch with a singular matrix in place must throw";
+    }
+    catch(matrixIsSingular const &e)
+    {
+        ASSERT_NE(string(e.what()).find("matrix 130 "), string::npos) << e.what();
+    }
+
+    // a small determinant of a regular matrix among regular ones costs only its own check
+    auto mixed = randomBatch<float, 4>(300, 7U);
+    mixed.set(17, static_matrix<float, 4, 4>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1e-4f});
+    auto const mixedInverse = mixed.inv();
+    ASSERT_EQ(mixedInverse.get(17), mixed.get(17).inv());
+    ASSERT_LT(maxAbsDiff(mixedInverse.get(18), mixed.get(18).inv()), 1e-5);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixBatchTest, matrix_batch_performance_test)
+#else
+TEST_F(MatrixBatchTest, DISABLED_matrix_batch_performance_test)
+#endif
+{
+    // a million independent 4x4 products, inversions and solves: individual matrices versus one batch
+    size_t const count = 1000000;
+    auto         a     = randomBatch<double, 4>(count, 1U);
+    auto         b     = randomBatch<double, 4>(count, 2U);
+    auto         v     = randomBatch<double, 4, 1>(count, 3U);
+
+    vector<matrix<double>> dynA;
+    vector<matrix<double>> dynB;
+    vector<matrix<double>> dynV;
+    for(size_t k = 0; k < count; k++)
+    {
+        dynA.push_back(a.get(k));
+        dynB.push_back(b.get(k));
+        dynV.push_back(v.get(k));
+    }
+
+    auto   start  = chrono::steady_clock::now();
+    double dynSum = 0.0;
+    for(size_t k = 0; k < count; k++)
+    {
+        auto product  = dynA[k] * dynB[k];
+        auto work     = dynA[k];
+        auto inverse  = work.inv();
+        auto solution = dynA[k].solve(dynV[k]);
+        dynSum += product(0, 0) + inverse(0, 0) + solution(0, 0);
+    }
+    chrono::duration<double> dynamicTime = chrono::steady_clock::now() - start;
+
+    start         = chrono::steady_clock::now();
+    double staSum = 0.0;
+    for(size_t k = 0; k < count; k++)
+    {
+        auto const m = a.get(k);
+        staSum += (m * b.get(k))(0, 0) + m.inv()(0, 0) + (m.inv() * v.get(k))(0, 0);
+    }
+    chrono::duration<double> staticTime = chrono::steady_clock::now() - start;
+
+    matrix_batch<double, 4>    product(count);
+    matrix_batch<double, 4>    inverse(count);
+    matrix_batch<double, 4, 1> solution(count);
+    start = chrono::steady_clock::now();
+    matrix_batch<double, 4>::multiplyInto(product, a, b);
+    a.invInto(inverse);
+    a.solveInto(solution, v);
+    chrono::duration<double> batchTime = chrono::steady_clock::now() - start;
+
+    double batchSum = 0.0;
+    for(size_t k = 0; k < count; k++)
+        batchSum += product(k, 0, 0) + inverse(k, 0, 0) + solution(k, 0, 0);
+    ASSERT_LT(std::abs(batchSum - dynSum) / std::abs(dynSum), 1e-9);
+    ASSERT_LT(std::abs(batchSum - staSum) / std::abs(staSum), 1e-9);
+    cout << count << " 4x4 multiply, invert and solve: matrix " << dynamicTime.count() << "s, static_matrix "
+         << staticTime.count() << "s, matrix_batch " << batchTime.count() << "s" << endl;
+}
@@ -0,0 +1,396 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/matrix_decomposition_tests.cc
+ * Description: Unit tests for LU, Cholesky and QR matrix decompositions
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "matrix.h"
+#include "matrix_decomposition.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class MatrixDecompositionTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+namespace
+{
+template<typename T_>
+double maxAbsDiff(matrix<T_> const &lhs, matrix<T_> const &rhs)
+{
+    double reval = 0.0;
+    for(size_t y = 0; y < lhs.sizeY(); y++)
+        for(size_t x = 0; x < lhs.sizeX(); x++)
+            reval = std::max(reval, static_cast<double>(std::abs(lhs(x, y) - rhs(x, y))));
+    return reval;
+}
+
+template<typename T_>
+matrix<T_> randomMatrix(size_t xDim, size_t yDim, unsigned seed)
+{
+    matrix<T_> reval(xDim, yDim);
+    for(size_t y = 0; y < yDim; y++)
+        for(size_t x = 0; x < xDim; x++)
+        {
+            seed        = seed * 1103515245U + 12345U;
+            reval(x, y) = T_(static_cast<double>((seed >> 16) % 1000) / 500.0 - 1.0);
+        }
+    return reval;
+}
+} // namespace
+
+template<typename T_>
+void testLuT(double tolerance)
+{
+    auto a = matrix<T_>(3, 3, {T_(2), T_(1), T_(1), T_(4), T_(-6), T_(0), T_(-2), T_(7), T_(2)});
+    lu_decomposition<T_> lu(a);
+    ASSERT_FALSE(lu.isSingular());
+    ASSERT_EQ(lu.size(), 3UL);
+    ASSERT_TRUE(lu.lower().isLowerTriangular());
+    ASSERT_TRUE(lu.upper().isUpperTriangular());
+
+    // P * A == L * U
+    auto permuted = a;
+    for(size_t y = 0; y < 3; y++)
+        for(size_t x = 0; x < 3; x++)
+            permuted(x, y) = a(x, lu.permutation()[y]);
+    ASSERT_LT(maxAbsDiff(lu.lower() * lu.upper(), permuted), tolerance);
+
+    ASSERT_LT(std::abs(lu.det() - T_(-16)), tolerance);
+    ASSERT_LT(maxAbsDiff(a * lu.inv(), matrix<T_>::scalar(3)), tolerance);
+
+    // one factorisation, many right-hand sides
+    auto b = matrix<T_>::vvect({T_(5), T_(-2), T_(9)});
+    auto x = lu.solve(b);
+    ASSERT_LT(maxAbsDiff(x, matrix<T_>::vvect({T_(1), T_(1), T_(2)})), tolerance);
+    auto many = matrix<T_>(4, 3, {T_(1), T_(2), T_(3), T_(4), T_(5), T_(6), T_(7), T_(8), T_(9), T_(0), T_(1), T_(2)});
+    ASSERT_LT(maxAbsDiff(a * lu.solve(many), many), tolerance);
+
+    auto singular = matrix<T_>(3, 3, {T_(1), T_(2), T_(3), T_(2), T_(4), T_(6), T_(1), T_(0), T_(1)});
+    lu_decomposition<T_> singularLu(singular);
+    ASSERT_TRUE(singularLu.isSingular());
+    ASSERT_LT(std::abs(singularLu.det()), tolerance);
+    ASSERT_THROW(singularLu.solve(b), matrixIsSingular);
+    ASSERT_THROW(singularLu.inv(), matrixIsSingular);
+
+    ASSERT_THROW(lu_decomposition<T_>(matrix<T_>(2, 3)), matrixMustBeSquare);
+    ASSERT_THROW(lu.solve(matrix<T_>(1, 4)), matrixSizesIncompatible);
+}
+
+TEST_F(MatrixDecompositionTest, lu_decomposition_test)
+{
+    testLuT<double>(1e-12);
+    testLuT<long double>(1e-15);
+    testLuT<complex<double>>(1e-12);
+
+    // the parallel factorisation gives the same factors as the sequential one
+    set_parallel_thread_count(4);
+    auto a = randomMatrix<double>(61, 61, 7U);
+    lu_decomposition<double> seq(a, exec_policy::sequential);
+    lu_decomposition<double> par(a, exec_policy::parallel);
+    ASSERT_EQ(seq.factors(), par.factors());
+    ASSERT_EQ(seq.permutation(), par.permutation());
+    ASSERT_EQ(seq.det(), par.det());
+    set_parallel_thread_count(0);
+
+    // singularity is judged relative to the pivot's row and column, as by matrix::inv()
+    for(auto const &scaled : {matrix<double>(2, 2, {1e20, 0.0, 0.0, 1.0}), matrix<double>(2, 2, {1e20, 1e20, 1.0, 2.0})})
+    {
+        lu_decomposition<double> scaledLu(scaled);
+        ASSERT_FALSE(scaledLu.isSingular());
+        ASSERT_FALSE(scaled.isSingular());
+        ASSERT_NO_THROW(matrix<double>(scaled).inv());
+        auto const b = matrix<double>::vvect({1e20, 1.0});
+        ASSERT_LT(maxAbsDiff(scaledLu.solve(b), scaled.solve(b)), 1e-12);
+    }
+    // the reflections mix the rows, so qr measures its diagonal against the columns only
+    ASSERT_FALSE(qr<double>(matrix<double>(2, 2, {1e20, 0.0, 0.0, 1.0})).isRankDeficient());
+    auto const scaledSingular = matrix<double>(2, 2, {1e20, 2e20, 1e-20, 2e-20});
+    ASSERT_TRUE(lu_decomposition<double>(scaledSingular).isSingular());
+    ASSERT_THROW(matrix<double>(scaledSingular).inv(), matrixIsSingular);
+    ASSERT_NO_THROW(cholesky<double>(matrix<double>(2, 2, {1e20, 0.0, 0.0, 1e-20})));
+}
+
+template<typename T_>
+void testCholeskyT(double tolerance)
+{
+    // A = M * M^H + n * I is hermitian positive definite
+    auto m = randomMatrix<T_>(5, 5, 3U);
+    auto mh = ~m;
+    for(size_t y = 0; y < 5; y++)
+        for(size_t x = 0; x < 5; x++)
+            if constexpr(std::is_same_v<T_, complex<double>>)
+                mh(x, y) = std::conj(mh(x, y));
+    auto a = m * mh + matrix<T_>::scalar(5, T_(5));
+
+    cholesky<T_> chol(a);
+    ASSERT_TRUE(chol.lower().isLowerTriangular());
+    auto lh = ~chol.lower();
+    for(size_t y = 0; y < 5; y++)
+        for(size_t x = 0; x < 5; x++)
+            if constexpr(std::is_same_v<T_, complex<double>>)
+                lh(x, y) = std::conj(lh(x, y));
+    ASSERT_LT(maxAbsDiff(chol.lower() * lh, a), tolerance);
+
+    auto b = randomMatrix<T_>(3, 5, 9U);
+    ASSERT_LT(maxAbsDiff(a * chol.solve(b), b), tolerance);
+    ASSERT_LT(maxAbsDiff(a * chol.inv(), matrix<T_>::scalar(5)), tolerance);
+    ASSERT_LT(std::abs(chol.det() - lu_decomposition<T_>(a).det()) / std::abs(chol.det()), tolerance);
+
+    auto indefinite = matrix<T_>(2, 2, {T_(1), T_(2), T_(2), T_(1)});
+    ASSERT_THROW(cholesky<T_>{indefinite}, matrixNotPositiveDefinite);
+    ASSERT_THROW(cholesky<T_>{matrix<T_>(2, 3)}, matrixMustBeSquare);
+}
+
+TEST_F(MatrixDecompositionTest, cholesky_test)
+{
+    testCholeskyT<double>(1e-12);
+    testCholeskyT<long double>(1e-15);
+    testCholeskyT<complex<double>>(1e-12);
+}
+
+template<typename T_>
+void testQrT(double tolerance)
+{
+    auto a = randomMatrix<T_>(4, 4, 5U);
+    qr<T_> fact(a);
+    ASSERT_FALSE(fact.isRankDeficient());
+    ASSERT_TRUE(fact.r().isUpperTriangular());
+    ASSERT_LT(maxAbsDiff(fact.q() * fact.r(), a), tolerance);
+
+    // Q is orthogonal (unitary)
+    auto q  = fact.q();
+    auto qh = ~q;
+    for(size_t y = 0; y < 4; y++)
+        for(size_t x = 0; x < 4; x++)
+            if constexpr(std::is_same_v<T_, complex<double>>)
+                qh(x, y) = std::conj(qh(x, y));
+    ASSERT_LT(maxAbsDiff(qh * q, matrix<T_>::scalar(4)), tolerance);
+
+    ASSERT_LT(std::abs(fact.det() - lu_decomposition<T_>(a).det()), tolerance);
+    ASSERT_LT(maxAbsDiff(a * fact.inv(), matrix<T_>::scalar(4)), tolerance);
+    auto b = randomMatrix<T_>(2, 4, 11U);
+    ASSERT_LT(maxAbsDiff(a * fact.solve(b), b), tolerance);
+
+    // over-determined: the least-squares fit of y = 1 + 2x through exact points is exact
+    auto design = matrix<T_>(2, 5, {T_(1), T_(0), T_(1), T_(1), T_(1), T_(2), T_(1), T_(3), T_(1), T_(4)});
+    auto values = matrix<T_>::vvect({T_(1), T_(3), T_(5), T_(7), T_(9)});
+    qr<T_> leastSquares(design);
+    ASSERT_LT(maxAbsDiff(leastSquares.solve(values), matrix<T_>::vvect({T_(1), T_(2)})), tolerance);
+    ASSERT_LT(maxAbsDiff(leastSquares.q() * leastSquares.r(), design), tolerance);
+    ASSERT_THROW(leastSquares.det(), matrixMustBeSquare);
+
+    auto dependent = matrix<T_>(2, 3, {T_(1), T_(2), T_(2), T_(4), T_(3), T_(6)});
+    ASSERT_TRUE(qr<T_>(dependent).isRankDeficient());
+    ASSERT_THROW(qr<T_>(dependent).solve(values), matrixSizesIncompatible);
+    ASSERT_THROW(qr<T_>(dependent).solve(matrix<T_>(1, 3)), matrixIsSingular);
+    ASSERT_THROW(qr<T_>(matrix<T_>(3, 2)), matrixSizesIncompatible);
+}
+
+TEST_F(MatrixDecompositionTest, qr_test)
+{
+    testQrT<double>(1e-12);
+    testQrT<long double>(1e-15);
+    testQrT<complex<double>>(1e-12);
+}
+
+template<typename T_>
+void testPowerT(double tolerance)
+{
+    auto a = matrix<T_>(3, 3, {T_(1), T_(1), T_(0), T_(0), T_(1), T_(1), T_(1), T_(0), T_(1)});
+    ASSERT_EQ(a ^ 0, matrix<T_>::scalar(3));
+    ASSERT_EQ(a ^ 1, a);
+    matrix<T_> product = a;
+    for(size_t pow = 2; pow <= 13; pow++)
+    {
+        product = product * a;
+        ASSERT_LT(maxAbsDiff(a ^ pow, product), tolerance * std::abs(product(0, 0)));
+    }
+    auto b = a;
+    b ^= 5;
+    ASSERT_EQ(b, a * a * a * a * a);
+    ASSERT_THROW(matrix<T_>(2, 3) ^ 2, matrixMustBeSquare);
+}
+
+TEST_F(MatrixDecompositionTest, power_test)
+{
+    testPowerT<double>(1e-12);
+    testPowerT<long double>(1e-15);
+    testPowerT<complex<double>>(1e-12);
+    testPowerT<long long>(0.5);
+
+    set_parallel_thread_count(4);
+    auto a = randomMatrix<double>(40, 40, 3U) * 0.2;
+    ASSERT_LT(maxAbsDiff(matrix<double>::power(a, 21, exec_policy::parallel),
+                         matrix<double>::power(a, 21, exec_policy::sequential)),
+              1e-12);
+    set_parallel_thread_count(0);
+}
+
+template<typename T_>
+void testSymmetricEigenT(double tolerance)
+{
+    // only the lower triangle is read
+    auto a = matrix<T_>(3, 3, {T_(2), T_(99), T_(99), T_(-1), T_(2), T_(99), T_(0), T_(-1), T_(2)});
+    auto s = matrix<T_>(3, 3, {T_(2), T_(-1), T_(0), T_(-1), T_(2), T_(-1), T_(0), T_(-1), T_(2)});
+    symmetric_eigen<T_> eig(a);
+    ASSERT_EQ(eig.size(), 3UL);
+    ASSERT_LT(std::abs(eig.eigenvalues()[0] - (T_(2) - std::sqrt(T_(2)))), tolerance);
+    ASSERT_LT(std::abs(eig.eigenvalues()[1] - T_(2)), tolerance);
+    ASSERT_LT(std::abs(eig.eigenvalues()[2] - (T_(2) + std::sqrt(T_(2)))), tolerance);
+
+    // A * V == V * D and V is orthogonal
+    auto v = eig.eigenvectors();
+    auto d = matrix<T_>(3, 3);
+    for(size_t k = 0; k < 3; k++)
+        d(k, k) = eig.eigenvalues()[k];
+    ASSERT_LT(maxAbsDiff(s * v, v * d), tolerance);
+    ASSERT_LT(maxAbsDiff(~v * v, matrix<T_>::scalar(3)), tolerance);
+
+    // functions of the matrix
+    ASSERT_LT(maxAbsDiff(eig.pow(T_(1)), s), tolerance);
+    ASSERT_LT(maxAbsDiff(eig.pow(T_(7)), s ^ 7), tolerance * 1e3);
+    ASSERT_LT(maxAbsDiff(eig.pow(T_(-1)), !s), tolerance);
+    auto root = eig.pow(T_(0.5));
+    ASSERT_LT(maxAbsDiff(root * root, s), tolerance);
+    ASSERT_LT(maxAbsDiff(eig.exp(T_(0)), matrix<T_>::scalar(3)), tolerance);
+    // exp(A) by its Taylor series
+    matrix<T_> series = matrix<T_>::scalar(3);
+    matrix<T_> term   = matrix<T_>::scalar(3);
+    for(size_t k = 1; k < 40; k++)
+    {
+        term   = term * s / T_(k);
+        series = series + term;
+    }
+    ASSERT_LT(maxAbsDiff(eig.exp(), series), tolerance * 1e2);
+    ASSERT_LT(maxAbsDiff(eig.exp(T_(0.5)) * eig.exp(T_(0.5)), eig.exp()), tolerance * 1e2);
+
+    // a larger random matrix
+    auto r = randomMatrix<T_>(30, 30, 5U);
+    r      = r + ~r;
+    symmetric_eigen<T_> big(r);
+    ASSERT_LE(big.sweeps(), 12UL);
+    ASSERT_TRUE(std::is_sorted(big.eigenvalues().begin(), big.eigenvalues().end()));
+    ASSERT_LT(maxAbsDiff(big.pow(T_(3)), r * r * r), tolerance * 1e4);
+
+    auto indefinite = matrix<T_>(2, 2, {T_(1), T_(0), T_(0), T_(-1)});
+    ASSERT_THROW(symmetric_eigen<T_>(indefinite).pow(T_(0.5)), matrixNotPositiveDefinite);
+    ASSERT_THROW(symmetric_eigen<T_>(matrix<T_>(2, 2)).pow(T_(-1)), matrixIsSingular);
+    ASSERT_THROW(symmetric_eigen<T_>(matrix<T_>(2, 3)), matrixMustBeSquare);
+}
+
+TEST_F(MatrixDecompositionTest, symmetric_eigen_test)
+{
+    testSymmetricEigenT<double>(1e-12);
+    testSymmetricEigenT<long double>(1e-15);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixDecompositionTest, decomposition_reuse_performance_test)
+#else
+TEST_F(MatrixDecompositionTest, DISABLED_decomposition_reuse_performance_test)
+#endif
+{
+    // solving against many single right-hand sides: Gauss-Jordan every time versus one factorisation
+    size_t const dim  = 400;
+    size_t const reps = 50;
+    auto         a    = randomMatrix<double>(dim, dim, 1U) + matrix<double>::scalar(dim, double(dim));
+    auto         b    = randomMatrix<double>(1, dim, 2U);
+
+    auto start = chrono::steady_clock::now();
+    for(size_t i = 0; i < reps; i++)
+        a.solve(b, exec_policy::sequential);
+    chrono::duration<double> gaussJordan = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    lu_decomposition<double> lu(a, exec_policy::sequential);
+    for(size_t i = 0; i < reps; i++)
+        lu.solve(b);
+    chrono::duration<double> factorised = chrono::steady_clock::now() - start;
+
+    cout << reps << " solves of a " << dim << "x" << dim << " system: Gauss-Jordan " << gaussJordan.count()
+         << "s, LU once " << factorised.count() << "s" << endl;
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixDecompositionTest, matrix_power_performance_test)
+#else
+TEST_F(MatrixDecompositionTest, DISABLED_matrix_power_performance_test)
+#endif
+{
+    // many steps of a Markov chain: repeated multiplication versus squaring versus one eigen-decomposition
+    size_t const dim   = 100;
+    size_t const steps = 1000;
+    auto         s     = randomMatrix<double>(dim, dim, 7U);
+    // symmetric and non-negative, scaled to row sums of at most 1 like the transitions of a reversible chain
+    double maxRowSum = 0.0;
+    for(size_t y = 0; y < dim; y++)
+        for(size_t x = 0; x <= y; x++)
+            s(x, y) = s(y, x) = std::abs(s(x, y)) + 0.01;
+    for(size_t y = 0; y < dim; y++)
+    {
+        double rowSum = 0.0;
+        for(size_t x = 0; x < dim; x++)
+            rowSum += s(x, y);
+        maxRowSum = std::max(maxRowSum, rowSum);
+    }
+    s /= maxRowSum;
+
+    auto           start  = chrono::steady_clock::now();
+    matrix<double> looped = s;
+    for(size_t i = 1; i < steps; i++)
+        looped = looped * s;
+    chrono::duration<double> loopTime = chrono::steady_clock::now() - start;
+
+    start                           = chrono::steady_clock::now();
+    auto squared                    = s ^ steps;
+    chrono::duration<double> sqTime = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    symmetric_eigen<double> eig(s);
+    matrix<double>          powers;
+    for(size_t i = 1; i <= 10; i++)
+        powers = eig.pow(double(steps * i));
+    chrono::duration<double> eigTime = chrono::steady_clock::now() - start;
+
+    ASSERT_LT(maxAbsDiff(squared, looped), 1e-9);
+    ASSERT_LT(maxAbsDiff(eig.pow(double(steps)), looped), 1e-9);
+    cout << "P^" << steps << " of a " << dim << "x" << dim << " matrix: loop " << loopTime.count() << "s, squaring "
+         << sqTime.count() << "s, eigen-decomposition and 10 powers " << eigTime.count() << "s" << endl;
+}
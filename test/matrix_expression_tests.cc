@@ -0,0 +1,177 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/matrix_expression_tests.cc
+ * Description: Unit tests for lazily evaluated matrix expressions
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "matrix.h"
+#include "matrix_expression.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace std;
+using namespace util;
+
+class MatrixExpressionTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+namespace
+{
+template<typename T_, bool enableBoundsCheck_>
+double maxAbsDiff(matrix<T_, enableBoundsCheck_> const &lhs, matrix<T_, enableBoundsCheck_> const &rhs)
+{
+    double reval = 0.0;
+    for(size_t y = 0; y < lhs.sizeY(); y++)
+        for(size_t x = 0; x < lhs.sizeX(); x++)
+            reval = std::max(reval, static_cast<double>(std::abs(lhs(x, y) - rhs(x, y))));
+    return reval;
+}
+
+template<typename T_, bool enableBoundsCheck_ = false>
+matrix<T_, enableBoundsCheck_> randomMatrix(size_t xDim, size_t yDim, unsigned seed)
+{
+    matrix<T_, enableBoundsCheck_> reval(xDim, yDim);
+    for(size_t y = 0; y < yDim; y++)
+        for(size_t x = 0; x < xDim; x++)
+        {
+            seed        = seed * 1103515245U + 12345U;
+            reval(x, y) = T_(static_cast<double>((seed >> 16) % 1000) / 500.0 - 1.0);
+        }
+    return reval;
+}
+} // namespace
+
+template<typename T_, bool enableBoundsCheck_>
+void testExpressionT(double tolerance)
+{
+    using mat = matrix<T_, enableBoundsCheck_>;
+    auto a    = randomMatrix<T_, enableBoundsCheck_>(7, 5, 1U);
+    auto b    = randomMatrix<T_, enableBoundsCheck_>(9, 7, 2U);
+    auto c    = randomMatrix<T_, enableBoundsCheck_>(9, 5, 3U);
+    auto d    = randomMatrix<T_, enableBoundsCheck_>(9, 5, 4U);
+
+    // the fused result equals the eager one
+    mat eager = a * b + c - d * T_(2);
+    mat fused = lazy(a) * b + c - lazy(d) * T_(2);
+    ASSERT_EQ(fused.sizeX(), 9UL);
+    ASSERT_EQ(fused.sizeY(), 5UL);
+    ASSERT_LT(maxAbsDiff(eager, fused), tolerance);
+
+    fused = T_(3) * lazy(c) - -lazy(d) / T_(4) + c * lazy(~b * b);
+    ASSERT_LT(maxAbsDiff(fused, T_(3) * c + d / T_(4) + c * (~b * b)), tolerance);
+
+    // products of expressions are evaluated before they are multiplied
+    fused = (lazy(a) + a) * (lazy(b) * T_(2));
+    ASSERT_LT(maxAbsDiff(fused, (a + a) * (b * T_(2))), tolerance);
+    ASSERT_LT(maxAbsDiff((lazy(c) - d).eval(), c - d), tolerance);
+
+    // the destination may appear in the expression
+    mat m = c;
+    m     = lazy(m) * T_(2) + m;
+    ASSERT_LT(maxAbsDiff(m, c * T_(3)), tolerance);
+    m = lazy(a) * b;
+    m = lazy(m) * (~b * b) - m;
+    ASSERT_LT(maxAbsDiff(m, a * b * (~b * b) - a * b), tolerance);
+    m = c;
+    m += lazy(a) * b;
+    ASSERT_LT(maxAbsDiff(m, c + a * b), tolerance);
+    m -= lazy(d) * T_(2);
+    ASSERT_LT(maxAbsDiff(m, c + a * b - d * T_(2)), tolerance);
+
+    // assignment resizes the destination
+    mat resized(2, 2);
+    resized = lazy(c) + d;
+    ASSERT_EQ(resized, c + d);
+
+    ASSERT_THROW(lazy(a) + b, matrixSizesIncompatible);
+    ASSERT_THROW(c - lazy(a), matrixSizesIncompatible);
+    ASSERT_THROW(lazy(b) * a, matrixSizesIncompatible);
+    ASSERT_THROW(lazy(a) / T_(0), matrixScalarMustNotBeZero);
+}
+
+TEST_F(MatrixExpressionTest, expression_test)
+{
+    testExpressionT<double, false>(1e-12);
+    testExpressionT<double, true>(1e-12);
+    testExpressionT<float, false>(1e-4);
+    testExpressionT<long double, false>(1e-15);
+    testExpressionT<complex<double>, false>(1e-12);
+}
+
+TEST_F(MatrixExpressionTest, parallel_expression_test)
+{
+    set_parallel_thread_count(4);
+    auto a = randomMatrix<double>(33, 47, 5U);
+    auto b = randomMatrix<double>(33, 47, 6U);
+    auto c = randomMatrix<double>(33, 47, 7U);
+
+    matrix<double> seq;
+    matrix<double> par;
+    seq.assign(lazy(a) - lazy(b) * 0.5 + c, exec_policy::sequential);
+    par.assign(lazy(a) - lazy(b) * 0.5 + c, exec_policy::parallel);
+    ASSERT_EQ(seq, par);
+    ASSERT_EQ(seq, a - b * 0.5 + c);
+    set_parallel_thread_count(0);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixExpressionTest, fused_update_performance_test)
+#else
+TEST_F(MatrixExpressionTest, DISABLED_fused_update_performance_test)
+#endif
+{
+    // an element-wise update loop: one temporary per operator versus one fused pass
+    size_t const dim  = 1000;
+    size_t const reps = 20;
+    auto         a    = randomMatrix<double>(dim, dim, 1U);
+    auto         b    = randomMatrix<double>(dim, dim, 2U);
+    auto         c    = randomMatrix<double>(dim, dim, 3U);
+    auto         d    = randomMatrix<double>(dim, dim, 4U);
+
+    matrix<double> reval;
+    auto           start = chrono::steady_clock::now();
+    for(size_t i = 0; i < reps; i++)
+        reval = a + b - c * 2.0 + d;
+    chrono::duration<double> eager = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for(size_t i = 0; i < reps; i++)
+        reval.assign(lazy(a) + b - lazy(c) * 2.0 + d, exec_policy::sequential);
+    chrono::duration<double> fused = chrono::steady_clock::now() - start;
+
+    cout << reps << " updates of a " << dim << "x" << dim << " matrix: eager " << eager.count() << "s, fused "
+         << fused.count() << "s" << endl;
+}
@@ -0,0 +1,182 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/matrix_io_tests.cc
+ * Description: Unit tests for binary matrix serialisation
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "matrix.h"
+#include "matrix_io.h"
+
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace util;
+
+string const filename = "/tmp/test_matrix.bin";
+
+class MatrixIoTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+        std::remove(filename.c_str());
+    }
+};
+
+namespace
+{
+template<typename T_, bool enableBoundsCheck_ = false>
+matrix<T_, enableBoundsCheck_> countingMatrix(size_t xDim, size_t yDim)
+{
+    matrix<T_, enableBoundsCheck_> reval(xDim, yDim);
+    for(size_t y = 0; y < yDim; y++)
+        for(size_t x = 0; x < xDim; x++)
+            reval(x, y) = T_(y * xDim + x + 1);
+    return reval;
+}
+} // namespace
+
+template<typename T_, bool enableBoundsCheck_>
+void testBinaryT()
+{
+    using mat = matrix<T_, enableBoundsCheck_>;
+
+    // rows that are padded in memory are written without the padding
+    for(auto [xDim, yDim]: {pair<size_t, size_t>{1, 1}, {3, 5}, {16, 2}, {37, 11}})
+    {
+        auto m = countingMatrix<T_, enableBoundsCheck_>(xDim, yDim);
+
+        stringstream ss(ios::in | ios::out | ios::binary);
+        writeBinary(ss, m);
+        ASSERT_EQ(ss.str().size(), sizeof(matrix_file_header) + xDim * yDim * sizeof(T_));
+        ASSERT_EQ((readBinary<T_, enableBoundsCheck_>(ss)), m);
+
+        saveBinary(filename, m);
+        ASSERT_EQ((loadBinary<T_, enableBoundsCheck_>(filename)), m);
+
+        mapped_matrix<T_, enableBoundsCheck_> mapped(filename);
+        ASSERT_EQ(mapped.sizeX(), xDim);
+        ASSERT_EQ(mapped.sizeY(), yDim);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(mapped.data()) % 64, 0UL);
+        ASSERT_EQ(mat(mapped.view()), m);
+        ASSERT_EQ(mat(mapped.view().block(0, yDim - 1, xDim, 1)), mat(m.rowView(yDim - 1)));
+        auto moved = std::move(mapped);
+        ASSERT_EQ(moved.toMatrix(), m);
+        ASSERT_EQ(mapped.data(), nullptr);
+    }
+
+    // a file is only read back as the element type it was written with
+    saveBinary(filename, countingMatrix<T_, enableBoundsCheck_>(3, 3));
+    ASSERT_THROW((loadBinary<int, enableBoundsCheck_>(filename)), matrixFileError);
+    ASSERT_THROW((loadBinary<complex<float>, enableBoundsCheck_>(filename)), matrixFileError);
+}
+
+TEST_F(MatrixIoTest, binary_test)
+{
+    testBinaryT<double, false>();
+    testBinaryT<double, true>();
+    testBinaryT<float, false>();
+    testBinaryT<long double, false>();
+    testBinaryT<long long, false>();
+    testBinaryT<complex<double>, false>();
+    testBinaryT<complex<double>, true>();
+
+    // broken and foreign files are rejected
+    ASSERT_THROW(loadBinary<double>("/tmp/no_such_dir/no_such_matrix.bin"), matrixFileError);
+    saveBinary(filename, countingMatrix<double>(10, 10));
+    string content;
+    {
+        ifstream ifs(filename, ios::binary);
+        content.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+    }
+    {
+        ofstream ofs(filename, ios::binary | ios::trunc);
+        ofs.write(content.data(), streamsize(content.size() - 8));
+    }
+    ASSERT_THROW(loadBinary<double>(filename), matrixFileError);
+    stringstream truncated(content.substr(0, content.size() - 8), ios::in | ios::binary);
+    ASSERT_THROW(readBinary<double>(truncated), matrixFileError);
+    {
+        ofstream ofs(filename, ios::binary | ios::trunc);
+        ofs << "1 2 3\n4 5 6\n";
+    }
+    ASSERT_THROW(loadBinary<double>(filename), matrixFileError);
+    stringstream text("1 2 3\n4 5 6\n7 8 9\n1 2 3\n4 5 6\n7 8 9\n1 2 3\n4 5 6\n7 8 9\n");
+    ASSERT_THROW(readBinary<double>(text), matrixFileError);
+
+    // the text format is unchanged
+    auto         m = countingMatrix<double>(3, 2);
+    stringstream textOut;
+    textOut << m;
+    matrix<double> textIn(3, 2);
+    textOut >> textIn;
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixIoTest, checkpoint_performance_test)
+#else
+TEST_F(MatrixIoTest, DISABLED_checkpoint_performance_test)
+#endif
+{
+    // write and read back a 2000x2000 matrix: text streams (which also lose precision) versus the binary format
+    size_t const dim = 2000;
+    auto         m   = countingMatrix<double>(dim, dim);
+
+    auto start = chrono::steady_clock::now();
+    {
+        ofstream ofs(filename);
+        ofs << m;
+    }
+    matrix<double> textIn(dim, dim);
+    {
+        ifstream ifs(filename);
+        ifs >> textIn;
+    }
+    chrono::duration<double> text = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    saveBinary(filename, m);
+    auto binIn                      = loadBinary<double>(filename);
+    chrono::duration<double> binary = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    mapped_matrix<double> mapped(filename);
+    double                sum = 0.0;
+    for(size_t i = 0; i < dim * dim; i++)
+        sum += mapped.data()[i];
+    chrono::duration<double> mappedTime = chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(binIn, m);
+    ASSERT_EQ(sum, double(dim * dim) * double(dim * dim + 1) / 2.0);
+    cout << "checkpointing a " << dim << "x" << dim << " matrix: text " << text.count() << "s, binary "
+         << binary.count() << "s, summing the mapped file " << mappedTime.count() << "s" << endl;
+}
@@ -0,0 +1,70 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/matrix_standalone_tests.cc
+ * Description: Unit tests for matrix.h included before any other header
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+// matrix.h must come first: the unqualified abs() calls in its templates may only see what matrix.h itself declares
+#include "matrix.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace util;
+
+class MatrixStandaloneTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+TEST_F(MatrixStandaloneTest, inverse_of_matrix_with_entries_below_one)
+{
+    matrix<double> m(2, 2);
+    m(0, 0) = 0.5;
+    m(1, 0) = 0.25;
+    m(0, 1) = 0.125;
+    m(1, 1) = 0.75;
+
+    // inv() reduces its operand to the unit matrix
+    matrix<double> const mInv = matrix<double>(m).inv();
+    matrix<double> const prod = m * mInv;
+    for(size_t y = 0; y < 2; y++)
+        for(size_t x = 0; x < 2; x++)
+            ASSERT_NEAR(prod(x, y), x == y ? 1.0 : 0.0, 1e-12);
+
+    for(double const val : {0.5, 1e-3, 3e9})
+    {
+        matrix<double> d(2, 2);
+        d(0, 0) = val;
+        d(1, 1) = val;
+        matrix<double> dInv;
+        ASSERT_NO_THROW(dInv = d.inv()) << "diag(" << val << ", " << val << ")";
+        ASSERT_NEAR(dInv(0, 0) * val, 1.0, 1e-12);
+    }
+}
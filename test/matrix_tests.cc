@@ -26,11 +26,17 @@
 #include "logvalue.h"
 #include "matrix.h"
 
+#include <algorithm>
+#include <chrono>
 #include <complex>
+#include <cstdint>
 #include <gtest/gtest.h>
 #include <initializer_list>
 #include <ios>
 #include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace std;
 using namespace util;
@@ -750,3 +756,516 @@ TEST_F(MatrixTest, testSquareMatrixOperations)
     //    },
     //                                              1e-10L);
 }
+
+TEST_F(MatrixTest, testContiguousStorage)
+{
+    auto m = matrix<double>(3, 2, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+    ASSERT_EQ(m.stride(), 3UL);
+    ASSERT_EQ(m.data()[m.stride() + 2], 6.0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(m.data()) % matrix<double>::alignment, 0UL);
+
+    auto r = m.row(1);
+    ASSERT_EQ(r.size(), 3UL);
+    r[0] = 40.0;
+    ASSERT_EQ(m(0, 1), 40.0);
+    ASSERT_EQ(std::as_const(m).row(0), (std::vector<double>{1.0, 2.0, 3.0}));
+
+    // rows longer than a cache-line are padded to an aligned stride
+    auto wide = matrix<double>(10, 3);
+    ASSERT_EQ(wide.stride(), 16UL);
+    for (size_t y = 0; y < wide.sizeY(); y++)
+    {
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(wide.row(y).data()) % matrix<double>::alignment, 0UL);
+        for (size_t x = 0; x < wide.sizeX(); x++)
+        {
+            wide(x, y) = static_cast<double>(y * 10 + x);
+        }
+    }
+    auto copy = wide;
+    ASSERT_EQ(copy, wide);
+    copy(9, 2) = -1.0;
+    ASSERT_NE(copy, wide);
+
+    // resize keeps the overlapping values
+    wide.resize(4, 5);
+    ASSERT_EQ(wide.sizeX(), 4UL);
+    ASSERT_EQ(wide.sizeY(), 5UL);
+    ASSERT_EQ(wide(3, 2), 23.0);
+    ASSERT_EQ(wide(3, 4), 0.0);
+    ASSERT_NE(wide, matrix<double>(4, 4));
+}
+
+namespace
+{
+/**
+ * @brief Create a diagonally dominant, hence well-conditioned, square matrix with reproducible values.
+ */
+template <typename T_>
+matrix<T_> dominantMatrix(size_t dim, unsigned seed = 1U)
+{
+    matrix<T_> reval(dim, dim);
+    for (size_t y = 0; y < dim; y++)
+    {
+        for (size_t x = 0; x < dim; x++)
+        {
+            seed        = seed * 1103515245U + 12345U;
+            reval(x, y) = T_(static_cast<double>((seed >> 16) % 1000) / 1000.0 - 0.5);
+        }
+        reval(y, y) += T_(static_cast<double>(dim));
+    }
+    return reval;
+}
+
+template <typename T_>
+double maxAbsDiff(matrix<T_> const &lhs, matrix<T_> const &rhs)
+{
+    double reval = 0.0;
+    for (size_t y = 0; y < lhs.sizeY(); y++)
+    {
+        for (size_t x = 0; x < lhs.sizeX(); x++)
+        {
+            reval = std::max(reval, static_cast<double>(std::abs(lhs(x, y) - rhs(x, y))));
+        }
+    }
+    return reval;
+}
+} // namespace
+
+TEST_F(MatrixTest, testParallelKernels)
+{
+    // force several threads, so that the parallel code paths are also taken on a single core
+    set_parallel_thread_count(4);
+
+    auto a = dominantMatrix<double>(67, 1U);
+    auto b = dominantMatrix<double>(67, 2U);
+
+    auto seqProduct = matrix<double>::multiply(a, b, exec_policy::sequential);
+    auto parProduct = matrix<double>::multiply(a, b, exec_policy::parallel);
+    ASSERT_EQ(seqProduct, parProduct);
+    auto inPlace = a;
+    inPlace *= b;
+    ASSERT_LT(maxAbsDiff(inPlace, seqProduct), 1e-9);
+
+    auto seqWork = a;
+    auto parWork = a;
+    auto seqInv  = seqWork.inv(exec_policy::sequential);
+    auto parInv  = parWork.inv(exec_policy::parallel);
+    ASSERT_LT(maxAbsDiff(seqInv, parInv), 1e-12);
+    ASSERT_LT(maxAbsDiff(a * parInv, matrix<double>::scalar(67)), 1e-12);
+
+    auto rhs = dominantMatrix<double>(67, 3U);
+    rhs.resize(5, 67);
+    auto solution = a.solve(rhs, exec_policy::parallel);
+    ASSERT_LT(maxAbsDiff(a.solve(rhs, exec_policy::sequential), solution), 1e-12);
+    ASSERT_LT(maxAbsDiff(a * solution, rhs), 1e-9);
+
+    auto singular = matrix<double>(3, 3, {1.0, 2.0, 3.0, 2.0, 4.0, 6.0, 1.0, 0.0, 1.0});
+    ASSERT_THROW(singular.inv(exec_policy::parallel), matrixIsSingular);
+    ASSERT_THROW(singular.solve(matrix<double>(1, 3), exec_policy::parallel), matrixIsSingular);
+    auto const rounded = matrix<double>(3, 3, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0});
+    for (auto policy: {exec_policy::sequential, exec_policy::parallel})
+    {
+        auto work = rounded;
+        ASSERT_THROW(work.inv(policy), matrixIsSingular);
+    }
+
+    // the pivot tolerance is relative to the pivot's row and column, badly scaled matrices are still regular
+    auto const badlyScaled = matrix<double>(2, 2, {1e20, 0.0, 0.0, 1.0});
+    for (auto policy: {exec_policy::sequential, exec_policy::parallel})
+    {
+        auto work      = badlyScaled;
+        auto scaledInv = work.inv(policy);
+        ASSERT_EQ(scaledInv(0, 0), 1e-20);
+        ASSERT_EQ(scaledInv(1, 1), 1.0);
+    }
+    auto rowScaled = matrix<double>(2, 2, {1e20, 1e20, 1.0, 2.0});
+    ASSERT_LT(maxAbsDiff(rowScaled.solve(matrix<double>::vvect({3e20, 5.0})), matrix<double>::vvect({1.0, 2.0})), 1e-12);
+
+    auto small = matrix<long double>(4, 4, {2, 0, 1, 3, 1, 1, 0, 2, 0, 3, 1, 1, 4, 1, 2, 0});
+    ASSERT_EQ(small.det(exec_policy::parallel), small.det(exec_policy::sequential));
+    ASSERT_NEAR(static_cast<double>(small.det()), -32.0, 1e-12);
+    ASSERT_EQ(small.adj(exec_policy::parallel), small.adj(exec_policy::sequential));
+    ASSERT_EQ(matrix<long double>(3, 3, {2, 0, 0, 0, 3, 0, 0, 0, 4}).det(), 24.0L);
+
+    set_parallel_thread_count(0);
+}
+
+TEST_F(MatrixTest, testMoveAndInPlaceOperations)
+{
+    // moving hands over the storage and leaves an empty matrix behind
+    auto          a    = dominantMatrix<double>(20, 1U);
+    auto const    copy = a;
+    double const *data = a.data();
+    auto          moved(std::move(a));
+    ASSERT_EQ(moved.data(), data);
+    ASSERT_EQ(moved, copy);
+    ASSERT_EQ(a.sizeX(), 0UL);
+    ASSERT_EQ(a.sizeY(), 0UL);
+    a = std::move(moved);
+    ASSERT_EQ(a.data(), data);
+    ASSERT_EQ(moved.sizeX(), 0UL);
+    moved = copy;
+    ASSERT_EQ(moved, a);
+
+    // compound operators work in place
+    auto b = dominantMatrix<double>(20, 2U);
+    auto c = a;
+    data   = c.data();
+    c += b;
+    ASSERT_EQ(c, copy + b);
+    c -= b;
+    ASSERT_LT(maxAbsDiff(c, copy), 1e-12);
+    c *= 3.0;
+    ASSERT_LT(maxAbsDiff(c, copy * 3.0), 1e-12);
+    c /= 3.0;
+    ASSERT_LT(maxAbsDiff(c, copy), 1e-12);
+    ASSERT_EQ(c.data(), data);
+    ASSERT_THROW(c += matrix<double>(3, 20), matrixSizesIncompatible);
+    ASSERT_THROW(c /= 0.0, matrixScalarMustNotBeZero);
+
+    // the into-variants reuse a destination of the right size and allow aliasing
+    matrix<double> dst(20, 20);
+    data = dst.data();
+    matrix<double>::addInto(dst, a, b);
+    ASSERT_EQ(dst, a + b);
+    matrix<double>::subtractInto(dst, dst, b);
+    ASSERT_LT(maxAbsDiff(dst, a), 1e-12);
+    matrix<double>::multiplyInto(dst, a, b);
+    ASSERT_EQ(dst, a * b);
+    ASSERT_EQ(dst.data(), data);
+    matrix<double>::multiplyInto(dst, dst, b);
+    ASSERT_EQ(dst, a * b * b);
+
+    matrix<double> grown(1, 1);
+    matrix<double>::multiplyInto(grown, matrix<double>(3, 2), matrix<double>(4, 3));
+    ASSERT_EQ(grown.sizeX(), 4UL);
+    ASSERT_EQ(grown.sizeY(), 2UL);
+    ASSERT_THROW(matrix<double>::multiplyInto(grown, a, matrix<double>(4, 3)), matrixSizesIncompatible);
+    ASSERT_THROW(matrix<double>::addInto(grown, a, matrix<double>(20, 3)), matrixSizesIncompatible);
+
+    // products are bit-for-bit the same whatever the policy and the number of threads, also when the rows do not
+    // split evenly and only some blocks of rows would be large enough for the GEMM kernel on their own
+    matrix<double> par(1, 1);
+    auto const     sequential = matrix<double>::multiply(a, b, exec_policy::sequential);
+    auto const     tall       = dominantMatrix<double>(17, 7U);
+    auto const     tallSquare = matrix<double>::multiply(tall, tall, exec_policy::sequential);
+    for (size_t threads = 1; threads <= 5; threads++)
+    {
+        set_parallel_thread_count(threads);
+        matrix<double>::addInto(par, a, b, exec_policy::parallel);
+        ASSERT_EQ(par, a + b);
+        matrix<double>::multiplyInto(par, a, b, exec_policy::parallel);
+        ASSERT_EQ(par, sequential) << threads;
+        ASSERT_EQ(matrix<double>::multiply(tall, tall, exec_policy::parallel), tallSquare) << threads;
+    }
+    set_parallel_thread_count(0);
+}
+
+TEST_F(MatrixTest, testDeterminantAndAdjugate)
+{
+    // integer matrices use fraction-free elimination and are exact
+    auto exact = matrix<long long>(4, 4, {2, 0, 1, 3, 1, 1, 0, 2, 0, 3, 1, 1, 4, 1, 2, 0});
+    ASSERT_EQ(exact.det(), -32LL);
+    ASSERT_FALSE(exact.isSingular());
+    auto exactAdj = exact.adj();
+    ASSERT_EQ(exactAdj * exact, matrix<long long>::scalar(4, -32LL));
+    ASSERT_EQ(exact * exactAdj, matrix<long long>::scalar(4, -32LL));
+    for (size_t y = 0; y < 4; y++)
+    {
+        for (size_t x = 0; x < 4; x++)
+        {
+            ASSERT_EQ(exactAdj(x, y), exact.cofact(y, x));
+        }
+    }
+    auto swapped = matrix<long long>(3, 3, {0, 2, 1, 3, 0, 2, 1, 1, 0});
+    ASSERT_EQ(swapped.det(), 7LL);
+    ASSERT_EQ(swapped.adj() * swapped, matrix<long long>::scalar(3, 7LL));
+
+    // the adjugate of a singular matrix of rank n-1 is not zero
+    auto rankTwo = matrix<long long>(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+    ASSERT_TRUE(rankTwo.isSingular());
+    ASSERT_EQ(rankTwo.det(), 0LL);
+    auto expectedAdj = matrix<long long>(3, 3, {-3, 6, -3, 6, -12, 6, -3, 6, -3});
+    ASSERT_EQ(rankTwo.adj(), expectedAdj);
+    auto rankTwoReal = matrix<double>(3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+    ASSERT_TRUE(rankTwoReal.isSingular());
+    ASSERT_NEAR(rankTwoReal.det(), 0.0, 1e-12);
+    // the determinant is the product of the pivots, only isSingular() applies a tolerance
+    double const nextHalf  = std::nextafter(0.5, 1.0);
+    auto         tinyPivot = matrix<double>(2, 2, {2.0, 1.0, 1.0, nextHalf});
+    ASSERT_TRUE(tinyPivot.isSingular());
+    ASSERT_EQ(tinyPivot.det(), 2.0 * (nextHalf - 0.5));
+    // a tiny pivot that is large against its own row and column is regular
+    ASSERT_FALSE(matrix<double>(2, 2, {1.0, 0.0, 0.0, 1e-17}).isSingular());
+    auto realAdj = rankTwoReal.adj();
+    for (size_t y = 0; y < 3; y++)
+    {
+        for (size_t x = 0; x < 3; x++)
+        {
+            ASSERT_NEAR(realAdj(x, y), static_cast<double>(expectedAdj(x, y)), 1e-12);
+        }
+    }
+
+    // large matrices no longer need the factorial cofactor expansion
+    auto large    = dominantMatrix<double>(100, 5U);
+    auto largeDet = large.det();
+    auto largeAdj = large.adj();
+    ASSERT_GT(std::abs(largeDet), 0.0);
+    ASSERT_LT(maxAbsDiff(largeAdj * large, matrix<double>::scalar(100, largeDet)), std::abs(largeDet) * 1e-12);
+    auto scaled = large;
+    for (size_t x = 0; x < 100; x++)
+    {
+        scaled(x, 7) *= 2.0;
+    }
+    ASSERT_NEAR(scaled.det() / largeDet, 2.0, 1e-12);
+    ASSERT_NEAR(largeAdj(3, 5), large.cofact(5, 3), std::abs(large.cofact(5, 3)) * 1e-12);
+
+    // nor do large singular matrices: the adjugate of rank n-1 comes from a regular rank-one update
+    auto rankDeficient = matrix<double>(60, 60);
+    for (size_t y = 0; y < 60; y++)
+    {
+        for (size_t x = 0; x < 59; x++)
+        {
+            rankDeficient(x, y) = static_cast<double>((x * 7 + y * 13) % 11) - 5.0 + (x == y ? 60.0 : 0.0);
+        }
+        rankDeficient(59, y) = rankDeficient(0, y) + rankDeficient(1, y);
+    }
+    ASSERT_TRUE(rankDeficient.isSingular());
+    auto const deficientAdj = rankDeficient.adj();
+    double     adjMax       = 0.0;
+    for (size_t y = 0; y < 60; y++)
+    {
+        for (size_t x = 0; x < 60; x++)
+        {
+            adjMax = std::max(adjMax, std::abs(deficientAdj(x, y)));
+        }
+    }
+    ASSERT_GT(adjMax, 0.0);
+    for (size_t i = 0; i < 60; i += 19)
+    {
+        ASSERT_NEAR(deficientAdj(i, 59), rankDeficient.cofact(59, i), adjMax * 1e-9);
+    }
+    ASSERT_LT(maxAbsDiff(deficientAdj * rankDeficient, matrix<double>(60, 60)), adjMax * 1e-9);
+    ASSERT_LT(maxAbsDiff(rankDeficient * deficientAdj, matrix<double>(60, 60)), adjMax * 1e-9);
+
+    // large singular integer matrices take the exact rank-one update, too: I - S with S the shift and a zero last
+    // diagonal element, mixed by unimodular row and column operations
+    auto integerDeficient = matrix<long long>(100, 100);
+    for (size_t y = 0; y < 100; y++)
+    {
+        integerDeficient(y, y) = y < 99 ? 1LL : 0LL;
+        if (y + 1 < 100)
+        {
+            integerDeficient(y + 1, y) = -1LL;
+        }
+    }
+    for (size_t y = 1; y < 100; y++)
+    {
+        for (size_t x = 0; x < 100; x++)
+        {
+            integerDeficient(x, y) += integerDeficient(x, y - 1);
+        }
+    }
+    for (size_t x = 1; x < 100; x++)
+    {
+        for (size_t y = 0; y < 100; y++)
+        {
+            integerDeficient(x, y) += integerDeficient(x - 1, y) * (static_cast<long long>(x % 3) - 1);
+        }
+    }
+    ASSERT_TRUE(integerDeficient.isSingular());
+    auto const start          = chrono::steady_clock::now();
+    auto const integerAdj     = integerDeficient.adj();
+    auto const integerAdjTime = chrono::steady_clock::now() - start;
+    ASSERT_LT(integerAdjTime, chrono::seconds(1));
+    ASSERT_NE(integerAdj, matrix<long long>(100, 100));
+    ASSERT_EQ(integerAdj * integerDeficient, matrix<long long>(100, 100));
+    ASSERT_EQ(integerDeficient * integerAdj, matrix<long long>(100, 100));
+    for (size_t y = 0; y < 100; y += 11)
+    {
+        for (size_t x : {size_t{0}, size_t{98}, size_t{99}})
+        {
+            ASSERT_EQ(integerAdj(x, y), integerDeficient.cofact(y, x));
+        }
+    }
+    ASSERT_NE(integerAdj(99, 11), 0LL);
+
+    // below rank n-1 every co-factor vanishes
+    auto rankOne = matrix<double>(3, 3, {1, 2, 3, 2, 4, 6, 3, 6, 9});
+    ASSERT_EQ(rankOne.adj(), matrix<double>(3, 3));
+}
+
+namespace
+{
+/**
+ * @brief Vector-of-vectors reference implementation that mirrors the previous matrix storage, for benchmarking.
+ */
+struct nested_matrix
+{
+    std::vector<std::vector<double>> m_;
+
+    explicit nested_matrix(size_t dim)
+        : m_(dim, std::vector<double>(dim, 1.5))
+    {
+    }
+
+    friend nested_matrix operator+(nested_matrix const &lhs, nested_matrix const &rhs)
+    {
+        nested_matrix reval = lhs;
+        for (size_t y = 0; y < reval.m_.size(); y++)
+        {
+            for (size_t x = 0; x < reval.m_.size(); x++)
+            {
+                reval.m_[y][x] += rhs.m_[y][x];
+            }
+        }
+        return reval;
+    }
+
+    friend nested_matrix operator*(nested_matrix const &lhs, nested_matrix const &rhs)
+    {
+        nested_matrix reval(lhs.m_.size());
+        for (size_t y = 0; y < lhs.m_.size(); y++)
+        {
+            for (size_t x = 0; x < rhs.m_.size(); x++)
+            {
+                reval.m_[y][x] = 0.0;
+                for (size_t k = 0; k < lhs.m_.size(); k++)
+                {
+                    reval.m_[y][x] += lhs.m_[y][k] * rhs.m_[k][x];
+                }
+            }
+        }
+        return reval;
+    }
+
+    friend nested_matrix operator~(nested_matrix const &rhs)
+    {
+        nested_matrix reval(rhs.m_.size());
+        for (size_t y = 0; y < rhs.m_.size(); y++)
+        {
+            for (size_t x = 0; x < rhs.m_.size(); x++)
+            {
+                reval.m_[x][y] = rhs.m_[y][x];
+            }
+        }
+        return reval;
+    }
+};
+
+/**
+ * @brief Measure the average time in seconds of a number of repetitions of an operation.
+ */
+template <typename Func_>
+double averageSeconds(size_t repetitions, Func_ func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; i++)
+    {
+        func();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(repetitions);
+}
+} // namespace
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixTest, matrix_storage_performance_test)
+#else
+TEST_F(MatrixTest, DISABLED_matrix_storage_performance_test)
+#endif
+{
+    std::cout << "dim\top\tnested[s]\tcontiguous[s]" << std::endl;
+    for (size_t dim = 4; dim <= 4096; dim *= 4)
+    {
+        nested_matrix  nestedA(dim);
+        nested_matrix  nestedB(dim);
+        matrix<double> contA(dim, dim);
+        matrix<double> contB(dim, dim);
+        for (size_t y = 0; y < dim; y++)
+        {
+            for (size_t x = 0; x < dim; x++)
+            {
+                contA(x, y) = 1.5;
+                contB(x, y) = 1.5;
+            }
+        }
+        size_t const reps = std::max(size_t{1}, (size_t{1} << 22) / (dim * dim));
+
+        double nestedAdd = averageSeconds(reps, [&]() { nestedA = nestedA + nestedB; });
+        double contAdd   = averageSeconds(reps, [&]() { contA = contA + contB; });
+        std::cout << dim << "\tadd\t" << nestedAdd << "\t" << contAdd << std::endl;
+
+        double nestedTrans = averageSeconds(reps, [&]() { nestedA = ~nestedB; });
+        double contTrans   = averageSeconds(reps, [&]() { contA = ~contB; });
+        std::cout << dim << "\ttransp\t" << nestedTrans << "\t" << contTrans << std::endl;
+
+        // the naive vector-of-vectors product of 4096x4096 matrices takes several minutes
+        if (dim <= 1024)
+        {
+            size_t const mulReps   = std::max(size_t{1}, (size_t{1} << 24) / (dim * dim * dim));
+            double       nestedMul = averageSeconds(mulReps, [&]() { nestedA = nestedA * nestedB; });
+            double       contMul   = averageSeconds(mulReps, [&]() { contA = contA * contB; });
+            std::cout << dim << "\tmult\t" << nestedMul << "\t" << contMul << std::endl;
+        }
+    }
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixTest, matrix_parallel_performance_test)
+#else
+TEST_F(MatrixTest, DISABLED_matrix_parallel_performance_test)
+#endif
+{
+    size_t const maxThreads = std::max(1U, std::thread::hardware_concurrency());
+    std::cout << "dim\tthreads\tmult[s]\tinv[s]\tsolve[s]" << std::endl;
+    for (size_t dim = 256; dim <= 1024; dim *= 2)
+    {
+        auto a   = dominantMatrix<double>(dim, 1U);
+        auto b   = dominantMatrix<double>(dim, 2U);
+        auto rhs = dominantMatrix<double>(dim, 3U);
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            set_parallel_thread_count(threads);
+            auto const policy = threads == 1 ? exec_policy::sequential : exec_policy::parallel;
+
+            double mult  = averageSeconds(2, [&]() { matrix<double>::multiply(a, b, policy); });
+            double inv   = averageSeconds(1,
+                                        [&]()
+                                        {
+                                            auto work = a;
+                                            work.inv(policy);
+                                        });
+            double solve = averageSeconds(1, [&]() { a.solve(rhs, policy); });
+            std::cout << dim << "\t" << threads << "\t" << mult << "\t" << inv << "\t" << solve << std::endl;
+        }
+    }
+    set_parallel_thread_count(0);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixTest, matrix_in_place_performance_test)
+#else
+TEST_F(MatrixTest, DISABLED_matrix_in_place_performance_test)
+#endif
+{
+    // an iterative update x = x + a * b, once with temporaries and once with pre-allocated matrices
+    std::cout << "dim	temporaries[s]	into[s]" << std::endl;
+    for (size_t dim = 16; dim <= 256; dim *= 4)
+    {
+        auto           a    = dominantMatrix<double>(dim, 1U);
+        auto           b    = dominantMatrix<double>(dim, 2U);
+        matrix<double> x(dim, dim);
+        matrix<double> prod(dim, dim);
+        size_t const   reps = std::max(size_t{1}, (size_t{1} << 24) / (dim * dim * dim));
+
+        double temporaries = averageSeconds(reps, [&]() { x = x + a * b; });
+        double into        = averageSeconds(reps,
+                                     [&]()
+                                     {
+                                         matrix<double>::multiplyInto(prod, a, b);
+                                         x += prod;
+                                     });
+        std::cout << dim << "\t" << temporaries << "\t" << into << std::endl;
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/matrix_view_tests.cc
+ * Description: Unit tests for non-owning matrix views and spans
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "matrix.h"
+#include "matrix_view.h"
+
+#include <chrono>
+#include <complex>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace std;
+using namespace util;
+
+class MatrixViewTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+namespace
+{
+template<typename T_, bool enableBoundsCheck_ = false>
+matrix<T_, enableBoundsCheck_> countingMatrix(size_t xDim, size_t yDim)
+{
+    matrix<T_, enableBoundsCheck_> reval(xDim, yDim);
+    for(size_t y = 0; y < yDim; y++)
+        for(size_t x = 0; x < xDim; x++)
+            reval(x, y) = T_(y * xDim + x + 1);
+    return reval;
+}
+} // namespace
+
+template<typename T_, bool enableBoundsCheck_>
+void testViewT()
+{
+    using mat = matrix<T_, enableBoundsCheck_>;
+    auto m    = countingMatrix<T_, enableBoundsCheck_>(4, 3);
+
+    // views refer to the elements of the matrix
+    auto blk = m.block(1, 1, 2, 2);
+    ASSERT_EQ(blk.sizeX(), 2UL);
+    ASSERT_EQ(blk.sizeY(), 2UL);
+    ASSERT_EQ(&blk(0, 0), &m(1, 1));
+    ASSERT_EQ(&blk(1, 1), &m(2, 2));
+    ASSERT_EQ(&m.rowView(2)(3, 0), &m(3, 2));
+    ASSERT_EQ(&m.colView(3)(0, 2), &m(3, 2));
+    ASSERT_EQ(&m.transposed()(2, 3), &m(3, 2));
+    ASSERT_EQ(&(~m.view())(2, 3), &m(3, 2));
+    ASSERT_EQ(&m.transposed().block(1, 2, 2, 2)(1, 0), &m(2, 2));
+    ASSERT_EQ(mat(m.transposed()), ~m);
+    ASSERT_EQ(mat(m.rowView(1)), mat::hvect({T_(5), T_(6), T_(7), T_(8)}));
+    ASSERT_EQ(mat(m.colView(0)), mat::vvect({T_(1), T_(5), T_(9)}));
+    ASSERT_TRUE(m.block(0, 0, 2, 2) == m.block(0, 0, 2, 2));
+    ASSERT_FALSE(m.block(0, 0, 2, 2) == m.block(1, 0, 2, 2));
+
+    // views are operands of the arithmetic operators
+    mat const &cm = m;
+    auto       a  = countingMatrix<T_, enableBoundsCheck_>(2, 2);
+    ASSERT_EQ(mat(cm.block(1, 1, 2, 2) + a), mat(2, 2, {T_(7), T_(9), T_(13), T_(15)}));
+    ASSERT_EQ(mat(a - cm.block(0, 0, 2, 2)), mat(2, 2, {T_(0), T_(0), T_(-2), T_(-2)}));
+    ASSERT_EQ(mat(-cm.block(0, 0, 1, 1) * T_(2)), mat::scalar(1, T_(-2)));
+    ASSERT_EQ(mat(cm.block(0, 0, 2, 2) / T_(2)), mat(2, 2, {T_(0.5), T_(1), T_(2.5), T_(3)}));
+    ASSERT_EQ(mat(cm.transposed() * m), ~m * m);
+    ASSERT_EQ(mat(cm.colView(0).transposed() * m), ~mat::vvect({T_(1), T_(5), T_(9)}) * m);
+
+    // spans write through to the matrix
+    m.block(0, 0, 2, 2) = lazy(a) * T_(2);
+    ASSERT_EQ(mat(cm.block(0, 0, 2, 2)), a * T_(2));
+    ASSERT_EQ(m(2, 0), T_(3));
+    m = countingMatrix<T_, enableBoundsCheck_>(4, 3);
+    m.colView(1) += m.colView(0);
+    ASSERT_EQ(mat(cm.colView(1)), mat::vvect({T_(3), T_(11), T_(19)}));
+    m.colView(1) -= m.colView(0);
+    ASSERT_EQ(m, (countingMatrix<T_, enableBoundsCheck_>(4, 3)));
+    m.rowView(2).fill(T_(7));
+    ASSERT_EQ(mat(cm.rowView(2)), mat::hvect({T_(7), T_(7), T_(7), T_(7)}));
+    m.rowView(2) *= T_(2);
+    ASSERT_EQ(m(3, 2), T_(14));
+    m.rowView(2) /= T_(7);
+    ASSERT_EQ(m(0, 2), T_(2));
+    m.rowView(0) = m.rowView(1);
+    ASSERT_EQ(mat(cm.rowView(0)), mat(cm.rowView(1)));
+
+    // overlapping operands in another layout are read before they are written
+    m      = countingMatrix<T_, enableBoundsCheck_>(4, 3);
+    auto t = ~m.block(0, 0, 3, 3).eval();
+    m.block(0, 0, 3, 3) = ~m.block(0, 0, 3, 3);
+    ASSERT_EQ(mat(cm.block(0, 0, 3, 3)), t);
+    m.block(1, 0, 3, 3) = m.block(0, 0, 3, 3);
+    ASSERT_EQ(mat(cm.block(1, 0, 3, 3)), t);
+    m = countingMatrix<T_, enableBoundsCheck_>(4, 3);
+    m = m.transposed();
+    ASSERT_EQ(m, ~(countingMatrix<T_, enableBoundsCheck_>(4, 3)));
+    m = lazy(m) + m.view();
+    ASSERT_EQ(m, ~(countingMatrix<T_, enableBoundsCheck_>(4, 3)) * T_(2));
+
+    ASSERT_THROW(m.block(2, 2, 2, 3), matrixIndexOutOfBounds);
+    ASSERT_THROW(cm.rowView(4), matrixIndexOutOfBounds);
+    ASSERT_THROW(lazy(a) + cm.block(0, 0, 3, 2), matrixSizesIncompatible);
+    ASSERT_THROW(m.block(0, 0, 2, 2) = m.block(0, 0, 3, 2), matrixSizesIncompatible);
+    if constexpr(enableBoundsCheck_)
+    {
+        ASSERT_THROW(cm.block(0, 0, 2, 2)(2, 0), matrixIndexOutOfBounds);
+    }
+}
+
+TEST_F(MatrixViewTest, view_test)
+{
+    testViewT<double, false>();
+    testViewT<double, true>();
+    testViewT<long double, false>();
+    testViewT<complex<double>, false>();
+    testViewT<complex<double>, true>();
+
+    // rows of a span are written in parallel
+    set_parallel_thread_count(4);
+    auto par = countingMatrix<double>(40, 30);
+    auto seq = par;
+    par.block(5, 3, 20, 20).assign(~par.block(5, 3, 20, 20) * 2.0, exec_policy::parallel);
+    seq.block(5, 3, 20, 20).assign(~seq.block(5, 3, 20, 20) * 2.0, exec_policy::sequential);
+    ASSERT_EQ(par, seq);
+    ASSERT_EQ(par(6, 3), 2.0 * (4 * 40 + 5 + 1));
+    set_parallel_thread_count(0);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(MatrixViewTest, block_update_performance_test)
+#else
+TEST_F(MatrixViewTest, DISABLED_block_update_performance_test)
+#endif
+{
+    // scale every 64x64 block of a matrix: copy out, scale and copy back, versus in place through a span
+    size_t const dim   = 2048;
+    size_t const block = 64;
+    auto         m     = countingMatrix<double>(dim, dim);
+
+    auto start = chrono::steady_clock::now();
+    for(size_t y0 = 0; y0 < dim; y0 += block)
+        for(size_t x0 = 0; x0 < dim; x0 += block)
+        {
+            matrix<double> copy(block, block);
+            for(size_t y = 0; y < block; y++)
+                for(size_t x = 0; x < block; x++)
+                    copy(x, y) = m(x0 + x, y0 + y);
+            copy *= 0.5;
+            for(size_t y = 0; y < block; y++)
+                for(size_t x = 0; x < block; x++)
+                    m(x0 + x, y0 + y) = copy(x, y);
+        }
+    chrono::duration<double> copied = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for(size_t y0 = 0; y0 < dim; y0 += block)
+        for(size_t x0 = 0; x0 < dim; x0 += block)
+            m.block(x0, y0, block, block) *= 2.0;
+    chrono::duration<double> viewed = chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(m, (countingMatrix<double>(dim, dim)));
+    cout << "scaling the " << block << "x" << block << " blocks of a " << dim << "x" << dim << " matrix: copied "
+         << copied.count() << "s, span " << viewed.count() << "s" << endl;
+}
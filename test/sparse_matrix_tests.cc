@@ -0,0 +1,261 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/sparse_matrix_tests.cc
+ * Description: Unit tests for compressed sparse matrices and iterative solvers
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "grid.h"
+#include "matrix.h"
+#include "sparse_matrix.h"
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace std;
+using namespace util;
+
+class SparseMatrixTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+namespace
+{
+// the 5-point Laplacian on a dim x dim grid: symmetric positive definite
+template<typename T_, sparse_format Format_ = sparse_format::csr>
+sparse_matrix<T_, Format_> poisson2D(size_t dim)
+{
+    vector<sparse_triplet<T_>> triplets;
+    for(size_t j = 0; j < dim; j++)
+        for(size_t i = 0; i < dim; i++)
+        {
+            size_t const row = j * dim + i;
+            triplets.push_back({row, row, T_(4)});
+            if(i > 0)
+                triplets.push_back({row - 1, row, T_(-1)});
+            if(i + 1 < dim)
+                triplets.push_back({row + 1, row, T_(-1)});
+            if(j > 0)
+                triplets.push_back({row - dim, row, T_(-1)});
+            if(j + 1 < dim)
+                triplets.push_back({row + dim, row, T_(-1)});
+        }
+    return sparse_matrix<T_, Format_>(dim * dim, dim * dim, triplets);
+}
+
+template<typename T_>
+double maxAbsDiff(vector<T_> const &lhs, vector<T_> const &rhs)
+{
+    double reval = 0.0;
+    for(size_t i = 0; i < lhs.size(); i++)
+        reval = std::max(reval, static_cast<double>(std::abs(lhs[i] - rhs[i])));
+    return reval;
+}
+
+template<typename T_>
+vector<T_> residual(sparse_matrix<T_> const &a, vector<T_> const &x, vector<T_> const &b)
+{
+    auto reval = a * x;
+    for(size_t i = 0; i < reval.size(); i++)
+        reval[i] -= b[i];
+    return reval;
+}
+} // namespace
+
+template<typename T_, sparse_format Format_>
+void testSparseMatrixT()
+{
+    using sparse = sparse_matrix<T_, Format_>;
+    using mat    = matrix<T_>;
+    mat dense(4, 3, {T_(1), T_(0), T_(2), T_(0), T_(0), T_(0), T_(3), T_(0), T_(4), T_(0), T_(0), T_(5)});
+
+    // duplicates are added up, zeros are dropped, the order of the triplets does not matter
+    sparse a(4,
+             3,
+             {{3, 2, T_(5)},
+              {0, 0, T_(1)},
+              {2, 1, T_(1)},
+              {2, 1, T_(2)},
+              {0, 2, T_(4)},
+              {2, 0, T_(2)},
+              {1, 1, T_(0)}});
+    ASSERT_EQ(a.sizeX(), 4UL);
+    ASSERT_EQ(a.sizeY(), 3UL);
+    ASSERT_EQ(a.nonZeros(), 5UL);
+    ASSERT_EQ(a(2, 1), T_(3));
+    ASSERT_EQ(a(1, 1), T_(0));
+    ASSERT_EQ(a.toMatrix(), dense);
+    ASSERT_EQ(sparse(dense).toMatrix(), dense);
+    ASSERT_EQ(sparse(sparse_matrix<T_, sparse_format::csr>(dense)).toMatrix(), dense);
+    ASSERT_EQ(sparse(sparse_matrix<T_, sparse_format::csc>(dense)).toMatrix(), dense);
+    ASSERT_EQ(a.transposed().toMatrix(), ~dense);
+    ASSERT_EQ(a.diagonal(), (vector<T_>{T_(1), T_(0), T_(0)}));
+
+    // only the cells that have been set in a grid are non-zeros
+    sparse_grid<T_> grid(4, 3, T_(7));
+    grid.set(0, 0, T_(1));
+    grid.set(2, 0, T_(2));
+    grid.set(2, 1, T_(3));
+    grid.set(0, 2, T_(4));
+    grid.set(3, 2, T_(5));
+    ASSERT_EQ(sparse(grid).toMatrix(), dense);
+
+    // products agree with the dense matrix
+    vector<T_> v{T_(1), T_(2), T_(3), T_(4)};
+    ASSERT_EQ(a * v, (vector<T_>{T_(7), T_(9), T_(24)}));
+    mat rhs(2, 4, {T_(1), T_(2), T_(3), T_(4), T_(5), T_(6), T_(7), T_(8)});
+    ASSERT_EQ(a * rhs, dense * rhs);
+    ASSERT_EQ(a.transposed() * dense, ~dense * dense);
+
+    ASSERT_THROW(sparse(2, 2, {{2, 0, T_(1)}}), matrixIndexOutOfBounds);
+    ASSERT_THROW(a(4, 0), matrixIndexOutOfBounds);
+    ASSERT_THROW(a * vector<T_>(3), matrixSizesIncompatible);
+    ASSERT_THROW(a * mat(2, 3), matrixSizesIncompatible);
+}
+
+template<typename T_>
+void testSolversT(double tolerance)
+{
+    size_t const dim = 12;
+    auto         a   = poisson2D<T_>(dim);
+    vector<T_>   b(dim * dim);
+    for(size_t i = 0; i < b.size(); i++)
+        b[i] = T_(double(i % 7) - 3.0);
+
+    auto cg = conjugate_gradient(a, b, 1e-12L);
+    ASSERT_TRUE(cg.converged);
+    ASSERT_LE(cg.iterations, b.size());
+    ASSERT_LT(maxAbsDiff(residual(a, cg.x, b), vector<T_>(b.size())), tolerance);
+
+    // non-symmetric: add a convection term
+    vector<sparse_triplet<T_>> triplets;
+    for(size_t i = 0; i < b.size(); i++)
+    {
+        triplets.push_back({i, i, T_(4)});
+        if(i > 0)
+            triplets.push_back({i - 1, i, T_(-2)});
+        if(i + 1 < b.size())
+            triplets.push_back({i + 1, i, T_(-0.5)});
+        if(i + dim < b.size())
+            triplets.push_back({i + dim, i, T_(-1)});
+    }
+    sparse_matrix<T_> nonSymmetric(b.size(), b.size(), triplets);
+    auto              bicg = bicgstab(nonSymmetric, b, 1e-12L);
+    ASSERT_TRUE(bicg.converged);
+    ASSERT_LT(maxAbsDiff(residual(nonSymmetric, bicg.x, b), vector<T_>(b.size())), tolerance);
+
+    // the solutions agree with a direct solver
+    matrix<T_> column(1, b.size());
+    for(size_t i = 0; i < b.size(); i++)
+        column(0, i) = b[i];
+    auto direct = nonSymmetric.toMatrix().solve(column);
+    for(size_t i = 0; i < b.size(); i++)
+        ASSERT_LT(std::abs(direct(0, i) - bicg.x[i]), tolerance);
+
+    // a good start vector needs no iterations
+    ASSERT_EQ(conjugate_gradient(a, b, 1e-10L, 0, exec_policy::automatic, cg.x).iterations, 0UL);
+    ASSERT_FALSE(conjugate_gradient(a, b, 1e-12L, 2).converged);
+    ASSERT_THROW(conjugate_gradient(sparse_matrix<T_>(3, 2), vector<T_>(2)), matrixMustBeSquare);
+    ASSERT_THROW(bicgstab(a, vector<T_>(3)), matrixSizesIncompatible);
+}
+
+TEST_F(SparseMatrixTest, sparse_matrix_test)
+{
+    testSparseMatrixT<double, sparse_format::csr>();
+    testSparseMatrixT<double, sparse_format::csc>();
+    testSparseMatrixT<long double, sparse_format::csr>();
+    testSparseMatrixT<complex<double>, sparse_format::csr>();
+    testSparseMatrixT<complex<double>, sparse_format::csc>();
+}
+
+TEST_F(SparseMatrixTest, iterative_solver_test)
+{
+    testSolversT<double>(1e-9);
+    testSolversT<long double>(1e-9);
+    testSolversT<complex<double>>(1e-9);
+
+    // parallel products and solvers give the results of the sequential ones
+    set_parallel_thread_count(4);
+    auto           csr = poisson2D<double>(30);
+    auto           csc = poisson2D<double, sparse_format::csc>(30);
+    vector<double> v(csr.sizeX());
+    for(size_t i = 0; i < v.size(); i++)
+        v[i] = double(i % 11);
+    auto expected = csr.multiply(v, exec_policy::sequential);
+    ASSERT_EQ(csr.multiply(v, exec_policy::parallel), expected);
+    ASSERT_EQ(csc.multiply(v, exec_policy::parallel), expected);
+    matrix<double> dense(3, v.size());
+    for(size_t y = 0; y < dense.sizeY(); y++)
+        for(size_t x = 0; x < dense.sizeX(); x++)
+            dense(x, y) = double(x + y % 5);
+    ASSERT_EQ(csr.multiply(dense, exec_policy::parallel), csr.multiply(dense, exec_policy::sequential));
+    ASSERT_EQ(csc.multiply(dense, exec_policy::parallel), csr.multiply(dense, exec_policy::sequential));
+    auto par = conjugate_gradient(csr, v, 1e-10L, 0, exec_policy::parallel);
+    auto seq = conjugate_gradient(csr, v, 1e-10L, 0, exec_policy::sequential);
+    ASSERT_TRUE(par.converged);
+    ASSERT_EQ(par.iterations, seq.iterations);
+    ASSERT_LT(maxAbsDiff(par.x, seq.x), 1e-9);
+    auto parBicg = bicgstab(csr, v, 1e-10L, 0, exec_policy::parallel);
+    auto seqBicg = bicgstab(csr, v, 1e-10L, 0, exec_policy::sequential);
+    ASSERT_TRUE(parBicg.converged);
+    ASSERT_TRUE(seqBicg.converged);
+    ASSERT_LT(maxAbsDiff(parBicg.x, seqBicg.x), 1e-6);
+    set_parallel_thread_count(0);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(SparseMatrixTest, poisson_solver_performance_test)
+#else
+TEST_F(SparseMatrixTest, DISABLED_poisson_solver_performance_test)
+#endif
+{
+    // a 2D Poisson problem with 160000 unknowns: far too large for a dense matrix
+    size_t const dim   = 400;
+    auto         start = chrono::steady_clock::now();
+    auto         a     = poisson2D<double>(dim);
+    chrono::duration<double> built = chrono::steady_clock::now() - start;
+
+    vector<double> b(a.sizeY(), 1.0);
+    start            = chrono::steady_clock::now();
+    vector<double> y = a * b;
+    for(size_t i = 0; i < 99; i++)
+        a.multiplyInto(b, y);
+    chrono::duration<double> spmv = chrono::steady_clock::now() - start;
+
+    start       = chrono::steady_clock::now();
+    auto solved = conjugate_gradient(a, b, 1e-8L);
+    chrono::duration<double> cg = chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(solved.converged);
+    cout << dim * dim << " unknowns, " << a.nonZeros() << " non-zeros: built in " << built.count() << "s, 100 SpMV "
+         << spmv.count() << "s, CG " << solved.iterations << " iterations in " << cg.count() << "s" << endl;
+}
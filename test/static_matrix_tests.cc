@@ -0,0 +1,192 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/static_matrix_tests.cc
+ * Description: Unit tests for matrices with compile-time dimensions
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "matrix.h"
+#include "static_matrix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <gtest/gtest.h>
+#include <iostream>
+
+using namespace std;
+using namespace util;
+
+class StaticMatrixTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+};
+
+namespace
+{
+template<typename T_, size_t Rows_, size_t Cols_>
+double maxAbsDiff(static_matrix<T_, Rows_, Cols_> const &lhs, static_matrix<T_, Rows_, Cols_> const &rhs)
+{
+    double reval = 0.0;
+    for(size_t y = 0; y < Rows_; y++)
+        for(size_t x = 0; x < Cols_; x++)
+            reval = std::max(reval, static_cast<double>(std::abs(lhs(x, y) - rhs(x, y))));
+    return reval;
+}
+
+template<typename T_, size_t Dim_>
+static_matrix<T_, Dim_, Dim_> dominantMatrix(unsigned seed)
+{
+    static_matrix<T_, Dim_, Dim_> reval;
+    for(size_t y = 0; y < Dim_; y++)
+        for(size_t x = 0; x < Dim_; x++)
+        {
+            seed        = seed * 1103515245U + 12345U;
+            reval(x, y) = T_(static_cast<double>((seed >> 16) % 1000) / 500.0 - 1.0);
+        }
+    for(size_t i = 0; i < Dim_; i++)
+        reval(i, i) += T_(Dim_);
+    return reval;
+}
+
+// evaluated by the compiler
+constexpr static_matrix<long long, 3, 3> constexprMat{2, 1, 0, 1, 1, 0, 0, 0, 1};
+static_assert(constexprMat.det() == 1);
+static_assert(constexprMat * constexprMat.inv() == static_matrix<long long, 3, 3>::scalar());
+static_assert((~static_matrix<int, 2, 3>{1, 2, 3, 4, 5, 6})(1, 2) == 6);
+static_assert(static_matrix<int, 2, 3>{1, 2, 3, 4, 5, 6} * static_matrix<int, 3, 1>{1, 1, 1} ==
+              static_matrix<int, 2, 1>{6, 15});
+} // namespace
+
+template<typename T_, size_t Dim_>
+void testInverseT(double tolerance)
+{
+    using mat = static_matrix<T_, Dim_, Dim_>;
+    auto a    = dominantMatrix<T_, Dim_>(Dim_);
+    ASSERT_LT(maxAbsDiff(a * a.inv(), mat::scalar()), tolerance);
+    ASSERT_LT(maxAbsDiff(!a * a, mat::scalar()), tolerance);
+    ASSERT_LT(maxAbsDiff(a * a.adj() / a.det(), mat::scalar()), tolerance);
+
+    // the closed forms agree with the dynamic matrix
+    matrix<T_> dyn = a;
+    ASSERT_LT(std::abs(a.det() - dyn.det()) / std::abs(dyn.det()), tolerance);
+    ASSERT_LT(maxAbsDiff(a.inv(), mat(dyn.inv())), tolerance);
+
+    ASSERT_THROW(mat().inv(), matrixIsSingular);
+}
+
+template<typename T_>
+void testStaticMatrixT(double tolerance)
+{
+    using mat23 = static_matrix<T_, 2, 3>;
+    mat23 a{T_(1), T_(2), T_(3), T_(4), T_(5), T_(6)};
+    ASSERT_EQ(a.sizeX(), 3UL);
+    ASSERT_EQ(a.sizeY(), 2UL);
+    ASSERT_EQ(a(2, 0), T_(3));
+    ASSERT_EQ(a(0, 1), T_(4));
+    ASSERT_EQ(mat23{T_(1)}(1, 0), T_(0));
+
+    ASSERT_EQ(a + a, a * T_(2));
+    ASSERT_EQ(a + a, T_(2) * a);
+    ASSERT_EQ(a - a, mat23());
+    ASSERT_EQ(-a + a, mat23());
+    ASSERT_EQ((a * T_(4)) / T_(2), a + a);
+    ASSERT_THROW(a / T_(0), matrixScalarMustNotBeZero);
+
+    // products and transposition agree with the dynamic matrix
+    auto b = ~a;
+    static_assert(std::is_same_v<decltype(b), static_matrix<T_, 3, 2>>);
+    auto product = a * b;
+    static_assert(std::is_same_v<decltype(product), static_matrix<T_, 2, 2>>);
+    matrix<T_> dynA = a;
+    ASSERT_EQ(dynA.sizeX(), 3UL);
+    ASSERT_EQ(dynA.sizeY(), 2UL);
+    ASSERT_EQ(product.toMatrix(), dynA * ~dynA);
+    using mat22 = static_matrix<T_, 2, 2>;
+    ASSERT_EQ(mat22(dynA * ~dynA), product);
+    ASSERT_EQ(dynA * b, dynA * ~dynA);
+    using mat33 = static_matrix<T_, 3, 3>;
+    ASSERT_THROW(mat33{dynA}, matrixSizesIncompatible);
+
+    testInverseT<T_, 1>(tolerance);
+    testInverseT<T_, 2>(tolerance);
+    testInverseT<T_, 3>(tolerance);
+    testInverseT<T_, 4>(tolerance);
+    testInverseT<T_, 6>(tolerance);
+}
+
+TEST_F(StaticMatrixTest, static_matrix_test)
+{
+    testStaticMatrixT<double>(1e-12);
+    testStaticMatrixT<long double>(1e-15);
+    testStaticMatrixT<complex<double>>(1e-12);
+
+    static_matrix<long long, 4, 4> exact{1, 2, 3, 4, 0, 1, 5, 2, 2, 1, 0, 1, 1, 1, 1, 0};
+    ASSERT_EQ(exact.det(), matrix<long long>(exact).det());
+
+    // a nearly singular matrix is rejected like matrix::inv() rejects it, a badly scaled regular one is not
+    static_matrix<double, 3, 3> const nearlySingular{1, 2, 3, 4, 5, 6, 7, 8, std::nextafter(9.0, 10.0)};
+    ASSERT_NE(nearlySingular.det(), 0.0);
+    ASSERT_THROW(nearlySingular.inv(), matrixIsSingular);
+    ASSERT_THROW(nearlySingular.toMatrix().inv(), matrixIsSingular);
+    static_matrix<double, 3, 3> const badlyScaled{1e20, 0, 0, 0, 1, 0, 0, 0, 1e-20};
+    ASSERT_NO_THROW(badlyScaled.toMatrix().inv());
+    ASSERT_EQ(badlyScaled.inv(), (static_matrix<double, 3, 3>{1e-20, 0, 0, 0, 1, 0, 0, 0, 1e20}));
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(StaticMatrixTest, small_transform_performance_test)
+#else
+TEST_F(StaticMatrixTest, DISABLED_small_transform_performance_test)
+#endif
+{
+    // multiplying and inverting 4x4 transforms: static versus dynamic matrices
+    size_t const reps = 200000;
+    auto         a    = dominantMatrix<double, 4>(1U);
+    auto         b    = dominantMatrix<double, 4>(2U);
+    using mat44       = static_matrix<double, 4, 4>;
+
+    auto  start = chrono::steady_clock::now();
+    mat44 s;
+    for(size_t i = 0; i < reps; i++)
+        s += (a * (b + mat44::scalar(double(i) * 1e-6))).inv();
+    chrono::duration<double> staticTime = chrono::steady_clock::now() - start;
+
+    matrix<double> dynA = a;
+    matrix<double> dynB = b;
+    matrix<double> d(4, 4);
+    start = chrono::steady_clock::now();
+    for(size_t i = 0; i < reps; i++)
+        d += (dynA * (dynB + matrix<double>::scalar(4, double(i) * 1e-6))).inv();
+    chrono::duration<double> dynamicTime = chrono::steady_clock::now() - start;
+
+    ASSERT_LT(maxAbsDiff(s, mat44(d)), 1e-6);
+    cout << reps << " 4x4 multiply-invert steps: static_matrix " << staticTime.count() << "s, matrix "
+         << dynamicTime.count() << "s" << endl;
+}
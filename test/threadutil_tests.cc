@@ -24,9 +24,14 @@
  */
 #include "threadutil.h"
 
+#include <atomic>
+#include <barrier>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 using namespace util;
@@ -71,3 +76,64 @@ TEST_F(ThreadutilTest, future_with_exception_test)
     result_future = make_exception_safe_future(somefunc, x, y);
     ASSERT_THROW(result_future.get(), std::exception);
 }
+
+TEST_F(ThreadutilTest, parallel_for_test)
+{
+    ASSERT_TRUE(use_parallel(exec_policy::parallel, 0, 100));
+    ASSERT_FALSE(use_parallel(exec_policy::sequential, 1000, 100));
+    ASSERT_FALSE(use_parallel(exec_policy::automatic, 99, 100));
+    ASSERT_TRUE(use_parallel(exec_policy::automatic, 100, 100));
+
+    set_parallel_thread_count(3);
+    ASSERT_EQ(parallel_thread_count(), 3UL);
+
+    // every index is visited exactly once, in contiguous blocks
+    std::vector<int> visits(1000, 0);
+    std::atomic<size_t> blocks{0};
+    parallel_for(10,
+                 visits.size(),
+                 [&visits, &blocks](size_t lo, size_t hi)
+                 {
+                     blocks++;
+                     for(size_t i = lo; i < hi; i++)
+                         visits[i]++;
+                 });
+    ASSERT_EQ(blocks.load(), 3UL);
+    for(size_t i = 0; i < visits.size(); i++)
+        ASSERT_EQ(visits[i], i < 10 ? 0 : 1) << "index " << i;
+
+    // fewer indices than threads
+    blocks = 0;
+    parallel_for(0, 2, [&blocks](size_t lo, size_t hi) { blocks += hi - lo; });
+    ASSERT_EQ(blocks.load(), 2UL);
+
+    // an exception in any thread is re-thrown in the caller
+    ASSERT_THROW(run_on_threads(4,
+                                [](size_t t, size_t)
+                                {
+                                    if(t == 2)
+                                        throw std::runtime_error("thread 2");
+                                }),
+                 std::runtime_error);
+
+    // consecutive calls reuse the same worker threads
+    std::vector<std::thread::id> firstIds(4);
+    std::vector<std::thread::id> secondIds(4);
+    run_on_threads(4, [&firstIds](size_t t, size_t) { firstIds[t] = std::this_thread::get_id(); });
+    run_on_threads(4, [&secondIds](size_t t, size_t) { secondIds[t] = std::this_thread::get_id(); });
+    ASSERT_EQ(firstIds, secondIds);
+
+    // all threads of a call run concurrently, and nested calls do not wait for the busy pool
+    std::barrier        sync(3);
+    std::atomic<size_t> nested{0};
+    run_on_threads(3,
+                   [&sync, &nested](size_t, size_t)
+                   {
+                       sync.arrive_and_wait();
+                       run_on_threads(2, [&nested](size_t, size_t) { nested++; });
+                   });
+    ASSERT_EQ(nested.load(), 6UL);
+
+    set_parallel_thread_count(0);
+    ASSERT_GE(parallel_thread_count(), 1UL);
+}
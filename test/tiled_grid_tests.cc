@@ -0,0 +1,221 @@
+/*
+ * Repository:  https://github.com/kingkybel/CPP-utilities
+ * File Name:   test/tiled_grid_tests.cc
+ * Description: Unit tests for grids stored in tiles of a memory-mapped file
+ *
+ * Copyright (C) 2023 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-18
+ * @author: Dieter J Kybelksties
+ */
+
+#include "grid.h"
+#include "tiled_grid.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <utility>
+
+using namespace std;
+using namespace util;
+
+string const filename = "/tmp/test_tiled_grid.bin";
+
+class TiledGridTest : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+        std::remove(filename.c_str());
+    }
+};
+
+namespace
+{
+// a value that identifies the position of an element
+double positional(size_t x, size_t y)
+{
+    return double(y) * 100000.0 + double(x);
+}
+
+// number of bytes the file occupies on disk, which is less than its length if it has holes
+size_t diskUsage(string const &name)
+{
+    struct stat st{};
+    ::stat(name.c_str(), &st);
+    return size_t(st.st_blocks) * 512;
+}
+} // namespace
+
+TEST_F(TiledGridTest, tiled_grid_test)
+{
+    {
+        // tiles of 4x4 elements, at most 3 of them mapped
+        tiled_grid<double, 4>        g(filename, 10, 9, -1.0, gridBase<double>::Mode::AutoGrow, 3);
+        tiled_grid<double, 4> const &cg = g;
+        ASSERT_EQ(g.sizeX(), 10UL);
+        ASSERT_EQ(g.sizeY(), 9UL);
+        ASSERT_EQ(g.tilesX(), 3UL);
+        ASSERT_EQ(g.tilesY(), 3UL);
+        ASSERT_EQ(cg.get(9, 8), -1.0);
+        ASSERT_EQ(cg.get(10, 0), -1.0);
+        ASSERT_EQ(g.residentTiles(), 0UL);
+
+        // setting the default value does not write a tile
+        g.set(5, 5, -1.0);
+        ASSERT_FALSE(g.isWritten(5, 5));
+
+        for(size_t y = 0; y < 9; y++)
+            for(size_t x = 0; x < 10; x++)
+                if((x + y) % 3 == 0)
+                    g.set(x, y, positional(x, y));
+        ASSERT_LE(g.residentTiles(), 3UL);
+        ASSERT_GT(g.dirtyTiles(), 0UL);
+        for(size_t y = 0; y < 9; y++)
+            for(size_t x = 0; x < 10; x++)
+                ASSERT_EQ(cg(x, y), (x + y) % 3 == 0 ? positional(x, y) : -1.0) << x << "," << y;
+        ASSERT_LE(g.residentTiles(), 3UL);
+        g(1, 1) += 0.5;
+        ASSERT_EQ(cg.get(1, 1), -0.5);
+        g.flush();
+        ASSERT_EQ(g.dirtyTiles(), 0UL);
+
+        // growing beyond the row of tiles in the file moves the tiles
+        g.set(20, 10, 1.0);
+        ASSERT_EQ(g.sizeX(), 21UL);
+        ASSERT_EQ(g.sizeY(), 11UL);
+        ASSERT_EQ(cg.get(9, 3), positional(9, 3));
+        ASSERT_EQ(cg.get(10, 3), -1.0);
+        ASSERT_EQ(cg.get(9, 9), -1.0);
+        ASSERT_EQ(cg.get(20, 10), 1.0);
+        ASSERT_FALSE(g.isWritten(12, 12));
+    }
+
+    {
+        // the grid is read back from the file
+        tiled_grid<double, 4>        g(filename, gridBase<double>::Mode::NoAutoGrow, 2);
+        tiled_grid<double, 4> const &cg = g;
+        ASSERT_EQ(g.sizeX(), 21UL);
+        ASSERT_EQ(g.sizeY(), 11UL);
+        ASSERT_EQ(g.getDefaultValue(), -1.0);
+        for(size_t y = 0; y < 9; y++)
+            for(size_t x = 0; x < 10; x++)
+            {
+                if(x != 1 || y != 1)
+                {
+                    ASSERT_EQ(cg(x, y), (x + y) % 3 == 0 ? positional(x, y) : -1.0) << x << "," << y;
+                }
+            }
+        ASSERT_EQ(cg.get(1, 1), -0.5);
+        ASSERT_EQ(cg.get(20, 10), 1.0);
+        ASSERT_THROW(g.set(21, 0, 1.0), grid_error);
+
+        // shrinking discards the elements outside, growing again does not bring them back
+        g.resize(7, 3);
+        ASSERT_EQ(cg.get(6, 0), positional(6, 0));
+        g.resize(12, 6);
+        ASSERT_EQ(cg.get(6, 0), positional(6, 0));
+        ASSERT_EQ(cg.get(9, 0), -1.0);
+        ASSERT_EQ(cg.get(6, 3), -1.0);
+        ASSERT_EQ(cg.get(7, 2), -1.0);
+
+        // a new default value applies to the elements outside the grid and the tiles never written, not to the
+        // elements of written tiles
+        g.resize(11, 6);
+        g.set(10, 0, 5.0);
+        g.setDefaultValue(-2.0);
+        g.resize(14, 6);
+        ASSERT_EQ(cg.get(9, 0), -1.0);
+        ASSERT_EQ(cg.get(10, 0), 5.0);
+        ASSERT_EQ(cg.get(11, 0), -2.0);
+        ASSERT_EQ(cg.get(12, 0), -2.0);
+        ASSERT_EQ(cg.get(13, 5), -2.0);
+
+        g.setAll(3.0);
+        ASSERT_EQ(cg.get(0, 0), 3.0);
+        ASSERT_FALSE(g.isWritten(0, 0));
+    }
+
+    // files that do not hold a matching grid are rejected
+    ASSERT_THROW((tiled_grid<float, 4>(filename)), grid_file_error);
+    ASSERT_THROW((tiled_grid<double, 8>(filename)), grid_file_error);
+    ASSERT_THROW((tiled_grid<double, 4>("/tmp/no_such_dir/no_such_grid.bin")), grid_file_error);
+    {
+        ofstream ofs(filename, ios::binary | ios::trunc);
+        ofs << "not a grid";
+    }
+    ASSERT_THROW((tiled_grid<double, 4>(filename)), grid_file_error);
+}
+
+#ifdef DO_PERFORMANCE_
+TEST_F(TiledGridTest, tiled_grid_performance_test)
+#else
+TEST_F(TiledGridTest, DISABLED_tiled_grid_performance_test)
+#endif
+{
+    // write a 8192x8192 raster of doubles (512MB) row by row through 128 resident tiles (4MB), one row of tiles, and
+    // read it back tile by tile through 16 resident tiles, compared to a grid in memory
+    size_t const dim  = 8192;
+    size_t const edge = tiled_grid<double>::tileEdge;
+
+    auto         start = chrono::steady_clock::now();
+    grid<double> inMemory(dim, dim);
+    for(size_t y = 0; y < dim; y++)
+        for(size_t x = 0; x < dim; x++)
+            inMemory.set(x, y, positional(x, y));
+    uint64_t memorySum = 0;
+    for(size_t y = 0; y < dim; y++)
+        for(size_t x = 0; x < dim; x++)
+            memorySum += uint64_t(as_const(inMemory).get(x, y));
+    chrono::duration<double> memoryTime = chrono::steady_clock::now() - start;
+    inMemory.resize(0, 0);
+
+    start                = chrono::steady_clock::now();
+    uint64_t tiledSum    = 0;
+    size_t   maxResident = 0;
+    {
+        tiled_grid<double> tiled(filename, dim, dim, 0.0, gridBase<double>::Mode::NoAutoGrow, 128);
+        for(size_t y = 0; y < dim; y++)
+            for(size_t x = 0; x < dim; x++)
+                tiled.set(x, y, positional(x, y));
+        maxResident = tiled.residentTiles();
+    }
+    {
+        tiled_grid<double> const tiled(filename, gridBase<double>::Mode::NoAutoGrow, 16);
+        for(size_t ty = 0; ty < tiled.tilesY(); ty++)
+            for(size_t tx = 0; tx < tiled.tilesX(); tx++)
+                for(size_t y = ty * edge; y < (ty + 1) * edge; y++)
+                    for(size_t x = tx * edge; x < (tx + 1) * edge; x++)
+                        tiledSum += uint64_t(tiled.get(x, y));
+        maxResident = max(maxResident, tiled.residentTiles());
+    }
+    chrono::duration<double> tiledTime = chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(memorySum, tiledSum);
+    ASSERT_LE(maxResident, 128UL);
+    ASSERT_GE(diskUsage(filename), dim * dim * sizeof(double));
+    cout << "writing and reading " << dim << "x" << dim << " doubles: grid in memory " << memoryTime.count()
+         << "s, tiled_grid with at most " << maxResident << " resident tiles " << tiledTime.count() << "s" << endl;
+}